@@ -42,6 +42,12 @@ if(UNDEFINED_SANITIZER)
 endif()
 cmake_print_variables(ADDRESS_SANITIZER UNDEFINED_SANITIZER)
 
+option(UCONTEXT_SWITCH "Switch to php scripts and back with ucontext(3) instead of the assembly implementation")
+if(UCONTEXT_SWITCH)
+    add_definitions(-DKPHP_UCONTEXT_SWITCH=1)
+endif()
+cmake_print_variables(UCONTEXT_SWITCH)
+
 option(KPHP_TESTS "Build the tests" ON)
 cmake_print_variables(KPHP_TESTS)
 
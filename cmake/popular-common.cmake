@@ -19,6 +19,8 @@ prepend(POPULAR_COMMON_SOURCES ${COMMON_DIR}/
         secure-bzero.cpp
         crc32_${HOST}.cpp
         crc32c_${HOST}.cpp
+        xxh3.cpp
+        string-encoders.cpp
         parallel/counter.cpp
         parallel/maximum.cpp
         parallel/thread-id.cpp
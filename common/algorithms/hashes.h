@@ -83,6 +83,17 @@ inline uint64_t string_hash_5381(const std::string &_input) {
   return hash;
 }
 
+// FNV-1a with a seed, the compiler searches for seeds making it a perfect hash of a fixed set of strings,
+// so the generated code and the runtime must agree on it
+inline uint32_t seeded_string_hash(const char *s, size_t len, uint32_t seed) noexcept {
+  uint32_t hash = 2166136261u ^ seed;
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<unsigned char>(s[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 } // namespace vk
 
 namespace std {
@@ -7,6 +7,7 @@ prepend(COMMON_TESTS_SOURCES ${COMMON_DIR}/
         algorithms/string-algorithms-test.cpp
         allocators/freelist-test.cpp
         allocators/lockfree-slab-test.cpp
+        context-switch-test.cpp
         crc32c-test.cpp
         crypto/aes256-test.cpp
         parallel/counter-test.cpp
@@ -14,9 +15,13 @@ prepend(COMMON_TESTS_SOURCES ${COMMON_DIR}/
         parallel/maximum-test.cpp
         smart_iterators/smart-iterators-test.cpp
         smart_ptrs/tagged-ptr-test.cpp
+        stats/hdr-histogram-test.cpp
+        string-encoders-test.cpp
         type_traits/list_of_types_test.cpp
+        unicode/utf8-utils-test.cpp
         wrappers/span-test.cpp
-        wrappers/string_view-test.cpp)
+        wrappers/string_view-test.cpp
+        xxh3-test.cpp)
 
 prepare_cross_platform_libs(COMMON_TESTS_LIBS zstd)
 set(COMMON_TESTS_LIBS vk::common_src vk::net_src vk::binlog_src vk::unicode ${COMMON_TESTS_LIBS} ${EPOLL_SHIM_LIB} OpenSSL::Crypto z)
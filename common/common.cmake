@@ -16,6 +16,7 @@ prepend(COMMON_MAIN_SOURCES ${COMMON_DIR}/
         crypto/aes256-generic.cpp
         crypto/aes256-${HOST}.cpp
 
+        context-switch.cpp
         fast-backtrace.cpp
         string-processing.cpp
         kphp-tasks-lease/lease-worker-mode.cpp)
@@ -0,0 +1,98 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <benchmark/benchmark.h>
+
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "common/context-switch.h"
+
+namespace {
+
+// a script doing rpc queries: it pauses on each of them and is resumed by the net loop
+struct ucontext_script {
+  static ucontext_t net_context;
+  static ucontext_t script_context;
+
+  static void run() {
+    while (true) {
+      swapcontext(&script_context, &net_context);
+    }
+  }
+
+  static void start(char *stack, size_t stack_size) {
+    getcontext(&script_context);
+    script_context.uc_stack.ss_sp = stack;
+    script_context.uc_stack.ss_size = stack_size;
+    script_context.uc_link = nullptr;
+    makecontext(&script_context, &run, 0);
+  }
+
+  static void resume() {
+    swapcontext(&net_context, &script_context);
+  }
+};
+
+ucontext_t ucontext_script::net_context;
+ucontext_t ucontext_script::script_context;
+
+struct execution_context_script {
+  static execution_context net_context;
+  static execution_context script_context;
+
+  static void run() {
+    while (true) {
+      swap_execution_context(&script_context, &net_context);
+    }
+  }
+
+  static void start(char *stack, size_t stack_size) {
+    make_execution_context(&script_context, stack, stack_size, &run);
+  }
+
+  static void resume() {
+    swap_execution_context(&net_context, &script_context);
+  }
+};
+
+execution_context execution_context_script::net_context;
+execution_context execution_context_script::script_context;
+
+const size_t script_stack_size = 8 << 20;
+
+} // namespace
+
+template<class Script>
+static void BM_context_switch(benchmark::State &state) {
+  char *stack = acquire_execution_stack(script_stack_size);
+  Script::start(stack, script_stack_size);
+  for (auto _ : state) {
+    Script::resume();
+  }
+  // a resume is two switches: to the script and back
+  state.SetItemsProcessed(2 * state.iterations());
+  release_execution_stack(stack, script_stack_size);
+}
+BENCHMARK_TEMPLATE(BM_context_switch, ucontext_script);
+BENCHMARK_TEMPLATE(BM_context_switch, execution_context_script);
+
+// per request: getting a stack, preparing the context and state.range(0) rpc round trips
+template<class Script>
+static void BM_request_with_rpc_round_trips(benchmark::State &state) {
+  const int64_t round_trips = state.range(0);
+  for (auto _ : state) {
+    char *stack = acquire_execution_stack(script_stack_size);
+    Script::start(stack, script_stack_size);
+    for (int64_t i = 0; i < round_trips; ++i) {
+      Script::resume();
+    }
+    release_execution_stack(stack, script_stack_size);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_request_with_rpc_round_trips, ucontext_script)->Arg(1)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_request_with_rpc_round_trips, execution_context_script)->Arg(1)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,79 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <unistd.h>
+
+#include "common/context-switch.h"
+
+namespace {
+
+execution_context main_context;
+execution_context coroutine_context;
+int coroutine_steps = 0;
+bool coroutine_stack_is_aligned = false;
+double coroutine_sum = 0;
+
+void coroutine_entry() {
+  alignas(16) char aligned_local[16];
+  coroutine_stack_is_aligned = reinterpret_cast<uintptr_t>(aligned_local) % 16 == 0;
+  for (int i = 0;; ++i) {
+    ++coroutine_steps;
+    coroutine_sum += i * 0.5;
+    swap_execution_context(&coroutine_context, &main_context);
+  }
+}
+
+size_t test_stack_size() {
+  return static_cast<size_t>(getpagesize()) * 17;
+}
+
+} // namespace
+
+TEST(context_switch_test, ping_pong) {
+  const size_t stack_size = test_stack_size();
+  char *stack = acquire_execution_stack(stack_size);
+  ASSERT_NE(stack, nullptr);
+
+  coroutine_steps = 0;
+  coroutine_sum = 0;
+  make_execution_context(&coroutine_context, stack, stack_size, &coroutine_entry);
+
+  double expected_sum = 0;
+  for (int i = 0; i < 1000; ++i) {
+    // keep values in callee-saved registers across the switch
+    const double before = expected_sum;
+    swap_execution_context(&main_context, &coroutine_context);
+    expected_sum = before + i * 0.5;
+    ASSERT_EQ(coroutine_steps, i + 1);
+  }
+  ASSERT_TRUE(coroutine_stack_is_aligned);
+  ASSERT_EQ(coroutine_sum, expected_sum);
+
+  release_execution_stack(stack, stack_size);
+}
+
+TEST(context_switch_test, stack_pool_reuses_stacks) {
+  const size_t stack_size = test_stack_size();
+  char *stack = acquire_execution_stack(stack_size);
+  release_execution_stack(stack, stack_size);
+  ASSERT_EQ(acquire_execution_stack(stack_size), stack);
+
+  const size_t other_stack_size = stack_size + getpagesize();
+  char *other_stack = acquire_execution_stack(other_stack_size);
+  ASSERT_NE(other_stack, stack);
+
+  release_execution_stack(other_stack, other_stack_size);
+  release_execution_stack(stack, stack_size);
+}
+
+TEST(context_switch_test, guard_page) {
+  const size_t stack_size = test_stack_size();
+  char *stack = acquire_execution_stack(stack_size);
+  ASSERT_DEATH(stack[getpagesize() - 1] = 1, "");
+  stack[getpagesize()] = 1;
+  release_execution_stack(stack, stack_size);
+}
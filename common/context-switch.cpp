@@ -0,0 +1,216 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/context-switch.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "common/dl-utils-lite.h"
+
+#if KPHP_UCONTEXT_SWITCH
+
+void make_execution_context(execution_context *ctx, char *stack, size_t stack_size, void (*entry)()) noexcept {
+  getcontext(&ctx->uc);
+  ctx->uc.uc_stack.ss_sp = stack;
+  ctx->uc.uc_stack.ss_size = stack_size;
+  ctx->uc.uc_link = nullptr;
+  makecontext(&ctx->uc, entry, 0);
+}
+
+void swap_execution_context(execution_context *from, const execution_context *to) noexcept {
+  dl_passert(swapcontext(&from->uc, &to->uc) == 0, "swapcontext failed");
+}
+
+void set_execution_context(const execution_context *to) noexcept {
+  setcontext(&to->uc);
+  dl_unreachable("setcontext failed");
+  __builtin_unreachable();
+}
+
+#else
+
+#if defined(__APPLE__)
+# define KPHP_ASM_SYMBOL(name) "_" #name
+# define KPHP_ASM_FUNCTION_TYPE(name)
+#else
+# define KPHP_ASM_SYMBOL(name) #name
+# define KPHP_ASM_FUNCTION_TYPE(name) ".type " #name ", %function\n"
+#endif
+
+extern "C" {
+// saves callee-saved registers on the current stack, stores the stack pointer to *from_sp,
+// switches to to_sp and restores the registers saved there
+void kphp_swap_context(void **from_sp, void *to_sp) noexcept;
+// the first frame of every context: calls the entry stored in a callee-saved register
+void kphp_context_trampoline() noexcept;
+}
+
+#if defined(__x86_64__)
+
+// frame: mxcsr and x87 control word, r15, r14, r13, r12, rbx, rbp, return address
+asm(".text\n"
+    ".globl " KPHP_ASM_SYMBOL(kphp_swap_context) "\n"
+    KPHP_ASM_FUNCTION_TYPE(kphp_swap_context)
+    ".p2align 4\n"
+    KPHP_ASM_SYMBOL(kphp_swap_context) ":\n"
+    "  pushq %rbp\n"
+    "  pushq %rbx\n"
+    "  pushq %r12\n"
+    "  pushq %r13\n"
+    "  pushq %r14\n"
+    "  pushq %r15\n"
+    "  subq $8, %rsp\n"
+    "  stmxcsr (%rsp)\n"
+    "  fnstcw 4(%rsp)\n"
+    "  movq %rsp, (%rdi)\n"
+    "  movq %rsi, %rsp\n"
+    "  ldmxcsr (%rsp)\n"
+    "  fldcw 4(%rsp)\n"
+    "  addq $8, %rsp\n"
+    "  popq %r15\n"
+    "  popq %r14\n"
+    "  popq %r13\n"
+    "  popq %r12\n"
+    "  popq %rbx\n"
+    "  popq %rbp\n"
+    "  ret\n"
+    ".globl " KPHP_ASM_SYMBOL(kphp_context_trampoline) "\n"
+    KPHP_ASM_FUNCTION_TYPE(kphp_context_trampoline)
+    ".p2align 4\n"
+    KPHP_ASM_SYMBOL(kphp_context_trampoline) ":\n"
+    "  .cfi_startproc\n"
+    "  .cfi_undefined rip\n"
+    "  callq *%rbx\n"
+    "  ud2\n"
+    "  .cfi_endproc\n");
+
+void make_execution_context(execution_context *ctx, char *stack, size_t stack_size, void (*entry)()) noexcept {
+  auto top = reinterpret_cast<uintptr_t>(stack + stack_size) & ~uintptr_t{15};
+  // the trampoline starts with 16-byte aligned rsp, as if it was called
+  auto *frame = reinterpret_cast<uint64_t *>(top - 10 * sizeof(uint64_t));
+  memset(frame, 0, 10 * sizeof(uint64_t));
+
+  uint32_t mxcsr = 0;
+  uint16_t x87_cw = 0;
+  asm volatile("stmxcsr %0\n\t"
+               "fnstcw %1"
+               : "=m"(mxcsr), "=m"(x87_cw));
+  memcpy(reinterpret_cast<char *>(frame), &mxcsr, sizeof(mxcsr));
+  memcpy(reinterpret_cast<char *>(frame) + 4, &x87_cw, sizeof(x87_cw));
+  frame[5] = reinterpret_cast<uint64_t>(entry);                   // rbx
+  frame[6] = 0;                                                   // rbp, stops backtraces
+  frame[7] = reinterpret_cast<uint64_t>(&kphp_context_trampoline); // return address
+  ctx->sp = frame;
+}
+
+#elif defined(__aarch64__)
+
+// frame: x19-x28, x29 (fp), x30 (lr), d8-d15
+asm(".text\n"
+    ".globl " KPHP_ASM_SYMBOL(kphp_swap_context) "\n"
+    KPHP_ASM_FUNCTION_TYPE(kphp_swap_context)
+    ".p2align 4\n"
+    KPHP_ASM_SYMBOL(kphp_swap_context) ":\n"
+    "  sub sp, sp, #0xa0\n"
+    "  stp x19, x20, [sp, #0x00]\n"
+    "  stp x21, x22, [sp, #0x10]\n"
+    "  stp x23, x24, [sp, #0x20]\n"
+    "  stp x25, x26, [sp, #0x30]\n"
+    "  stp x27, x28, [sp, #0x40]\n"
+    "  stp x29, x30, [sp, #0x50]\n"
+    "  stp d8, d9, [sp, #0x60]\n"
+    "  stp d10, d11, [sp, #0x70]\n"
+    "  stp d12, d13, [sp, #0x80]\n"
+    "  stp d14, d15, [sp, #0x90]\n"
+    "  mov x9, sp\n"
+    "  str x9, [x0]\n"
+    "  mov sp, x1\n"
+    "  ldp x19, x20, [sp, #0x00]\n"
+    "  ldp x21, x22, [sp, #0x10]\n"
+    "  ldp x23, x24, [sp, #0x20]\n"
+    "  ldp x25, x26, [sp, #0x30]\n"
+    "  ldp x27, x28, [sp, #0x40]\n"
+    "  ldp x29, x30, [sp, #0x50]\n"
+    "  ldp d8, d9, [sp, #0x60]\n"
+    "  ldp d10, d11, [sp, #0x70]\n"
+    "  ldp d12, d13, [sp, #0x80]\n"
+    "  ldp d14, d15, [sp, #0x90]\n"
+    "  add sp, sp, #0xa0\n"
+    "  ret\n"
+    ".globl " KPHP_ASM_SYMBOL(kphp_context_trampoline) "\n"
+    KPHP_ASM_FUNCTION_TYPE(kphp_context_trampoline)
+    ".p2align 4\n"
+    KPHP_ASM_SYMBOL(kphp_context_trampoline) ":\n"
+    "  .cfi_startproc\n"
+    "  .cfi_undefined x30\n"
+    "  blr x19\n"
+    "  brk #0\n"
+    "  .cfi_endproc\n");
+
+void make_execution_context(execution_context *ctx, char *stack, size_t stack_size, void (*entry)()) noexcept {
+  auto top = reinterpret_cast<uintptr_t>(stack + stack_size) & ~uintptr_t{15};
+  auto *frame = reinterpret_cast<uint64_t *>(top - 20 * sizeof(uint64_t));
+  memset(frame, 0, 20 * sizeof(uint64_t));
+  frame[0] = reinterpret_cast<uint64_t>(entry);                    // x19
+  frame[10] = 0;                                                   // x29, stops backtraces
+  frame[11] = reinterpret_cast<uint64_t>(&kphp_context_trampoline); // x30
+  ctx->sp = frame;
+}
+
+#endif
+
+void swap_execution_context(execution_context *from, const execution_context *to) noexcept {
+  kphp_swap_context(&from->sp, to->sp);
+}
+
+void set_execution_context(const execution_context *to) noexcept {
+  void *dropped_sp = nullptr;
+  kphp_swap_context(&dropped_sp, to->sp);
+  __builtin_unreachable();
+}
+
+#endif
+
+namespace {
+
+// stacks are acquired and released by the main thread of a worker only
+struct pooled_execution_stack {
+  char *stack;
+  size_t stack_size;
+};
+
+constexpr size_t EXECUTION_STACK_POOL_CAPACITY = 4;
+pooled_execution_stack execution_stack_pool[EXECUTION_STACK_POOL_CAPACITY];
+size_t execution_stack_pool_size = 0;
+
+} // namespace
+
+char *acquire_execution_stack(size_t stack_size) noexcept {
+  const auto page_size = static_cast<size_t>(getpagesize());
+  dl_assert(stack_size > page_size && stack_size % page_size == 0, "bad execution stack size");
+
+  for (size_t i = 0; i < execution_stack_pool_size; ++i) {
+    if (execution_stack_pool[i].stack_size == stack_size) {
+      char *stack = execution_stack_pool[i].stack;
+      execution_stack_pool[i] = execution_stack_pool[--execution_stack_pool_size];
+      return stack;
+    }
+  }
+
+  void *stack = mmap(nullptr, stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  dl_passert(stack != MAP_FAILED, "can't mmap execution stack");
+  dl_passert(mprotect(stack, page_size, PROT_NONE) == 0, "can't protect execution stack guard page");
+  return static_cast<char *>(stack);
+}
+
+void release_execution_stack(char *stack, size_t stack_size) noexcept {
+  if (execution_stack_pool_size < EXECUTION_STACK_POOL_CAPACITY) {
+    execution_stack_pool[execution_stack_pool_size++] = pooled_execution_stack{stack, stack_size};
+    return;
+  }
+  munmap(stack, stack_size);
+}
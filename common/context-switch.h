@@ -0,0 +1,48 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+
+// Execution contexts for coroutines (e.g. php scripts running on their own stacks).
+// Unlike swapcontext(3), switching doesn't save and restore the signal mask, so it costs no syscalls:
+// only the callee-saved registers and the stack pointer are stored on the stack being left.
+// Build with -DKPHP_UCONTEXT_SWITCH=1 to fall back to ucontext(3).
+
+#if !defined(KPHP_UCONTEXT_SWITCH)
+# if defined(__x86_64__) || defined(__aarch64__)
+#  define KPHP_UCONTEXT_SWITCH 0
+# else
+#  define KPHP_UCONTEXT_SWITCH 1
+# endif
+#endif
+
+#if KPHP_UCONTEXT_SWITCH
+#include <ucontext.h>
+
+struct execution_context {
+  ucontext_t uc;
+};
+#else
+struct execution_context {
+  void *sp{nullptr};
+};
+#endif
+
+// entry must never return
+void make_execution_context(execution_context *ctx, char *stack, size_t stack_size, void (*entry)()) noexcept;
+
+// saves the current context to from and continues with to
+void swap_execution_context(execution_context *from, const execution_context *to) noexcept;
+
+// continues with to, the current context is dropped;
+// the signal mask is left as is, restore it when leaving a signal handler
+[[noreturn]] void set_execution_context(const execution_context *to) noexcept;
+
+// Coroutine stacks are mmaped with a PROT_NONE guard page at the lowest address,
+// released stacks are kept in a small pool and reused, as mmap + mprotect are syscalls.
+// stack_size includes the guard page and must be a multiple of the page size.
+char *acquire_execution_stack(size_t stack_size) noexcept;
+void release_execution_stack(char *stack, size_t stack_size) noexcept;
@@ -14,8 +14,18 @@ const kdb_cpuid_t *kdb_cpuid() {
     assert(cached.type == KDB_CPUID_X86_64);
     return &cached;
   }
-  int a;
+  int a, b, c, d;
+  asm volatile("cpuid\n\t" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(0));
+  const int max_leaf = a;
   asm volatile("cpuid\n\t" : "=a"(a), "=b"(cached.x86_64.ebx), "=c"(cached.x86_64.ecx), "=d"(cached.x86_64.edx) : "0"(1));
+  cached.x86_64.ebx7 = cached.x86_64.ecx7 = cached.x86_64.xcr0 = 0;
+  if (max_leaf >= 7) {
+    asm volatile("cpuid\n\t" : "=a"(a), "=b"(cached.x86_64.ebx7), "=c"(cached.x86_64.ecx7), "=d"(d) : "0"(7), "2"(0));
+  }
+  // OSXSAVE: xgetbv is available
+  if (cached.x86_64.ecx & (1 << 27)) {
+    asm volatile("xgetbv\n\t" : "=a"(cached.x86_64.xcr0), "=d"(d) : "c"(0));
+  }
   cached.type = KDB_CPUID_X86_64;
 #elif defined(__aarch64__)
   if (cached.type) {
@@ -30,3 +40,13 @@ const kdb_cpuid_t *kdb_cpuid() {
 
   return &cached;
 }
+
+bool kdb_cpuid_has_avx2() {
+#if defined(__x86_64__)
+  const kdb_cpuid_t *cpuid = kdb_cpuid();
+  const bool os_saves_ymm = (cpuid->x86_64.ecx & (1 << 27)) && (cpuid->x86_64.xcr0 & 0x06) == 0x06;
+  return (cpuid->x86_64.ebx7 & (1 << 5)) && os_saves_ymm;
+#else
+  return false;
+#endif
+}
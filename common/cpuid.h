@@ -13,10 +13,17 @@ typedef struct {
   union {
     struct {
       int ebx, ecx, edx;
+      // structured extended features (leaf 7, subleaf 0): AVX2, SHA, VAES, AVX-512...
+      int ebx7, ecx7;
+      // low half of XCR0, tells which register states are enabled by the OS
+      int xcr0;
     } x86_64;
   };
 } kdb_cpuid_t;
 
 const kdb_cpuid_t *kdb_cpuid ();
 
+// AVX2 is supported by the CPU and the OS saves the ymm registers
+bool kdb_cpuid_has_avx2 ();
+
 #endif
@@ -12,6 +12,7 @@
 
 #include "common/crypto/aes256-generic.h"
 #include "common/crypto/aes256.h"
+#include "common/crypto/aes256-x86_64.h"
 
 static void BM_crypto_aes256_set_encrypt_key(benchmark::State& state) {
   std::array<std::uint8_t, 32> key;
@@ -54,6 +55,7 @@ static void BM_crypto_aes256_encrypt_cbc(benchmark::State& state) {
   for(auto _ : state) {
     ctx.cbc_crypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data());
   }
+  state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_crypto_aes256_encrypt_cbc)->RangeMultiplier(2)->Range(16, 16 << 20);
 
@@ -73,6 +75,7 @@ static void BM_crypto_generic_aes256_encrypt_cbc(benchmark::State& state) {
   for(auto _ : state) {
     crypto_generic_aes256_cbc_encrypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data());
   }
+  state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_crypto_generic_aes256_encrypt_cbc)->RangeMultiplier(2)->Range(16, 16 << 20);
 
@@ -92,6 +95,7 @@ static void BM_crypto_generic_aes256_encrypt_ige(benchmark::State& state) {
   for(auto _ : state) {
     crypto_generic_aes256_ige_encrypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data());
   }
+  state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_crypto_generic_aes256_encrypt_ige)->RangeMultiplier(2)->Range(16, 16 << 20);
 
@@ -111,6 +115,7 @@ static void BM_crypto_aes256_encrypt_ige(benchmark::State& state) {
   for(auto _ : state) {
     ctx.ige_crypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data());
   }
+  state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_crypto_aes256_encrypt_ige)->RangeMultiplier(2)->Range(16, 16 << 20);
 
@@ -131,7 +136,107 @@ static void BM_crypto_aes256_encrypt_ctr(benchmark::State& state) {
   for(auto _ : state) {
     ctx.ctr_crypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data(), 0);
   }
+  state.SetBytesProcessed(state.iterations() * size);
 }
 BENCHMARK(BM_crypto_aes256_encrypt_ctr)->RangeMultiplier(2)->Range(16, 16 << 20);
 
+static void BM_crypto_aes256_decrypt_cbc(benchmark::State& state) {
+  std::array<std::uint8_t, 16> iv;
+  std::array<std::uint8_t, 32> key;
+  std::independent_bits_engine<std::default_random_engine, 8, std::uint8_t> engine;
+  std::generate(key.begin(), key.end(), std::ref(engine));
+  std::generate(iv.begin(), iv.end(), std::ref(engine));
+
+  const std::size_t size = state.range(0);
+  std::vector<std::uint8_t> ciphertext(size), plaintext(size);
+  std::generate(ciphertext.begin(), ciphertext.end(), std::ref(engine));
+
+  vk_aes_ctx_t ctx;
+  vk_aes_set_decrypt_key(&ctx, key.data(), AES256_KEY_BITS);
+
+  for(auto _ : state) {
+    ctx.cbc_crypt(&ctx, ciphertext.data(), plaintext.data(), ciphertext.size(), iv.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_crypto_aes256_decrypt_cbc)->RangeMultiplier(2)->Range(16, 16 << 20);
+
+static void BM_crypto_generic_aes256_decrypt_cbc(benchmark::State& state) {
+  std::array<std::uint8_t, 16> iv;
+  std::array<std::uint8_t, 32> key;
+  std::independent_bits_engine<std::default_random_engine, 8, std::uint8_t> engine;
+  std::generate(key.begin(), key.end(), std::ref(engine));
+  std::generate(iv.begin(), iv.end(), std::ref(engine));
+
+  const std::size_t size = state.range(0);
+  std::vector<std::uint8_t> ciphertext(size), plaintext(size);
+  std::generate(ciphertext.begin(), ciphertext.end(), std::ref(engine));
+
+  vk_aes_ctx_t ctx;
+  crypto_generic_aes256_set_decrypt_key(&ctx, key.data());
+
+  for(auto _ : state) {
+    crypto_generic_aes256_cbc_decrypt(&ctx, ciphertext.data(), plaintext.data(), ciphertext.size(), iv.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_crypto_generic_aes256_decrypt_cbc)->RangeMultiplier(2)->Range(16, 16 << 20);
+
+#ifdef __x86_64__
+// compares the AES-NI and VAES kernels directly, independently of what the dispatcher has chosen
+template<void (*ctr_crypt)(vk_aes_ctx_t *, const uint8_t *, uint8_t *, int, uint8_t *, uint64_t)>
+static void BM_crypto_x86_64_aes256_encrypt_ctr(benchmark::State& state) {
+  if (!crypto_x86_64_has_aesni_extension() || (ctr_crypt == crypto_x86_64_vaes256_ctr_encrypt && !crypto_x86_64_has_vaes_extension())) {
+    state.SkipWithError("not supported by CPU");
+    return;
+  }
+  std::array<std::uint8_t, 16> iv;
+  std::array<std::uint8_t, 32> key;
+  std::independent_bits_engine<std::default_random_engine, 8, std::uint8_t> engine;
+  std::generate(key.begin(), key.end(), std::ref(engine));
+  std::generate(iv.begin(), iv.end(), std::ref(engine));
+
+  const std::size_t size = state.range(0);
+  std::vector<std::uint8_t> payload(size), ciphertext(size);
+  std::generate(payload.begin(), payload.end(), std::ref(engine));
+
+  vk_aes_ctx_t ctx;
+  crypto_x86_64_aesni256_set_encrypt_key(&ctx, key.data());
+
+  for(auto _ : state) {
+    ctr_crypt(&ctx, payload.data(), ciphertext.data(), payload.size(), iv.data(), 0);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK_TEMPLATE(BM_crypto_x86_64_aes256_encrypt_ctr, crypto_x86_64_aesni256_ctr_encrypt)->RangeMultiplier(4)->Range(16, 16 << 20);
+BENCHMARK_TEMPLATE(BM_crypto_x86_64_aes256_encrypt_ctr, crypto_x86_64_vaes256_ctr_encrypt)->RangeMultiplier(4)->Range(16, 16 << 20);
+
+template<void (*cbc_crypt)(vk_aes_ctx_t *, const uint8_t *, uint8_t *, int, uint8_t *)>
+static void BM_crypto_x86_64_aes256_decrypt_cbc(benchmark::State& state) {
+  if (!crypto_x86_64_has_aesni_extension() || (cbc_crypt == crypto_x86_64_vaes256_cbc_decrypt && !crypto_x86_64_has_vaes_extension())) {
+    state.SkipWithError("not supported by CPU");
+    return;
+  }
+  std::array<std::uint8_t, 16> iv;
+  std::array<std::uint8_t, 32> key;
+  std::independent_bits_engine<std::default_random_engine, 8, std::uint8_t> engine;
+  std::generate(key.begin(), key.end(), std::ref(engine));
+  std::generate(iv.begin(), iv.end(), std::ref(engine));
+
+  const std::size_t size = state.range(0);
+  std::vector<std::uint8_t> ciphertext(size), plaintext(size);
+  std::generate(ciphertext.begin(), ciphertext.end(), std::ref(engine));
+
+  vk_aes_ctx_t ctx;
+  crypto_x86_64_aesni256_set_decrypt_key(&ctx, key.data());
+
+  for(auto _ : state) {
+    cbc_crypt(&ctx, ciphertext.data(), plaintext.data(), ciphertext.size(), iv.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK_TEMPLATE(BM_crypto_x86_64_aes256_decrypt_cbc, crypto_x86_64_aesni256_cbc_decrypt)->RangeMultiplier(4)->Range(16, 16 << 20);
+BENCHMARK_TEMPLATE(BM_crypto_x86_64_aes256_decrypt_cbc, crypto_x86_64_vaes256_cbc_decrypt)->RangeMultiplier(4)->Range(16, 16 << 20);
+#endif // __x86_64__
+
 BENCHMARK_MAIN();
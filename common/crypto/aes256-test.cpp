@@ -257,6 +257,43 @@ TEST(AES256_ctr, test_vector) {
   }
 }
 
+// sizes are chosen to cover the multi-block pipelined loops and the single block / partial tails
+using AES256_multiblock_random = AESCtx<16 * 67 + 5, 16, 32>;
+TEST_F(AES256_multiblock_random, cbc_decrypt_matches_generic) {
+  vk_aes_ctx_t ctx, generic_ctx;
+  vk_aes_set_decrypt_key(&ctx, random_key_.data(), aes_ctx_key_bits);
+  crypto_generic_aes256_set_decrypt_key(&generic_ctx, random_key_.data());
+
+  for (int size : {16, 16 * 7, 16 * 8, 16 * 9, 16 * 16, 16 * 23, 16 * 67}) {
+    auto iv = random_iv_initial_;
+    auto generic_iv = random_iv_initial_;
+    std::array<std::uint8_t, aes_ctx_plaintext_bytes> expected, actual;
+    crypto_generic_aes256_cbc_decrypt(&generic_ctx, random_payload_.data(), expected.data(), size, generic_iv.data());
+
+    actual = random_payload_;
+    ctx.cbc_crypt(&ctx, actual.data(), actual.data(), size, iv.data());
+    EXPECT_FALSE(std::memcmp(expected.data(), actual.data(), size)) << "size " << size;
+    EXPECT_EQ(generic_iv, iv) << "size " << size;
+  }
+}
+
+TEST_F(AES256_multiblock_random, ctr_matches_generic) {
+  vk_aes_ctx_t ctx, generic_ctx;
+  vk_aes_set_encrypt_key(&ctx, random_key_.data(), aes_ctx_key_bits);
+  crypto_generic_aes256_set_encrypt_key(&generic_ctx, random_key_.data());
+
+  for (uint64_t offset : {0, 3, 16, 17 * 16}) {
+    for (int size : {5, 16, 16 * 8 + 3, 16 * 9, 16 * 33 + 1, 16 * 67 + 5}) {
+      auto iv = random_iv_initial_;
+      auto generic_iv = random_iv_initial_;
+      std::array<std::uint8_t, aes_ctx_plaintext_bytes> expected, actual;
+      crypto_generic_aes256_ctr_encrypt(&generic_ctx, random_payload_.data(), expected.data(), size, generic_iv.data(), offset);
+      ctx.ctr_crypt(&ctx, random_payload_.data(), actual.data(), size, iv.data(), offset);
+      EXPECT_FALSE(std::memcmp(expected.data(), actual.data(), size)) << "size " << size << ", offset " << offset;
+    }
+  }
+}
+
 #ifdef __x86_64__
 
 TEST(crypto_x86_64_aesni256_set_encrypt_key, basic) {
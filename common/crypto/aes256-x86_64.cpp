@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <emmintrin.h>
+#include <immintrin.h>
 #include <string.h>
 
 #include "common/cpuid.h"
@@ -21,6 +22,33 @@ static inline void storedqu(char *out, v16qi v) {
   _mm_storeu_si128((v2di *)out, (v2di)v);
 }
 
+// the whole project is built for nehalem, so AES-NI and VAES intrinsics are enabled per function
+#define AES_TARGET __attribute__((target("aes,sse4.1")))
+#define VAES_TARGET __attribute__((target("aes,sse4.1,avx2,vaes")))
+
+// number of independent blocks processed together: aesenc/aesdec latency is several times larger than its throughput
+static constexpr int AES_PIPELINE_BLOCKS = 8;
+
+AES_TARGET __attribute__((always_inline))
+static inline __m128i aesenc(__m128i block, __m128i round_key) {
+  return _mm_aesenc_si128(block, round_key);
+}
+
+AES_TARGET __attribute__((always_inline))
+static inline __m128i aesenclast(__m128i block, __m128i round_key) {
+  return _mm_aesenclast_si128(block, round_key);
+}
+
+AES_TARGET __attribute__((always_inline))
+static inline __m128i aesdec(__m128i block, __m128i round_key) {
+  return _mm_aesdec_si128(block, round_key);
+}
+
+AES_TARGET __attribute__((always_inline))
+static inline __m128i aesdeclast(__m128i block, __m128i round_key) {
+  return _mm_aesdeclast_si128(block, round_key);
+}
+
 bool crypto_x86_64_has_aesni_extension() {
   const kdb_cpuid_t *cpuid = kdb_cpuid();
   assert(cpuid->type == KDB_CPUID_X86_64);
@@ -28,6 +56,16 @@ bool crypto_x86_64_has_aesni_extension() {
   return (cpuid->x86_64.ecx & (1 << 25)) && ((cpuid->x86_64.edx & 0x06000000) == 0x06000000);
 }
 
+bool crypto_x86_64_has_vaes_extension() {
+  const kdb_cpuid_t *cpuid = kdb_cpuid();
+  assert(cpuid->type == KDB_CPUID_X86_64);
+
+  const bool has_avx2 = (cpuid->x86_64.ecx & (1 << 28)) && (cpuid->x86_64.ebx7 & (1 << 5));
+  const bool os_saves_ymm = (cpuid->x86_64.ecx & (1 << 27)) && (cpuid->x86_64.xcr0 & 0x06) == 0x06;
+  const bool has_vaes = cpuid->x86_64.ecx7 & (1 << 9);
+  return crypto_x86_64_has_aesni_extension() && has_avx2 && os_saves_ymm && has_vaes;
+}
+
 void crypto_x86_64_aesni256_set_encrypt_key(vk_aes_ctx_t *ctx, const uint8_t key[32]) {
   int a, b;
   unsigned int *c, *d;
@@ -156,42 +194,54 @@ void crypto_x86_64_aesni256_cbc_encrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in,
                : "%xmm1", "%xmm2", "memory");
 }
 
+AES_TARGET
 void crypto_x86_64_aesni256_cbc_decrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16]) {
-  aes256_ctx_t *ctx = &vk_ctx->u.ctx;
-  void *p1, *p2;
   if (size < 16) {
     return;
   }
-  asm volatile("movdqu (%5), %%xmm1\n\t"          // move IV in %xmm1
-               "1:\n\t"                           // start of block processing
-               "subl $0x10, %3\n\t"               // decrease plaintext size on block size
-               "movdqu (%4), %%xmm2\n\t"          // move block of cyphertext to %xmm2
-               "pxor 0xe0(%6), %%xmm2\n\t"        // AddRoundKey
-               "aesdec 0xd0(%6), %%xmm2\n\t"      // 1 round
-               "aesdec 0xc0(%6), %%xmm2\n\t"      // 2 round
-               "aesdec 0xb0(%6), %%xmm2\n\t"      // 3 round
-               "aesdec 0xa0(%6), %%xmm2\n\t"      // ...
-               "aesdec 0x90(%6), %%xmm2\n\t"      // ...
-               "aesdec 0x80(%6), %%xmm2\n\t"      // ...
-               "aesdec 0x70(%6), %%xmm2\n\t"      // ..
-               "aesdec 0x60(%6), %%xmm2\n\t"      // ..
-               "aesdec 0x50(%6), %%xmm2\n\t"      // ..
-               "aesdec 0x40(%6), %%xmm2\n\t"      // ..
-               "aesdec 0x30(%6), %%xmm2\n\t"      // ...
-               "aesdec 0x20(%6), %%xmm2\n\t"      // ...
-               "aesdec 0x10(%6), %%xmm2\n\t"      // ...
-               "aesdeclast 0x00(%6), %%xmm2\n\t"  // 14 round is last for 256 bits key
-               "pxor %%xmm1, %%xmm2\n\t"          // CBC xor
-               "movdqu (%4), %%xmm1\n\t"          // move next block of cyphertext to %xmm1
-               "movdqu %%xmm2, (%7)\n\t"          // move block on plaintext to out
-               "addq $0x10, %4\n\t"               // advance in pointer on block size
-               "addq $0x10, %7\n\t"               // advance out pointer on block size
-               "cmpl $0x0f, %3\n\t"               // do we have more blocks of cyphertext?
-               "jg 1b\n\t"                        // if yes - jump to start of block processing
-               "movdqu %%xmm1, (%5)\n\t"          // move block of cyphertext to IV
-               : "=r"(size), "=r"(p1), "=r"(p2)
-               : "0"(size), "1r"(in), "r"(iv), "r"(align16(ctx)), "2r"(out)
-               : "%xmm1", "%xmm2", "memory");
+  const __m128i *rk = static_cast<const __m128i *>(align16(&vk_ctx->u.ctx.a[0]));
+  __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+
+  // CBC decryption has no dependency between blocks, so keep several of them in flight to hide aesdec latency
+  while (size >= AES_PIPELINE_BLOCKS * 16) {
+    __m128i c[AES_PIPELINE_BLOCKS], b[AES_PIPELINE_BLOCKS];
+    for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+      c[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * j));
+      b[j] = _mm_xor_si128(c[j], rk[14]);
+    }
+    for (int r = 13; r > 0; --r) {
+      for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+        b[j] = aesdec(b[j], rk[r]);
+      }
+    }
+    for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+      b[j] = aesdeclast(b[j], rk[0]);
+    }
+    // all ciphertext blocks are loaded already, so in == out is safe
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_xor_si128(b[0], prev));
+    for (int j = 1; j < AES_PIPELINE_BLOCKS; ++j) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * j), _mm_xor_si128(b[j], c[j - 1]));
+    }
+    prev = c[AES_PIPELINE_BLOCKS - 1];
+    in += AES_PIPELINE_BLOCKS * 16;
+    out += AES_PIPELINE_BLOCKS * 16;
+    size -= AES_PIPELINE_BLOCKS * 16;
+  }
+
+  while (size >= 16) {
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    __m128i b = _mm_xor_si128(c, rk[14]);
+    for (int r = 13; r > 0; --r) {
+      b = aesdec(b, rk[r]);
+    }
+    b = aesdeclast(b, rk[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_xor_si128(b, prev));
+    prev = c;
+    in += 16;
+    out += 16;
+    size -= 16;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(iv), prev);
 }
 
 void crypto_x86_64_aesni256_ige_encrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[32]) {
@@ -292,6 +342,7 @@ static inline void crypto_x86_64_aesni256_encrypt(uint8_t *ctx, const uint8_t *i
       :);
 }
 
+AES_TARGET
 void crypto_x86_64_aesni256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16], uint64_t offset) {
   unsigned char *a = static_cast<unsigned char *>(align16(&ctx->u.ctx.a[0]));
   unsigned char iv_copy[16], u[16];
@@ -311,39 +362,46 @@ void crypto_x86_64_aesni256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, ui
       *out++ = (*in++) ^ u[i++];
     } while (i < l);
   }
-  int n = size >> 4;
-
-  if (n > 0) {
-    v2di IV = *((v2di *)iv_copy), INC;
-    asm("movd %1, %0\n\t"
-        "pshufd $0xcf, %0, %0\n\t"
-        : "=x"(INC)
-        : "r"(1));
-    do {
-      v2di I = (v2di)loaddqu((const char *)in), T;
-      asm("pxor (%2), %1\n\t"
-          "aesenc 0x10(%2), %1\n\t"
-          "aesenc 0x20(%2), %1\n\t"
-          "aesenc 0x30(%2), %1\n\t"
-          "aesenc 0x40(%2), %1\n\t"
-          "aesenc 0x50(%2), %1\n\t"
-          "aesenc 0x60(%2), %1\n\t"
-          "aesenc 0x70(%2), %1\n\t"
-          "aesenc 0x80(%2), %1\n\t"
-          "aesenc 0x90(%2), %1\n\t"
-          "aesenc 0xa0(%2), %1\n\t"
-          "aesenc 0xb0(%2), %1\n\t"
-          "aesenc 0xc0(%2), %1\n\t"
-          "aesenc 0xd0(%2), %1\n\t"
-          "aesenclast 0xe0(%2), %1\n\t"
-          : "=x"(T)
-          : "0"(IV), "r"(a));
+  if (size >= 16) {
+    const __m128i *rk = reinterpret_cast<const __m128i *>(a);
+    const __m128i one = _mm_set_epi64x(1, 0);
+    __m128i IV = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv_copy));
+
+    while (size >= AES_PIPELINE_BLOCKS * 16) {
+      __m128i b[AES_PIPELINE_BLOCKS];
+      for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+        b[j] = _mm_xor_si128(IV, rk[0]);
+        IV = _mm_add_epi64(IV, one);
+      }
+      for (int r = 1; r < 14; ++r) {
+        for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+          b[j] = aesenc(b[j], rk[r]);
+        }
+      }
+      for (int j = 0; j < AES_PIPELINE_BLOCKS; ++j) {
+        b[j] = aesenclast(b[j], rk[14]);
+        const __m128i I = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * j));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * j), _mm_xor_si128(I, b[j]));
+      }
+      in += AES_PIPELINE_BLOCKS * 16;
+      out += AES_PIPELINE_BLOCKS * 16;
+      size -= AES_PIPELINE_BLOCKS * 16;
+    }
+
+    while (size >= 16) {
+      __m128i b = _mm_xor_si128(IV, rk[0]);
+      for (int r = 1; r < 14; ++r) {
+        b = aesenc(b, rk[r]);
+      }
+      b = aesenclast(b, rk[14]);
+      const __m128i I = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_xor_si128(I, b));
+      IV = _mm_add_epi64(IV, one);
       in += 16;
-      storedqu((char *)out, (v16qi)(I ^ T));
-      IV += INC;
       out += 16;
-    } while (--n);
-    *((v2di *)iv_copy) = IV;
+      size -= 16;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(iv_copy), IV);
   }
 
   l = size & 15;
@@ -355,3 +413,100 @@ void crypto_x86_64_aesni256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, ui
     } while (i < l);
   }
 }
+
+VAES_TARGET __attribute__((always_inline))
+static inline __m256i broadcast_round_key(const __m128i *rk, int r) {
+  return _mm256_broadcastsi128_si256(_mm_load_si128(rk + r));
+}
+
+// VAES works on two blocks per ymm register, so AES_PIPELINE_BLOCKS blocks take a half of the registers
+static constexpr int VAES_PIPELINE_LANES = AES_PIPELINE_BLOCKS / 2;
+
+VAES_TARGET
+void crypto_x86_64_vaes256_cbc_decrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16]) {
+  if (size < 16) {
+    return;
+  }
+  const __m128i *rk = static_cast<const __m128i *>(align16(&vk_ctx->u.ctx.a[0]));
+  __m256i keys[15];
+  for (int r = 0; r < 15; ++r) {
+    keys[r] = broadcast_round_key(rk, r);
+  }
+  __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+
+  while (size >= VAES_PIPELINE_LANES * 32) {
+    __m256i c[VAES_PIPELINE_LANES], p[VAES_PIPELINE_LANES], b[VAES_PIPELINE_LANES];
+    // p[j] holds the ciphertext blocks preceding the ones in c[j]
+    p[0] = _mm256_inserti128_si256(_mm256_castsi128_si256(prev), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in)), 1);
+    for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+      c[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 32 * j));
+      if (j) {
+        p[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 32 * j - 16));
+      }
+      b[j] = _mm256_xor_si256(c[j], keys[14]);
+    }
+    for (int r = 13; r > 0; --r) {
+      for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+        b[j] = _mm256_aesdec_epi128(b[j], keys[r]);
+      }
+    }
+    for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+      b[j] = _mm256_xor_si256(_mm256_aesdeclast_epi128(b[j], keys[0]), p[j]);
+    }
+    prev = _mm256_extracti128_si256(c[VAES_PIPELINE_LANES - 1], 1);
+    for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32 * j), b[j]);
+    }
+    in += VAES_PIPELINE_LANES * 32;
+    out += VAES_PIPELINE_LANES * 32;
+    size -= VAES_PIPELINE_LANES * 32;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(iv), prev);
+
+  crypto_x86_64_aesni256_cbc_decrypt(vk_ctx, in, out, size, iv);
+}
+
+VAES_TARGET
+void crypto_x86_64_vaes256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16], uint64_t offset) {
+  // the unaligned head and the tail are rare, leave them to the AES-NI implementation
+  if ((offset & 15) || size < VAES_PIPELINE_LANES * 32) {
+    crypto_x86_64_aesni256_ctr_encrypt(ctx, in, out, size, iv, offset);
+    return;
+  }
+  const __m128i *rk = static_cast<const __m128i *>(align16(&ctx->u.ctx.a[0]));
+  __m256i keys[15];
+  for (int r = 0; r < 15; ++r) {
+    keys[r] = broadcast_round_key(rk, r);
+  }
+
+  // the counter is the little endian 64-bit word in the upper half of IV, see crypto_x86_64_aesni256_ctr_encrypt
+  const __m128i IV = _mm_add_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(iv)), _mm_set_epi64x(offset >> 4, 0));
+  __m256i counters = _mm256_add_epi64(_mm256_broadcastsi128_si256(IV), _mm256_set_epi64x(1, 0, 0, 0));
+  const __m256i two = _mm256_set_epi64x(2, 0, 2, 0);
+
+  uint64_t processed = 0;
+  while (size >= VAES_PIPELINE_LANES * 32) {
+    __m256i b[VAES_PIPELINE_LANES];
+    for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+      b[j] = _mm256_xor_si256(counters, keys[0]);
+      counters = _mm256_add_epi64(counters, two);
+    }
+    for (int r = 1; r < 14; ++r) {
+      for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+        b[j] = _mm256_aesenc_epi128(b[j], keys[r]);
+      }
+    }
+    for (int j = 0; j < VAES_PIPELINE_LANES; ++j) {
+      const __m256i I = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 32 * j));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32 * j), _mm256_xor_si256(I, _mm256_aesenclast_epi128(b[j], keys[14])));
+    }
+    in += VAES_PIPELINE_LANES * 32;
+    out += VAES_PIPELINE_LANES * 32;
+    size -= VAES_PIPELINE_LANES * 32;
+    processed += VAES_PIPELINE_LANES * 32;
+  }
+
+  if (size) {
+    crypto_x86_64_aesni256_ctr_encrypt(ctx, in, out, size, iv, offset + processed);
+  }
+}
@@ -12,6 +12,7 @@
 #include "common/crypto/aes256.h"
 
 bool crypto_x86_64_has_aesni_extension();
+bool crypto_x86_64_has_vaes_extension();
 
 void crypto_x86_64_aesni256_set_encrypt_key(vk_aes_ctx_t *ctx, const uint8_t key[32]);
 void crypto_x86_64_aesni256_set_decrypt_key(vk_aes_ctx_t *ctx, const uint8_t key[32]);
@@ -22,4 +23,8 @@ void crypto_x86_64_aesni256_ige_encrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in,
 void crypto_x86_64_aesni256_ige_decrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[32]);
 void crypto_x86_64_aesni256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16], uint64_t offset);
 
+// VAES (AVX2 width) variants of the modes which can be parallelized, CBC encryption and IGE are sequential by design
+void crypto_x86_64_vaes256_cbc_decrypt(vk_aes_ctx_t *vk_ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16]);
+void crypto_x86_64_vaes256_ctr_encrypt(vk_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, int size, uint8_t iv[16], uint64_t offset);
+
 #endif // KDB_COMMON_CRYPTO_AES256_X86_64_H
@@ -36,6 +36,9 @@ void vk_aes_set_encrypt_key(vk_aes_ctx_t *ctx, const uint8_t *key, int bits) {
       ctx->cbc_crypt = crypto_x86_64_aesni256_cbc_encrypt;
       ctx->ige_crypt = crypto_x86_64_aesni256_ige_encrypt;
       ctx->ctr_crypt = crypto_x86_64_aesni256_ctr_encrypt;
+      if (crypto_x86_64_has_vaes_extension()) {
+        ctx->ctr_crypt = crypto_x86_64_vaes256_ctr_encrypt;
+      }
       return;
     }
 #endif // __x86_64__
@@ -68,6 +71,9 @@ void vk_aes_set_decrypt_key(vk_aes_ctx_t *ctx, const uint8_t *key, int bits) {
       crypto_x86_64_aesni256_set_decrypt_key(ctx, key);
       ctx->cbc_crypt = crypto_x86_64_aesni256_cbc_decrypt;
       ctx->ige_crypt = crypto_x86_64_aesni256_ige_decrypt;
+      if (crypto_x86_64_has_vaes_extension()) {
+        ctx->cbc_crypt = crypto_x86_64_vaes256_cbc_decrypt;
+      }
       return;
     }
 #endif // __x86_64__
@@ -6,12 +6,19 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <execinfo.h>
 
 #include "common/sanitizer.h"
 
 char *stack_end;
 
+// the frame record is the same on x86_64 and aarch64: the saved frame pointer and the return address
+struct stack_frame {
+  struct stack_frame *bp;
+  void *ip;
+};
+
 #if defined(__aarch64__) || defined(__APPLE__)
 int fast_backtrace (void **buffer, int size) {
   return backtrace(buffer, size);
@@ -19,11 +26,6 @@ int fast_backtrace (void **buffer, int size) {
 #elif defined(__x86_64__)
 extern void *__libc_stack_end;
 
-struct stack_frame {
-  struct stack_frame *bp;
-  void *ip;
-};
-
 static __inline__ void *get_bp () {
   void *bp;
   __asm__ volatile ("movq %%rbp, %[r]" : [r] "=r" (bp));
@@ -83,3 +85,18 @@ int fast_backtrace_without_recursions(void **buffer, int size) noexcept {
   return i;
 }
 #endif
+
+int fast_backtrace_by_bp(void *bp, const char *stack_begin, const char *stack_end, void **buffer, int size) noexcept {
+  auto *frame = static_cast<const stack_frame *>(bp);
+  int i = 0;
+  while (i < size && reinterpret_cast<const char *>(frame) >= stack_begin && reinterpret_cast<const char *>(frame + 1) <= stack_end
+         && !(reinterpret_cast<uintptr_t>(frame) & (sizeof(long) - 1))) {
+    buffer[i++] = frame->ip;
+    const stack_frame *p = frame->bp;
+    if (p <= frame) {
+      break;
+    }
+    frame = p;
+  }
+  return i;
+}
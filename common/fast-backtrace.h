@@ -15,5 +15,8 @@ extern char *stack_end;
 
 int fast_backtrace (void **buffer, int size) __attribute__ ((noinline));
 int fast_backtrace_without_recursions(void **buffer, int size) noexcept;
+// walks the chain of the frame pointers starting from bp, only the frames lying within [stack_begin, stack_end) are read,
+// so it can be used for the stack interrupted by a signal
+int fast_backtrace_by_bp(void *bp, const char *stack_begin, const char *stack_end, void **buffer, int size) noexcept;
 
 #endif
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "common/stats/hdr-histogram.h"
+
+using Histogram = vk::HdrHistogram<>;
+
+TEST(hdr_histogram, test_buckets) {
+  for (uint64_t value = 0; value != 64; ++value) {
+    ASSERT_EQ(Histogram::get_bucket(value), value);
+    ASSERT_EQ(Histogram::get_bucket_lowest_value(value), value);
+    ASSERT_EQ(Histogram::get_bucket_highest_value(value), value);
+  }
+  ASSERT_EQ(Histogram::get_bucket(Histogram::max_value), Histogram::buckets_count - 1);
+  ASSERT_EQ(Histogram::get_bucket(std::numeric_limits<uint64_t>::max()), Histogram::buckets_count - 1);
+
+  // the buckets go one by one without gaps, every value is inside its bucket
+  for (size_t bucket = 1; bucket != Histogram::buckets_count; ++bucket) {
+    ASSERT_EQ(Histogram::get_bucket_lowest_value(bucket), Histogram::get_bucket_highest_value(bucket - 1) + 1);
+    ASSERT_EQ(Histogram::get_bucket(Histogram::get_bucket_lowest_value(bucket)), bucket);
+    ASSERT_EQ(Histogram::get_bucket(Histogram::get_bucket_highest_value(bucket)), bucket);
+  }
+}
+
+TEST(hdr_histogram, test_percentiles) {
+  Histogram histogram;
+  ASSERT_EQ(histogram.get_value_at_percentile(50), 0);
+
+  for (uint64_t value = 1; value <= 100000; ++value) {
+    histogram.add(value * 1000);
+  }
+  ASSERT_EQ(histogram.get_total_count(), 100000);
+  for (double percentile : {50.0, 90.0, 99.0, 99.9, 100.0}) {
+    const double expected = percentile * 1000 * 1000;
+    const double got = histogram.get_value_at_percentile(percentile);
+    ASSERT_GE(got, expected);
+    ASSERT_LT((got - expected) / expected, 1.0 / 32) << percentile;
+  }
+
+  const auto values = histogram.get_values_at_percentiles(std::array<double, 6>{50, 90, 95, 99, 99.9, 100});
+  ASSERT_EQ(values[0], histogram.get_value_at_percentile(50));
+  ASSERT_EQ(values[1], histogram.get_value_at_percentile(90));
+  ASSERT_EQ(values[2], histogram.get_value_at_percentile(95));
+  ASSERT_EQ(values[3], histogram.get_value_at_percentile(99));
+  ASSERT_EQ(values[4], histogram.get_value_at_percentile(99.9));
+  ASSERT_EQ(values[5], histogram.get_value_at_percentile(100));
+  ASSERT_EQ(Histogram{}.get_values_at_percentiles(std::array<double, 2>{50, 100}), (std::array<uint64_t, 2>{}));
+}
+
+TEST(hdr_histogram, test_merge) {
+  std::mt19937 gen{42};
+  std::exponential_distribution<double> latency{1.0 / 20000000};
+  Histogram worker1;
+  Histogram worker2;
+  Histogram all;
+  for (int i = 0; i != 100000; ++i) {
+    const auto value = static_cast<uint64_t>(latency(gen));
+    (i % 3 ? worker1 : worker2).add(value);
+    all.add(value);
+  }
+
+  Histogram merged;
+  merged.merge(worker1);
+  merged.drain(worker2);
+  ASSERT_EQ(worker2.get_total_count(), 0);
+  ASSERT_EQ(merged.get_total_count(), all.get_total_count());
+  for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+    ASSERT_EQ(merged.get_value_at_percentile(percentile), all.get_value_at_percentile(percentile));
+  }
+}
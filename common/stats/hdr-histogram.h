@@ -0,0 +1,128 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+
+#include "common/mixin/not_copyable.h"
+
+namespace vk {
+
+// The HDR-style histogram: every power of 2 range of the values is split into the equal linear sub buckets,
+// so any percentile is known with the relative error below 2^(1 - SUB_BUCKET_BITS) regardless of the magnitude.
+// The counters are atomic and don't need any locks, so the histogram can be placed into the shared memory
+// and filled by many processes at once, the histograms of the same type are merged bucket by bucket.
+template<uint32_t SUB_BUCKET_BITS = 6, uint32_t MAX_VALUE_BITS = 40>
+class HdrHistogram : vk::not_copyable {
+  static_assert(SUB_BUCKET_BITS >= 2 && SUB_BUCKET_BITS < MAX_VALUE_BITS && MAX_VALUE_BITS <= 63, "unexpected histogram precision");
+
+  static constexpr uint64_t sub_buckets_count = uint64_t{1} << SUB_BUCKET_BITS;
+  static constexpr uint64_t half_sub_buckets_count = sub_buckets_count / 2;
+
+public:
+  // the values below sub_buckets_count are counted exactly, the next ranges take half_sub_buckets_count each
+  static constexpr size_t buckets_count = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * half_sub_buckets_count + half_sub_buckets_count;
+  // the greater values are counted in the last bucket
+  static constexpr uint64_t max_value = (uint64_t{1} << MAX_VALUE_BITS) - 1;
+
+  static size_t get_bucket(uint64_t value) noexcept {
+    value = std::min(value, max_value);
+    if (value < sub_buckets_count) {
+      return static_cast<size_t>(value);
+    }
+    const uint32_t shift = 63 - __builtin_clzll(value) - (SUB_BUCKET_BITS - 1);
+    return static_cast<size_t>(shift * half_sub_buckets_count + (value >> shift));
+  }
+
+  static uint64_t get_bucket_lowest_value(size_t bucket) noexcept {
+    if (bucket < sub_buckets_count) {
+      return bucket;
+    }
+    const uint64_t shift = bucket / half_sub_buckets_count - 1;
+    return (bucket - shift * half_sub_buckets_count) << shift;
+  }
+
+  static uint64_t get_bucket_highest_value(size_t bucket) noexcept {
+    return bucket + 1 == buckets_count ? max_value : get_bucket_lowest_value(bucket + 1) - 1;
+  }
+
+  void add(uint64_t value, uint64_t count = 1) noexcept {
+    counts_[get_bucket(value)].fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void merge(const HdrHistogram &other) noexcept {
+    for (size_t i = 0; i != buckets_count; ++i) {
+      if (const uint64_t count = other.counts_[i].load(std::memory_order_relaxed)) {
+        counts_[i].fetch_add(count, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // moves the counters of the other histogram, which can be still filled at the same time, to this one
+  void drain(HdrHistogram &other) noexcept {
+    for (size_t i = 0; i != buckets_count; ++i) {
+      if (other.counts_[i].load(std::memory_order_relaxed)) {
+        counts_[i].fetch_add(other.counts_[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void reset() noexcept {
+    for (auto &count : counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t get_total_count() const noexcept {
+    uint64_t total = 0;
+    for (const auto &count : counts_) {
+      total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  // the highest value equivalent to the value at the percentile, 0 for the empty histogram
+  uint64_t get_value_at_percentile(double percentile) const noexcept {
+    return get_values_at_percentiles(std::array<double, 1>{percentile})[0];
+  }
+
+  // the same for several percentiles given in the ascending order, the counters are scanned only twice for all of them
+  template<size_t N>
+  std::array<uint64_t, N> get_values_at_percentiles(const std::array<double, N> &percentiles) const noexcept {
+    std::array<uint64_t, N> values{};
+    const uint64_t total = get_total_count();
+    if (!total) {
+      return values;
+    }
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i != buckets_count && next != N; ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      for (; next != N && seen >= get_rank(percentiles[next], total); ++next) {
+        values[next] = get_bucket_highest_value(i);
+      }
+    }
+    // the counters can be added concurrently, so the last ranks may be not reached
+    for (; next != N; ++next) {
+      values[next] = max_value;
+    }
+    return values;
+  }
+
+private:
+  static uint64_t get_rank(double percentile, uint64_t total) noexcept {
+    const auto rank = static_cast<uint64_t>(std::ceil(percentile * static_cast<double>(total) / 100.0));
+    return std::min(std::max(rank, uint64_t{1}), total);
+  }
+
+  std::array<std::atomic<uint64_t>, buckets_count> counts_{};
+};
+
+} // namespace vk
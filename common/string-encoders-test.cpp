@@ -0,0 +1,204 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/string-encoders.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::string random_bytes(std::mt19937 &gen, size_t len, const std::string &alphabet = {}) {
+  std::string result(len, '\0');
+  for (auto &c : result) {
+    c = alphabet.empty() ? static_cast<char>(gen()) : alphabet[gen() % alphabet.size()];
+  }
+  return result;
+}
+
+std::string base64(const std::string &s) {
+  std::string result(base64_encoded_len(s.size()), '\0');
+  encode_base64(reinterpret_cast<const unsigned char *>(s.data()), s.size(), &result[0]);
+  return result;
+}
+
+std::string reference_base64(const std::string &s) {
+  static const char symbols[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string result;
+  for (size_t i = 0; i < s.size(); i += 3) {
+    uint32_t triple = static_cast<unsigned char>(s[i]) << 16;
+    if (i + 1 < s.size()) {
+      triple |= static_cast<unsigned char>(s[i + 1]) << 8;
+    }
+    if (i + 2 < s.size()) {
+      triple |= static_cast<unsigned char>(s[i + 2]);
+    }
+    result += symbols[triple >> 18];
+    result += symbols[(triple >> 12) & 63];
+    result += i + 1 < s.size() ? symbols[(triple >> 6) & 63] : '=';
+    result += i + 2 < s.size() ? symbols[triple & 63] : '=';
+  }
+  return result;
+}
+
+std::string hex(const std::string &s) {
+  std::string result(2 * s.size(), '\0');
+  encode_hex(reinterpret_cast<const unsigned char *>(s.data()), s.size(), &result[0]);
+  return result;
+}
+
+std::string reference_hex(const std::string &s) {
+  std::string result;
+  for (char c : s) {
+    char digits[3];
+    snprintf(digits, sizeof(digits), "%02x", static_cast<unsigned char>(c));
+    result += digits;
+  }
+  return result;
+}
+
+std::string url(const std::string &s, bool raw) {
+  std::string result(url_encoded_len(s.data(), s.size(), raw), '\0');
+  encode_url(s.data(), s.size(), &result[0], raw);
+  return result;
+}
+
+std::string reference_url(const std::string &s, bool raw) {
+  std::string result;
+  for (char c : s) {
+    if (isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.') {
+      result += c;
+    } else if (c == ' ' && !raw) {
+      result += '+';
+    } else {
+      char escaped[4];
+      snprintf(escaped, sizeof(escaped), "%%%02X", static_cast<unsigned char>(c));
+      result += escaped;
+    }
+  }
+  return result;
+}
+
+std::string html(const std::string &s, bool double_quotes, bool single_quotes) {
+  std::string result(html_escaped_len(s.data(), s.size(), double_quotes, single_quotes), '\0');
+  escape_html(s.data(), s.size(), &result[0], double_quotes, single_quotes);
+  return result;
+}
+
+std::string reference_html(const std::string &s, bool double_quotes, bool single_quotes) {
+  std::string result;
+  for (char c : s) {
+    if (c == '&') {
+      result += "&amp;";
+    } else if (c == '"' && double_quotes) {
+      result += "&quot;";
+    } else if (c == '\'' && single_quotes) {
+      result += "&#039;";
+    } else if (c == '<') {
+      result += "&lt;";
+    } else if (c == '>') {
+      result += "&gt;";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(string_encoders, base64) {
+  ASSERT_EQ(base64(""), "");
+  ASSERT_EQ(base64("f"), "Zg==");
+  ASSERT_EQ(base64("fo"), "Zm8=");
+  ASSERT_EQ(base64("foobar"), "Zm9vYmFy");
+
+  std::mt19937 gen;
+  const auto dispatched = encode_base64_blocks;
+  for (size_t len = 0; len < 300; ++len) {
+    const auto s = random_bytes(gen, len);
+    ASSERT_EQ(base64(s), reference_base64(s)) << "len " << len;
+    encode_base64_blocks = encode_base64_blocks_generic;
+    ASSERT_EQ(base64(s), reference_base64(s)) << "len " << len;
+    encode_base64_blocks = dispatched;
+  }
+}
+
+TEST(string_encoders, base64_blocks) {
+  std::mt19937 gen;
+  for (size_t len = 0; len < 300; ++len) {
+    const auto s = random_bytes(gen, len);
+    const auto encoded = base64(s);
+    std::string decoded(s.size() + 16, '\0');
+    const size_t decoded_symbols = decode_base64_blocks(encoded.data(), encoded.size(), reinterpret_cast<unsigned char *>(&decoded[0]));
+    ASSERT_EQ(decoded_symbols % 16, 0);
+    ASSERT_LE(decoded_symbols, encoded.size());
+    ASSERT_EQ(decoded.substr(0, decoded_symbols / 4 * 3), s.substr(0, decoded_symbols / 4 * 3)) << "len " << len;
+  }
+
+  unsigned char decoded[12];
+  ASSERT_EQ(decode_base64_blocks("Zm9vYmFyZm9vYmFy", 16, decoded), 16);
+  ASSERT_EQ(std::string(reinterpret_cast<char *>(decoded), 12), "foobarfoobar");
+  ASSERT_EQ(decode_base64_blocks("Zm9vYmFyZm9vYmE=", 16, decoded), 0);
+  ASSERT_EQ(decode_base64_blocks("Zm9vYmFy Zm9vYmF", 16, decoded), 0);
+  ASSERT_EQ(decode_base64_blocks("Zm9vYmFyZm9vYmF\xc3", 16, decoded), 0);
+}
+
+TEST(string_encoders, hex) {
+  std::mt19937 gen;
+  const auto dispatched = encode_hex_blocks;
+  for (size_t len = 0; len < 200; ++len) {
+    const auto s = random_bytes(gen, len);
+    ASSERT_EQ(hex(s), reference_hex(s)) << "len " << len;
+    encode_hex_blocks = encode_hex_blocks_generic;
+    ASSERT_EQ(hex(s), reference_hex(s)) << "len " << len;
+    encode_hex_blocks = dispatched;
+
+    std::string digits = hex(s);
+    for (size_t i = 0; i < digits.size(); i += 3) {
+      digits[i] = static_cast<char>(toupper(digits[i]));
+    }
+    std::string decoded(len, '\0');
+    ASSERT_TRUE(decode_hex(digits.data(), len, reinterpret_cast<unsigned char *>(&decoded[0])));
+    ASSERT_EQ(decoded, s);
+    if (len) {
+      for (char wrong : {'g', 'G', '/', ':', '@', '`', ' ', '\xc0', '\0'}) {
+        digits[gen() % digits.size()] = wrong;
+        ASSERT_FALSE(decode_hex(digits.data(), len, reinterpret_cast<unsigned char *>(&decoded[0]))) << "len " << len;
+        digits = hex(s);
+      }
+    }
+  }
+}
+
+TEST(string_encoders, url) {
+  ASSERT_EQ(url("a b&c=d/e?f", false), "a+b%26c%3Dd%2Fe%3Ff");
+  ASSERT_EQ(url("a b&c=d/e?f", true), "a%20b%26c%3Dd%2Fe%3Ff");
+
+  std::mt19937 gen;
+  for (size_t len = 0; len < 200; ++len) {
+    for (const auto &alphabet : {std::string{}, std::string{"abcXYZ019-_. ~"}, std::string{"abcdefghijklmnopqrstuvwxyz0123456789/"}}) {
+      const auto s = random_bytes(gen, len, alphabet);
+      ASSERT_EQ(url(s, false), reference_url(s, false)) << "len " << len;
+      ASSERT_EQ(url(s, true), reference_url(s, true)) << "len " << len;
+    }
+  }
+}
+
+TEST(string_encoders, html) {
+  ASSERT_EQ(html("<a href=\"x\">'&'</a>", true, false), "&lt;a href=&quot;x&quot;&gt;'&amp;'&lt;/a&gt;");
+
+  std::mt19937 gen;
+  for (size_t len = 0; len < 200; ++len) {
+    for (const auto &alphabet : {std::string{}, std::string{"abc <>&\"'\n"}, std::string{"abcdefghijklmnopqrstuvwxyz0123456789 &"}}) {
+      const auto s = random_bytes(gen, len, alphabet);
+      for (int quotes = 0; quotes < 4; ++quotes) {
+        ASSERT_EQ(html(s, quotes & 1, quotes & 2), reference_html(s, quotes & 1, quotes & 2)) << "len " << len;
+      }
+    }
+  }
+}
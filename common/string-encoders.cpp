@@ -0,0 +1,437 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/string-encoders.h"
+
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+constexpr char base64_symbols[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char lower_hex_digits[] = "0123456789abcdef";
+constexpr char upper_hex_digits[] = "0123456789ABCDEF";
+
+constexpr unsigned char HEX_NONE = 16;
+
+constexpr unsigned char hex_digit_value(unsigned char c) noexcept {
+  return ('0' <= c && c <= '9') ? static_cast<unsigned char>(c - '0') :
+         ('a' <= c && c <= 'f') ? static_cast<unsigned char>(c - 'a' + 10) :
+         ('A' <= c && c <= 'F') ? static_cast<unsigned char>(c - 'A' + 10) : HEX_NONE;
+}
+
+inline bool is_good_url_char(unsigned char c) noexcept {
+  return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '-' || c == '_' || c == '.';
+}
+
+inline char *encode_url_char(unsigned char c, char *output, bool raw) noexcept {
+  if (is_good_url_char(c)) {
+    *output++ = static_cast<char>(c);
+  } else if (c == ' ' && !raw) {
+    *output++ = '+';
+  } else {
+    *output++ = '%';
+    *output++ = upper_hex_digits[c >> 4];
+    *output++ = upper_hex_digits[c & 15];
+  }
+  return output;
+}
+
+inline size_t html_escape_extra_len(char c, bool double_quotes, bool single_quotes) noexcept {
+  switch (c) {
+    case '&':
+      return 4;
+    case '"':
+      return double_quotes ? 5 : 0;
+    case '\'':
+      return single_quotes ? 5 : 0;
+    case '<':
+    case '>':
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+inline char *escape_html_char(char c, char *output, bool double_quotes, bool single_quotes) noexcept {
+  switch (c) {
+    case '&':
+      memcpy(output, "&amp;", 5);
+      return output + 5;
+    case '"':
+      if (double_quotes) {
+        memcpy(output, "&quot;", 6);
+        return output + 6;
+      }
+      break;
+    case '\'':
+      if (single_quotes) {
+        memcpy(output, "&#039;", 6);
+        return output + 6;
+      }
+      break;
+    case '<':
+      memcpy(output, "&lt;", 4);
+      return output + 4;
+    case '>':
+      memcpy(output, "&gt;", 4);
+      return output + 4;
+    default:
+      break;
+  }
+  *output = c;
+  return output + 1;
+}
+
+#ifdef __x86_64__
+
+// signed comparisons, so the bytes >= 0x80 are never in range
+inline __m128i in_range(__m128i block, char low, char high) noexcept {
+  return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(low - 1))),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), block));
+}
+
+inline __m128i good_url_chars_mask(__m128i block) noexcept {
+  const __m128i letters = in_range(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z');
+  const __m128i digits = in_range(block, '0', '9');
+  const __m128i marks = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('-')), _mm_cmpeq_epi8(block, _mm_set1_epi8('_'))),
+                                     _mm_cmpeq_epi8(block, _mm_set1_epi8('.')));
+  return _mm_or_si128(_mm_or_si128(letters, digits), marks);
+}
+
+// every byte of the result is the number of bytes which its escaping adds
+inline __m128i html_escape_extra_lens(__m128i block, __m128i double_quote_extra, __m128i single_quote_extra) noexcept {
+  const __m128i amp = _mm_and_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_set1_epi8(4));
+  const __m128i angle_brackets = _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('<')), _mm_cmpeq_epi8(block, _mm_set1_epi8('>'))),
+                                               _mm_set1_epi8(3));
+  const __m128i double_quotes = _mm_and_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), double_quote_extra);
+  const __m128i single_quotes = _mm_and_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\'')), single_quote_extra);
+  return _mm_or_si128(_mm_or_si128(amp, angle_brackets), _mm_or_si128(double_quotes, single_quotes));
+}
+
+inline size_t sum_bytes(__m128i block) noexcept {
+  const __m128i sums = _mm_sad_epu8(block, _mm_setzero_si128());
+  return _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+}
+
+// copies a block of 16 bytes, the bytes from the mask are written by escape_char()
+template<class F>
+inline char *copy_escaped_block(const char *input, char *output, int escaped_mask, const F &escape_char) noexcept {
+  int copied = 0;
+  for (; escaped_mask; escaped_mask &= escaped_mask - 1) {
+    const int escaped = __builtin_ctz(escaped_mask);
+    memcpy(output, input + copied, escaped - copied);
+    output = escape_char(input[escaped], output + escaped - copied);
+    copied = escaped + 1;
+  }
+  memcpy(output, input + copied, 16 - copied);
+  return output + 16 - copied;
+}
+
+// 12 bytes in the low part of the input become 16 base64 symbols, http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+inline __m128i base64_encode_block(__m128i input) noexcept {
+  input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  const __m128i indices = _mm_or_si128(t1, t3);
+
+  // 0..25 -> 13 ('A'), 26..51 -> 0 ('a' - 26), 52..61 -> 1..10 ('0' - 52), 62 -> 11 ('+' - 62), 63 -> 12 ('/' - 63)
+  __m128i shift_index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  shift_index = _mm_or_si128(shift_index, _mm_and_si128(less, _mm_set1_epi8(13)));
+  const __m128i shifts = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(shifts, shift_index));
+}
+
+// the same for two blocks of 12 bytes in the 128-bit lanes
+__attribute__((target("avx2")))
+inline __m256i base64_encode_block_avx2(__m256i input) noexcept {
+  input = _mm256_shuffle_epi8(input, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m256i t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+  const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+  const __m256i t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+  const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+  const __m256i indices = _mm256_or_si256(t1, t3);
+
+  __m256i shift_index = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  shift_index = _mm256_or_si256(shift_index, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+  const __m256i shifts = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                          'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm256_add_epi8(indices, _mm256_shuffle_epi8(shifts, shift_index));
+}
+
+size_t encode_base64_blocks_ssse3(const unsigned char *input, size_t len, char *output) noexcept {
+  size_t i = 0;
+  // 16 bytes are loaded and 12 of them are encoded
+  for (; i + 16 <= len; i += 12, output += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), base64_encode_block(block));
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t encode_base64_blocks_avx2(const unsigned char *input, size_t len, char *output) noexcept {
+  size_t i = 0;
+  // every lane gets 12 bytes
+  for (; i + 28 <= len; i += 24, output += 32) {
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i + 12));
+    const __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), base64_encode_block_avx2(block));
+  }
+  return i + encode_base64_blocks_ssse3(input + i, len - i, output);
+}
+
+size_t encode_hex_blocks_ssse3(const unsigned char *input, size_t len, char *output) noexcept {
+  const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lower_hex_digits));
+  const __m128i low_nibble = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16, output += 32) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i high_digits = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble));
+    const __m128i low_digits = _mm_shuffle_epi8(digits, _mm_and_si128(block, low_nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), _mm_unpacklo_epi8(high_digits, low_digits));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16), _mm_unpackhi_epi8(high_digits, low_digits));
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t encode_hex_blocks_avx2(const unsigned char *input, size_t len, char *output) noexcept {
+  const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lower_hex_digits)));
+  const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32, output += 64) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    const __m256i high_digits = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble));
+    const __m256i low_digits = _mm256_shuffle_epi8(digits, _mm256_and_si256(block, low_nibble));
+    // unpacking works inside the 128-bit lanes, so the halves are put in order afterwards
+    const __m256i low_pairs = _mm256_unpacklo_epi8(high_digits, low_digits);
+    const __m256i high_pairs = _mm256_unpackhi_epi8(high_digits, low_digits);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), _mm256_permute2x128_si256(low_pairs, high_pairs, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + 32), _mm256_permute2x128_si256(low_pairs, high_pairs, 0x31));
+  }
+  return i + encode_hex_blocks_ssse3(input + i, len - i, output);
+}
+
+#endif
+
+} // namespace
+
+size_t encode_base64_blocks_generic(const unsigned char *input, size_t len, char *output) noexcept {
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3, output += 4) {
+    const uint32_t triple = (input[i] << 16) | (input[i + 1] << 8) | input[i + 2];
+    output[0] = base64_symbols[triple >> 18];
+    output[1] = base64_symbols[(triple >> 12) & 63];
+    output[2] = base64_symbols[(triple >> 6) & 63];
+    output[3] = base64_symbols[triple & 63];
+  }
+  return i;
+}
+
+size_t encode_hex_blocks_generic(const unsigned char *input, size_t len, char *output) noexcept {
+  for (size_t i = 0; i < len; ++i) {
+    output[2 * i] = lower_hex_digits[input[i] >> 4];
+    output[2 * i + 1] = lower_hex_digits[input[i] & 15];
+  }
+  return len;
+}
+
+encode_blocks_func_t encode_base64_blocks = encode_base64_blocks_generic;
+encode_blocks_func_t encode_hex_blocks = encode_hex_blocks_generic;
+
+#ifdef __x86_64__
+static void __attribute__((constructor(101))) string_encoders_init() {
+  const bool has_avx2 = kdb_cpuid_has_avx2();
+  encode_base64_blocks = has_avx2 ? encode_base64_blocks_avx2 : encode_base64_blocks_ssse3;
+  encode_hex_blocks = has_avx2 ? encode_hex_blocks_avx2 : encode_hex_blocks_ssse3;
+}
+#endif
+
+void encode_base64(const unsigned char *input, size_t len, char *output) noexcept {
+  size_t i = encode_base64_blocks(input, len, output);
+  i += encode_base64_blocks_generic(input + i, len - i, output + i / 3 * 4);
+  output += i / 3 * 4;
+  if (i + 1 == len) {
+    output[0] = base64_symbols[input[i] >> 2];
+    output[1] = base64_symbols[(input[i] & 3) << 4];
+    output[2] = output[3] = '=';
+  } else if (i + 2 == len) {
+    output[0] = base64_symbols[input[i] >> 2];
+    output[1] = base64_symbols[((input[i] & 3) << 4) | (input[i + 1] >> 4)];
+    output[2] = base64_symbols[(input[i + 1] & 15) << 2];
+    output[3] = '=';
+  }
+}
+
+size_t decode_base64_blocks(const char *input, size_t len, unsigned char *output) noexcept {
+  size_t i = 0;
+#ifdef __x86_64__
+  for (; i + 16 <= len; i += 16, output += 12) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i upper = in_range(block, 'A', 'Z');
+    const __m128i lower = in_range(block, 'a', 'z');
+    const __m128i digits = in_range(block, '0', '9');
+    const __m128i plus = _mm_cmpeq_epi8(block, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('/'));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digits, plus)), slash);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+      break;
+    }
+    const __m128i shifts = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(_mm_and_si128(digits, _mm_set1_epi8(52 - '0')),
+                   _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')), _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+    const __m128i values = _mm_add_epi8(block, shifts);
+    // 4 symbols of 6 bits are merged into 24 bits of every 32-bit word, then the words are packed
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const __m128i bytes = _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(output), bytes);
+    const uint32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+    memcpy(output + 8, &tail, sizeof(tail));
+  }
+#else
+  static_cast<void>(input);
+  static_cast<void>(len);
+  static_cast<void>(output);
+#endif
+  return i;
+}
+
+void encode_hex(const unsigned char *input, size_t len, char *output) noexcept {
+  const size_t i = encode_hex_blocks(input, len, output);
+  encode_hex_blocks_generic(input + i, len - i, output + 2 * i);
+}
+
+bool decode_hex(const char *input, size_t len, unsigned char *output) noexcept {
+  size_t i = 0;
+#ifdef __x86_64__
+  for (; i + 16 <= len; i += 16) {
+    __m128i values[2];
+    for (int half = 0; half < 2; ++half) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 2 * i + 16 * half));
+      const __m128i letters_block = _mm_or_si128(block, _mm_set1_epi8(0x20));
+      const __m128i digits = in_range(block, '0', '9');
+      const __m128i letters = in_range(letters_block, 'a', 'f');
+      if (_mm_movemask_epi8(_mm_or_si128(digits, letters)) != 0xFFFF) {
+        return false;
+      }
+      values[half] = _mm_or_si128(_mm_and_si128(digits, _mm_sub_epi8(block, _mm_set1_epi8('0'))),
+                                  _mm_and_si128(letters, _mm_sub_epi8(letters_block, _mm_set1_epi8('a' - 10))));
+    }
+    // (high nibble, low nibble) byte pairs become 16-bit words with the byte values
+    const __m128i low_bytes = _mm_maddubs_epi16(values[0], _mm_set1_epi16(0x0110));
+    const __m128i high_bytes = _mm_maddubs_epi16(values[1], _mm_set1_epi16(0x0110));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(low_bytes, high_bytes));
+  }
+#endif
+  for (; i < len; ++i) {
+    const unsigned char high = hex_digit_value(input[2 * i]);
+    const unsigned char low = hex_digit_value(input[2 * i + 1]);
+    if (high == HEX_NONE || low == HEX_NONE) {
+      return false;
+    }
+    output[i] = static_cast<unsigned char>((high << 4) | low);
+  }
+  return true;
+}
+
+size_t url_encoded_len(const char *input, size_t len, bool raw) noexcept {
+  size_t result = len;
+  size_t i = 0;
+#ifdef __x86_64__
+  const __m128i space_mask = _mm_set1_epi8(raw ? 0 : -1);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    // ' ' becomes a single '+' in urlencode()
+    const __m128i spaces = _mm_and_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), space_mask);
+    const int escaped = ~_mm_movemask_epi8(_mm_or_si128(good_url_chars_mask(block), spaces)) & 0xFFFF;
+    result += 2 * __builtin_popcount(escaped);
+  }
+#endif
+  for (; i < len; ++i) {
+    const auto c = static_cast<unsigned char>(input[i]);
+    if (!is_good_url_char(c) && (raw || c != ' ')) {
+      result += 2;
+    }
+  }
+  return result;
+}
+
+void encode_url(const char *input, size_t len, char *output, bool raw) noexcept {
+  size_t i = 0;
+#ifdef __x86_64__
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const int escaped = ~_mm_movemask_epi8(good_url_chars_mask(block)) & 0xFFFF;
+    if (!escaped) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output), block);
+      output += 16;
+      continue;
+    }
+    output = copy_escaped_block(input + i, output, escaped, [raw](char c, char *output) {
+      return encode_url_char(static_cast<unsigned char>(c), output, raw);
+    });
+  }
+#endif
+  for (; i < len; ++i) {
+    output = encode_url_char(static_cast<unsigned char>(input[i]), output, raw);
+  }
+}
+
+size_t html_escaped_len(const char *input, size_t len, bool double_quotes, bool single_quotes) noexcept {
+  size_t result = len;
+  size_t i = 0;
+#ifdef __x86_64__
+  const __m128i double_quote_extra = _mm_set1_epi8(double_quotes ? 5 : 0);
+  const __m128i single_quote_extra = _mm_set1_epi8(single_quotes ? 5 : 0);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    result += sum_bytes(html_escape_extra_lens(block, double_quote_extra, single_quote_extra));
+  }
+#endif
+  for (; i < len; ++i) {
+    result += html_escape_extra_len(input[i], double_quotes, single_quotes);
+  }
+  return result;
+}
+
+void escape_html(const char *input, size_t len, char *output, bool double_quotes, bool single_quotes) noexcept {
+  size_t i = 0;
+#ifdef __x86_64__
+  const __m128i double_quote_extra = _mm_set1_epi8(double_quotes ? 5 : 0);
+  const __m128i single_quote_extra = _mm_set1_epi8(single_quotes ? 5 : 0);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    const __m128i extra_lens = html_escape_extra_lens(block, double_quote_extra, single_quote_extra);
+    const int escaped = ~_mm_movemask_epi8(_mm_cmpeq_epi8(extra_lens, _mm_setzero_si128())) & 0xFFFF;
+    if (!escaped) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output), block);
+      output += 16;
+      continue;
+    }
+    output = copy_escaped_block(input + i, output, escaped, [double_quotes, single_quotes](char c, char *output) {
+      return escape_html_char(c, output, double_quotes, single_quotes);
+    });
+  }
+#endif
+  for (; i < len; ++i) {
+    output = escape_html_char(input[i], output, double_quotes, single_quotes);
+  }
+}
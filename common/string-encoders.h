@@ -0,0 +1,45 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels of base64_encode(), base64_decode(), bin2hex(), hex2bin(), urlencode() and htmlspecialchars().
+// They write into a buffer of the exact output size, which is computed by the *_len() functions beforehand.
+
+inline size_t base64_encoded_len(size_t len) noexcept {
+  return (len + 2) / 3 * 4;
+}
+
+// the standard alphabet with '=' padding
+void encode_base64(const unsigned char *input, size_t len, char *output) noexcept;
+
+// decodes the leading blocks of 16 symbols from the alphabet into 12 bytes each and returns the number of decoded symbols,
+// it stops at the first block with a padding, a whitespace or a wrong symbol, the rest is left for the caller
+size_t decode_base64_blocks(const char *input, size_t len, unsigned char *output) noexcept;
+
+// lowercase digits, the output has 2 * len bytes
+void encode_hex(const unsigned char *input, size_t len, char *output) noexcept;
+
+// decodes 2 * len digits of both cases into len bytes, returns false if there is something else
+bool decode_hex(const char *input, size_t len, unsigned char *output) noexcept;
+
+// [0-9a-zA-Z-_.] are kept and the other bytes become %XX, urlencode() also replaces ' ' with '+' while rawurlencode() doesn't
+size_t url_encoded_len(const char *input, size_t len, bool raw) noexcept;
+void encode_url(const char *input, size_t len, char *output, bool raw) noexcept;
+
+// '&', '<' and '>' are always escaped, the quotes are escaped on request
+size_t html_escaped_len(const char *input, size_t len, bool double_quotes, bool single_quotes) noexcept;
+void escape_html(const char *input, size_t len, char *output, bool double_quotes, bool single_quotes) noexcept;
+
+// the loops over the whole blocks of base64_encode() and bin2hex(), picked by cpuid at startup,
+// they return the number of encoded bytes and leave the tail to the caller
+using encode_blocks_func_t = size_t (*)(const unsigned char *input, size_t len, char *output) noexcept;
+extern encode_blocks_func_t encode_base64_blocks;
+extern encode_blocks_func_t encode_hex_blocks;
+
+size_t encode_base64_blocks_generic(const unsigned char *input, size_t len, char *output) noexcept;
+size_t encode_hex_blocks_generic(const unsigned char *input, size_t len, char *output) noexcept;
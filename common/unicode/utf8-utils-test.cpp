@@ -0,0 +1,116 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/unicode/utf8-utils.h"
+
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+bool reference_is_valid_utf8(const std::string &s) {
+  int x = 0;
+  for (size_t i = 0; i < s.size();) {
+    if (s[i] == 0) {
+      i++;
+      continue;
+    }
+    const int len = get_char_utf8(&x, s.c_str() + i);
+    // get_char_utf8() accepts surrogates, 5 and 6 byte forms and code points above U+10FFFF
+    if (len <= 0 || len > 4 || x > 0x10ffff || (0xd800 <= x && x <= 0xdfff)) {
+      return false;
+    }
+    i += len;
+  }
+  return true;
+}
+
+size_t reference_chars_count(const std::string &s) {
+  size_t result = 0;
+  for (char c : s) {
+    result += (c & 0xc0) != 0x80;
+  }
+  return result;
+}
+
+std::string random_text(std::mt19937 &gen, size_t chars) {
+  static const char *samples[] = {"a", "Z", " ", "\xd0\x9f", "\xd1\x8f", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xef\xbf\xbf", "\xf4\x8f\xbf\xbf"};
+  std::string result;
+  for (size_t i = 0; i < chars; i++) {
+    result += gen() % 4 ? samples[gen() % 3] : samples[gen() % (sizeof(samples) / sizeof(samples[0]))];
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(utf8_utils, is_valid_utf8_short_sequences) {
+  for (uint32_t seq = 0; seq < (1 << 24); seq += (seq < (1 << 16) ? 1 : 13)) {
+    std::string s{static_cast<char>(seq & 0xff), static_cast<char>((seq >> 8) & 0xff), static_cast<char>(seq >> 16)};
+    for (size_t offset : {0, 13, 14, 15, 30}) {
+      const std::string padded = std::string(offset, 'x') + s;
+      ASSERT_EQ(is_valid_utf8(padded.c_str(), padded.size()), reference_is_valid_utf8(padded)) << std::hex << seq << " at " << offset;
+    }
+  }
+}
+
+TEST(utf8_utils, is_valid_utf8_four_byte_sequences) {
+  for (int a = 0xf0; a <= 0xff; a++) {
+    for (int b = 0; b <= 0xff; b++) {
+      for (int c : {0x00, 0x7f, 0x80, 0xbf, 0xc0}) {
+        for (int d : {0x20, 0x80, 0x9f, 0xbf, 0xe0}) {
+          const std::string s = std::string(14, 'x') + std::string{static_cast<char>(a), static_cast<char>(b), static_cast<char>(c), static_cast<char>(d)};
+          ASSERT_EQ(is_valid_utf8(s.c_str(), s.size()), reference_is_valid_utf8(s)) << std::hex << a << " " << b << " " << c << " " << d;
+        }
+      }
+    }
+  }
+}
+
+TEST(utf8_utils, is_valid_utf8_text) {
+  std::mt19937 gen;
+  for (int iter = 0; iter < 20000; iter++) {
+    std::string s = random_text(gen, gen() % 100);
+    ASSERT_TRUE(is_valid_utf8(s.c_str(), s.size())) << s;
+    if (!s.empty()) {
+      const size_t pos = gen() % s.size();
+      s[pos] = static_cast<char>(gen());
+      ASSERT_EQ(is_valid_utf8(s.c_str(), s.size()), reference_is_valid_utf8(s)) << s;
+      s.resize(pos);
+      ASSERT_EQ(is_valid_utf8(s.c_str(), s.size()), reference_is_valid_utf8(s)) << s;
+    }
+  }
+  ASSERT_FALSE(is_valid_utf8("\xed\xa0\x80", 3));
+  ASSERT_FALSE(is_valid_utf8("\xc0\xaf", 2));
+  ASSERT_FALSE(is_valid_utf8("\xf4\x90\x80\x80", 4));
+  ASSERT_TRUE(is_valid_utf8("a\0b", 3));
+}
+
+TEST(utf8_utils, chars_and_offsets) {
+  std::mt19937 gen;
+  for (int iter = 0; iter < 5000; iter++) {
+    const std::string s = random_text(gen, gen() % 100);
+    const size_t count = utf8_chars_count(s.c_str(), s.size());
+    ASSERT_EQ(count, reference_chars_count(s));
+    for (size_t n = 0; n <= count + 1; n++) {
+      const size_t offset = utf8_char_offset(s.c_str(), s.size(), n);
+      ASSERT_EQ(reference_chars_count(s.substr(0, offset)), std::min(n, count));
+      ASSERT_TRUE(offset == s.size() || (s[offset] & 0xc0) != 0x80);
+    }
+
+    const size_t ascii_len = utf8_ascii_prefix_len(s.c_str(), s.size());
+    ASSERT_EQ(ascii_len, s.find_first_of(std::string{"\xd0\xd1\xe2\xef\xf0\xf4"}) == std::string::npos ? s.size() : s.find_first_of("\xd0\xd1\xe2\xef\xf0\xf4"));
+
+    std::string lower(s.size(), '\0');
+    std::string upper(s.size(), '\0');
+    ASSERT_EQ(utf8_ascii_prefix_tolower(s.c_str(), s.size(), &lower[0]), ascii_len);
+    ASSERT_EQ(utf8_ascii_prefix_toupper(s.c_str(), s.size(), &upper[0]), ascii_len);
+    for (size_t i = 0; i < ascii_len; i++) {
+      ASSERT_EQ(lower[i], tolower(s[i]));
+      ASSERT_EQ(upper[i], toupper(s[i]));
+    }
+  }
+}
@@ -8,6 +8,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 void string_to_utf8 (const char *s, int *v) {
   int *tv = v;
 #define CHECK(x) if (!(x)) {v = tv; break;}
@@ -1693,3 +1697,279 @@ int has_bad_symbols (int *v_s) {
   }
   return 0;
 }
+
+#ifdef __x86_64__
+
+namespace {
+
+// Validation by lookups of the nibbles of every two adjacent bytes, see
+// J. Keiser, D. Lemire "Validating UTF-8 In Less Than One Instruction Per Byte", 2021
+constexpr char TOO_SHORT = 1 << 0;   // 11______ 0_______ or 11______ 11______
+constexpr char TOO_LONG = 1 << 1;    // 0_______ 10______
+constexpr char OVERLONG_3 = 1 << 2;  // 11100000 100_____
+constexpr char TOO_LARGE = 1 << 3;   // 11110100 1001____ and above
+constexpr char SURROGATE = 1 << 4;   // 11101101 101_____
+constexpr char OVERLONG_2 = 1 << 5;  // 1100000_ 10______
+constexpr char TOO_LARGE_1000 = 1 << 6; // 11110101 1000____ and above
+constexpr char OVERLONG_4 = 1 << 6;  // 11110000 1000____
+constexpr char TWO_CONTS = static_cast<char>(1 << 7); // 10______ 10______
+constexpr char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+struct Utf8Checker {
+  __m128i error = _mm_setzero_si128();
+  __m128i prev_block = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  void check_block(__m128i block) {
+    if (_mm_movemask_epi8(block) == 0) {
+      // an ASCII block can only break a sequence at the end of the previous one
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = _mm_setzero_si128();
+      prev_block = block;
+      return;
+    }
+
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i prev1 = _mm_alignr_epi8(block, prev_block, 15);
+    const __m128i byte_1_high = _mm_shuffle_epi8(
+      _mm_setr_epi8(TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                    TOO_SHORT | OVERLONG_2,
+                    TOO_SHORT,
+                    TOO_SHORT | OVERLONG_3 | SURROGATE,
+                    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+      _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+    const __m128i byte_1_low = _mm_shuffle_epi8(
+      _mm_setr_epi8(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                    CARRY | OVERLONG_2,
+                    CARRY,
+                    CARRY,
+                    CARRY | TOO_LARGE,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000,
+                    CARRY | TOO_LARGE | TOO_LARGE_1000),
+      _mm_and_si128(prev1, low_nibble));
+    const __m128i byte_2_high = _mm_shuffle_epi8(
+      _mm_setr_epi8(TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT),
+      _mm_and_si128(_mm_srli_epi16(block, 4), low_nibble));
+    const __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // the third and the fourth bytes of sequences must be continuations, which is TWO_CONTS above
+    const __m128i prev2 = _mm_alignr_epi8(block, prev_block, 14);
+    const __m128i prev3 = _mm_alignr_epi8(block, prev_block, 13);
+    const __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(static_cast<char>(0x80)));
+    error = _mm_or_si128(error, _mm_xor_si128(must_be_continuation, special_cases));
+
+    // the sequences which are cut by the end of the block: 1111____ 111_____ 11______
+    prev_incomplete = _mm_subs_epu8(block, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                         static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1)));
+    prev_block = block;
+  }
+
+  bool is_valid() const {
+    return _mm_testz_si128(_mm_or_si128(error, prev_incomplete), _mm_or_si128(error, prev_incomplete));
+  }
+};
+
+inline int non_ascii_mask(__m128i block) {
+  return _mm_movemask_epi8(block);
+}
+
+// bytes which aren't 10xxxxxx, they are greater than -65 as signed
+inline int char_starts_mask(__m128i block) {
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(block, _mm_set1_epi8(-65)));
+}
+
+template<char Low, char High>
+inline size_t ascii_prefix_change_case(const char *s, size_t len, char *output) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if (non_ascii_mask(block)) {
+      break;
+    }
+    const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(Low - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(High + 1), block));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_xor_si128(block, _mm_and_si128(in_range, _mm_set1_epi8(0x20))));
+  }
+  for (; i < len && static_cast<unsigned char>(s[i]) < 0x80; i++) {
+    output[i] = Low <= s[i] && s[i] <= High ? static_cast<char>(s[i] ^ 0x20) : s[i];
+  }
+  return i;
+}
+
+} // namespace
+
+bool is_valid_utf8 (const char *s, size_t len) {
+  Utf8Checker checker;
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 16));
+    if (non_ascii_mask(_mm_or_si128(first, second)) == 0) {
+      checker.error = _mm_or_si128(checker.error, checker.prev_incomplete);
+      checker.prev_incomplete = _mm_setzero_si128();
+      checker.prev_block = second;
+      continue;
+    }
+    checker.check_block(first);
+    checker.check_block(second);
+  }
+  for (; i + 16 <= len; i += 16) {
+    checker.check_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i)));
+  }
+  if (i < len) {
+    // the zero padding is ASCII, so a sequence cut by the end of the string is too short
+    char tail[16] = {0};
+    memcpy(tail, s + i, len - i);
+    checker.check_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tail)));
+  }
+  return checker.is_valid();
+}
+
+size_t utf8_ascii_prefix_len (const char *s, size_t len) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 16));
+    if (const int mask = non_ascii_mask(first) | (non_ascii_mask(second) << 16)) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  for (; i < len && static_cast<unsigned char>(s[i]) < 0x80; i++) {
+  }
+  return i;
+}
+
+size_t utf8_chars_count (const char *s, size_t len) {
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 16));
+    result += __builtin_popcount(char_starts_mask(first) | (char_starts_mask(second) << 16));
+  }
+  for (; i < len; i++) {
+    result += (s[i] & 0xc0) != 0x80;
+  }
+  return result;
+}
+
+size_t utf8_char_offset (const char *s, size_t len, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    int mask = char_starts_mask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i)));
+    const size_t count = __builtin_popcount(mask);
+    if (n < count) {
+      for (; n > 0; n--) {
+        mask &= mask - 1;
+      }
+      return i + __builtin_ctz(mask);
+    }
+    n -= count;
+  }
+  for (; i < len; i++) {
+    if ((s[i] & 0xc0) != 0x80) {
+      if (n == 0) {
+        return i;
+      }
+      n--;
+    }
+  }
+  return len;
+}
+
+size_t utf8_ascii_prefix_tolower (const char *s, size_t len, char *output) {
+  return ascii_prefix_change_case<'A', 'Z'>(s, len, output);
+}
+
+size_t utf8_ascii_prefix_toupper (const char *s, size_t len, char *output) {
+  return ascii_prefix_change_case<'a', 'z'>(s, len, output);
+}
+
+#else
+
+bool is_valid_utf8 (const char *str, size_t len) {
+  const auto *s = reinterpret_cast<const unsigned char *>(str);
+  for (size_t i = 0; i < len;) {
+    const unsigned char a = s[i];
+    if (a < 0x80) {
+      i++;
+      continue;
+    }
+    const size_t seq_len = a < 0xc2 ? 0 : a < 0xe0 ? 2 : a < 0xf0 ? 3 : a < 0xf5 ? 4 : 0;
+    if (seq_len == 0 || i + seq_len > len) {
+      return false;
+    }
+    for (size_t j = 1; j < seq_len; j++) {
+      if ((s[i + j] & 0xc0) != 0x80) {
+        return false;
+      }
+    }
+    const unsigned char b = s[i + 1];
+    if ((a == 0xe0 && b < 0xa0) || (a == 0xed && b >= 0xa0) || (a == 0xf0 && b < 0x90) || (a == 0xf4 && b >= 0x90)) {
+      return false;
+    }
+    i += seq_len;
+  }
+  return true;
+}
+
+size_t utf8_ascii_prefix_len (const char *s, size_t len) {
+  size_t i = 0;
+  for (; i < len && static_cast<unsigned char>(s[i]) < 0x80; i++) {
+  }
+  return i;
+}
+
+size_t utf8_chars_count (const char *s, size_t len) {
+  size_t result = 0;
+  for (size_t i = 0; i < len; i++) {
+    result += (s[i] & 0xc0) != 0x80;
+  }
+  return result;
+}
+
+size_t utf8_char_offset (const char *s, size_t len, size_t n) {
+  for (size_t i = 0; i < len; i++) {
+    if ((s[i] & 0xc0) != 0x80) {
+      if (n == 0) {
+        return i;
+      }
+      n--;
+    }
+  }
+  return len;
+}
+
+size_t utf8_ascii_prefix_tolower (const char *s, size_t len, char *output) {
+  size_t i = 0;
+  for (; i < len && static_cast<unsigned char>(s[i]) < 0x80; i++) {
+    output[i] = 'A' <= s[i] && s[i] <= 'Z' ? static_cast<char>(s[i] ^ 0x20) : s[i];
+  }
+  return i;
+}
+
+size_t utf8_ascii_prefix_toupper (const char *s, size_t len, char *output) {
+  size_t i = 0;
+  for (; i < len && static_cast<unsigned char>(s[i]) < 0x80; i++) {
+    output[i] = 'a' <= s[i] && s[i] <= 'z' ? static_cast<char>(s[i] ^ 0x20) : s[i];
+  }
+  return i;
+}
+
+#endif
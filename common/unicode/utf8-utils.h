@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 void string_to_utf8 (const char *s, int *v);
 void string_to_utf8_len (const char *s, int s_len, int *v);
 void html_string_to_utf8 (const char *s, int *v);
@@ -98,3 +100,20 @@ static inline int put_char_utf8 (unsigned int x, char *s) {
   return 0;
 }
 
+// The functions below work on the whole string of len bytes and process 16-32 bytes at a time
+
+// well-formed UTF-8 without overlong forms, surrogates and code points above U+10FFFF
+bool is_valid_utf8 (const char *s, size_t len);
+
+// the number of leading ASCII bytes
+size_t utf8_ascii_prefix_len (const char *s, size_t len);
+
+// the number of characters, i.e. of the bytes which aren't 10xxxxxx
+size_t utf8_chars_count (const char *s, size_t len);
+
+// the offset of the character with index n or len if there are fewer characters
+size_t utf8_char_offset (const char *s, size_t len, size_t n);
+
+// convert the leading ASCII bytes to the lower or the upper case, return their number
+size_t utf8_ascii_prefix_tolower (const char *s, size_t len, char *output);
+size_t utf8_ascii_prefix_toupper (const char *s, size_t len, char *output);
@@ -0,0 +1,77 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <openssl/evp.h>
+
+#include "common/xxh3.h"
+
+static std::vector<std::uint8_t> make_payload(std::size_t size) {
+  std::vector<std::uint8_t> payload(size);
+  std::independent_bits_engine<std::default_random_engine, 8, std::uint8_t> engine;
+  std::generate(payload.begin(), payload.end(), std::ref(engine));
+  return payload;
+}
+
+static void BM_xxh3_64(benchmark::State& state) {
+  const std::size_t size = state.range(0);
+  const auto payload = make_payload(size);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compute_xxh3_64(payload.data(), payload.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_xxh3_64)->RangeMultiplier(4)->Range(16, 16 << 20);
+
+static void BM_xxh3_64_generic(benchmark::State& state) {
+  const std::size_t size = state.range(0);
+  const auto payload = make_payload(size);
+
+  const auto dispatched = xxh3_accumulate;
+  xxh3_accumulate = xxh3_accumulate_generic;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compute_xxh3_64(payload.data(), payload.size()));
+  }
+  xxh3_accumulate = dispatched;
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_xxh3_64_generic)->RangeMultiplier(4)->Range(256, 16 << 20);
+
+// md5(), sha1() and hash() go to the OpenSSL one-shot digests, which pick SHA-NI / AVX2 code by cpuid themselves
+static void run_openssl_digest(benchmark::State& state, const EVP_MD *md) {
+  const std::size_t size = state.range(0);
+  const auto payload = make_payload(size);
+
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  unsigned int digest_len = 0;
+  for (auto _ : state) {
+    EVP_Digest(payload.data(), payload.size(), digest, &digest_len, md, nullptr);
+    benchmark::DoNotOptimize(digest);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_openssl_md5(benchmark::State& state) {
+  run_openssl_digest(state, EVP_md5());
+}
+BENCHMARK(BM_openssl_md5)->RangeMultiplier(4)->Range(16, 16 << 20);
+
+static void BM_openssl_sha1(benchmark::State& state) {
+  run_openssl_digest(state, EVP_sha1());
+}
+BENCHMARK(BM_openssl_sha1)->RangeMultiplier(4)->Range(16, 16 << 20);
+
+static void BM_openssl_sha256(benchmark::State& state) {
+  run_openssl_digest(state, EVP_sha256());
+}
+BENCHMARK(BM_openssl_sha256)->RangeMultiplier(4)->Range(16, 16 << 20);
+
+BENCHMARK_MAIN();
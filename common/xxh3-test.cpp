@@ -0,0 +1,64 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/xxh3.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<unsigned char> make_sanity_buffer() {
+  std::vector<unsigned char> buffer(4096);
+  uint64_t generator = 2654435761U;
+  for (auto &c : buffer) {
+    c = static_cast<unsigned char>(generator >> 56);
+    generator *= 11400714785074694797ULL;
+  }
+  return buffer;
+}
+
+// the values of XXH3_64bits() from xxHash 0.8
+const std::pair<size_t, uint64_t> expected_hashes[] = {
+  {0, 0x2d06800538d394c2ULL},
+  {1, 0xc44bdff4074eecdbULL},
+  {3, 0x54247382a8d6b94dULL},
+  {4, 0xe5dc74bc51848a51ULL},
+  {8, 0x24ccc9acaa9f65e4ULL},
+  {9, 0x14d5001c15dd3f2bULL},
+  {16, 0x981b17d36c7498c9ULL},
+  {17, 0x796f5acd3a60f862ULL},
+  {128, 0xfcff24126754d861ULL},
+  {129, 0x98f1b0a679a2ca29ULL},
+  {240, 0x81c3c2b67f568ccfULL},
+  {241, 0xc5a639ecd2030e5eULL},
+  {1024, 0xdd85c9b5c1109c5cULL},
+  {1025, 0xd870c0fa13211c6aULL},
+  {2048, 0xdd59e2c3a5f038e0ULL},
+  {4096, 0xe91206429d1f48f9ULL},
+};
+
+} // namespace
+
+TEST(xxh3, reference_values) {
+  const auto buffer = make_sanity_buffer();
+  for (const auto &expected : expected_hashes) {
+    EXPECT_EQ(compute_xxh3_64(buffer.data(), expected.first), expected.second) << "len " << expected.first;
+  }
+  EXPECT_EQ(compute_xxh3_64("abc", 3), 0x78af5f94892f3950ULL);
+}
+
+TEST(xxh3, generic_accumulate) {
+  const auto buffer = make_sanity_buffer();
+  const auto dispatched = xxh3_accumulate;
+  for (size_t len = 200; len <= buffer.size(); len += 61) {
+    const uint64_t hash = compute_xxh3_64(buffer.data(), len);
+    xxh3_accumulate = xxh3_accumulate_generic;
+    EXPECT_EQ(compute_xxh3_64(buffer.data(), len), hash) << "len " << len;
+    xxh3_accumulate = dispatched;
+  }
+}
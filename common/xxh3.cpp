@@ -0,0 +1,253 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "common/xxh3.h"
+
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "common/cpuid.h"
+
+namespace {
+
+constexpr uint64_t PRIME32_1 = 0x9E3779B1U;
+constexpr uint64_t PRIME32_2 = 0x85EBCA77U;
+constexpr uint64_t PRIME32_3 = 0xC2B2AE3DU;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t STRIPE_LEN = 64;
+constexpr size_t SECRET_CONSUME_RATE = 8;
+constexpr size_t ACC_NB = STRIPE_LEN / sizeof(uint64_t);
+constexpr size_t SECRET_SIZE = 192;
+constexpr size_t SECRET_SIZE_MIN = 136;
+constexpr size_t MIDSIZE_MAX = 240;
+constexpr size_t MIDSIZE_START_OFFSET = 3;
+constexpr size_t MIDSIZE_LAST_OFFSET = 17;
+constexpr size_t SECRET_LAST_ACC_START = 7;
+constexpr size_t SECRET_MERGE_ACCS_START = 11;
+
+alignas(64) const unsigned char default_secret[SECRET_SIZE] = {
+  0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+  0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+  0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+  0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+  0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+  0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+  0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+  0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+  0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+  0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+  0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+  0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "xxh3 reads the input as little-endian words");
+
+inline uint64_t read64(const unsigned char *p) noexcept {
+  uint64_t value = 0;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t read32(const unsigned char *p) noexcept {
+  uint32_t value = 0;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t rotl64(uint64_t x, int r) noexcept {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t mul128_fold64(uint64_t lhs, uint64_t rhs) noexcept {
+  const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t xorshift64(uint64_t x, int shift) noexcept {
+  return x ^ (x >> shift);
+}
+
+inline uint64_t xxh64_avalanche(uint64_t h) noexcept {
+  h = xorshift64(h, 33) * PRIME64_2;
+  h = xorshift64(h, 29) * PRIME64_3;
+  return xorshift64(h, 32);
+}
+
+inline uint64_t avalanche(uint64_t h) noexcept {
+  h = xorshift64(h, 37) * PRIME_MX1;
+  return xorshift64(h, 32);
+}
+
+inline uint64_t rrmxmx(uint64_t h, uint64_t len) noexcept {
+  h ^= rotl64(h, 49) ^ rotl64(h, 24);
+  h *= PRIME_MX2;
+  h ^= (h >> 35) + len;
+  h *= PRIME_MX2;
+  return xorshift64(h, 28);
+}
+
+uint64_t hash_len_0to16(const unsigned char *input, size_t len, const unsigned char *secret) noexcept {
+  if (len > 8) {
+    const uint64_t input_lo = read64(input) ^ (read64(secret + 24) ^ read64(secret + 32));
+    const uint64_t input_hi = read64(input + len - 8) ^ (read64(secret + 40) ^ read64(secret + 48));
+    return avalanche(len + __builtin_bswap64(input_lo) + input_hi + mul128_fold64(input_lo, input_hi));
+  }
+  if (len >= 4) {
+    const uint64_t input64 = read32(input + len - 4) + (static_cast<uint64_t>(read32(input)) << 32);
+    return rrmxmx(input64 ^ (read64(secret + 8) ^ read64(secret + 16)), len);
+  }
+  if (len) {
+    const uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[len >> 1]) << 24) |
+                              static_cast<uint32_t>(input[len - 1]) | (static_cast<uint32_t>(len) << 8);
+    return xxh64_avalanche(combined ^ static_cast<uint64_t>(read32(secret) ^ read32(secret + 4)));
+  }
+  return xxh64_avalanche(read64(secret + 56) ^ read64(secret + 64));
+}
+
+inline uint64_t mix16(const unsigned char *input, const unsigned char *secret) noexcept {
+  return mul128_fold64(read64(input) ^ read64(secret), read64(input + 8) ^ read64(secret + 8));
+}
+
+uint64_t hash_len_17to128(const unsigned char *input, size_t len, const unsigned char *secret) noexcept {
+  uint64_t acc = len * PRIME64_1;
+  if (len > 32) {
+    if (len > 64) {
+      if (len > 96) {
+        acc += mix16(input + 48, secret + 96);
+        acc += mix16(input + len - 64, secret + 112);
+      }
+      acc += mix16(input + 32, secret + 64);
+      acc += mix16(input + len - 48, secret + 80);
+    }
+    acc += mix16(input + 16, secret + 32);
+    acc += mix16(input + len - 32, secret + 48);
+  }
+  acc += mix16(input, secret);
+  acc += mix16(input + len - 16, secret + 16);
+  return avalanche(acc);
+}
+
+uint64_t hash_len_129to240(const unsigned char *input, size_t len, const unsigned char *secret) noexcept {
+  uint64_t acc = len * PRIME64_1;
+  for (size_t i = 0; i < 8; ++i) {
+    acc += mix16(input + 16 * i, secret + 16 * i);
+  }
+  acc = avalanche(acc);
+  uint64_t acc_end = mix16(input + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LAST_OFFSET);
+  for (size_t i = 8; i < len / 16; ++i) {
+    acc_end += mix16(input + 16 * i, secret + 16 * (i - 8) + MIDSIZE_START_OFFSET);
+  }
+  return avalanche(acc + acc_end);
+}
+
+void scramble(uint64_t *acc, const unsigned char *secret) noexcept {
+  for (size_t i = 0; i < ACC_NB; ++i) {
+    acc[i] = (xorshift64(acc[i], 47) ^ read64(secret + 8 * i)) * PRIME32_1;
+  }
+}
+
+uint64_t hash_long(const unsigned char *input, size_t len, const unsigned char *secret) noexcept {
+  alignas(64) uint64_t acc[ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+  constexpr size_t stripes_per_block = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+  constexpr size_t block_len = STRIPE_LEN * stripes_per_block;
+  const size_t blocks = (len - 1) / block_len;
+  for (size_t n = 0; n < blocks; ++n) {
+    xxh3_accumulate(acc, input + n * block_len, secret, stripes_per_block);
+    scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+  }
+  const size_t stripes = ((len - 1) - block_len * blocks) / STRIPE_LEN;
+  xxh3_accumulate(acc, input + blocks * block_len, secret, stripes);
+  xxh3_accumulate(acc, input + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LAST_ACC_START, 1);
+
+  uint64_t result = len * PRIME64_1;
+  for (size_t i = 0; i < 4; ++i) {
+    const unsigned char *merge_secret = secret + SECRET_MERGE_ACCS_START + 16 * i;
+    result += mul128_fold64(acc[2 * i] ^ read64(merge_secret), acc[2 * i + 1] ^ read64(merge_secret + 8));
+  }
+  return avalanche(result);
+}
+
+#ifdef __x86_64__
+
+void xxh3_accumulate_sse2(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes) noexcept {
+  auto *xacc = reinterpret_cast<__m128i *>(acc);
+  for (size_t n = 0; n < stripes; ++n) {
+    const auto *xinput = reinterpret_cast<const __m128i *>(input + n * STRIPE_LEN);
+    const auto *xsecret = reinterpret_cast<const __m128i *>(secret + n * SECRET_CONSUME_RATE);
+    for (size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); ++i) {
+      const __m128i data = _mm_loadu_si128(xinput + i);
+      const __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128(xsecret + i));
+      // the low halves of the lanes multiplied by their high halves
+      const __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped_data = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], swapped_data));
+    }
+  }
+}
+
+__attribute__((target("avx2")))
+void xxh3_accumulate_avx2(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes) noexcept {
+  auto *xacc = reinterpret_cast<__m256i *>(acc);
+  for (size_t n = 0; n < stripes; ++n) {
+    const auto *xinput = reinterpret_cast<const __m256i *>(input + n * STRIPE_LEN);
+    const auto *xsecret = reinterpret_cast<const __m256i *>(secret + n * SECRET_CONSUME_RATE);
+    for (size_t i = 0; i < STRIPE_LEN / sizeof(__m256i); ++i) {
+      const __m256i data = _mm256_loadu_si256(xinput + i);
+      const __m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256(xsecret + i));
+      const __m256i product = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped_data = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      xacc[i] = _mm256_add_epi64(product, _mm256_add_epi64(xacc[i], swapped_data));
+    }
+  }
+}
+
+#endif
+
+} // namespace
+
+void xxh3_accumulate_generic(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes) noexcept {
+  for (size_t n = 0; n < stripes; ++n) {
+    const unsigned char *stripe = input + n * STRIPE_LEN;
+    const unsigned char *stripe_secret = secret + n * SECRET_CONSUME_RATE;
+    for (size_t i = 0; i < ACC_NB; ++i) {
+      const uint64_t data = read64(stripe + 8 * i);
+      const uint64_t data_key = data ^ read64(stripe_secret + 8 * i);
+      acc[i ^ 1] += data;
+      acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+  }
+}
+
+xxh3_accumulate_func_t xxh3_accumulate = xxh3_accumulate_generic;
+
+#ifdef __x86_64__
+static void __attribute__((constructor(101))) xxh3_init() {
+  xxh3_accumulate = kdb_cpuid_has_avx2() ? xxh3_accumulate_avx2 : xxh3_accumulate_sse2;
+}
+#endif
+
+uint64_t compute_xxh3_64(const void *data, size_t len) noexcept {
+  const auto *input = static_cast<const unsigned char *>(data);
+  if (len <= 16) {
+    return hash_len_0to16(input, len, default_secret);
+  }
+  if (len <= 128) {
+    return hash_len_17to128(input, len, default_secret);
+  }
+  if (len <= MIDSIZE_MAX) {
+    return hash_len_129to240(input, len, default_secret);
+  }
+  return hash_long(input, len, default_secret);
+}
@@ -0,0 +1,18 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// XXH3 64-bit hash with the default secret and seed 0, the same values as XXH3_64bits() of xxHash 0.8
+// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+uint64_t compute_xxh3_64(const void *data, size_t len) noexcept;
+
+// the stripes loop of long inputs, picked by cpuid at startup
+using xxh3_accumulate_func_t = void (*)(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes) noexcept;
+extern xxh3_accumulate_func_t xxh3_accumulate;
+
+void xxh3_accumulate_generic(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes) noexcept;
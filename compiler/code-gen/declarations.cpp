@@ -549,7 +549,8 @@ void ClassDeclaration::compile_accept_visitor(CodeGenerator &W, ClassPtr klass,
 void ClassDeclaration::compile_accept_visitor_methods(CodeGenerator &W, ClassPtr klass) {
   if (!klass->need_instance_to_array_visitor &&
       !klass->need_instance_cache_visitors &&
-      !klass->need_instance_memory_estimate_visitor) {
+      !klass->need_instance_memory_estimate_visitor &&
+      !klass->need_instance_json_visitors) {
     return;
   }
 
@@ -579,7 +580,64 @@ void ClassDeclaration::compile_accept_visitor_methods(CodeGenerator &W, ClassPtr
     compile_accept_visitor(W, klass, "InstanceUniqueIndexVisitor");
     compile_accept_visitor(W, klass, "InstanceDeepCopyVisitor");
     compile_accept_visitor(W, klass, "InstanceDeepDestroyVisitor");
+    compile_accept_visitor(W, klass, "InstanceReferencesCheckVisitor");
   }
+
+  if (klass->need_instance_json_visitors) {
+    W << NL;
+    compile_accept_visitor(W, klass, "InstanceToJsonVisitor");
+    compile_json_parse_field(W, klass);
+  }
+}
+
+void ClassDeclaration::compile_json_parse_field(CodeGenerator &W, ClassPtr klass) {
+  //bool json_parse_field(InstanceFromJsonParser &parser, const char *key, size_t key_len) {
+  //  switch (vk::seeded_string_hash(key, key_len, seed) % table_size) {
+  //    case 3:
+  //      if (key_len == 5 && !memcmp(key, "field", 5)) { return parser.parse($field); }
+  //      break;
+  //    ...
+  //  }
+  //  return parser.skip_value();
+  //}
+  std::vector<std::string> field_names;
+  for (auto cur_klass = klass; cur_klass; cur_klass = cur_klass->parent_class) {
+    cur_klass->members.for_each([&field_names](const ClassMemberInstanceField &f) {
+      field_names.emplace_back(f.local_name());
+    });
+  }
+
+  // the field names get different slots of the switch: a seed without collisions is searched for, the table grows if there is none
+  uint32_t seed = 0;
+  uint32_t table_size = std::max<uint32_t>(field_names.size(), 1);
+  std::map<uint32_t, std::string> slots;
+  auto fill_slots = [&] {
+    slots.clear();
+    for (const auto &name : field_names) {
+      if (!slots.emplace(vk::seeded_string_hash(name.c_str(), name.size(), seed) % table_size, name).second) {
+        return false;
+      }
+    }
+    return true;
+  };
+  while (!fill_slots()) {
+    if (++seed == 64) {
+      seed = 0;
+      ++table_size;
+    }
+  }
+
+  W << "bool json_parse_field(InstanceFromJsonParser &parser, const char *key, size_t key_len)" << BEGIN
+    << "switch (vk::seeded_string_hash(key, key_len, " << seed << ") % " << table_size << ")" << BEGIN;
+  for (const auto &slot : slots) {
+    const std::string &name = slot.second;
+    W << "case " << slot.first << ":" << NL
+      << "  if (key_len == " << name.size() << " && !memcmp(key, \"" << name << "\", " << name.size() << ")) { return parser.parse($" << name << "); }" << NL
+      << "  break;" << NL;
+  }
+  W << END << NL
+    << "return parser.skip_value();" << NL
+    << END << NL;
 }
 
 void ClassDeclaration::compile_serialization_methods(CodeGenerator &W, ClassPtr klass) {
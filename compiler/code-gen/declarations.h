@@ -115,6 +115,7 @@ private:
   static void compile_get_class(CodeGenerator &W, ClassPtr klass);
   static void compile_get_hash(CodeGenerator &W, ClassPtr klass);
   static void compile_accept_visitor_methods(CodeGenerator &W, ClassPtr klass);
+  static void compile_json_parse_field(CodeGenerator &W, ClassPtr klass);
   static void compile_serialization_methods(CodeGenerator &W, ClassPtr klass);
   static void compile_serialize(CodeGenerator &W, ClassPtr klass);
   static void compile_deserialize(CodeGenerator &W, ClassPtr klass);
@@ -123,6 +123,7 @@ void GlobalResetFunction::compile(CodeGenerator &W) const {
       W << lib->lib_namespace() << "::lib_global_vars_reset();" << NL;
     }
   }
+  W << "global_vars_dirty_parts = 0;" << NL;
   W << END << NL;
 }
 
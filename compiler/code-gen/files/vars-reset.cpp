@@ -10,6 +10,7 @@
 #include "compiler/code-gen/namespace.h"
 #include "compiler/code-gen/vertex-compiler.h"
 #include "compiler/data/class-data.h"
+#include "compiler/data/function-data.h"
 #include "compiler/data/src-file.h"
 #include "compiler/data/vars-collector.h"
 #include "compiler/vertex.h"
@@ -47,18 +48,36 @@ void GlobalVarsReset::compile_part(FunctionPtr func, const std::set<VarPtr> &use
     }
   }
 
-  FunctionSignatureGenerator(W) << "void " << GlobalVarsResetFuncName(func, part_i) << " " << BEGIN;
-  for (auto var : used_vars) {
-    if (G->settings().is_static_lib_mode() && var->is_builtin_global()) {
-      continue;
-    }
-
+  const auto compile_reset = [&W](VarPtr var) {
     W << "hard_reset_var(" << VarName(var);
     //FIXME: brk and comments
     if (var->init_val) {
       W << ", " << var->init_val;
     }
     W << ");" << NL;
+  };
+
+  FunctionSignatureGenerator(W) << "void " << GlobalVarsResetFuncName(func, part_i) << " " << BEGIN;
+  // the builtin globals are filled by the runtime, so they are reset regardless of the dirty parts
+  size_t dirty_vars = 0;
+  for (auto var : used_vars) {
+    if (!var->is_builtin_global()) {
+      ++dirty_vars;
+    } else if (!G->settings().is_static_lib_mode()) {
+      compile_reset(var);
+    }
+  }
+
+  if (dirty_vars) {
+    W << "if (!(global_vars_dirty_parts & (1u << " << part_i << "))) " << BEGIN
+      << "return;" << NL
+      << END << NL;
+    W << "global_vars_reset_count += " << dirty_vars << ";" << NL;
+    for (auto var : used_vars) {
+      if (!var->is_builtin_global()) {
+        compile_reset(var);
+      }
+    }
   }
 
   W << END;
@@ -66,13 +85,13 @@ void GlobalVarsReset::compile_part(FunctionPtr func, const std::set<VarPtr> &use
   W << CloseNamespace();
 }
 
-void GlobalVarsReset::compile_func(FunctionPtr func, int parts_n, CodeGenerator &W) {
+void GlobalVarsReset::compile_func(FunctionPtr func, const std::vector<int> &parts, CodeGenerator &W) {
   W << OpenNamespace();
   FunctionSignatureGenerator(W) << "void " << GlobalVarsResetFuncName(func) << " " << BEGIN;
 
-  for (int i = 0; i < parts_n; i++) {
-    W << "void " << GlobalVarsResetFuncName(func, i) << ";" << NL;
-    W << GlobalVarsResetFuncName(func, i) << ";" << NL;
+  for (int part_i : parts) {
+    W << "void " << GlobalVarsResetFuncName(func, part_i) << ";" << NL;
+    W << GlobalVarsResetFuncName(func, part_i) << ";" << NL;
   }
 
   W << END;
@@ -83,25 +102,48 @@ void GlobalVarsReset::compile_func(FunctionPtr func, int parts_n, CodeGenerator
 void GlobalVarsReset::compile(CodeGenerator &W) const {
   FunctionPtr main_func = main_file_->main_function;
 
-  VarsCollector vars_collector{32};
+  VarsCollector vars_collector{parts_count};
   vars_collector.collect_global_and_static_vars_from(main_func);
   auto used_vars = vars_collector.flush();
 
-  static const std::string vars_reset_src_prefix = "vars_reset.";
-  std::vector<std::string> src_names(used_vars.size());
+  // the empty parts are dropped, so the part index is got from any of its vars
+  std::vector<int> parts(used_vars.size());
   for (int i = 0; i < used_vars.size(); i++) {
-    src_names[i] = vars_reset_src_prefix + std::to_string(i) + "." + main_func->src_name;
+    parts[i] = static_cast<int>(VarsCollector::get_var_part(*used_vars[i].begin(), parts_count));
   }
 
+  static const std::string vars_reset_src_prefix = "vars_reset.";
   for (int i = 0; i < used_vars.size(); i++) {
-    W << OpenFile(src_names[i], "o_vars_reset", false);
+    W << OpenFile(vars_reset_src_prefix + std::to_string(parts[i]) + "." + main_func->src_name, "o_vars_reset", false);
     W << ExternInclude(G->settings().runtime_headers.get());
-    compile_part(main_func, used_vars[i], i, W);
+    compile_part(main_func, used_vars[i], parts[i], W);
     W << CloseFile();
   }
 
   W << OpenFile(vars_reset_src_prefix + main_func->src_name, "", false);
   W << ExternInclude(G->settings().runtime_headers.get());
-  compile_func(main_func, used_vars.size(), W);
+  compile_func(main_func, parts, W);
   W << CloseFile();
 }
+
+GlobalVarsDirtyMark::GlobalVarsDirtyMark(FunctionPtr function) :
+  function_(function) {
+}
+
+void GlobalVarsDirtyMark::compile(CodeGenerator &W) const {
+  static_assert(GlobalVarsReset::parts_count <= 32, "global_vars_dirty_parts is uint32_t");
+  uint32_t parts_mask = 0;
+  const auto add_vars = [&parts_mask](const auto &vars) {
+    for (VarPtr var : vars) {
+      if (!var->is_builtin_global()) {
+        parts_mask |= 1u << VarsCollector::get_var_part(var, GlobalVarsReset::parts_count);
+      }
+    }
+  };
+  add_vars(function_->global_var_ids);
+  add_vars(function_->static_var_ids);
+
+  if (parts_mask) {
+    W << "global_vars_dirty_parts |= " << parts_mask << "u;" << NL;
+  }
+}
@@ -9,17 +9,30 @@
 #include "compiler/data/data_ptr.h"
 #include "compiler/data/vertex-adaptor.h"
 
+// The global and static vars are split into parts, and only the parts marked as dirty during the request are reset:
+// a function marks the parts of the vars it uses on entry, see GlobalVarsDirtyMark
 struct GlobalVarsReset : CodeGenRootCmd {
+  static constexpr int parts_count = 32;
+
   explicit GlobalVarsReset(SrcFilePtr main_file);
 
   void compile(CodeGenerator &W) const final;
 
   static void compile_part(FunctionPtr func, const std::set<VarPtr> &used_vars, int part_i, CodeGenerator &W);
 
-  static void compile_func(FunctionPtr func, int parts_n, CodeGenerator &W);
+  static void compile_func(FunctionPtr func, const std::vector<int> &parts, CodeGenerator &W);
 
   static void declare_extern_for_init_val(VertexPtr v, std::set<VarPtr> &externed_vars, CodeGenerator &W);
 
 private:
   SrcFilePtr main_file_;
 };
+
+struct GlobalVarsDirtyMark {
+  explicit GlobalVarsDirtyMark(FunctionPtr function);
+
+  void compile(CodeGenerator &W) const;
+
+private:
+  FunctionPtr function_;
+};
@@ -11,6 +11,7 @@
 
 #include "compiler/code-gen/common.h"
 #include "compiler/code-gen/declarations.h"
+#include "compiler/code-gen/files/vars-reset.h"
 #include "compiler/code-gen/naming.h"
 #include "compiler/code-gen/raw-data.h"
 #include "compiler/data/class-data.h"
@@ -1064,6 +1065,7 @@ void compile_function_resumable(VertexAdaptor<op_function> func_root, CodeGenera
   //CALL FUNCTION
   W << FunctionDeclaration(func, false) << " " <<
     BEGIN;
+  W << GlobalVarsDirtyMark(func);
   W << "return start_resumable < " << FunctionClassName(func) << "::ReturnT >" <<
     "(new " << FunctionClassName(func) << "(";
 
@@ -1076,6 +1078,7 @@ void compile_function_resumable(VertexAdaptor<op_function> func_root, CodeGenera
   //FORK FUNCTION
   W << FunctionForkDeclaration(func, false) << " " <<
     BEGIN;
+  W << GlobalVarsDirtyMark(func);
   W << "return fork_resumable(new " << FunctionClassName(func) << "(";
   W << JoinValues(func->param_ids, ", ", join_mode::one_line, var_name_gen);
   W << "));" << NL;
@@ -1095,6 +1098,7 @@ void compile_function(VertexAdaptor<op_function> func_root, CodeGenerator &W) {
   }
 
   W << FunctionDeclaration(func, false) << " " << BEGIN;
+  W << GlobalVarsDirtyMark(func);
 
   compile_tracing_profiler(func, W);
 
@@ -323,6 +323,8 @@ void CompilerSettings::init() {
   external_static_libs.emplace_back("vk-flex-data");
   append_if_doesnt_contain(ld_flags.value_, external_static_libs, "-l:lib", ".a");
   external_libs.emplace_back("rt");
+  // the build id tells the server that the old master runs the same binary, its instance cache is handed over on graceful restart
+  ld_flags.value_ += " -Wl,--build-id";
 #endif
   append_if_doesnt_contain(ld_flags.value_, external_libs, "-l");
   ld_flags.value_ += " -rdynamic";
@@ -454,6 +454,10 @@ void ClassData::deeply_require_instance_memory_estimate_visitor() {
   set_atomic_field_deeply<&ClassData::need_instance_memory_estimate_visitor>();
 }
 
+void ClassData::deeply_require_instance_json_visitors() {
+  set_atomic_field_deeply<&ClassData::need_instance_json_visitors>();
+}
+
 void ClassData::deeply_require_virtual_builtin_functions() {
   set_atomic_field_deeply<&ClassData::need_virtual_builtin_functions>();
 }
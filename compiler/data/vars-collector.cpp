@@ -38,6 +38,13 @@ std::vector<std::set<VarPtr>> VarsCollector::flush() {
   return std::move(collected_vars_);
 }
 
+size_t VarsCollector::get_var_part(VarPtr var_id, size_t parts) {
+  const size_t var_hash = var_id->class_id ?
+                          vk::std_hash(var_id->class_id->file_id->main_func_name) :
+                          vk::std_hash(var_id->name);
+  return var_hash % parts;
+}
+
 template<class It>
 void VarsCollector::add_vars(It begin, It end) {
   for (; begin != end; begin++) {
@@ -45,11 +52,6 @@ void VarsCollector::add_vars(It begin, It end) {
     if (vars_checker_ && !vars_checker_(var_id)) {
       continue;
     }
-    const size_t var_hash = var_id->class_id ?
-                            vk::std_hash(var_id->class_id->file_id->main_func_name) :
-                            vk::std_hash(var_id->name);
-
-    const size_t bucket = var_hash % collected_vars_.size();
-    collected_vars_[bucket].emplace(var_id);
+    collected_vars_[get_var_part(var_id, collected_vars_.size())].emplace(var_id);
   }
 }
@@ -17,6 +17,9 @@ public:
   void collect_global_and_static_vars_from(FunctionPtr function);
   std::vector<std::set<VarPtr>> flush();
 
+  // the index of the part the var is collected into, it doesn't depend on the other vars
+  static size_t get_var_part(VarPtr var_id, size_t parts);
+
 private:
   template<class It>
   void add_vars(It begin, It end);
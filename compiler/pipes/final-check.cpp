@@ -91,6 +91,24 @@ void check_instance_to_array_call(VertexAdaptor<op_func_call> call) {
   type->class_type()->deeply_require_instance_to_array_visitor();
 }
 
+void require_instance_json_visitors(ClassPtr klass, const char *function_name) {
+  kphp_error_return(!klass->is_polymorphic_or_has_polymorphic_member(),
+                    fmt_format("You may not use {} with class {}: it has an interface inside", function_name, klass->name));
+  klass->deeply_require_instance_json_visitors();
+}
+
+void check_instance_to_json_call(VertexAdaptor<op_func_call> call) {
+  auto type = tinf::get_type(call->args()[0]);
+  kphp_error_return(type->ptype() == tp_Class, "You may not use instance_to_json with non-instance var");
+  require_instance_json_visitors(type->class_type(), "instance_to_json");
+}
+
+void check_instance_from_json_call(VertexAdaptor<op_func_call> call) {
+  auto klass = tinf::get_type(call)->class_type();
+  kphp_assert(klass);
+  require_instance_json_visitors(klass, "instance_from_json");
+}
+
 void check_estimate_memory_usage_call(VertexAdaptor<op_func_call> call) {
   auto type = tinf::get_type(call->args()[0]);
   std::unordered_set<ClassPtr> classes_inside;
@@ -459,6 +477,10 @@ void FinalCheckPass::check_op_func_call(VertexAdaptor<op_func_call> call) {
       check_instance_cache_store_call(call);
     } else if (function_name == "instance_to_array") {
       check_instance_to_array_call(call);
+    } else if (function_name == "instance_to_json") {
+      check_instance_to_json_call(call);
+    } else if (function_name == "instance_from_json") {
+      check_instance_from_json_call(call);
     } else if (function_name == "estimate_memory_usage") {
       check_estimate_memory_usage_call(call);
     } else if (function_name == "get_global_vars_memory_stats") {
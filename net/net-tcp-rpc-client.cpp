@@ -528,6 +528,23 @@ int tcp_rpcc_start_crypto (struct connection *c, char *nonce, int key_select) {
   return 1;
 }
 
+/* the counters of this process, the workers pass them to the master with the other worker stats */
+long long tcp_rpcc_total_flushes, tcp_rpcc_total_flushed_packets, tcp_rpcc_total_flushed_bytes;
+
+static void tcp_rpcc_account_flush (struct connection *c) {
+  struct tcp_rpc_data *D = TCP_RPC_DATA (c);
+  const int packets = D->out_packet_num - D->out_flushed_packet_num;
+  if (packets <= 0) {
+    return;
+  }
+  const long long bytes = D->out_queued_bytes;
+  D->out_flushed_packet_num = D->out_packet_num;
+  D->out_queued_bytes = 0;
+  tcp_rpcc_total_flushes++;
+  tcp_rpcc_total_flushed_packets += packets;
+  tcp_rpcc_total_flushed_bytes += bytes;
+}
+
 void tcp_rpcc_flush_crypto (struct connection *c) {
   if (c->crypto) {
     int pad_bytes = c->type->crypto_needed_output_bytes (c);
@@ -542,16 +559,19 @@ void tcp_rpcc_flush_crypto (struct connection *c) {
 }
 
 int tcp_rpcc_flush_packet (struct connection *c) {
+  tcp_rpcc_account_flush (c);
   tcp_rpcc_flush_crypto (c);
   return flush_connection_output (c);
 }
 
+/* Doesn't pad the packet: every packet queued till the connection is processed by the event loop
+ * is written with a single write and padded once in tcp_rpcc_flush */
 int tcp_rpcc_flush_packet_later (struct connection *c) {
-  tcp_rpcc_flush_crypto (c);
   return flush_later (c);
 }
 
 int tcp_rpcc_flush (struct connection *c) {
+  tcp_rpcc_account_flush (c);
   if (c->crypto) {
     int pad_bytes = c->type->crypto_needed_output_bytes (c);
     vkprintf (2, "rpcs_flush: padding with %d bytes\n", pad_bytes);
@@ -25,6 +25,7 @@ struct tcp_rpc_client_functions {
   int max_packet_len, mode_flags;
 };
 extern conn_type_t ct_tcp_rpc_client;
+extern long long tcp_rpcc_total_flushes, tcp_rpcc_total_flushed_packets, tcp_rpcc_total_flushed_bytes;
 conn_type_t get_default_tcp_rpc_client_conn_type();
 int tcp_rpcc_parse_execute (struct connection *c);
 int tcp_rpcc_connected (struct connection *c);
@@ -40,6 +40,7 @@ void tcp_rpc_conn_send (struct connection *c, raw_message_t *raw, int flags) {
   rwm_push_data_front (&r, Q, 8);
   unsigned crc32 = rwm_custom_crc32 (&r, r.total_bytes, TCP_RPC_DATA(c)->custom_crc_partial);
   rwm_push_data (&r, &crc32, 4);
+  TCP_RPC_DATA(c)->out_queued_bytes += r.total_bytes;
   rwm_union (&c->out, &r);
 }
 
@@ -63,7 +63,12 @@ struct tcp_rpc_data {
   int extra_int4;
   double extra_double, extra_double2;
   crc32_partial_func_t custom_crc_partial;
+  /* outbound batching counters: every flush pushes all packets queued since the previous one with one write */
+  int out_flushed_packet_num;
+  /* the size of the packets queued since the previous flush, the bytes left unwritten by it aren't counted again */
+  long long out_queued_bytes;
 };
+static_assert(sizeof(struct tcp_rpc_data) <= CONN_CUSTOM_DATA_BYTES, "tcp_rpc_data must fit into connection custom data");
 
 #define	TCP_RPC_DATA(c)	((struct tcp_rpc_data *) ((c)->custom_data))
 
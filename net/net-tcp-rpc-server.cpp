@@ -632,6 +632,8 @@ int tcp_rpcs_init_crypto (struct connection *c, struct tcp_rpc_nonce_packet *P)
 }
 
 int tcp_rpcs_flush_packet (struct connection *c) {
+  /* the queued bytes are accounted only by the client connections */
+  TCP_RPC_DATA(c)->out_queued_bytes = 0;
   if (c->crypto) {
     int pad_bytes = c->type->crypto_needed_output_bytes (c);
     vkprintf (2, "tcp_rpcs_flush_packet: padding with %d bytes\n", pad_bytes);    
@@ -646,6 +648,7 @@ int tcp_rpcs_flush_packet (struct connection *c) {
 }
 
 int tcp_rpcs_flush (struct connection *c) {
+  TCP_RPC_DATA(c)->out_queued_bytes = 0;
   if (c->crypto) {
     int pad_bytes = c->type->crypto_needed_output_bytes (c);
     vkprintf (2, "rpcs_flush: padding with %d bytes\n", pad_bytes);
@@ -0,0 +1,268 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "runtime/aho-corasick.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr int64_t ALPHABET_SIZE = 256;
+// transitions of the first states are stored in a table, 256 KB at most
+constexpr int64_t MAX_DENSE_STATES = 256;
+
+int64_t transition_key(int64_t state, unsigned char c) noexcept {
+  return state * ALPHABET_SIZE + c;
+}
+
+} // namespace
+
+AhoCorasick::AhoCorasick(const array<string> &patterns) noexcept :
+  pattern_states_(array_size(patterns.count(), 0, true)),
+  pattern_lengths_(array_size(patterns.count(), 0, true)) {
+  // the trie, the root is state 0
+  array<int64_t> parent;
+  array<int64_t> label;
+  array<int64_t> depth;
+  array<int64_t> output;
+  array<int64_t> transitions;
+  const auto add_state = [&](int64_t parent_state, unsigned char c) {
+    parent.push_back(parent_state);
+    label.push_back(c);
+    depth.push_back(parent_state == -1 ? 0 : depth.get_value(parent_state) + 1);
+    output.push_back(-1);
+    return depth.count() - 1;
+  };
+  add_state(-1, 0);
+
+  int64_t pattern_index = 0;
+  for (const auto &it : patterns) {
+    const string &pattern = it.get_value();
+    int64_t state = pattern.empty() ? -1 : 0;
+    for (string::size_type i = 0; i < pattern.size(); ++i) {
+      const int64_t key = transition_key(state, static_cast<unsigned char>(pattern[i]));
+      if (const int64_t *next = transitions.find_value(key)) {
+        state = *next;
+      } else {
+        const int64_t new_state = add_state(state, static_cast<unsigned char>(pattern[i]));
+        transitions.set_value(key, new_state);
+        state = new_state;
+      }
+    }
+    if (state != -1 && output.get_value(state) == -1) {
+      output.set_value(state, pattern_index);
+    }
+    pattern_states_.push_back(state);
+    pattern_lengths_.push_back(pattern.size());
+    ++pattern_index;
+  }
+
+  // renumber the states in bfs order: failure states always have smaller numbers then,
+  // and the states visited most often get the dense transition rows
+  const int64_t states_count = depth.count();
+  array<int64_t> depth_counts(array_size(states_count + 1, 0, true));
+  depth_counts.fill_vector(states_count + 1, 0);
+  for (int64_t state = 0; state < states_count; ++state) {
+    ++depth_counts[depth.get_value(state) + 1];
+  }
+  for (int64_t d = 1; d <= states_count; ++d) {
+    depth_counts[d] += depth_counts.get_value(d - 1);
+  }
+  array<int64_t> new_state(array_size(states_count, 0, true));
+  new_state.fill_vector(states_count, 0);
+  for (int64_t state = 0; state < states_count; ++state) {
+    new_state[state] = depth_counts[depth.get_value(state)]++;
+  }
+
+  depth_ = array<int64_t>(array_size(states_count, 0, true));
+  depth_.fill_vector(states_count, 0);
+  output_ = array<int64_t>(array_size(states_count, 0, true));
+  output_.fill_vector(states_count, -1);
+  array<int64_t> renumbered_parent(array_size(states_count, 0, true));
+  renumbered_parent.fill_vector(states_count, 0);
+  array<int64_t> renumbered_label(array_size(states_count, 0, true));
+  renumbered_label.fill_vector(states_count, 0);
+  for (int64_t state = 0; state < states_count; ++state) {
+    const int64_t renumbered = new_state.get_value(state);
+    depth_[renumbered] = depth.get_value(state);
+    output_[renumbered] = output.get_value(state);
+    renumbered_parent[renumbered] = state == 0 ? -1 : new_state.get_value(parent.get_value(state));
+    renumbered_label[renumbered] = label.get_value(state);
+  }
+  for (int64_t i = 0; i < pattern_states_.count(); ++i) {
+    const int64_t state = pattern_states_.get_value(i);
+    if (state != -1) {
+      pattern_states_[i] = new_state.get_value(state);
+    }
+  }
+  for (int64_t state = 1; state < states_count; ++state) {
+    const int64_t renumbered = new_state.get_value(state);
+    transitions_.set_value(transition_key(renumbered_parent.get_value(renumbered), static_cast<unsigned char>(label.get_value(state))), renumbered);
+  }
+
+  dense_states_ = std::min(states_count, MAX_DENSE_STATES);
+  dense_transitions_ = array<int32_t>(array_size(dense_states_ * ALPHABET_SIZE, 0, true));
+  dense_transitions_.fill_vector(dense_states_ * ALPHABET_SIZE, 0);
+  fail_ = array<int64_t>(array_size(states_count, 0, true));
+  fail_.fill_vector(states_count, 0);
+  for (int64_t state = 0; state < states_count; ++state) {
+    const int64_t parent_state = renumbered_parent.get_value(state);
+    if (parent_state > 0) {
+      fail_[state] = next_state(fail_.get_value(parent_state), static_cast<unsigned char>(renumbered_label.get_value(state)));
+    }
+    if (output_.get_value(state) == -1 && state != 0) {
+      output_[state] = output_.get_value(fail_.get_value(state));
+    }
+    if (state < dense_states_) {
+      for (int64_t c = 0; c < ALPHABET_SIZE; ++c) {
+        const int64_t *next = transitions_.find_value(transition_key(state, static_cast<unsigned char>(c)));
+        const int64_t fallback = state == 0 ? 0 : dense_transitions_.get_value(fail_.get_value(state) * ALPHABET_SIZE + c);
+        dense_transitions_[state * ALPHABET_SIZE + c] = static_cast<int32_t>(next ? *next : fallback);
+      }
+    }
+  }
+}
+
+int64_t AhoCorasick::next_state(int64_t state, unsigned char c) const noexcept {
+  // failure states have smaller numbers, so the loop ends up in a dense row
+  while (state >= dense_states_) {
+    if (const int64_t *next = transitions_.find_value(transition_key(state, c))) {
+      return *next;
+    }
+    state = fail_.get_value(state);
+  }
+  return dense_transitions_.get_value(state * ALPHABET_SIZE + c);
+}
+
+int64_t AhoCorasick::find_leftmost_longest(const string &text, int64_t pos, int64_t &match_pos) const noexcept {
+  const int32_t *dense_transitions = dense_transitions_.get_const_vector_pointer();
+  const int64_t *depth = depth_.get_const_vector_pointer();
+  const int64_t *output = output_.get_const_vector_pointer();
+
+  int64_t best = -1;
+  int64_t state = 0;
+  for (int64_t i = pos; i < text.size(); ++i) {
+    const auto c = static_cast<unsigned char>(text[i]);
+    state = state < dense_states_ ? dense_transitions[state * ALPHABET_SIZE + c] : next_state(state, c);
+    // the longest match ending here starts before any shorter one, so it's the only candidate
+    const int64_t found = output[state];
+    if (found != -1) {
+      const int64_t found_pos = i + 1 - pattern_length(found);
+      if (best == -1 || found_pos < match_pos || (found_pos == match_pos && pattern_length(found) > pattern_length(best))) {
+        best = found;
+        match_pos = found_pos;
+      }
+    }
+    // matches which are still possible start after the current best one
+    if (best != -1 && i + 1 - depth[state] > match_pos) {
+      break;
+    }
+  }
+  return best;
+}
+
+void AhoCorasick::find_occurring_patterns(const string &text, array<bool> &found) const noexcept {
+  const int64_t states_count = depth_.count();
+  array<bool> reached(array_size(states_count, 0, true));
+  reached.fill_vector(states_count, false);
+
+  const int32_t *dense_transitions = dense_transitions_.get_const_vector_pointer();
+  int64_t state = 0;
+  for (string::size_type i = 0; i < text.size(); ++i) {
+    const auto c = static_cast<unsigned char>(text[i]);
+    state = state < dense_states_ ? dense_transitions[state * ALPHABET_SIZE + c] : next_state(state, c);
+    reached[state] = true;
+  }
+  // all suffixes of the reached states occur as well
+  for (int64_t i = states_count - 1; i > 0; --i) {
+    if (reached.get_value(i)) {
+      reached[fail_.get_value(i)] = true;
+    }
+  }
+
+  const int64_t count = pattern_states_.count();
+  found = array<bool>(array_size(count, 0, true));
+  for (int64_t i = 0; i < count; ++i) {
+    const int64_t pattern_state = pattern_states_.get_value(i);
+    found.push_back(pattern_state != -1 && reached.get_value(pattern_state));
+  }
+}
+
+namespace {
+
+struct AhoCorasickCacheEntry {
+  const void *dictionary;
+  AhoCorasickCacheKind kind;
+  AhoCorasick *automaton;
+  array<string> *values;
+  void *dictionary_holder;
+  void (*release_dictionary)(void *);
+};
+
+constexpr int64_t AHO_CORASICK_CACHE_SIZE = 16;
+AhoCorasickCacheEntry aho_corasick_cache[AHO_CORASICK_CACHE_SIZE];
+int64_t aho_corasick_cache_size = 0;
+int64_t aho_corasick_cache_next_evicted = 0;
+
+void release_cache_entry(AhoCorasickCacheEntry &entry) noexcept {
+  delete entry.automaton;
+  entry.values->~array<string>();
+  dl::deallocate(entry.values, sizeof(array<string>));
+  entry.release_dictionary(entry.dictionary_holder);
+}
+
+} // namespace
+
+const AhoCorasick *find_cached_aho_corasick(const void *dictionary, AhoCorasickCacheKind kind, array<string> *values) noexcept {
+  for (int64_t i = 0; i < aho_corasick_cache_size; ++i) {
+    const auto &entry = aho_corasick_cache[i];
+    if (entry.dictionary == dictionary && entry.kind == kind) {
+      if (values) {
+        *values = *entry.values;
+      }
+      return entry.automaton;
+    }
+  }
+  return nullptr;
+}
+
+const AhoCorasick *find_cached_aho_corasick_by_values(AhoCorasickCacheKind kind, const array<string> &values) noexcept {
+  for (int64_t i = 0; i < aho_corasick_cache_size; ++i) {
+    const auto &entry = aho_corasick_cache[i];
+    if (entry.kind != kind || entry.values->count() != values.count()) {
+      continue;
+    }
+    const array<string> &cached_values = *entry.values;
+    bool equal = true;
+    for (auto cached_it = cached_values.begin(), it = values.begin(); equal && it != values.end(); ++cached_it, ++it) {
+      equal = cached_it.get_value() == it.get_value();
+    }
+    if (equal) {
+      return entry.automaton;
+    }
+  }
+  return nullptr;
+}
+
+void cache_aho_corasick(const void *dictionary, AhoCorasickCacheKind kind, AhoCorasick *automaton, const array<string> &values,
+                        void *dictionary_holder, void (*release_dictionary)(void *)) noexcept {
+  AhoCorasickCacheEntry *entry = nullptr;
+  if (aho_corasick_cache_size < AHO_CORASICK_CACHE_SIZE) {
+    entry = &aho_corasick_cache[aho_corasick_cache_size++];
+  } else {
+    entry = &aho_corasick_cache[aho_corasick_cache_next_evicted];
+    aho_corasick_cache_next_evicted = (aho_corasick_cache_next_evicted + 1) % AHO_CORASICK_CACHE_SIZE;
+    release_cache_entry(*entry);
+  }
+  auto *values_holder = new(dl::allocate(sizeof(array<string>))) array<string>(values);
+  *entry = AhoCorasickCacheEntry{dictionary, kind, automaton, values_holder, dictionary_holder, release_dictionary};
+}
+
+void free_aho_corasick_lib() noexcept {
+  for (int64_t i = 0; i < aho_corasick_cache_size; ++i) {
+    release_cache_entry(aho_corasick_cache[i]);
+  }
+  aho_corasick_cache_size = 0;
+  aho_corasick_cache_next_evicted = 0;
+}
@@ -0,0 +1,68 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <new>
+
+#include "runtime/allocator.h"
+#include "runtime/kphp_core.h"
+
+// Aho-Corasick automaton over a dictionary of strings, finds all of them in one pass over a text
+class AhoCorasick : public ManagedThroughDlAllocator {
+public:
+  // empty patterns are never found
+  explicit AhoCorasick(const array<string> &patterns) noexcept;
+
+  // the leftmost match in text starting from pos, the longest one among matches at that position, as strtr() needs;
+  // returns the pattern index and sets match_pos, or returns -1 if nothing is found
+  int64_t find_leftmost_longest(const string &text, int64_t pos, int64_t &match_pos) const noexcept;
+
+  // found[i] is set to whether patterns[i] occurs in text
+  void find_occurring_patterns(const string &text, array<bool> &found) const noexcept;
+
+  int64_t pattern_length(int64_t pattern_index) const noexcept {
+    return pattern_lengths_.get_value(pattern_index);
+  }
+
+  ~AhoCorasick() = default;
+
+private:
+  int64_t next_state(int64_t state, unsigned char c) const noexcept;
+
+  int64_t dense_states_{0};
+  array<int32_t> dense_transitions_; // state * 256 + c => state, for the states less than dense_states_
+  array<int64_t> transitions_;       // state * 256 + c => state, trie edges only
+  array<int64_t> fail_;              // the state of the longest proper suffix being a prefix of some pattern
+  array<int64_t> depth_;
+  array<int64_t> output_;            // the longest pattern ending in the state, or -1
+  array<int64_t> pattern_states_;    // pattern index => its final state, or -1 for empty patterns
+  array<int64_t> pattern_lengths_;
+};
+
+enum class AhoCorasickCacheKind {
+  strtr_pairs,
+  str_replace_search,
+};
+
+// Automatons are cached within a request by the identity of the dictionary array they were built from.
+// The cache keeps a reference to the array: it can't be modified in place then (it's copied on write),
+// and its data can't be freed and reused by another array while cached.
+const AhoCorasick *find_cached_aho_corasick(const void *dictionary, AhoCorasickCacheKind kind, array<string> *values) noexcept;
+// The dictionaries built anew on every call miss the identity lookup, they are found by the cached values then;
+// comparing them is much cheaper than building an automaton
+const AhoCorasick *find_cached_aho_corasick_by_values(AhoCorasickCacheKind kind, const array<string> &values) noexcept;
+void cache_aho_corasick(const void *dictionary, AhoCorasickCacheKind kind, AhoCorasick *automaton, const array<string> &values,
+                        void *dictionary_holder, void (*release_dictionary)(void *)) noexcept;
+
+template<class T>
+void cache_aho_corasick(const array<T> &dictionary, AhoCorasickCacheKind kind, AhoCorasick *automaton, const array<string> &values) noexcept {
+  auto *holder = new(dl::allocate(sizeof(array<T>))) array<T>(dictionary);
+  cache_aho_corasick(dictionary.get_inner_pointer(), kind, automaton, values, holder, [](void *kept) {
+    static_cast<array<T> *>(kept)->~array<T>();
+    dl::deallocate(kept, sizeof(array<T>));
+  });
+}
+
+void free_aho_corasick_lib() noexcept;
@@ -62,6 +62,27 @@ size_t get_heap_memory_used() noexcept {
   return get_memory_dealer().get_heap_resource().memory_used();
 }
 
+bool global_init_frozen_memory(size_t max_size) noexcept {
+  php_assert(get_memory_dealer().heap_script_resource_replacer());
+  php_assert(!query_num);
+  return get_memory_dealer().get_frozen_resource().init(max_size);
+}
+
+void freeze_global_init_memory() noexcept {
+  auto &frozen = get_memory_dealer().get_frozen_resource();
+  if (frozen.is_accepting()) {
+    frozen.freeze();
+  }
+}
+
+size_t get_frozen_memory_used() noexcept {
+  return get_memory_dealer().get_frozen_resource().memory_used();
+}
+
+size_t get_frozen_memory_shared() noexcept {
+  return get_memory_dealer().get_frozen_resource().get_shared_memory_size();
+}
+
 void global_init_script_allocator() noexcept {
   auto &dealer = get_memory_dealer();
   php_assert(dealer.heap_script_resource_replacer());
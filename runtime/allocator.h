@@ -27,6 +27,12 @@ void restore_default_script_allocator(bool force_disable) noexcept;
 const memory_resource::MemoryStats &get_script_memory_stats() noexcept;
 size_t get_heap_memory_used() noexcept;
 
+// the memory allocated during the global init between these calls is packed into the segment shared by all the workers
+bool global_init_frozen_memory(size_t max_size) noexcept;
+void freeze_global_init_memory() noexcept;
+size_t get_frozen_memory_used() noexcept;
+size_t get_frozen_memory_shared() noexcept;
+
 void global_init_script_allocator() noexcept;
 void init_script_allocator(void *buffer, size_t buffer_size) noexcept; // init script allocator with arena of n bytes at buf
 void free_script_allocator() noexcept;
@@ -44,6 +44,24 @@ array_size &array_size::min(const array_size &other) {
 
 namespace dl {
 
+// ranges of this size and shorter are finished with insertion sort, the quicksort above them isn't stable
+constexpr int64_t INSERTION_SORT_MAX_SIZE = 16;
+
+template<class T, class T1>
+void insertion_sort(T *begin, T *end, const T1 &compare) {
+  for (T *i = begin + 1; i <= end; ++i) {
+    if (compare(*(i - 1), *i) > 0) {
+      T value = std::move(*i);
+      T *j = i;
+      do {
+        *j = std::move(*(j - 1));
+        --j;
+      } while (j > begin && compare(*(j - 1), value) > 0);
+      *j = std::move(value);
+    }
+  }
+}
+
 template<class T, class T1>
 void sort(T *begin_init, T *end_init, const T1 &compare) {
   T *begin_stack[32];
@@ -56,9 +74,19 @@ void sort(T *begin_init, T *end_init, const T1 &compare) {
     T *begin = begin_stack[depth];
     T *end = end_stack[depth];
 
-    while (begin < end) {
-      const auto offset = (end - begin) >> 1;
-      swap(*begin, begin[offset]);
+    while (end - begin >= INSERTION_SORT_MAX_SIZE) {
+      // the median of the first, the middle and the last elements is the pivot
+      T *middle = begin + ((end - begin) >> 1);
+      if (compare(*begin, *middle) > 0) {
+        swap(*begin, *middle);
+      }
+      if (compare(*middle, *end) > 0) {
+        swap(*middle, *end);
+        if (compare(*begin, *middle) > 0) {
+          swap(*begin, *middle);
+        }
+      }
+      swap(*begin, *middle);
 
       T *i = begin + 1, *j = end;
 
@@ -94,7 +122,165 @@ void sort(T *begin_init, T *end_init, const T1 &compare) {
         begin = j + 1;
       }
     }
+    insertion_sort(begin, end, compare);
+  }
+}
+
+// Which order a comparator puts int64_t and double values in, if it compares them as numbers.
+// Such values are sorted with radix sort, see array<T>::sort
+enum class NumericOrder {
+  none,
+  ascending,
+  descending
+};
+
+template<class T1>
+struct numeric_order : std::integral_constant<NumericOrder, NumericOrder::none> {
+};
+
+// radix sort isn't worth its two passes over the memory on short arrays
+constexpr int64_t RADIX_SORT_MIN_SIZE = 1024;
+
+template<class T>
+using is_radix_sortable = vk::is_type_in_list<T, int64_t, double>;
+
+// int64_t and double values are mapped to uint64_t keys, which are ordered the same way as the values
+inline bool to_radix_key(int64_t value, uint64_t &key) {
+  key = static_cast<uint64_t>(value) ^ (1ULL << 63);
+  return true;
+}
+
+// -0.0 gets the key of 0.0, they are equal for the comparison sort, so the stable radix sort keeps their order
+inline bool to_radix_key(double value, uint64_t &key) {
+  if (std::isnan(value)) {
+    return false;
+  }
+  if (value == 0) {
+    value = 0.0;
+  }
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  key = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+  return true;
+}
+
+template<class T>
+bool to_radix_key(const T &, uint64_t &) {
+  return false;
+}
+
+inline void from_radix_key(uint64_t key, int64_t &value) {
+  value = static_cast<int64_t>(key ^ (1ULL << 63));
+}
+
+inline void from_radix_key(uint64_t key, double &value) {
+  const uint64_t bits = (key >> 63) ? key ^ (1ULL << 63) : ~key;
+  memcpy(&value, &bits, sizeof(value));
+}
+
+template<class T>
+void from_radix_key(uint64_t, T &) {
+}
+
+// the values are restored from their keys, so -0.0 would become 0.0
+inline bool is_negative_zero(double value) {
+  return value == 0 && std::signbit(value);
+}
+
+template<class T>
+bool is_negative_zero(const T &) {
+  return false;
+}
+
+// Stable LSD radix sort by bytes of the keys, the passes over bytes which are the same in all keys are skipped
+template<class Item, class GetKey>
+void radix_sort(Item *items, Item *buffer, int64_t n, const GetKey &get_key) {
+  constexpr int passes = sizeof(uint64_t);
+  uint32_t counts[passes][256] = {};
+  for (int64_t i = 0; i < n; ++i) {
+    const uint64_t key = get_key(items[i]);
+    for (int pass = 0; pass < passes; ++pass) {
+      ++counts[pass][(key >> (8 * pass)) & 0xFF];
+    }
+  }
+
+  const uint64_t first_key = get_key(items[0]);
+  Item *from = items;
+  Item *to = buffer;
+  for (int pass = 0; pass < passes; ++pass) {
+    uint32_t *offsets = counts[pass];
+    if (offsets[(first_key >> (8 * pass)) & 0xFF] == n) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (uint32_t &count : counts[pass]) {
+      const uint32_t bucket_size = count;
+      count = offset;
+      offset += bucket_size;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      to[offsets[(get_key(from[i]) >> (8 * pass)) & 0xFF]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != items) {
+    memcpy(items, from, n * sizeof(Item));
+  }
+}
+
+// sorts values of a vector, returns false if they should be sorted with the comparator
+template<class T>
+bool radix_sort_values(T *values, int64_t n, NumericOrder order) {
+  if (!is_radix_sortable<T>{} || order == NumericOrder::none || n < RADIX_SORT_MIN_SIZE) {
+    return false;
+  }
+
+  const size_t buffer_size = 2 * n * sizeof(uint64_t);
+  auto *keys = static_cast<uint64_t *>(dl::allocate(buffer_size));
+  const uint64_t key_mask = order == NumericOrder::descending ? ~uint64_t{0} : 0;
+  for (int64_t i = 0; i < n; ++i) {
+    if (!to_radix_key(values[i], keys[i]) || is_negative_zero(values[i])) {
+      dl::deallocate(keys, buffer_size);
+      return false;
+    }
+    keys[i] ^= key_mask;
+  }
+  radix_sort(keys, keys + n, n, [](uint64_t key) { return key; });
+  for (int64_t i = 0; i < n; ++i) {
+    from_radix_key(keys[i] ^ key_mask, values[i]);
+  }
+  dl::deallocate(keys, buffer_size);
+  return true;
+}
+
+// sorts hash entries by their values, returns false if they should be sorted with the comparator
+template<class Entry>
+bool radix_sort_entries(Entry **entries, int64_t n, NumericOrder order) {
+  if (!is_radix_sortable<decltype(entries[0]->value)>{} || order == NumericOrder::none || n < RADIX_SORT_MIN_SIZE) {
+    return false;
+  }
+
+  struct Item {
+    uint64_t key;
+    Entry *entry;
+  };
+  const size_t buffer_size = 2 * n * sizeof(Item);
+  auto *items = static_cast<Item *>(dl::allocate(buffer_size));
+  const uint64_t key_mask = order == NumericOrder::descending ? ~uint64_t{0} : 0;
+  for (int64_t i = 0; i < n; ++i) {
+    if (!to_radix_key(entries[i]->value, items[i].key)) {
+      dl::deallocate(items, buffer_size);
+      return false;
+    }
+    items[i].key ^= key_mask;
+    items[i].entry = entries[i];
+  }
+  radix_sort(items, items + n, n, [](const Item &item) { return item.key; });
+  for (int64_t i = 0; i < n; ++i) {
+    entries[i] = items[i].entry;
   }
+  dl::deallocate(items, buffer_size);
+  return true;
 }
 
 } // namespace dl
@@ -1805,6 +1991,21 @@ void array<T>::memcpy_vector(int64_t num, const void *src_buf) {
   p->int_size = static_cast<uint32_t>(num);
 }
 
+template<class T>
+template<class S>
+void array<T>::convert_vector(int64_t num, const S *src_buf) {
+  static_assert(std::is_arithmetic<T>{} && std::is_arithmetic<S>{}, "only arithmetic vectors can be converted element-wise");
+  php_assert(is_vector() && p->int_size == 0 && num <= p->int_buf_size);
+  mutate_if_vector_shared();
+
+  T *dst = reinterpret_cast<T *>(p->int_entries);
+  for (int64_t i = 0; i < num; ++i) {
+    dst[i] = static_cast<T>(src_buf[i]);
+  }
+  p->max_key = num - 1;
+  p->int_size = static_cast<uint32_t>(num);
+}
+
 
 template<class T>
 int64_t array<T>::get_next_key() const {
@@ -1839,7 +2040,9 @@ void array<T>::sort(const T1 &compare, bool renumber) {
         return compare(lhs, rhs) > 0;
       };
     T *begin = reinterpret_cast<T *>(p->int_entries);
-    dl::sort<T, decltype(elements_cmp)>(begin, begin + n, elements_cmp);
+    if (!dl::radix_sort_values(begin, n, dl::numeric_order<T1>::value)) {
+      dl::sort<T, decltype(elements_cmp)>(begin, begin + n, elements_cmp);
+    }
     return;
   }
 
@@ -1864,7 +2067,9 @@ void array<T>::sort(const T1 &compare, bool renumber) {
     [&compare](const int_hash_entry *lhs, const int_hash_entry *rhs) {
       return compare(lhs->value, rhs->value) > 0;
     };
-  dl::sort<int_hash_entry *, decltype(hash_entry_cmp)>(arTmp, arTmp + n, hash_entry_cmp);
+  if (!dl::radix_sort_entries(arTmp, n, dl::numeric_order<T1>::value)) {
+    dl::sort<int_hash_entry *, decltype(hash_entry_cmp)>(arTmp, arTmp + n, hash_entry_cmp);
+  }
 
   arTmp[0]->prev = p->get_pointer(p->end());
   p->end()->next = p->get_pointer(arTmp[0]);
@@ -1887,6 +2092,11 @@ void array<T>::ksort(const T1 &compare) {
     return;
   }
 
+  // keys of a vector are already in the ascending order
+  if (is_vector() && dl::numeric_order<T1>::value == dl::NumericOrder::ascending) {
+    return;
+  }
+
   if (is_vector()) {
     convert_to_map();
   } else {
@@ -2148,6 +2358,11 @@ bool array<T>::is_equal_inner_pointer(const array &other) const noexcept {
   return p == other.p;
 }
 
+template<class T>
+const void *array<T>::get_inner_pointer() const noexcept {
+  return p;
+}
+
 template<class T>
 void swap(array<T> &lhs, array<T> &rhs) {
   lhs.swap(rhs);
@@ -344,6 +344,8 @@ public:
 
   inline void fill_vector(int64_t num, const T &value);
   inline void memcpy_vector(int64_t num, const void *src_buf);
+  template<class S>
+  inline void convert_vector(int64_t num, const S *src_buf);
 
   inline int64_t get_next_key() const __attribute__ ((always_inline));
 
@@ -416,6 +418,7 @@ public:
   const T *get_const_vector_pointer() const; // unsafe
 
   bool is_equal_inner_pointer(const array &other) const noexcept;
+  const void *get_inner_pointer() const noexcept; // identity of the array data, e.g. to cache something built from it
 
   void reserve(int64_t int_size, int64_t string_size, bool make_vector_if_possible);
 
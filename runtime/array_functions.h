@@ -1291,6 +1291,18 @@ struct sort_compare_natural {
   }
 };
 
+namespace dl {
+
+template<class T>
+struct numeric_order<sort_compare<T>> : std::integral_constant<NumericOrder, NumericOrder::ascending> {
+};
+
+template<class T>
+struct numeric_order<sort_compare_numeric<T>> : std::integral_constant<NumericOrder, NumericOrder::ascending> {
+};
+
+} // namespace dl
+
 template<class T>
 void f$sort(array<T> &a, int64_t flag) {
   switch (flag) {
@@ -1333,6 +1345,18 @@ struct rsort_compare_string {
   }
 };
 
+namespace dl {
+
+template<class T>
+struct numeric_order<rsort_compare<T>> : std::integral_constant<NumericOrder, NumericOrder::descending> {
+};
+
+template<class T>
+struct numeric_order<rsort_compare_numeric<T>> : std::integral_constant<NumericOrder, NumericOrder::descending> {
+};
+
+} // namespace dl
+
 template<class T>
 void f$rsort(array<T> &a, int64_t flag) {
   switch (flag) {
@@ -5,13 +5,22 @@
 #include "runtime/instance-cache.h"
 
 #include <chrono>
+#include <cstring>
 #include <forward_list>
 #include <map>
 #include <mutex>
+#include <string>
 #include <unordered_set>
 
+#if !defined(__APPLE__)
+#include <elf.h>
+#include <link.h>
+#endif
+
+#include "common/algorithms/hashes.h"
 #include "common/kprintf.h"
 #include "common/wrappers/memory-utils.h"
+#include "common/wrappers/string_view.h"
 
 #include "runtime/allocator.h"
 #include "runtime/critical_section.h"
@@ -20,6 +29,16 @@
 #include "runtime/memory_resource/resource_allocator.h"
 #include "runtime/refcountable_php_classes.h"
 
+#ifndef MAP_FIXED_NOREPLACE
+  #define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+#if !defined(__APPLE__)
+// the bounds of the binary image set by the linker
+extern "C" char __executable_start[];
+extern "C" char _end[];
+#endif
+
 namespace impl_ {
 
 //#define DEBUG_INSTANCE_CACHE
@@ -126,7 +145,28 @@ public:
   std::atomic<ElementHolder *> next_in_garbage_list{nullptr};
 };
 
-using ElementStorage_ = memory_resource::stl::map<string, vk::intrusive_ptr<ElementHolder>, memory_resource::unsynchronized_pool_resource, stl_string_less>;
+// the keys can be also compared with the ones kept out of the cache memory, e.g. with the last copied one on the handover
+struct ElementKeyLess : stl_string_less {
+  using is_transparent = void;
+  using stl_string_less::operator();
+
+  bool operator()(const string &lhs, vk::string_view rhs) const noexcept {
+    return compare(lhs, rhs) < 0;
+  }
+
+  bool operator()(vk::string_view lhs, const string &rhs) const noexcept {
+    return compare(rhs, lhs) > 0;
+  }
+
+private:
+  // the same order as string::compare()
+  static int64_t compare(const string &lhs, vk::string_view rhs) noexcept {
+    const int res = memcmp(lhs.c_str(), rhs.data(), std::min<size_t>(lhs.size(), rhs.size()));
+    return res ? res : static_cast<int64_t>(lhs.size()) - static_cast<int64_t>(rhs.size());
+  }
+};
+
+using ElementStorage_ = memory_resource::stl::map<string, vk::intrusive_ptr<ElementHolder>, memory_resource::unsynchronized_pool_resource, ElementKeyLess>;
 
 struct SharedDataStorages : private vk::not_copyable {
   explicit SharedDataStorages(memory_resource::unsynchronized_pool_resource &resource) :
@@ -165,7 +205,15 @@ public:
     php_assert(!shared_memory_);
     shared_memory_pool_size_ = pool_size;
     share_memory_full_size_ = get_context_size() + get_data_size() + shared_memory_pool_size_;
-    shared_memory_ = mmap_shared(share_memory_full_size_);
+#if !defined(__APPLE__)
+    // the memory backed by the file can be handed over to the new master on graceful restart
+    shared_memory_fd_ = memfd_create("instance_cache", MFD_CLOEXEC);
+    if (shared_memory_fd_ != -1 && ftruncate(shared_memory_fd_, static_cast<off_t>(share_memory_full_size_)) != 0) {
+      close(shared_memory_fd_);
+      shared_memory_fd_ = -1;
+    }
+#endif
+    shared_memory_ = mmap_shared(share_memory_full_size_, shared_memory_fd_);
     construct_data_inplace();
   }
 
@@ -198,6 +246,17 @@ public:
     return *cache_context_;
   }
 
+  InstanceCacheSharedMemory get_shared_memory() const noexcept {
+    return {shared_memory_fd_, shared_memory_, share_memory_full_size_};
+  }
+
+  // the shards placed in the same way by other process
+  static SharedDataStorages *get_data_shards_of(void *shared_memory, size_t size) noexcept {
+    return size > get_context_size() + get_data_size()
+           ? reinterpret_cast<SharedDataStorages *>(static_cast<uint8_t *>(shared_memory) + get_context_size())
+           : nullptr;
+  }
+
 private:
   void destroy_data() noexcept {
     php_assert(data_shards_);
@@ -229,6 +288,7 @@ private:
   }
 
   void *shared_memory_{nullptr};
+  int shared_memory_fd_{-1};
   size_t share_memory_full_size_{0};
   size_t shared_memory_pool_size_{0};
   CacheContext *cache_context_{nullptr};
@@ -524,7 +584,163 @@ public:
     return last_memory_stats_;
   }
 
+  // this function should be called only from master
+  InstanceCacheSharedMemory get_shared_memory() noexcept {
+    return data_manager_.get_current_resource().get_shared_memory();
+  }
+
+  // this function should be called only from master
+  bool start_elements_take_over(const InstanceCacheSharedMemory &other_memory) noexcept {
+#if defined(__APPLE__)
+    static_cast<void>(other_memory);
+    return false;
+#else
+    php_assert(!take_over_.other_data_shards);
+    // the elements refer to each other by the pointers, so the memory is mapped at the same address as in the other master,
+    // it's writable as the shard mutexes placed in it are locked, but nothing else is written there
+    void *other_shared_memory = mmap(other_memory.address, other_memory.size, PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_FIXED_NOREPLACE, other_memory.fd, 0);
+    if (other_shared_memory == MAP_FAILED) {
+      return false;
+    }
+    // the old kernels take the address as a hint
+    SharedDataStorages *other_data_shards = SharedMemoryData::get_data_shards_of(other_shared_memory, other_memory.size);
+    // the workers forked while the elements are copied mustn't keep the memory of the other master after it has exited
+    if (other_shared_memory != other_memory.address || !other_data_shards ||
+        madvise(other_shared_memory, other_memory.size, MADV_DONTFORK) != 0) {
+      munmap(other_shared_memory, other_memory.size);
+      return false;
+    }
+    take_over_ = ElementsTakeOver{};
+    take_over_.other_memory = other_shared_memory;
+    take_over_.other_memory_size = other_memory.size;
+    take_over_.other_data_shards = other_data_shards;
+    return true;
+#endif
+  }
+
+  // this function should be called only from master
+  bool take_over_next_elements(InstanceCacheHandoverStats &handover_stats, size_t max_elements) noexcept {
+#if defined(__APPLE__)
+    static_cast<void>(handover_stats);
+    static_cast<void>(max_elements);
+    return true;
+#else
+    php_assert(take_over_.other_data_shards);
+    update_now();
+    auto &current_data = data_manager_.get_current_resource();
+    auto &context = current_data.get_context();
+    dl::MemoryReplacementGuard shared_memory_guard{context.memory_resource, true};
+
+    // the constant strings and arrays can be placed in the binary, it's the same for both masters,
+    // but not in the memory allocated by the other master, e.g. the constants built on the global init
+    const std::vector<InstanceReferencesCheckVisitor::MemoryRange> accessible_memory{
+      {take_over_.other_memory, static_cast<uint8_t *>(take_over_.other_memory) + take_over_.other_memory_size},
+      {__executable_start, _end}
+    };
+    for (; take_over_.shard_id != DATA_SHARDS_COUNT; ++take_over_.shard_id, take_over_.shard_started = false) {
+      auto &other_data_shard = take_over_.other_data_shards[take_over_.shard_id];
+      if (other_data_shard.is_storage_empty.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      // the element can't be removed by the other master while the shard is locked,
+      // the shard is unlocked between the batches, so the other workers aren't blocked for the whole copying
+      std::lock_guard<inter_process_mutex> other_data_lock{other_data_shard.storage_mutex};
+      const auto &other_storage = other_data_shard.storage;
+      // the elements can be added or removed meanwhile, the copying is continued after the last passed key
+      auto it = take_over_.shard_started ? other_storage.upper_bound(vk::string_view{take_over_.last_key}) : other_storage.begin();
+      for (; it != other_storage.end(); ++it) {
+        if (!max_elements) {
+          return false;
+        }
+        --max_elements;
+        InstanceReferencesCheckVisitor checker{accessible_memory};
+        // the keys are compared on resuming, so the rest of the shard isn't passed after the key that can't be read
+        if (!checker.is_accessible(it->first.c_str())) {
+          ++handover_stats.elements_skipped;
+          break;
+        }
+        take_over_.last_key.assign(it->first.c_str(), it->first.size());
+        take_over_.shard_started = true;
+        switch (take_over_element(current_data, it->first, it->second.get(), checker)) {
+          case TakeOverStatus::transferred:
+            ++handover_stats.elements_transferred;
+            break;
+          case TakeOverStatus::skipped:
+            ++handover_stats.elements_skipped;
+            break;
+          case TakeOverStatus::memory_limit_exceeded:
+            ++handover_stats.elements_skipped;
+            finish_elements_take_over();
+            return true;
+        }
+      }
+    }
+    finish_elements_take_over();
+    return true;
+#endif
+  }
+
 private:
+  enum class TakeOverStatus {
+    transferred,
+    skipped,
+    memory_limit_exceeded
+  };
+
+  TakeOverStatus take_over_element(SharedMemoryData &current_data, const string &other_key, const ElementHolder *other_element,
+                                   InstanceReferencesCheckVisitor &checker) noexcept {
+    if (!checker.is_accessible(other_key.c_str()) || !checker.is_accessible(other_element) ||
+        other_element->expiring_at <= now_ || !checker.is_accessible(other_element->instance_wrapper.get()) ||
+        !other_element->instance_wrapper->check_references(checker)) {
+      return TakeOverStatus::skipped;
+    }
+
+    auto &context = current_data.get_context();
+    auto &data = current_data.get_data(other_key);
+    // lock in this very order, as in purge_expired()
+    std::lock_guard<inter_process_mutex> allocator_lock{context.allocator_mutex};
+    auto clear_garbage = vk::finally([&context] { context.clear_garbage(); });
+    std::lock_guard<inter_process_mutex> shared_data_lock{data.storage_mutex};
+    // the new workers could have stored the fresher one
+    if (data.storage.find(other_key) != data.storage.end()) {
+      return TakeOverStatus::skipped;
+    }
+
+    InstanceDeepCopyVisitor detach_processor{context.memory_resource, ExtraRefCnt::for_instance_cache};
+    // the other master's workers can copy the same element at the moment
+    detach_processor.keep_copied_instances_aside();
+    auto cached_instance_wrapper = other_element->instance_wrapper->deep_copy_and_set_ref_cnt(detach_processor);
+    void *mem = cached_instance_wrapper ? detach_processor.prepare_raw_memory(sizeof(ElementHolder)) : nullptr;
+    if (!mem) {
+      return detach_processor.is_memory_limit_exceeded() ? TakeOverStatus::memory_limit_exceeded : TakeOverStatus::skipped;
+    }
+    vk::intrusive_ptr<ElementHolder> element{new(mem) ElementHolder{now_, 0, std::move(cached_instance_wrapper), context}};
+    element->stored_at = other_element->stored_at;
+    element->expiring_at = other_element->expiring_at;
+
+    string key_in_shared_memory = other_key;
+    if (unlikely(!detach_processor.process(key_in_shared_memory))) {
+      return TakeOverStatus::memory_limit_exceeded;
+    }
+    constexpr auto node_max_size = ElementStorage_::allocator_type::max_value_type_size();
+    if (unlikely(!detach_processor.is_enough_memory_for(node_max_size))) {
+      InstanceDeepDestroyVisitor{ExtraRefCnt::for_instance_cache}.process(key_in_shared_memory);
+      return TakeOverStatus::memory_limit_exceeded;
+    }
+    data.storage.emplace(std::move(key_in_shared_memory), std::move(element));
+    data.is_storage_empty.store(false, std::memory_order_relaxed);
+    context.stats.elements_cached.fetch_add(1, std::memory_order_relaxed);
+    return TakeOverStatus::transferred;
+  }
+
+  void finish_elements_take_over() noexcept {
+#if !defined(__APPLE__)
+    munmap(take_over_.other_memory, take_over_.other_memory_size);
+#endif
+    take_over_ = ElementsTakeOver{};
+  }
+
   bool is_element_insertion_can_be_skipped(SharedDataStorages &data, const string &key) const {
     std::lock_guard<inter_process_mutex> shared_data_lock{data.storage_mutex};
     auto it = data.storage.find(key);
@@ -667,6 +883,17 @@ private:
   std::chrono::nanoseconds now_{std::chrono::nanoseconds::zero()};
   memory_resource::MemoryStats last_memory_stats_;
   size_t purge_shard_offset_{0};
+
+  // The memory of the other master mapped at the same address, its elements are copied in batches
+  struct ElementsTakeOver {
+    void *other_memory{nullptr};
+    size_t other_memory_size{0};
+    SharedDataStorages *other_data_shards{nullptr};
+    size_t shard_id{0};
+    bool shard_started{false};
+    std::string last_key;
+  };
+  ElementsTakeOver take_over_;
 };
 
 bool instance_cache_store(const string &key, const InstanceCopyistBase &instance_wrapper, int64_t ttl) {
@@ -720,6 +947,63 @@ void instance_cache_release_all_resources_acquired_by_this_proc() {
   impl_::InstanceCache::get().force_release_all_resources();
 }
 
+// should be called only from master
+uint64_t instance_cache_get_layout_hash() {
+#if defined(__APPLE__)
+  return 0;
+#else
+  // the cached elements refer to the vtables and the constants of the binary, so its memory is readable only by the same binary
+  // loaded at the same address, the build id of the position dependent executable identifies it
+  size_t build_id_hash = 0;
+  dl_iterate_phdr([](dl_phdr_info *info, size_t, void *data) {
+    // the first one is the executable, it's loaded at the address from the headers only if it's position dependent
+    if (info->dlpi_addr != 0) {
+      return 1;
+    }
+    for (ElfW(Half) i = 0; i != info->dlpi_phnum; ++i) {
+      const ElfW(Phdr) &header = info->dlpi_phdr[i];
+      if (header.p_type != PT_NOTE) {
+        continue;
+      }
+      const char *note = reinterpret_cast<const char *>(info->dlpi_addr + header.p_vaddr);
+      const char *notes_end = note + header.p_memsz;
+      while (note + sizeof(ElfW(Nhdr)) <= notes_end) {
+        const auto *note_header = reinterpret_cast<const ElfW(Nhdr) *>(note);
+        const char *name = note + sizeof(ElfW(Nhdr));
+        const char *desc = name + ((note_header->n_namesz + 3) & ~3u);
+        if (note_header->n_type == NT_GNU_BUILD_ID && note_header->n_namesz == 4 && !std::memcmp(name, "GNU", 4)) {
+          *static_cast<size_t *>(data) = vk::std_hash(vk::string_view{desc, note_header->n_descsz});
+          return 1;
+        }
+        note = desc + ((note_header->n_descsz + 3) & ~3u);
+      }
+    }
+    return 1;
+  }, &build_id_hash);
+  if (!build_id_hash) {
+    return 0;
+  }
+  vk::hash_combine(build_id_hash, vk::hash_sequence(sizeof(impl_::CacheContext), sizeof(impl_::SharedDataStorages),
+                                                    sizeof(impl_::ElementHolder), impl_::DATA_SHARDS_COUNT));
+  return std::max<uint64_t>(build_id_hash, 1);
+#endif
+}
+
+// should be called only from master
+InstanceCacheSharedMemory instance_cache_get_shared_memory() {
+  return impl_::InstanceCache::get().get_shared_memory();
+}
+
+// should be called only from master
+bool instance_cache_start_elements_take_over(const InstanceCacheSharedMemory &other_memory) {
+  return impl_::InstanceCache::get().start_elements_take_over(other_memory);
+}
+
+// should be called only from master
+bool instance_cache_take_over_next_elements(InstanceCacheHandoverStats &stats, size_t max_elements) {
+  return impl_::InstanceCache::get().take_over_next_elements(stats, max_elements);
+}
+
 bool f$instance_cache_update_ttl(const string &key, int64_t ttl) {
   return impl_::InstanceCache::get().update_ttl(key, ttl);
 }
@@ -70,6 +70,31 @@ void instance_cache_purge_expired_elements();
 
 void instance_cache_release_all_resources_acquired_by_this_proc();
 
+struct InstanceCacheSharedMemory {
+  int fd{-1};
+  void *address{nullptr};
+  size_t size{0};
+};
+
+struct InstanceCacheHandoverStats {
+  uint64_t elements_transferred{0};
+  uint64_t elements_skipped{0};
+};
+
+// these function should be called from master
+// the memory of the cache can be read only by the master with the same layout hash, 0 means that it can't be read at all
+uint64_t instance_cache_get_layout_hash();
+// these function should be called from master
+InstanceCacheSharedMemory instance_cache_get_shared_memory();
+// these function should be called from master
+// maps the cache memory of other master with the same layout hash at the same address as in that master,
+// returns false if it's impossible
+bool instance_cache_start_elements_take_over(const InstanceCacheSharedMemory &other_memory);
+// these function should be called from master
+// copies up to max_elements live elements from the memory mapped by instance_cache_start_elements_take_over(),
+// returns true and unmaps the memory when all the elements are passed
+bool instance_cache_take_over_next_elements(InstanceCacheHandoverStats &stats, size_t max_elements);
+
 template<typename ClassInstanceType>
 bool f$instance_cache_store(const string &key, const ClassInstanceType &instance, int64_t ttl = 0) {
   static_assert(is_class_instance<ClassInstanceType>::value, "class_instance<> type expected");
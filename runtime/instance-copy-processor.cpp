@@ -4,6 +4,8 @@
 
 #include "runtime/instance-copy-processor.h"
 
+#include <algorithm>
+
 InstanceDeepCopyVisitor::InstanceDeepCopyVisitor(memory_resource::unsynchronized_pool_resource &memory_pool,
                                                  ExtraRefCnt memory_ref_cnt, ResourceCallbackOOM oom_callback) noexcept:
   Basic(*this, memory_ref_cnt),
@@ -15,6 +17,17 @@ InstanceDeepDestroyVisitor::InstanceDeepDestroyVisitor(ExtraRefCnt memory_ref_cn
   Basic(*this, memory_ref_cnt) {
 }
 
+InstanceReferencesCheckVisitor::InstanceReferencesCheckVisitor(std::vector<MemoryRange> accessible_memory) noexcept:
+  Basic(*this),
+  accessible_memory_(std::move(accessible_memory)) {
+}
+
+bool InstanceReferencesCheckVisitor::is_accessible(const void *ptr) const noexcept {
+  return std::any_of(accessible_memory_.begin(), accessible_memory_.end(), [ptr](const MemoryRange &range) {
+    return range.begin <= ptr && ptr < range.end;
+  });
+}
+
 bool InstanceDeepCopyVisitor::process(string &str) noexcept {
   if (str.is_reference_counter(ExtraRefCnt::for_global_const)) {
     return true;
@@ -5,7 +5,10 @@
 #pragma once
 
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "common/mixin/not_copyable.h"
 
@@ -197,8 +200,18 @@ public:
     return is_enough_memory_for(size) ? memory_pool_.allocate(size) : nullptr;
   }
 
+  // The copied instances are marked with their unique index, so the instances referred several times are copied once.
+  // The instances placed by other process can be read by that process at the same time and mustn't be written,
+  // so the copies of them are kept in the visitor instead.
+  void keep_copied_instances_aside() noexcept {
+    keep_copied_instances_aside_ = true;
+  }
+
   template<class I>
   bool process_instance(class_instance<I> &instance) noexcept {
+    if (keep_copied_instances_aside_) {
+      return process(instance);
+    }
     class_instance<I> instance_copy = instance;
     const bool result = process(instance);
     InstanceUniqueIndexVisitor{[](uint32_t &index) { return !!std::exchange(index, 0); }}.process_instance(instance_copy);
@@ -212,9 +225,16 @@ private:
       return true;
     }
 
-    uint32_t &reduced_ptr = instance.get()->get_unique_index_ref();
-    if (reduced_ptr) {
-      instance = class_instance<I>::create_from_base_raw_ptr(expand_ptr(reduced_ptr));
+    void *original_ptr = instance.get_base_raw_ptr();
+    uint32_t &original_index = instance.get()->get_unique_index_ref();
+    if (keep_copied_instances_aside_) {
+      auto copied = copied_instances_.find(original_ptr);
+      if (copied != copied_instances_.end()) {
+        instance = class_instance<I>::create_from_base_raw_ptr(copied->second);
+        return true;
+      }
+    } else if (original_index) {
+      instance = class_instance<I>::create_from_base_raw_ptr(expand_ptr(original_index));
       return true;
     }
 
@@ -224,7 +244,13 @@ private:
     }
 
     instance = instance.virtual_builtin_clone();
-    reduced_ptr = reduce_ptr(instance.get_base_raw_ptr());
+    if (keep_copied_instances_aside_) {
+      // the index is copied from the original, which can be marked by the other process at the moment
+      instance.get()->get_unique_index_ref() = 0;
+      copied_instances_.emplace(original_ptr, instance.get_base_raw_ptr());
+    } else {
+      original_index = reduce_ptr(instance.get_base_raw_ptr());
+    }
 
     if (const auto extra_ref_cnt = get_memory_ref_cnt()) {
       instance.set_reference_counter_to(extra_ref_cnt);
@@ -289,6 +315,8 @@ private:
   bool memory_limit_exceeded_{false};
   memory_resource::unsynchronized_pool_resource &memory_pool_;
   ResourceCallbackOOM oom_callback_{nullptr};
+  bool keep_copied_instances_aside_{false};
+  std::unordered_map<const void *, void *> copied_instances_;
 };
 
 class InstanceDeepDestroyVisitor : impl_::InstanceDeepBasicVisitor<InstanceDeepDestroyVisitor> {
@@ -346,11 +374,66 @@ private:
   }
 };
 
+// Checks that all the strings, arrays and instances reachable from the instance are placed in the accessible memory,
+// nothing is read from them before the check. It's used for the instances placed by other process,
+// which can refer to the memory of that process not mapped into this one.
+class InstanceReferencesCheckVisitor : impl_::InstanceDeepBasicVisitor<InstanceReferencesCheckVisitor> {
+public:
+  friend class impl_::InstanceDeepBasicVisitor<InstanceReferencesCheckVisitor>;
+
+  using Basic = impl_::InstanceDeepBasicVisitor<InstanceReferencesCheckVisitor>;
+  using Basic::operator();
+  using Basic::is_ok;
+
+  struct MemoryRange {
+    const void *begin{nullptr};
+    const void *end{nullptr};
+  };
+
+  explicit InstanceReferencesCheckVisitor(std::vector<MemoryRange> accessible_memory) noexcept;
+
+  bool is_accessible(const void *ptr) const noexcept;
+
+  bool process(string &str) noexcept {
+    return is_accessible(str.c_str());
+  }
+
+  template<class I>
+  bool process_instance(class_instance<I> &instance) noexcept {
+    return process(instance);
+  }
+
+private:
+  using Basic::process;
+
+  template<class T>
+  bool process(array<T> &arr) noexcept {
+    return is_accessible(arr.get_inner_pointer()) && Basic::process_range(arr.begin_no_mutate(), arr.end_no_mutate());
+  }
+
+  template<class I>
+  bool process(class_instance<I> &instance) noexcept {
+    if (instance.is_null()) {
+      return true;
+    }
+    const void *ptr = instance.get();
+    if (!is_accessible(ptr)) {
+      return false;
+    }
+    // the instances can refer to each other
+    return !visited_instances_.emplace(ptr).second || Basic::process(instance);
+  }
+
+  std::vector<MemoryRange> accessible_memory_;
+  std::unordered_set<const void *> visited_instances_;
+};
+
 class InstanceCopyistBase : public ManagedThroughDlAllocator, vk::not_copyable {
 public:
   virtual const char *get_class() const noexcept = 0;
   virtual std::unique_ptr<InstanceCopyistBase> deep_copy_and_set_ref_cnt(InstanceDeepCopyVisitor &detach_processor) const noexcept = 0;
   virtual std::unique_ptr<InstanceCopyistBase> shallow_copy() const noexcept = 0;
+  virtual bool check_references(InstanceReferencesCheckVisitor &checker) const noexcept = 0;
   virtual ~InstanceCopyistBase() noexcept = default;
 };
 
@@ -392,6 +475,11 @@ public:
     return make_unique_on_script_memory<InstanceCopyistImpl<class_instance<I>>>(instance_);
   }
 
+  bool check_references(InstanceReferencesCheckVisitor &checker) const noexcept final {
+    // the instance isn't copied, its reference counter can't be touched before the check
+    return checker.process_instance(const_cast<class_instance<I> &>(instance_));
+  }
+
   class_instance<I> get_instance() const noexcept {
     return instance_;
   }
@@ -0,0 +1,315 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2020 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+#include "common/algorithms/hashes.h"
+#include "common/mixin/not_copyable.h"
+
+#include "runtime/json-functions.h"
+#include "runtime/kphp_core.h"
+
+// Instances are encoded into json objects with their fields as keys, tuples and shapes are encoded into json arrays.
+// The compiler generates accept(InstanceToJsonVisitor &) and json_parse_field() methods for the classes,
+// the latter finds a field by its name with a perfect hash and parses its value straight from the json string.
+
+namespace impl_ {
+
+template<size_t Index, class Tuple>
+auto &json_element(Tuple &tuple) noexcept {
+  return std::get<Index>(tuple);
+}
+
+template<size_t Index, class Indexes, class ...T>
+auto &json_element(shape<Indexes, T...> &shape) noexcept {
+  return shape.template get<Index>();
+}
+
+template<size_t Index, class Indexes, class ...T>
+const auto &json_element(const shape<Indexes, T...> &shape) noexcept {
+  return shape.template get<Index>();
+}
+
+} // namespace impl_
+
+class InstanceToJsonVisitor : vk::not_copyable {
+public:
+  explicit InstanceToJsonVisitor(const impl_::JsonEncoder &encoder) noexcept :
+    encoder_(encoder) {
+  }
+
+  template<class T>
+  void operator()(const char *field_name, const T &value) noexcept {
+    if (!first_field_) {
+      static_SB << ',';
+    }
+    first_field_ = false;
+    static_SB << '"' << field_name << "\":";
+    is_ok_ &= encoder_.encode(value);
+  }
+
+  bool is_ok() const noexcept {
+    return is_ok_;
+  }
+
+private:
+  const impl_::JsonEncoder &encoder_;
+  bool first_field_{true};
+  bool is_ok_{true};
+};
+
+template<class I>
+bool impl_::JsonEncoder::encode(const class_instance<I> &instance) const noexcept {
+  if (instance.is_null()) {
+    return encode_null();
+  }
+  return encode_instance_fields(instance, std::is_empty<I>{});
+}
+
+template<class I>
+bool impl_::JsonEncoder::encode_instance_fields(const class_instance<I> &, std::true_type /*is_empty*/) const noexcept {
+  static_SB.append("{}", 2);
+  return true;
+}
+
+template<class I>
+bool impl_::JsonEncoder::encode_instance_fields(const class_instance<I> &instance, std::false_type /*is_empty*/) const noexcept {
+  InstanceToJsonVisitor visitor{*this};
+  static_SB << '{';
+  instance.get()->accept(visitor);
+  static_SB << '}';
+  return visitor.is_ok() || (options_ & JSON_PARTIAL_OUTPUT_ON_ERROR);
+}
+
+template<class ...Args>
+bool impl_::JsonEncoder::encode(const std::tuple<Args...> &tuple) const noexcept {
+  return encode_elements(tuple, std::index_sequence_for<Args...>{});
+}
+
+template<size_t ...Is, class ...T>
+bool impl_::JsonEncoder::encode(const shape<std::index_sequence<Is...>, T...> &shape) const noexcept {
+  // shape doesn't have key names at runtime, so it's encoded like a tuple
+  return encode_elements(shape, std::index_sequence<Is...>{});
+}
+
+template<class Tuple, size_t ...Is>
+bool impl_::JsonEncoder::encode_elements(const Tuple &elements, std::index_sequence<Is...>) const noexcept {
+  bool is_ok = true;
+  size_t position = 0;
+  auto encode_element = [this, &is_ok, &position](const auto &element) {
+    if (position++ != 0) {
+      static_SB << ',';
+    }
+    is_ok &= this->encode(element) || (options_ & JSON_PARTIAL_OUTPUT_ON_ERROR);
+  };
+  static_cast<void>(encode_element);
+
+  static_SB << '[';
+  std::initializer_list<int32_t>{(encode_element(json_element<Is>(elements)), 0)...};
+  static_SB << ']';
+  return is_ok;
+}
+
+// Parses json into typed values without building mixed, a value is rejected if its json type doesn't match
+class InstanceFromJsonParser : vk::not_copyable {
+public:
+  explicit InstanceFromJsonParser(const string &json) noexcept;
+
+  bool parse(bool &value) noexcept;
+  bool parse(int64_t &value) noexcept;
+  bool parse(double &value) noexcept;
+  bool parse(string &value) noexcept;
+  bool parse(mixed &value) noexcept;
+
+  template<class T>
+  bool parse(Optional<T> &value) noexcept;
+
+  template<class T>
+  bool parse(array<T> &value) noexcept;
+
+  template<class I>
+  bool parse(class_instance<I> &instance) noexcept;
+
+  template<class ...Args>
+  bool parse(std::tuple<Args...> &value) noexcept;
+
+  template<size_t ...Is, class ...T>
+  bool parse(shape<std::index_sequence<Is...>, T...> &value) noexcept;
+
+  // skips a value of an unknown field
+  bool skip_value() noexcept;
+
+  // only blanks are left after the parsed value
+  bool is_finished() noexcept;
+
+  int64_t get_pos() const noexcept {
+    return pos_;
+  }
+
+private:
+  // skips blanks and consumes the literal if it goes next
+  bool parse_literal(const char *literal, int len) noexcept;
+  bool parse_char(char c) noexcept {
+    return parse_literal(&c, 1);
+  }
+  bool parse_scalar(mixed &value) noexcept;
+  // points key to the json string itself unless the key has escaped characters
+  bool parse_key(const char *&key, size_t &key_len, string &unescaped_key) noexcept;
+
+  template<class F>
+  bool parse_object_fields(F &&parse_field) noexcept;
+
+  template<class F>
+  bool parse_array_elements(F &&parse_element) noexcept;
+
+  template<class I>
+  bool parse_instance_fields(class_instance<I> &instance, std::true_type /*is_empty*/) noexcept;
+
+  template<class I>
+  bool parse_instance_fields(class_instance<I> &instance, std::false_type /*is_empty*/) noexcept;
+
+  template<class Tuple, size_t ...Is>
+  bool parse_elements(Tuple &elements, std::index_sequence<Is...>) noexcept;
+
+  const char *json_{nullptr};
+  int json_len_{0};
+  int pos_{0};
+};
+
+template<class T>
+bool InstanceFromJsonParser::parse(Optional<T> &value) noexcept {
+  if (parse_literal("null", 4)) {
+    value = Optional<T>{};
+    return true;
+  }
+  if (parse_literal("false", 5)) {
+    value = false;
+    return true;
+  }
+  T inner{};
+  if (!parse(inner)) {
+    return false;
+  }
+  value = std::move(inner);
+  return true;
+}
+
+template<class T>
+bool InstanceFromJsonParser::parse(array<T> &value) noexcept {
+  value = array<T>{};
+  if (parse_char('[')) {
+    return parse_array_elements([this, &value] {
+      T element{};
+      if (!parse(element)) {
+        return false;
+      }
+      value.push_back(std::move(element));
+      return true;
+    });
+  }
+  if (parse_char('{')) {
+    return parse_object_fields([this, &value](const char *key, size_t key_len) {
+      T element{};
+      if (!parse(element)) {
+        return false;
+      }
+      value.set_value(string{key, static_cast<string::size_type>(key_len)}, std::move(element));
+      return true;
+    });
+  }
+  return false;
+}
+
+template<class I>
+bool InstanceFromJsonParser::parse(class_instance<I> &instance) noexcept {
+  instance.destroy();
+  if (parse_literal("null", 4)) {
+    return true;
+  }
+  return parse_char('{') && parse_instance_fields(instance, std::is_empty<I>{});
+}
+
+template<class I>
+bool InstanceFromJsonParser::parse_instance_fields(class_instance<I> &instance, std::true_type /*is_empty*/) noexcept {
+  instance.empty_alloc();
+  return parse_object_fields([this](const char *, size_t) { return skip_value(); });
+}
+
+template<class I>
+bool InstanceFromJsonParser::parse_instance_fields(class_instance<I> &instance, std::false_type /*is_empty*/) noexcept {
+  instance.alloc();
+  I *fields = instance.get();
+  return parse_object_fields([this, fields](const char *key, size_t key_len) { return fields->json_parse_field(*this, key, key_len); });
+}
+
+template<class ...Args>
+bool InstanceFromJsonParser::parse(std::tuple<Args...> &value) noexcept {
+  return parse_char('[') && parse_elements(value, std::index_sequence_for<Args...>{}) && parse_char(']');
+}
+
+template<size_t ...Is, class ...T>
+bool InstanceFromJsonParser::parse(shape<std::index_sequence<Is...>, T...> &value) noexcept {
+  return parse_char('[') && parse_elements(value, std::index_sequence<Is...>{}) && parse_char(']');
+}
+
+template<class Tuple, size_t ...Is>
+bool InstanceFromJsonParser::parse_elements(Tuple &elements, std::index_sequence<Is...>) noexcept {
+  bool is_ok = true;
+  size_t position = 0;
+  auto parse_element = [this, &is_ok, &position](auto &element) {
+    is_ok = is_ok && (position++ == 0 || parse_char(',')) && parse(element);
+  };
+  static_cast<void>(parse_element);
+
+  std::initializer_list<int32_t>{(parse_element(impl_::json_element<Is>(elements)), 0)...};
+  return is_ok;
+}
+
+template<class F>
+bool InstanceFromJsonParser::parse_object_fields(F &&parse_field) noexcept {
+  if (parse_char('}')) {
+    return true;
+  }
+  do {
+    const char *key = nullptr;
+    size_t key_len = 0;
+    string unescaped_key;
+    if (!parse_key(key, key_len, unescaped_key) || !parse_char(':') || !parse_field(key, key_len)) {
+      return false;
+    }
+  } while (parse_char(','));
+  return parse_char('}');
+}
+
+template<class F>
+bool InstanceFromJsonParser::parse_array_elements(F &&parse_element) noexcept {
+  if (parse_char(']')) {
+    return true;
+  }
+  do {
+    if (!parse_element()) {
+      return false;
+    }
+  } while (parse_char(','));
+  return parse_char(']');
+}
+
+template<class T>
+Optional<string> f$instance_to_json(const class_instance<T> &instance, int64_t options = 0) noexcept {
+  return f$json_encode(instance, options);
+}
+
+template<class ResultClass>
+ResultClass f$instance_from_json(const string &json, const string &class_name) noexcept {
+  ResultClass result;
+  InstanceFromJsonParser parser{json};
+  if (!parser.parse(result) || !parser.is_finished()) {
+    php_warning("Can't decode json into an instance of %s, error at position %" PRIi64, class_name.c_str(), parser.get_pos());
+    return {};
+  }
+  return result;
+}
@@ -18,6 +18,7 @@
 #include "common/macos-ports.h"
 #include "common/tl/constants/common.h"
 
+#include "runtime/aho-corasick.h"
 #include "runtime/array_functions.h"
 #include "runtime/bcmath.h"
 #include "runtime/confdata-functions.h"
@@ -75,6 +76,10 @@ static int http_need_gzip;
 static bool is_utf8_enabled = false;
 bool is_json_log_on_timeout_enabled = true;
 
+// all the global vars are initialized by the first reset
+uint32_t global_vars_dirty_parts = ~0u;
+int64_t global_vars_reset_count = 0;
+
 void f$ob_clean() {
   coub->clean();
 }
@@ -2229,6 +2234,7 @@ static void free_runtime_libs() {
 
   free_confdata_functions_lib();
   free_instance_cache_lib();
+  free_aho_corasick_lib();
   free_kphp_backtrace();
 
   free_migration_php8();
@@ -2252,6 +2258,18 @@ void global_init_runtime_libs() {
   global_init_curl_lib();
 }
 
+void global_init_frozen_memory() {
+  // only the address space is reserved, the unused part of it is released by the freezing
+  constexpr size_t frozen_memory_max_size = size_t{1} << 30;
+  if (!dl::global_init_frozen_memory(frozen_memory_max_size)) {
+    php_warning("Can't reserve the frozen memory, the constants are allocated in the heap");
+  }
+}
+
+void freeze_global_init_memory() {
+  dl::freeze_global_init_memory();
+}
+
 void global_init_script_allocator() {
   dl::global_init_script_allocator();
 }
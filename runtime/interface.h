@@ -159,12 +159,19 @@ Optional<string> f$ini_get(const string &s);
 Optional<array<mixed>> f$getopt(const string &options, array<string> longopts = array<string>());
 
 void global_init_runtime_libs();
+void global_init_frozen_memory();
+void freeze_global_init_memory();
 void global_init_script_allocator();
 
 void init_runtime_environment(php_query_data *data, void *mem, size_t mem_size);
 
 void free_runtime_environment();
 
+// the bits of the parts of the global vars used by the current request, only these parts are reset after it
+extern uint32_t global_vars_dirty_parts;
+// the total number of the global vars reset between the requests
+extern int64_t global_vars_reset_count;
+
 void use_utf8();
 
 /*
@@ -18,6 +18,8 @@ class InstanceDeepCopyVisitor;
 
 class InstanceDeepDestroyVisitor;
 
+class InstanceReferencesCheckVisitor;
+
 class InstanceToArrayVisitor;
 
 class InstanceMemoryEstimateVisitor;
@@ -38,6 +40,7 @@ struct SendingInstanceBase : virtual abstract_refcountable_php_interface {
   virtual void accept(InstanceUniqueIndexVisitor &) noexcept = 0;
   virtual void accept(InstanceDeepCopyVisitor &) noexcept = 0;
   virtual void accept(InstanceDeepDestroyVisitor &) noexcept = 0;
+  virtual void accept(InstanceReferencesCheckVisitor &) noexcept = 0;
 
   virtual void accept(InstanceToArrayVisitor &) noexcept {}
 
@@ -100,6 +103,10 @@ struct C$KphpJobWorkerResponseError: public refcountable_polymorphic_php_classes
     return generic_accept(visitor);
   }
 
+  void accept(InstanceReferencesCheckVisitor &visitor) noexcept {
+    return generic_accept(visitor);
+  }
+
   void accept(InstanceToArrayVisitor &visitor) noexcept {
     return generic_accept(visitor);
   }
@@ -4,13 +4,53 @@
 
 #include "runtime/json-functions.h"
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 #include "common/algorithms/find.h"
+#include "common/unicode/utf8-utils.h"
 
 #include "runtime/exception.h"
+#include "runtime/instance-json-processor.h"
 #include "runtime/string_functions.h"
 
 namespace {
 
+// the length of the prefix of s which is copied to json as is: without quotes, slashes and control characters,
+// and without multibyte utf-8 characters if they have to be validated or escaped
+template<bool stop_on_non_ascii>
+int json_plain_prefix_len(const char *s, int len) noexcept {
+  int pos = 0;
+#ifdef __x86_64__
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i slash = _mm_set1_epi8('/');
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i max_control = _mm_set1_epi8(0x1f);
+  for (; pos + 16 <= len; pos += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+    __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)), _mm_cmpeq_epi8(block, slash));
+    if (stop_on_non_ascii) {
+      // bytes >= 0x80 are negative, so they are less than a space as well
+      special = _mm_or_si128(special, _mm_cmplt_epi8(block, space));
+    } else {
+      special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_min_epu8(block, max_control), block));
+    }
+    if (const int mask = _mm_movemask_epi8(special)) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#endif
+  for (; pos < len; pos++) {
+    const auto c = static_cast<unsigned char>(s[pos]);
+    if (c < 0x20 || c == '"' || c == '\\' || c == '/' || (stop_on_non_ascii && c >= 0x80)) {
+      break;
+    }
+  }
+  return pos;
+}
+
 void json_append_one_char(unsigned int c) noexcept {
   static_SB.append_char('\\');
   static_SB.append_char('u');
@@ -54,7 +94,17 @@ bool do_json_encode_string_php(const char *s, int len, int64_t options) noexcept
     return false;
   };
 
+  // a valid utf-8 string keeps its multibyte characters as is, so they are copied with the ascii ones;
+  // otherwise they are checked one by one below to report the position of the wrong one
+  const bool copy_multibyte = (options & JSON_UNESCAPED_UNICODE) && is_valid_utf8(s, len);
   for (int pos = 0; pos < len; pos++) {
+    const int plain_len = copy_multibyte ? json_plain_prefix_len<false>(s + pos, len - pos) : json_plain_prefix_len<true>(s + pos, len - pos);
+    static_SB.append_unsafe(s + pos, plain_len);
+    pos += plain_len;
+    if (pos == len) {
+      break;
+    }
+
     switch (s[pos]) {
       case '"':
         static_SB.append_char('\\');
@@ -174,6 +224,13 @@ bool do_json_encode_string_vkext(const char *s, int len) noexcept {
   static_SB.append_char('"');
 
   for (int pos = 0; pos < len; pos++) {
+    const int plain_len = json_plain_prefix_len<false>(s + pos, len - pos);
+    static_SB.append_unsafe(s + pos, plain_len);
+    pos += plain_len;
+    if (pos == len) {
+      break;
+    }
+
     char c = s[pos];
     if (unlikely (static_cast<unsigned int>(c) < 32u)) {
       switch (c) {
@@ -286,9 +343,260 @@ void json_skip_blanks(const char *s, int &i) noexcept {
   }
 }
 
-bool do_json_decode(const char *s, int s_len, int &i, mixed &v) noexcept {
+// the position of the first quote or backslash in s starting from pos, or len if there are none
+int json_find_quote_or_backslash(const char *s, int pos, int len) noexcept {
+#ifdef __x86_64__
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; pos + 16 <= len; pos += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+    if (const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)))) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+#endif
+  while (pos < len && s[pos] != '"' && s[pos] != '\\') {
+    pos++;
+  }
+  return pos;
+}
+
+// The first stage of json_decode: a pass over the whole document which finds its structural characters
+// and counts the elements of every array and object in the order they are opened.
+// The second stage creates arrays of the final size then instead of growing them element by element.
+// The counts are only hints: they are meaningless for malformed documents, which the second stage rejects anyway.
+class JsonElementCounts : vk::not_copyable {
+public:
+  JsonElementCounts(const char *s, int len) noexcept {
+    if (len >= MIN_INDEXED_DOCUMENT_LEN) {
+      index_document(s, len);
+      if (!open_.empty()) {
+        // the document is malformed, keep what is known anyway
+        counts_.set_value(open_.get_value(open_.count() - 1), innermost_count_);
+      }
+    }
+  }
+
+  // the number of elements of the next opened array or object, 0 if unknown
+  int64_t next() noexcept {
+    if (next_ >= counts_.count()) {
+      return 0;
+    }
+    return std::min(counts_.get_value(next_++), MAX_SIZE_HINT);
+  }
+
+private:
+  static constexpr int MIN_INDEXED_DOCUMENT_LEN = 256;
+  static constexpr int64_t MAX_SIZE_HINT = 1 << 20;
+
+  void index_document(const char *s, int len) noexcept {
+    int pos = 0;
+#ifdef __x86_64__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i brackets[] = {_mm_set1_epi8('['), _mm_set1_epi8(']'), _mm_set1_epi8('{'), _mm_set1_epi8('}')};
+    for (; pos + 16 <= len; pos += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+      const int string_mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+      if (in_string_ && string_mask == 0) {
+        continue;
+      }
+      __m128i structural = _mm_cmpeq_epi8(block, comma);
+      for (const __m128i &bracket : brackets) {
+        structural = _mm_or_si128(structural, _mm_cmpeq_epi8(block, bracket));
+      }
+      for (int mask = string_mask | _mm_movemask_epi8(structural); mask != 0; mask &= mask - 1) {
+        if (!index_char(s, pos + __builtin_ctz(mask))) {
+          return;
+        }
+      }
+    }
+#endif
+    for (; pos < len; pos++) {
+      if (!index_char(s, pos)) {
+        return;
+      }
+    }
+  }
+
+  bool index_char(const char *s, int pos) noexcept {
+    if (pos < skipped_until_) {
+      return true;
+    }
+    const char c = s[pos];
+    if (in_string_) {
+      if (c == '\\') {
+        skipped_until_ = pos + 2;
+      } else if (c == '"') {
+        in_string_ = false;
+      }
+      return true;
+    }
+    switch (c) {
+      case '"':
+        in_string_ = true;
+        return true;
+      case '[':
+      case '{':
+        if (!open_.empty()) {
+          counts_.set_value(open_.get_value(open_.count() - 1), innermost_count_);
+        }
+        open_.push_back(counts_.count());
+        counts_.push_back(0);
+        // elements are separated by commas, empty arrays and objects never ask for their hints
+        innermost_count_ = 1;
+        return true;
+      case ']':
+      case '}':
+        if (open_.empty()) {
+          return false;
+        }
+        counts_.set_value(open_.pop(), innermost_count_);
+        if (!open_.empty()) {
+          innermost_count_ = counts_.get_value(open_.get_value(open_.count() - 1));
+        }
+        return true;
+      case ',':
+        ++innermost_count_;
+        return true;
+      default:
+        return true;
+    }
+  }
+
+  array<int64_t> counts_;
+  array<int64_t> open_;
+  int64_t innermost_count_{0};
+  int64_t next_{0};
+  int skipped_until_{0};
+  bool in_string_{false};
+};
+
+bool json_decode_string(const char *s, int s_len, int &i, string &value) noexcept {
+  int j = json_find_quote_or_backslash(s, i + 1, s_len);
+  int slashes = 0;
+  while (j < s_len && s[j] == '\\') {
+    slashes++;
+    j = json_find_quote_or_backslash(s, j + 2, s_len);
+  }
+  if (j < s_len) {
+    if (slashes == 0) {
+      value = string(s + i + 1, j - i - 1);
+      i = j + 1;
+      return true;
+    }
+
+    int len = j - i - 1 - slashes;
+
+    value = string(len, false);
+
+    i++;
+    int l;
+    for (l = 0; l < len && i < j; l++) {
+      char c = s[i];
+      if (c == '\\') {
+        i++;
+        switch (s[i]) {
+          case '"':
+          case '\\':
+          case '/':
+            value[l] = s[i];
+            break;
+          case 'b':
+            value[l] = '\b';
+            break;
+          case 'f':
+            value[l] = '\f';
+            break;
+          case 'n':
+            value[l] = '\n';
+            break;
+          case 'r':
+            value[l] = '\r';
+            break;
+          case 't':
+            value[l] = '\t';
+            break;
+          case 'u':
+            if (isxdigit(s[i + 1]) && isxdigit(s[i + 2]) && isxdigit(s[i + 3]) && isxdigit(s[i + 4])) {
+              int num = 0;
+              for (int t = 0; t < 4; t++) {
+                char c = s[++i];
+                if ('0' <= c && c <= '9') {
+                  num = num * 16 + c - '0';
+                } else {
+                  c |= 0x20;
+                  if ('a' <= c && c <= 'f') {
+                    num = num * 16 + c - 'a' + 10;
+                  }
+                }
+              }
+
+              if (0xD7FF < num && num < 0xE000) {
+                if (s[i + 1] == '\\' && s[i + 2] == 'u' &&
+                    isxdigit(s[i + 3]) && isxdigit(s[i + 4]) && isxdigit(s[i + 5]) && isxdigit(s[i + 6])) {
+                  i += 2;
+                  int u = 0;
+                  for (int t = 0; t < 4; t++) {
+                    char c = s[++i];
+                    if ('0' <= c && c <= '9') {
+                      u = u * 16 + c - '0';
+                    } else {
+                      c |= 0x20;
+                      if ('a' <= c && c <= 'f') {
+                        u = u * 16 + c - 'a' + 10;
+                      }
+                    }
+                  }
+
+                  if (0xD7FF < u && u < 0xE000) {
+                    num = (((num & 0x3FF) << 10) | (u & 0x3FF)) + 0x10000;
+                  } else {
+                    i -= 6;
+                    return false;
+                  }
+                } else {
+                  return false;
+                }
+              }
+
+              if (num < 128) {
+                value[l] = static_cast<char>(num);
+              } else if (num < 0x800) {
+                value[l++] = static_cast<char>(0xc0 + (num >> 6));
+                value[l] = static_cast<char>(0x80 + (num & 63));
+              } else if (num < 0xffff) {
+                value[l++] = static_cast<char>(0xe0 + (num >> 12));
+                value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
+                value[l] = static_cast<char>(0x80 + (num & 63));
+              } else {
+                value[l++] = static_cast<char>(0xf0 + (num >> 18));
+                value[l++] = static_cast<char>(0x80 + ((num >> 12) & 63));
+                value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
+                value[l] = static_cast<char>(0x80 + (num & 63));
+              }
+              break;
+            }
+            /* fallthrough */
+          default:
+            return false;
+        }
+        i++;
+      } else {
+        value[l] = s[i++];
+      }
+    }
+    value.shrink(l);
+    i++;
+    return true;
+  }
+  return false;
+}
+
+bool do_json_decode(const char *s, int s_len, int &i, mixed &v, JsonElementCounts &counts) noexcept {
   if (!v.is_null()) {
-    v.destroy();
+    v = mixed();
   }
   json_skip_blanks(s, i);
   switch (s[i]) {
@@ -320,120 +628,9 @@ bool do_json_decode(const char *s, int s_len, int &i, mixed &v) noexcept {
       }
       break;
     case '"': {
-      int j = i + 1;
-      int slashes = 0;
-      while (j < s_len && s[j] != '"') {
-        if (s[j] == '\\') {
-          slashes++;
-          j++;
-        }
-        j++;
-      }
-      if (j < s_len) {
-        int len = j - i - 1 - slashes;
-
-        string value(len, false);
-
-        i++;
-        int l;
-        for (l = 0; l < len && i < j; l++) {
-          char c = s[i];
-          if (c == '\\') {
-            i++;
-            switch (s[i]) {
-              case '"':
-              case '\\':
-              case '/':
-                value[l] = s[i];
-                break;
-              case 'b':
-                value[l] = '\b';
-                break;
-              case 'f':
-                value[l] = '\f';
-                break;
-              case 'n':
-                value[l] = '\n';
-                break;
-              case 'r':
-                value[l] = '\r';
-                break;
-              case 't':
-                value[l] = '\t';
-                break;
-              case 'u':
-                if (isxdigit(s[i + 1]) && isxdigit(s[i + 2]) && isxdigit(s[i + 3]) && isxdigit(s[i + 4])) {
-                  int num = 0;
-                  for (int t = 0; t < 4; t++) {
-                    char c = s[++i];
-                    if ('0' <= c && c <= '9') {
-                      num = num * 16 + c - '0';
-                    } else {
-                      c |= 0x20;
-                      if ('a' <= c && c <= 'f') {
-                        num = num * 16 + c - 'a' + 10;
-                      }
-                    }
-                  }
-
-                  if (0xD7FF < num && num < 0xE000) {
-                    if (s[i + 1] == '\\' && s[i + 2] == 'u' &&
-                        isxdigit(s[i + 3]) && isxdigit(s[i + 4]) && isxdigit(s[i + 5]) && isxdigit(s[i + 6])) {
-                      i += 2;
-                      int u = 0;
-                      for (int t = 0; t < 4; t++) {
-                        char c = s[++i];
-                        if ('0' <= c && c <= '9') {
-                          u = u * 16 + c - '0';
-                        } else {
-                          c |= 0x20;
-                          if ('a' <= c && c <= 'f') {
-                            u = u * 16 + c - 'a' + 10;
-                          }
-                        }
-                      }
-
-                      if (0xD7FF < u && u < 0xE000) {
-                        num = (((num & 0x3FF) << 10) | (u & 0x3FF)) + 0x10000;
-                      } else {
-                        i -= 6;
-                        return false;
-                      }
-                    } else {
-                      return false;
-                    }
-                  }
-
-                  if (num < 128) {
-                    value[l] = static_cast<char>(num);
-                  } else if (num < 0x800) {
-                    value[l++] = static_cast<char>(0xc0 + (num >> 6));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  } else if (num < 0xffff) {
-                    value[l++] = static_cast<char>(0xe0 + (num >> 12));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  } else {
-                    value[l++] = static_cast<char>(0xf0 + (num >> 18));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 12) & 63));
-                    value[l++] = static_cast<char>(0x80 + ((num >> 6) & 63));
-                    value[l] = static_cast<char>(0x80 + (num & 63));
-                  }
-                  break;
-                }
-                /* fallthrough */
-              default:
-                return false;
-            }
-            i++;
-          } else {
-            value[l] = s[i++];
-          }
-        }
-        value.shrink(l);
-
+      string value;
+      if (json_decode_string(s, s_len, i, value)) {
         new(&v) mixed(value);
-        i++;
         return true;
       }
       break;
@@ -441,11 +638,15 @@ bool do_json_decode(const char *s, int s_len, int &i, mixed &v) noexcept {
     case '[': {
       array<mixed> res;
       i++;
+      const int64_t size_hint = counts.next();
       json_skip_blanks(s, i);
       if (s[i] != ']') {
+        if (size_hint > 0) {
+          res = array<mixed>(array_size(size_hint, 0, true));
+        }
         do {
           mixed value;
-          if (!do_json_decode(s, s_len, i, value)) {
+          if (!do_json_decode(s, s_len, i, value, counts)) {
             return false;
           }
           res.push_back(value);
@@ -465,11 +666,15 @@ bool do_json_decode(const char *s, int s_len, int &i, mixed &v) noexcept {
     case '{': {
       array<mixed> res;
       i++;
+      const int64_t size_hint = counts.next();
       json_skip_blanks(s, i);
       if (s[i] != '}') {
+        if (size_hint > 0) {
+          res = array<mixed>(array_size(0, size_hint, false));
+        }
         do {
           mixed key;
-          if (!do_json_decode(s, s_len, i, key) || !key.is_string()) {
+          if (!do_json_decode(s, s_len, i, key, counts) || !key.is_string()) {
             return false;
           }
           json_skip_blanks(s, i);
@@ -477,7 +682,7 @@ bool do_json_decode(const char *s, int s_len, int &i, mixed &v) noexcept {
             return false;
           }
 
-          if (!do_json_decode(s, s_len, i, res[key])) {
+          if (!do_json_decode(s, s_len, i, res[key], counts)) {
             return false;
           }
           json_skip_blanks(s, i);
@@ -529,7 +734,8 @@ mixed f$json_decode(const string &v, bool assoc) noexcept {
 
   mixed result;
   int i = 0;
-  if (do_json_decode(v.c_str(), v.size(), i, result)) {
+  JsonElementCounts counts(v.c_str(), v.size());
+  if (do_json_decode(v.c_str(), v.size(), i, result, counts)) {
     json_skip_blanks(v.c_str(), i);
     if (i == static_cast<int>(v.size())) {
       return result;
@@ -538,3 +744,108 @@ mixed f$json_decode(const string &v, bool assoc) noexcept {
 
   return mixed();
 }
+
+InstanceFromJsonParser::InstanceFromJsonParser(const string &json) noexcept:
+  json_(json.c_str()),
+  json_len_(json.size()) {
+}
+
+bool InstanceFromJsonParser::parse(bool &value) noexcept {
+  mixed v;
+  if (!parse_scalar(v) || !v.is_bool()) {
+    return false;
+  }
+  value = v.as_bool();
+  return true;
+}
+
+bool InstanceFromJsonParser::parse(int64_t &value) noexcept {
+  mixed v;
+  if (!parse_scalar(v) || !v.is_int()) {
+    return false;
+  }
+  value = v.as_int();
+  return true;
+}
+
+bool InstanceFromJsonParser::parse(double &value) noexcept {
+  mixed v;
+  if (!parse_scalar(v) || !(v.is_float() || v.is_int())) {
+    return false;
+  }
+  value = v.to_float();
+  return true;
+}
+
+bool InstanceFromJsonParser::parse(string &value) noexcept {
+  json_skip_blanks(json_, pos_);
+  return json_[pos_] == '"' && json_decode_string(json_, json_len_, pos_, value);
+}
+
+bool InstanceFromJsonParser::parse(mixed &value) noexcept {
+  JsonElementCounts no_counts{json_, 0};
+  return do_json_decode(json_, json_len_, pos_, value, no_counts);
+}
+
+bool InstanceFromJsonParser::skip_value() noexcept {
+  json_skip_blanks(json_, pos_);
+  switch (json_[pos_]) {
+    case '"': {
+      string value;
+      return json_decode_string(json_, json_len_, pos_, value);
+    }
+    case '[':
+      pos_++;
+      return parse_array_elements([this] { return skip_value(); });
+    case '{':
+      pos_++;
+      return parse_object_fields([this](const char *, size_t) { return skip_value(); });
+    default: {
+      mixed value;
+      return parse_scalar(value);
+    }
+  }
+}
+
+bool InstanceFromJsonParser::is_finished() noexcept {
+  json_skip_blanks(json_, pos_);
+  return pos_ == json_len_;
+}
+
+bool InstanceFromJsonParser::parse_literal(const char *literal, int len) noexcept {
+  json_skip_blanks(json_, pos_);
+  if (pos_ + len > json_len_ || memcmp(json_ + pos_, literal, len) != 0) {
+    return false;
+  }
+  pos_ += len;
+  return true;
+}
+
+bool InstanceFromJsonParser::parse_scalar(mixed &value) noexcept {
+  json_skip_blanks(json_, pos_);
+  if (vk::any_of_equal(json_[pos_], '"', '[', '{')) {
+    return false;
+  }
+  JsonElementCounts no_counts{json_, 0};
+  return do_json_decode(json_, json_len_, pos_, value, no_counts);
+}
+
+bool InstanceFromJsonParser::parse_key(const char *&key, size_t &key_len, string &unescaped_key) noexcept {
+  json_skip_blanks(json_, pos_);
+  if (json_[pos_] != '"') {
+    return false;
+  }
+  const int end = json_find_quote_or_backslash(json_, pos_ + 1, json_len_);
+  if (end < json_len_ && json_[end] == '"') {
+    key = json_ + pos_ + 1;
+    key_len = end - pos_ - 1;
+    pos_ = end + 1;
+    return true;
+  }
+  if (!json_decode_string(json_, json_len_, pos_, unescaped_key)) {
+    return false;
+  }
+  key = unescaped_key.c_str();
+  key_len = unescaped_key.size();
+  return true;
+}
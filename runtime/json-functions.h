@@ -30,9 +30,28 @@ public:
   template<class T>
   bool encode(const Optional<T> &opt) const noexcept;
 
+  // defined in instance-json-processor.h
+  template<class I>
+  bool encode(const class_instance<I> &instance) const noexcept;
+
+  template<class ...Args>
+  bool encode(const std::tuple<Args...> &tuple) const noexcept;
+
+  template<size_t ...Is, class ...T>
+  bool encode(const shape<std::index_sequence<Is...>, T...> &shape) const noexcept;
+
 private:
   bool encode_null() const noexcept;
 
+  template<class I>
+  bool encode_instance_fields(const class_instance<I> &instance, std::true_type is_empty) const noexcept;
+
+  template<class I>
+  bool encode_instance_fields(const class_instance<I> &instance, std::false_type is_empty) const noexcept;
+
+  template<class Tuple, size_t ...Is>
+  bool encode_elements(const Tuple &elements, std::index_sequence<Is...>) const noexcept;
+
   const int64_t options_{0};
   const bool simple_encode_{false};
 };
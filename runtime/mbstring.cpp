@@ -17,81 +17,8 @@ static int mb_detect_encoding(const string &encoding) {
   return -1;
 }
 
-static int64_t mb_UTF8_strlen(const char *s) {
-  int64_t res = 0;
-  for (int64_t i = 0; s[i]; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      res++;
-    }
-  }
-  return res;
-}
-
-static int64_t mb_UTF8_advance(const char *s, int64_t cnt) {
-  php_assert (cnt >= 0);
-  int64_t i;
-  for (i = 0; s[i] && cnt >= 0; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      cnt--;
-    }
-  }
-  if (cnt < 0) {
-    i--;
-  }
-  return i;
-}
-
-static int64_t mb_UTF8_get_offset(const char *s, int64_t pos) {
-  int64_t res = 0;
-  for (int64_t i = 0; i < pos && s[i]; i++) {
-    if ((((unsigned char)s[i]) & 0xc0) != 0x80) {
-      res++;
-    }
-  }
-  return res;
-}
-
-bool mb_UTF8_check(const char *s) {
-  do {
-#define CHECK(condition) if (!(condition)) {return false;}
-    unsigned int a = (unsigned char)(*s++);
-    if ((a & 0x80) == 0) {
-      if (a == 0) {
-        return true;
-      }
-      continue;
-    }
-
-    CHECK ((a & 0x40) != 0);
-
-    unsigned int b = (unsigned char)(*s++);
-    CHECK((b & 0xc0) == 0x80);
-    if ((a & 0x20) == 0) {
-      CHECK((a & 0x1e) > 0);
-      continue;
-    }
-
-    unsigned int c = (unsigned char)(*s++);
-    CHECK((c & 0xc0) == 0x80);
-    if ((a & 0x10) == 0) {
-      int x = (((a & 0x0f) << 6) | (b & 0x20));
-      CHECK(x != 0 && x != 0x360);//surrogates
-      continue;
-    }
-
-    unsigned int d = (unsigned char)(*s++);
-    CHECK((d & 0xc0) == 0x80);
-    if ((a & 0x08) == 0) {
-      int t = (((a & 0x07) << 6) | (b & 0x30));
-      CHECK(0 < t && t < 0x110);//end of unicode
-      continue;
-    }
-
-    return false;
-#undef CHECK
-  } while (true);
-
-  php_assert (0);
+bool mb_UTF8_check(const char *s, size_t len) {
+  return is_valid_utf8(s, len);
 }
 
 bool f$mb_check_encoding(const string &str, const string &encoding) {
@@ -105,7 +32,7 @@ bool f$mb_check_encoding(const string &str, const string &encoding) {
     return true;
   }
 
-  return mb_UTF8_check(str.c_str());
+  return mb_UTF8_check(str.c_str(), str.size());
 }
 
 
@@ -120,7 +47,7 @@ int64_t f$mb_strlen(const string &str, const string &encoding) {
     return str.size();
   }
 
-  return mb_UTF8_strlen(str.c_str());
+  return utf8_chars_count(str.c_str(), str.size());
 }
 
 
@@ -173,16 +100,24 @@ string f$mb_strtolower(const string &str, const string &encoding) {
   } else {
     string res(len * 3, false);
     const char *s = str.c_str();
+    const char *end = s + len;
     int res_len = 0;
-    int p;
     int ch;
-    while ((p = get_char_utf8(&ch, s)) > 0) {
+    while (true) {
+      const size_t ascii_len = utf8_ascii_prefix_tolower(s, end - s, &res[res_len]);
+      s += ascii_len;
+      res_len += ascii_len;
+      if (s == end) {
+        break;
+      }
+      const int p = get_char_utf8(&ch, s);
+      if (p < 0) {
+        php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtolower", str.c_str());
+        break;
+      }
       s += p;
       res_len += put_char_utf8(unicode_tolower(ch), &res[res_len]);
     }
-    if (p < 0) {
-      php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtolower", str.c_str());
-    }
     res.shrink(res_len);
 
     return res;
@@ -243,16 +178,24 @@ string f$mb_strtoupper(const string &str, const string &encoding) {
   } else {
     string res(len * 3, false);
     const char *s = str.c_str();
+    const char *end = s + len;
     int res_len = 0;
-    int p;
     int ch;
-    while ((p = get_char_utf8(&ch, s)) > 0) {
+    while (true) {
+      const size_t ascii_len = utf8_ascii_prefix_toupper(s, end - s, &res[res_len]);
+      s += ascii_len;
+      res_len += ascii_len;
+      if (s == end) {
+        break;
+      }
+      const int p = get_char_utf8(&ch, s);
+      if (p < 0) {
+        php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtoupper", str.c_str());
+        break;
+      }
       s += p;
       res_len += put_char_utf8(unicode_toupper(ch), &res[res_len]);
     }
-    if (p < 0) {
-      php_warning("Incorrect UTF-8 string \"%s\" in function mb_strtoupper", str.c_str());
-    }
     res.shrink(res_len);
 
     return res;
@@ -284,12 +227,12 @@ Optional<int64_t> mp_strpos_impl(const string &haystack, const string &needle, i
     return f$strpos(haystack, needle, offset);
   }
 
-  int64_t UTF8_offset = mb_UTF8_advance(haystack.c_str(), offset);
+  int64_t UTF8_offset = utf8_char_offset(haystack.c_str(), haystack.size(), offset);
   const char *s = static_cast<const char *>(memmem(haystack.c_str() + UTF8_offset, haystack.size() - UTF8_offset, needle.c_str(), needle.size()));
   if (unlikely(s == nullptr)) {
     return false;
   }
-  return mb_UTF8_get_offset(haystack.c_str() + UTF8_offset, s - (haystack.c_str() + UTF8_offset)) + offset;
+  return utf8_chars_count(haystack.c_str() + UTF8_offset, s - (haystack.c_str() + UTF8_offset)) + offset;
 }
 
 } // namespace
@@ -330,7 +273,7 @@ string f$mb_substr(const string &str, int64_t start, const mixed &length_var, co
     return res.val();
   }
 
-  int64_t len = mb_UTF8_strlen(str.c_str());
+  int64_t len = utf8_chars_count(str.c_str(), str.size());
   if (start < 0) {
     start += len;
   }
@@ -347,8 +290,8 @@ string f$mb_substr(const string &str, int64_t start, const mixed &length_var, co
     length = len - start;
   }
 
-  int64_t UTF8_start = mb_UTF8_advance(str.c_str(), start);
-  int64_t UTF8_length = mb_UTF8_advance(str.c_str() + UTF8_start, length);
+  int64_t UTF8_start = utf8_char_offset(str.c_str(), str.size(), start);
+  int64_t UTF8_length = utf8_char_offset(str.c_str() + UTF8_start, str.size() - UTF8_start, length);
 
   return string(str.c_str() + UTF8_start, static_cast<string::size_type>(UTF8_length));
 }
@@ -8,6 +8,7 @@ namespace memory_resource {
 
 Dealer::Dealer() noexcept :
   current_script_resource_(&default_script_resource_) {
+  heap_resource_.set_frozen_resource(frozen_resource_);
   set_script_resource_replacer(heap_resource_);
 }
 
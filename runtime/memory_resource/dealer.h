@@ -3,6 +3,7 @@
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
 #pragma once
+#include "runtime/memory_resource/frozen_resource.h"
 #include "runtime/memory_resource/heap_resource.h"
 #include "runtime/memory_resource/unsynchronized_pool_resource.h"
 
@@ -42,11 +43,16 @@ public:
     return heap_resource_;
   }
 
+  frozen_resource &get_frozen_resource() noexcept {
+    return frozen_resource_;
+  }
+
   unsynchronized_pool_resource &current_script_resource() noexcept {
     return *current_script_resource_;
   }
 
 private:
+  frozen_resource frozen_resource_;
   heap_resource heap_resource_;
   unsynchronized_pool_resource default_script_resource_;
 
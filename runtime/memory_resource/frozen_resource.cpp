@@ -0,0 +1,121 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "runtime/memory_resource/frozen_resource.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace memory_resource {
+
+namespace {
+
+constexpr size_t align_size(size_t size) noexcept {
+  return (size + 7) & ~size_t{7};
+}
+
+size_t get_page_size() noexcept {
+  static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+} // namespace
+
+bool frozen_resource::init(size_t max_size) noexcept {
+  php_assert(!memory_begin_);
+  void *mem = mmap(nullptr, max_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mem == MAP_FAILED) {
+    return false;
+  }
+  monotonic_buffer::init(mem, max_size);
+  return true;
+}
+
+void frozen_resource::freeze() noexcept {
+  php_assert(is_accepting());
+  frozen_ = true;
+  const size_t page_size = get_page_size();
+  const size_t used_size = (static_cast<size_t>(memory_current_ - memory_begin_) + page_size - 1) / page_size * page_size;
+  const size_t reserved_size = static_cast<size_t>(memory_end_ - memory_begin_);
+  if (used_size != reserved_size) {
+    munmap(memory_begin_ + used_size, reserved_size - used_size);
+  }
+  memory_end_ = memory_begin_ + used_size;
+}
+
+void *frozen_resource::allocate(size_t size) noexcept {
+  php_assert(is_accepting());
+  size = align_size(size);
+  void *mem = get_from_pool(size, true);
+  memory_debug("frozen allocate %zu at %p\n", size, mem);
+  register_allocation(mem, size);
+  return mem;
+}
+
+void *frozen_resource::reallocate(void *mem, size_t new_size, size_t old_size) noexcept {
+  php_assert(is_accepting());
+  old_size = align_size(old_size);
+  new_size = align_size(new_size);
+  if (static_cast<char *>(mem) + old_size == memory_current_ && static_cast<size_t>(memory_end_ - static_cast<char *>(mem)) >= new_size) {
+    memory_current_ = static_cast<char *>(mem) + new_size;
+    register_allocation(mem, new_size - old_size);
+    return mem;
+  }
+
+  void *new_mem = allocate(new_size);
+  if (new_mem) {
+    memcpy(new_mem, mem, old_size);
+    deallocate(mem, old_size);
+  }
+  return new_mem;
+}
+
+void frozen_resource::deallocate(void *mem, size_t size) noexcept {
+  memory_debug("frozen deallocate %zu at %p\n", size, mem);
+  if (frozen_) {
+    return;
+  }
+  // only the last piece goes back, the rest is wasted, but the temporary data is rare during the global init
+  size = align_size(size);
+  put_memory_back(mem, size);
+  register_deallocation(size);
+}
+
+size_t frozen_resource::get_shared_memory_size() const noexcept {
+  size_t shared_size = 0;
+#if defined(__linux__)
+  if (!frozen_ || memory_begin_ == memory_end_) {
+    return 0;
+  }
+  const int fd = open("/proc/self/pagemap", O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  // every page has a 64 bit entry: the bit 63 is 'present', the bit 56 is 'exclusively mapped',
+  // so the present pages mapped not exclusively are still shared with the other processes
+  const size_t page_size = get_page_size();
+  const size_t first_page = reinterpret_cast<uintptr_t>(memory_begin_) / page_size;
+  const size_t pages = static_cast<size_t>(memory_end_ - memory_begin_) / page_size;
+  uint64_t entries[512];
+  for (size_t page = 0; page < pages;) {
+    const size_t count = std::min(pages - page, sizeof(entries) / sizeof(entries[0]));
+    const ssize_t read_bytes = pread(fd, entries, count * sizeof(uint64_t), static_cast<off_t>((first_page + page) * sizeof(uint64_t)));
+    if (read_bytes <= 0) {
+      break;
+    }
+    const size_t read_count = static_cast<size_t>(read_bytes) / sizeof(uint64_t);
+    for (size_t i = 0; i != read_count; ++i) {
+      if ((entries[i] >> 63 & 1) && !(entries[i] >> 56 & 1)) {
+        shared_size += page_size;
+      }
+    }
+    page += read_count;
+  }
+  close(fd);
+#endif
+  return shared_size;
+}
+
+} // namespace memory_resource
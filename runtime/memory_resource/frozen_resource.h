@@ -0,0 +1,40 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include "runtime/memory_resource/monotonic_buffer_resource.h"
+
+namespace memory_resource {
+
+// The memory of the data created by the master once during the global init and never changed after (e.g. the php constants).
+// It is packed into a separate mapping instead of the malloc heap, so none of its pages is shared with the data changed later,
+// and the workers forked by the master keep sharing its pages instead of copying them on write.
+class frozen_resource : private monotonic_buffer_resource {
+public:
+  // reserves the address space, the pages are allocated by the first write
+  bool init(size_t max_size) noexcept;
+  // releases the unused rest of the reserved space, nothing can be allocated after that
+  void freeze() noexcept;
+
+  bool is_accepting() const noexcept { return memory_begin_ && !frozen_; }
+  bool contains(const void *mem) const noexcept {
+    return memory_begin_ <= static_cast<const char *>(mem) && static_cast<const char *>(mem) < memory_end_;
+  }
+
+  // returns nullptr if the reserved space is over, the caller should use the heap instead
+  void *allocate(size_t size) noexcept;
+  void *reallocate(void *mem, size_t new_size, size_t old_size) noexcept;
+  // the memory isn't reused after the freezing
+  void deallocate(void *mem, size_t size) noexcept;
+
+  size_t memory_used() const noexcept { return stats_.memory_used; }
+  // the bytes of the frozen data still shared with the master and the other workers, i.e. not copied by the current process
+  size_t get_shared_memory_size() const noexcept;
+
+private:
+  bool frozen_{false};
+};
+
+} // namespace memory_resource
@@ -6,6 +6,7 @@
 
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 
 #include "common/wrappers/likely.h"
 
@@ -16,6 +17,11 @@ namespace memory_resource {
 
 void *heap_resource::allocate(size_t size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (frozen_ && frozen_->is_accepting()) {
+    if (void *mem = frozen_->allocate(size)) {
+      return mem;
+    }
+  }
   void *mem = std::malloc(size);
   if (unlikely(!mem)) {
     php_out_of_memory_warning("Can't heap_allocate %zu bytes", size);
@@ -30,6 +36,11 @@ void *heap_resource::allocate(size_t size) noexcept {
 
 void *heap_resource::allocate0(size_t size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (frozen_ && frozen_->is_accepting()) {
+    if (void *mem = frozen_->allocate(size)) {
+      return memset(mem, 0x00, size);
+    }
+  }
   void *mem = std::calloc(1, size);
   if (unlikely(!mem)) {
     php_out_of_memory_warning("Can't heap_allocate0 %zu bytes", size);
@@ -44,6 +55,20 @@ void *heap_resource::allocate0(size_t size) noexcept {
 
 void *heap_resource::reallocate(void *mem, size_t new_size, size_t old_size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (frozen_ && frozen_->contains(mem)) {
+    if (frozen_->is_accepting()) {
+      if (void *new_mem = frozen_->reallocate(mem, new_size, old_size)) {
+        return new_mem;
+      }
+    }
+    // the frozen memory can't grow in place, it is moved to the heap
+    void *new_mem = allocate(new_size);
+    if (new_mem) {
+      memcpy(new_mem, mem, old_size);
+      frozen_->deallocate(mem, old_size);
+    }
+    return new_mem;
+  }
   mem = std::realloc(mem, new_size);
   memory_debug("heap reallocate %zu at %p\n", old_size, mem);
   if (unlikely(!mem)) {
@@ -57,6 +82,10 @@ void *heap_resource::reallocate(void *mem, size_t new_size, size_t old_size) noe
 
 void heap_resource::deallocate(void *mem, size_t size) noexcept {
   dl::CriticalSectionGuard lock;
+  if (frozen_ && frozen_->contains(mem)) {
+    frozen_->deallocate(mem, size);
+    return;
+  }
   memory_used_ -= size;
 
   std::free(mem);
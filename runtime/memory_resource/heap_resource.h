@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "runtime/memory_resource/frozen_resource.h"
 #include "runtime/memory_resource/memory_resource.h"
 
 namespace memory_resource {
@@ -17,8 +18,12 @@ public:
 
   size_t memory_used() const noexcept { return memory_used_; }
 
+  // while the frozen resource accepts allocations, the memory is taken from it
+  void set_frozen_resource(frozen_resource &frozen) noexcept { frozen_ = &frozen; }
+
 private:
   size_t memory_used_{0};
+  frozen_resource *frozen_{nullptr};
 };
 
 } // namespace memory_resource
@@ -4,6 +4,13 @@
 
 #include "runtime/memory_usage.h"
 
+FrozenConstMemoryStats get_frozen_const_memory_stats() noexcept {
+  FrozenConstMemoryStats stats;
+  stats.frozen_bytes = dl::get_frozen_memory_used();
+  stats.shared_bytes = dl::get_frozen_memory_shared();
+  return stats;
+}
+
 int64_t f$estimate_memory_usage(const string &value) {
   if (value.is_reference_counter(ExtraRefCnt::for_global_const) || value.is_reference_counter(ExtraRefCnt::for_instance_cache)) {
     return 0;
@@ -8,6 +8,15 @@
 #include "runtime/kphp_core.h"
 #include "runtime/shape.h"
 
+struct FrozenConstMemoryStats {
+  // the memory of the constants created by the master during the global init, see memory_resource::frozen_resource
+  size_t frozen_bytes{0};
+  // the part of it still shared with the master and the other workers, i.e. not copied by the current process
+  size_t shared_bytes{0};
+};
+
+FrozenConstMemoryStats get_frozen_const_memory_stats() noexcept;
+
 int64_t f$estimate_memory_usage(const string &value);
 
 int64_t f$estimate_memory_usage(const mixed &value);
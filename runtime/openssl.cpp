@@ -27,6 +27,7 @@
 #include "common/wrappers/openssl.h"
 #include "common/wrappers/string_view.h"
 #include "common/wrappers/to_array.h"
+#include "common/xxh3.h"
 
 #include "runtime/array_functions.h"
 #include "runtime/critical_section.h"
@@ -81,23 +82,43 @@ public:
   }
 };
 
+// The one-shot SHA1(), SHA256() etc. of OpenSSL 3 fetch the algorithm on every call, which costs more than hashing a short key.
+// The context functions go straight to the block functions, and those pick SHA-NI or AVX2 code by cpuid.
+template<class Ctx, int (*init)(Ctx *), int (*update)(Ctx *, const void *, size_t), int (*final)(unsigned char *, Ctx *)>
+unsigned char *ctx_digest(const unsigned char *data, size_t len, unsigned char *out) noexcept {
+  Ctx ctx;
+  init(&ctx);
+  update(&ctx, data, len);
+  final(out, &ctx);
+  return out;
+}
+
 HashTraits make_sha1_traits() noexcept {
-  return HashTraits{"sha1", SHA1, SHA_DIGEST_LENGTH, EVP_sha1};
+  return HashTraits{"sha1", ctx_digest<SHA_CTX, SHA1_Init, SHA1_Update, SHA1_Final>, SHA_DIGEST_LENGTH, EVP_sha1};
 }
 
 HashTraits make_md5_traits() noexcept {
-  return HashTraits{"md5", MD5, MD5_DIGEST_LENGTH, EVP_md5};
+  return HashTraits{"md5", ctx_digest<MD5_CTX, MD5_Init, MD5_Update, MD5_Final>, MD5_DIGEST_LENGTH, EVP_md5};
+}
+
+unsigned char *xxh3_digest(const unsigned char *data, size_t len, unsigned char *out) noexcept {
+  // the canonical big-endian form, as php prints it
+  const uint64_t hash = __builtin_bswap64(compute_xxh3_64(data, len));
+  memcpy(out, &hash, sizeof(hash));
+  return out;
 }
 
 const auto &get_supported_hash_algorithms() noexcept {
   const static auto supported_algorithms = vk::to_array<HashTraits>(
     {
       make_sha1_traits(),
-      HashTraits{"sha224", SHA224, SHA224_DIGEST_LENGTH, EVP_sha224},
-      HashTraits{"sha256", SHA256, SHA256_DIGEST_LENGTH, EVP_sha256},
-      HashTraits{"sha384", SHA384, SHA384_DIGEST_LENGTH, EVP_sha384},
-      HashTraits{"sha512", SHA512, SHA512_DIGEST_LENGTH, EVP_sha512},
-      make_md5_traits()
+      HashTraits{"sha224", ctx_digest<SHA256_CTX, SHA224_Init, SHA224_Update, SHA224_Final>, SHA224_DIGEST_LENGTH, EVP_sha224},
+      HashTraits{"sha256", ctx_digest<SHA256_CTX, SHA256_Init, SHA256_Update, SHA256_Final>, SHA256_DIGEST_LENGTH, EVP_sha256},
+      HashTraits{"sha384", ctx_digest<SHA512_CTX, SHA384_Init, SHA384_Update, SHA384_Final>, SHA384_DIGEST_LENGTH, EVP_sha384},
+      HashTraits{"sha512", ctx_digest<SHA512_CTX, SHA512_Init, SHA512_Update, SHA512_Final>, SHA512_DIGEST_LENGTH, EVP_sha512},
+      make_md5_traits(),
+      // non-cryptographic, there is no hmac for it
+      HashTraits{"xxh3", xxh3_digest, sizeof(uint64_t), nullptr}
     });
   return supported_algorithms;
 }
@@ -124,7 +145,14 @@ array<string> f$hash_algos() noexcept {
 }
 
 array<string> f$hash_hmac_algos() noexcept {
-  return f$hash_algos();
+  const auto &supported_algorithms = get_supported_hash_algorithms();
+  array<string> result{array_size{static_cast<int64_t>(supported_algorithms.size()), 0, true}};
+  for (const auto &algo : supported_algorithms) {
+    if (algo.get_evp) {
+      result.emplace_back(string{algo.name});
+    }
+  }
+  return result;
 }
 
 string f$hash(const string &algo, const string &s, bool raw_output) noexcept {
@@ -132,7 +160,11 @@ string f$hash(const string &algo, const string &s, bool raw_output) noexcept {
 }
 
 string f$hash_hmac(const string &algo, const string &data, const string &key, bool raw_output) noexcept {
-  return find_hash_algorithm(algo.c_str()).hash_hmac(data, key, raw_output);
+  const HashTraits &traits = find_hash_algorithm(algo.c_str());
+  if (!traits.get_evp) {
+    php_critical_error ("algo %s not supported in function hash_hmac", algo.c_str());
+  }
+  return traits.hash_hmac(data, key, raw_output);
 }
 
 string f$sha1(const string &s, bool raw_output) noexcept {
@@ -4,9 +4,14 @@
 
 #include "runtime/regexp.h"
 
+#include <chrono>
 #include <cstddef>
+#include <memory>
 #include <re2/re2.h>
+#include <string>
+#include <unordered_map>
 
+#include "common/algorithms/find.h"
 #include "common/containers/final_action.h"
 
 #include "runtime/critical_section.h"
@@ -29,6 +34,13 @@ static re2::StringPiece RE2_submatch[MAX_SUBPATTERNS];
 int32_t regexp::submatch[3 * MAX_SUBPATTERNS];
 pcre_extra regexp::extra;
 
+#ifdef PCRE_STUDY_JIT_COMPILE
+// shared by all jit compiled regexps, the default one is 32K on the machine stack
+static pcre_jit_stack *jit_stack = nullptr;
+constexpr int32_t PCRE_JIT_STACK_MIN_SIZE = 32 * 1024;
+constexpr int32_t PCRE_JIT_STACK_MAX_SIZE = 1024 * 1024;
+#endif
+
 
 regexp::regexp(const string &regexp_string) {
   init(regexp_string);
@@ -295,58 +307,165 @@ bool regexp::is_valid_RE2_regexp(const char *regexp_string, int64_t regexp_len,
   return true;
 }
 
-void regexp::init(const string &regexp_string, const char *function, const char *file) {
-  static char regexp_cache_storage[sizeof(array<regexp *>)];
-  static array<regexp *> *regexp_cache = (array<regexp *> *)regexp_cache_storage;
-  static long long regexp_last_query_num = -1;
+namespace {
 
-  use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
+struct RegexpCacheEntry {
+  std::unique_ptr<regexp> re;
+  uint64_t last_use{0};
+  long long last_use_query_num{0};
+};
 
-  if (!use_heap_memory) {
-    if (dl::query_num != regexp_last_query_num) {
-      new(regexp_cache_storage) array<regexp *>();
-      regexp_last_query_num = dl::query_num;
-    }
+int64_t regexp_cache_size_limit = 256;
+uint64_t regexp_cache_uses = 0;
 
-    regexp *re = regexp_cache->get_value(regexp_string);
-    if (re != nullptr) {
-      php_assert (!re->use_heap_memory);
+std::unordered_map<std::string, RegexpCacheEntry> &get_regexp_worker_cache() noexcept {
+  static std::unordered_map<std::string, RegexpCacheEntry> cache;
+  return cache;
+}
+
+const regexp *find_cached_regexp(const string &regexp_string) noexcept {
+  auto &cache = get_regexp_worker_cache();
+  auto it = cache.find(std::string{regexp_string.c_str(), regexp_string.size()});
+  if (it == cache.end()) {
+    return nullptr;
+  }
+  it->second.last_use = ++regexp_cache_uses;
+  it->second.last_use_query_num = dl::query_num;
+  return it->second.re.get();
+}
+
+// evicts the least recently used entry if the cache is full;
+// entries used by the current request are never evicted, script regexps may share their compiled data
+bool reserve_regexp_cache_entry() noexcept {
+  auto &cache = get_regexp_worker_cache();
+  if (static_cast<int64_t>(cache.size()) < regexp_cache_size_limit) {
+    return true;
+  }
+  auto lru = cache.end();
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    if (it->second.last_use_query_num != dl::query_num && (lru == cache.end() || it->second.last_use < lru->second.last_use)) {
+      lru = it;
+    }
+  }
+  if (lru == cache.end()) {
+    return false;
+  }
+  cache.erase(lru);
+  auto &stats = vk::singleton<RegexpStats>::get();
+  ++stats.cache_evictions;
+  stats.cache_size = cache.size();
+  return true;
+}
 
-      subpatterns_count = re->subpatterns_count;
-      named_subpatterns_count = re->named_subpatterns_count;
-      is_utf8 = re->is_utf8;
-      use_heap_memory = re->use_heap_memory;
+void add_cached_regexp(const string &regexp_string, regexp *re) noexcept {
+  auto &cache = get_regexp_worker_cache();
+  auto &entry = cache[std::string{regexp_string.c_str(), regexp_string.size()}];
+  entry.re.reset(re);
+  entry.last_use = ++regexp_cache_uses;
+  entry.last_use_query_num = dl::query_num;
+  vk::singleton<RegexpStats>::get().cache_size = cache.size();
+}
 
-      subpattern_names = re->subpattern_names;
+} // namespace
 
-      pcre_regexp = re->pcre_regexp;
-      RE2_regexp = re->RE2_regexp;
+void set_regexp_cache_size(int64_t size) noexcept {
+  regexp_cache_size_limit = size;
+}
 
-      return;
-    }
+regexp *regexp::compile_cached(const string &regexp_string, const char *function, const char *file) {
+  auto *re = new regexp();
+  re->use_heap_memory = true;
+  re->is_cached = true;
+  re->compile(regexp_string.c_str(), regexp_string.size(), function, file);
+  if (re->pcre_regexp == nullptr && re->RE2_regexp == nullptr) {
+    delete re;
+    return nullptr;
   }
+  return re;
+}
 
-  init(regexp_string.c_str(), regexp_string.size(), function, file);
+void regexp::share_compiled_data(const regexp &other) noexcept {
+  subpatterns_count = other.subpatterns_count;
+  named_subpatterns_count = other.named_subpatterns_count;
+  is_utf8 = other.is_utf8;
+  is_cached = other.is_cached;
 
-  if (!use_heap_memory) {
-    regexp *re = static_cast <regexp *> (dl::allocate(sizeof(regexp)));
-    new(re) regexp();
+  subpattern_names = other.subpattern_names;
 
-    re->subpatterns_count = subpatterns_count;
-    re->named_subpatterns_count = named_subpatterns_count;
-    re->is_utf8 = is_utf8;
-    re->use_heap_memory = use_heap_memory;
+  pcre_regexp = other.pcre_regexp;
+  pcre_study_extra = other.pcre_study_extra;
+  RE2_regexp = other.RE2_regexp;
+
+  required_prefix = other.required_prefix;
+  required_prefix_len = other.required_prefix_len;
+  is_prefix_anchored = other.is_prefix_anchored;
+  is_literal = other.is_literal;
+}
+
+void regexp::init(const string &regexp_string, const char *function, const char *file) {
+  static char regexp_cache_storage[sizeof(array<regexp *>)];
+  static array<regexp *> *regexp_cache = (array<regexp *> *)regexp_cache_storage;
+  static long long regexp_last_query_num = -1;
+
+  use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
+
+  if (use_heap_memory) {
+    compile(regexp_string.c_str(), regexp_string.size(), function, file);
+    return;
+  }
 
-    re->subpattern_names = subpattern_names;
+  if (dl::query_num != regexp_last_query_num) {
+    new(regexp_cache_storage) array<regexp *>();
+    regexp_last_query_num = dl::query_num;
+  }
 
-    re->pcre_regexp = pcre_regexp;
-    re->RE2_regexp = RE2_regexp;
+  auto &stats = vk::singleton<RegexpStats>::get();
+  regexp *re = regexp_cache->get_value(regexp_string);
+  if (re != nullptr) {
+    php_assert (!re->use_heap_memory);
+    ++stats.cache_hits;
+    share_compiled_data(*re);
+    return;
+  }
 
-    regexp_cache->set_value(regexp_string, re);
+  {
+    // the worker cache is on heap, it mustn't be left inconsistent by a script timeout
+    dl::CriticalSectionGuard critical_section;
+    if (const regexp *cached = find_cached_regexp(regexp_string)) {
+      ++stats.cache_hits;
+      share_compiled_data(*cached);
+    } else {
+      ++stats.cache_misses;
+      const auto compile_start = std::chrono::steady_clock::now();
+      if (reserve_regexp_cache_entry()) {
+        if (regexp *compiled = compile_cached(regexp_string, function, file)) {
+          add_cached_regexp(regexp_string, compiled);
+          share_compiled_data(*compiled);
+        }
+      } else {
+        // the cache is full of the regexps used by the current request
+        compile(regexp_string.c_str(), regexp_string.size(), function, file);
+      }
+      stats.compile_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - compile_start).count();
+    }
+    if (is_cached) {
+      auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator();
+      init_subpattern_names(function, file);
+    }
   }
+
+  re = static_cast <regexp *> (dl::allocate(sizeof(regexp)));
+  new(re) regexp();
+  re->share_compiled_data(*this);
+  regexp_cache->set_value(regexp_string, re);
 }
 
 void regexp::init(const char *regexp_string, int64_t regexp_len, const char *function, const char *file) {
+  use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
+  compile(regexp_string, regexp_len, function, file);
+}
+
+void regexp::compile(const char *regexp_string, int64_t regexp_len, const char *function, const char *file) {
   if (regexp_len == 0) {
     pattern_compilation_warning(function, file, "Empty regular expression");
     return;
@@ -397,8 +516,6 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
 
   static_SB.clean().append(regexp_string + 1, static_cast<size_t>(regexp_end - 1));
 
-  use_heap_memory = (dl::get_script_memory_stats().memory_limit == 0);
-
   auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator(!use_heap_memory);
 
   is_utf8 = false;
@@ -463,7 +580,7 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
 
   can_use_RE2 = can_use_RE2 && is_valid_RE2_regexp(static_SB.c_str(), static_SB.size(), is_utf8, function, file);
 
-  if (is_utf8 && !mb_UTF8_check(static_SB.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(static_SB.c_str(), static_SB.size())) {
     pattern_compilation_warning(function, file, "Regexp \"%s\" contains not UTF-8 symbols", static_SB.c_str());
     clean();
     return;
@@ -501,6 +618,27 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
       clean();
       return;
     }
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    // jit code is allocated outside the script memory and has to be freed explicitly,
+    // so only the regexps living between requests are jit compiled: master ones, inherited by workers, and cached ones
+    if (use_heap_memory) {
+      pcre_study_extra = pcre_study(pcre_regexp, PCRE_STUDY_JIT_COMPILE, &error);
+      if (pcre_study_extra != nullptr) {
+        pcre_study_extra->flags |= extra.flags;
+        pcre_study_extra->match_limit = extra.match_limit;
+        pcre_study_extra->match_limit_recursion = extra.match_limit_recursion;
+        if (jit_stack != nullptr) {
+          pcre_assign_jit_stack(pcre_study_extra, nullptr, jit_stack);
+        }
+
+        int32_t is_jit_compiled = 0;
+        if (is_cached && pcre_fullinfo(pcre_regexp, pcre_study_extra, PCRE_INFO_JIT, &is_jit_compiled) == 0 && is_jit_compiled) {
+          ++vk::singleton<RegexpStats>::get().jit_compiled;
+        }
+      }
+    }
+#endif
   }
 
   //compile has finished
@@ -510,51 +648,172 @@ void regexp::init(const char *regexp_string, int64_t regexp_len, const char *fun
     subpatterns_count = RE2_regexp->NumberOfCapturingGroups();
   } else {
     php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_CAPTURECOUNT, &subpatterns_count) == 0);
+    php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMECOUNT, &named_subpatterns_count) == 0);
+  }
+  subpatterns_count++;
 
-    if (subpatterns_count) {
-      php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMECOUNT, &named_subpatterns_count) == 0);
-
-      if (named_subpatterns_count > 0) {
-        subpattern_names = new string[subpatterns_count + 1];
+  if (subpatterns_count > MAX_SUBPATTERNS) {
+    pattern_compilation_warning(function, file, "Maximum number of subpatterns %d exceeded, %d subpatterns found", MAX_SUBPATTERNS, subpatterns_count);
+    subpatterns_count = 0;
+    named_subpatterns_count = 0;
 
-        int32_t name_entry_size = 0;
-        php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMEENTRYSIZE, &name_entry_size) == 0);
+    delete RE2_regexp;
+    RE2_regexp = nullptr;
+    clean();
+    return;
+  }
 
-        char *name_table;
-        php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMETABLE, &name_table) == 0);
+  init_required_prefix(static_SB.c_str(), static_SB.size(), pcre_options);
 
-        for (int64_t i = 0; i < named_subpatterns_count; i++) {
-          int64_t name_id = (((unsigned char)name_table[0]) << 8) + (unsigned char)name_table[1];
-          string name(name_table + 2);
+  // the names of the cached regexps are created by each request in the script memory
+  if (!is_cached) {
+    init_subpattern_names(function, file);
+  }
+}
 
-          if (use_heap_memory) {
-            name.set_reference_counter_to(ExtraRefCnt::for_global_const);
-          }
+namespace {
 
-          if (name.is_int()) {
-            pattern_compilation_warning(function, file, "Numeric named subpatterns are not allowed");
-          } else {
-            subpattern_names[name_id] = name;
+bool has_top_level_alternation(const char *regexp_body, int64_t regexp_body_len) noexcept {
+  int64_t brackets_depth = 0;
+  for (int64_t i = 0; i < regexp_body_len; i++) {
+    switch (regexp_body[i]) {
+      case '\\':
+        if (regexp_body[i + 1] == 'Q') {
+          const void *quote_end = memmem(regexp_body + i, regexp_body_len - i, "\\E", 2);
+          i = quote_end ? static_cast<const char *>(quote_end) - regexp_body + 1 : regexp_body_len;
+        } else {
+          i++;
+        }
+        break;
+      case '[':
+        if (regexp_body[i + 1] == '^') {
+          i++;
+        }
+        if (regexp_body[i + 1] == ']') {
+          i++;
+        }
+        while (++i < regexp_body_len && regexp_body[i] != ']') {
+          if (regexp_body[i] == '\\') {
+            i++;
+          } else if (regexp_body[i] == '[' && regexp_body[i + 1] == ':') {
+            const void *class_end = memmem(regexp_body + i, regexp_body_len - i, ":]", 2);
+            i = class_end ? static_cast<const char *>(class_end) - regexp_body + 1 : regexp_body_len;
           }
-          name_table += name_entry_size;
         }
+        break;
+      case '(':
+        brackets_depth++;
+        break;
+      case ')':
+        brackets_depth--;
+        break;
+      case '|':
+        if (brackets_depth == 0) {
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void regexp::init_required_prefix(const char *regexp_body, int64_t regexp_body_len, int32_t pcre_options) noexcept {
+  if ((pcre_options & (PCRE_CASELESS | PCRE_EXTENDED)) || has_top_level_alternation(regexp_body, regexp_body_len)) {
+    return;
+  }
+
+  int64_t i = 0;
+  bool is_anchored = (pcre_options & PCRE_ANCHORED) != 0;
+  if (regexp_body[0] == '^') {
+    if (pcre_options & PCRE_MULTILINE) {
+      return;
+    }
+    is_anchored = true;
+    i++;
+  }
+
+  auto *prefix = static_cast<char *>(malloc(static_cast<size_t>(regexp_body_len)));
+  int64_t prefix_len = 0;
+  // a quantifier after the prefix applies to its last character only
+  int64_t last_char_start = 0;
+  for (; i < regexp_body_len; i++) {
+    char c = regexp_body[i];
+    if (c == '\\') {
+      c = regexp_body[i + 1];
+      if (!(('!' <= c && c <= '/') || (':' <= c && c <= '@') || ('[' <= c && c <= '`') || ('{' <= c && c <= '~'))) {
+        break;
       }
+      i++;
+    } else if (vk::any_of_equal(c, '^', '$', '.', '[', '|', '(', ')', '?', '*', '+', '{')) {
+      break;
     }
+    // in UTF-8 mode continuation bytes are parts of the previous character
+    if (!is_utf8 || (static_cast<unsigned char>(c) & 0xc0) != 0x80) {
+      last_char_start = prefix_len;
+    }
+    prefix[prefix_len++] = c;
   }
-  subpatterns_count++;
 
-  if (subpatterns_count > MAX_SUBPATTERNS) {
-    pattern_compilation_warning(function, file, "Maximum number of subpatterns %d exceeded, %d subpatterns found", MAX_SUBPATTERNS, subpatterns_count);
-    subpatterns_count = 0;
+  const bool is_quantified = i < regexp_body_len && vk::any_of_equal(regexp_body[i], '?', '*', '+', '{');
+  if (is_quantified) {
+    prefix_len = last_char_start;
+  }
+  if (prefix_len == 0) {
+    free(prefix);
+    return;
+  }
 
-    delete RE2_regexp;
-    RE2_regexp = nullptr;
+  required_prefix = prefix;
+  required_prefix_len = static_cast<int32_t>(prefix_len);
+  is_prefix_anchored = is_anchored;
+  is_literal = i == regexp_body_len && !is_anchored;
+}
 
-    delete[] subpattern_names;
-    subpattern_names = nullptr;
-    clean();
+const char *regexp::find_required_prefix(const string &subject, int64_t offset) const noexcept {
+  const char *search_start = subject.c_str() + offset;
+  const size_t search_len = subject.size() - offset;
+  if (is_prefix_anchored) {
+    return search_len >= required_prefix_len && memcmp(search_start, required_prefix, required_prefix_len) == 0 ? search_start : nullptr;
+  }
+  // both are vectorized by libc
+  if (required_prefix_len == 1) {
+    return static_cast<const char *>(memchr(search_start, required_prefix[0], search_len));
+  }
+  return static_cast<const char *>(memmem(search_start, search_len, required_prefix, required_prefix_len));
+}
+
+void regexp::init_subpattern_names(const char *function, const char *file) noexcept {
+  if (named_subpatterns_count == 0) {
     return;
   }
+
+  subpattern_names = new string[subpatterns_count];
+
+  int32_t name_entry_size = 0;
+  php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMEENTRYSIZE, &name_entry_size) == 0);
+
+  char *name_table;
+  php_assert (pcre_fullinfo(pcre_regexp, nullptr, PCRE_INFO_NAMETABLE, &name_table) == 0);
+
+  for (int64_t i = 0; i < named_subpatterns_count; i++) {
+    int64_t name_id = (((unsigned char)name_table[0]) << 8) + (unsigned char)name_table[1];
+    string name(name_table + 2);
+
+    if (use_heap_memory) {
+      name.set_reference_counter_to(ExtraRefCnt::for_global_const);
+    }
+
+    if (name.is_int()) {
+      pattern_compilation_warning(function, file, "Numeric named subpatterns are not allowed");
+    } else {
+      subpattern_names[name_id] = name;
+    }
+    name_table += name_entry_size;
+  }
 }
 
 void regexp::clean() {
@@ -570,6 +829,11 @@ void regexp::clean() {
   is_utf8 = false;
   use_heap_memory = false;
 
+  if (pcre_study_extra != nullptr) {
+    pcre_free_study(pcre_study_extra);
+    pcre_study_extra = nullptr;
+  }
+
   if (pcre_regexp != nullptr) {
     pcre_free(pcre_regexp);
     pcre_regexp = nullptr;
@@ -580,6 +844,12 @@ void regexp::clean() {
 
   delete[] subpattern_names;
   subpattern_names = nullptr;
+
+  free(required_prefix);
+  required_prefix = nullptr;
+  required_prefix_len = 0;
+  is_prefix_anchored = false;
+  is_literal = false;
 }
 
 regexp::~regexp() {
@@ -591,10 +861,28 @@ regexp::~regexp() {
 int64_t regexp::pcre_last_error;
 
 int64_t regexp::exec(const string &subject, int64_t offset, bool second_try) const {
+  if (required_prefix) {
+    // the prefix isn't empty, so neither are the matches and second_try is never set
+    const char *prefix_pos = find_required_prefix(subject, offset);
+    if (prefix_pos == nullptr) {
+      ++vk::singleton<RegexpStats>::get().prefilter_rejections;
+      return 0;
+    }
+    if (is_literal) {
+      ++vk::singleton<RegexpStats>::get().literal_searches;
+      submatch[0] = static_cast<int32_t>(prefix_pos - subject.c_str());
+      submatch[1] = submatch[0] + required_prefix_len;
+      return 1;
+    }
+    // no match can start before the prefix
+    offset = prefix_pos - subject.c_str();
+  }
+
   if (RE2_regexp && !second_try) {
     {
       dl::CriticalSectionGuard critical_section;
-      auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator(!use_heap_memory);
+      // the cached regexps live between requests, so do their lazily built automatons
+      auto malloc_replacement_guard = make_malloc_replacement_with_script_allocator(!use_heap_memory && !is_cached);
 
       re2::StringPiece text(subject.c_str(), subject.size());
       bool matched = RE2_regexp->Match(text, static_cast<int32_t>(offset), subject.size(), RE2::UNANCHORED, RE2_submatch, subpatterns_count);
@@ -623,8 +911,15 @@ int64_t regexp::exec(const string &subject, int64_t offset, bool second_try) con
 
   int32_t options = second_try ? PCRE_NO_UTF8_CHECK | PCRE_NOTEMPTY_ATSTART : PCRE_NO_UTF8_CHECK;
   dl::enter_critical_section();//OK
-  int64_t count = pcre_exec(pcre_regexp, &extra, subject.c_str(), subject.size(),
+  int64_t count = pcre_exec(pcre_regexp, pcre_study_extra ? pcre_study_extra : &extra, subject.c_str(), subject.size(),
                             static_cast<int32_t>(offset), options, submatch, 3 * subpatterns_count);
+#ifdef PCRE_STUDY_JIT_COMPILE
+  if (count == PCRE_ERROR_JIT_STACKLIMIT) {
+    // the interpreter isn't limited by the jit stack size
+    count = pcre_exec(pcre_regexp, &extra, subject.c_str(), subject.size(),
+                      static_cast<int32_t>(offset), options, submatch, 3 * subpatterns_count);
+  }
+#endif
   dl::leave_critical_section();
 
   php_assert (count != 0);
@@ -648,7 +943,7 @@ Optional<int64_t> regexp::match(const string &subject, bool all_matches) const {
     return false;
   }
 
-  if (is_utf8 && !mb_UTF8_check(subject.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(subject.c_str(), subject.size())) {
     pcre_last_error = PCRE_ERROR_BADUTF8;
     return false;
   }
@@ -698,7 +993,7 @@ Optional<int64_t> regexp::match(const string &subject, mixed &matches, bool all_
     return false;
   }
 
-  if (is_utf8 && !mb_UTF8_check(subject.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(subject.c_str(), subject.size())) {
     matches = array<mixed>();
     pcre_last_error = PCRE_ERROR_BADUTF8;
     return false;
@@ -793,7 +1088,7 @@ Optional<int64_t> regexp::match(const string &subject, mixed &matches, int64_t f
     return false;
   }
 
-  if (is_utf8 && !mb_UTF8_check(subject.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(subject.c_str(), subject.size())) {
     matches = array<mixed>();
     pcre_last_error = PCRE_ERROR_BADUTF8;
     return false;
@@ -934,7 +1229,7 @@ Optional<array<mixed>> regexp::split(const string &subject, int64_t limit, int64
     return false;
   }
 
-  if (is_utf8 && !mb_UTF8_check(subject.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(subject.c_str(), subject.size())) {
     pcre_last_error = PCRE_ERROR_BADUTF8;
     return false;
   }
@@ -1095,6 +1390,10 @@ void regexp::global_init() {
   extra.flags = PCRE_EXTRA_MATCH_LIMIT | PCRE_EXTRA_MATCH_LIMIT_RECURSION;
   extra.match_limit = PCRE_BACKTRACK_LIMIT;
   extra.match_limit_recursion = PCRE_RECURSION_LIMIT;
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+  jit_stack = pcre_jit_stack_alloc(PCRE_JIT_STACK_MIN_SIZE, PCRE_JIT_STACK_MAX_SIZE);
+#endif
 }
 
 void global_init_regexp_lib() {
@@ -7,6 +7,7 @@
 #include <pcre.h>
 
 #include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
 
 #include "runtime/kphp_core.h"
 #include "runtime/mbstring.h"
@@ -44,16 +45,40 @@ private:
   int32_t named_subpatterns_count{0};
   bool is_utf8{false};
   bool use_heap_memory{false};
+  // compiled data is owned by the worker regexp cache and lives between requests
+  bool is_cached{false};
 
   string *subpattern_names{nullptr};
 
   pcre *pcre_regexp{nullptr};
+  // study data with the jit compiled code, only regexps on heap have it
+  pcre_extra *pcre_study_extra{nullptr};
   re2::RE2 *RE2_regexp{nullptr};
 
+  // the literal every match starts with, the subject is searched for it before running the engines
+  char *required_prefix{nullptr};
+  int32_t required_prefix_len{0};
+  // the prefix is checked only at the search start, the regexp is anchored
+  bool is_prefix_anchored{false};
+  // the regexp is the prefix, its matches are found without the engines
+  bool is_literal{false};
+
   char *regex_compilation_warning{nullptr};
 
   void clean();
 
+  void compile(const char *regexp_string, int64_t regexp_len, const char *function, const char *file);
+
+  void init_subpattern_names(const char *function, const char *file) noexcept;
+
+  void init_required_prefix(const char *regexp_body, int64_t regexp_body_len, int32_t pcre_options) noexcept;
+
+  const char *find_required_prefix(const string &subject, int64_t offset) const noexcept;
+
+  void share_compiled_data(const regexp &other) noexcept;
+
+  static regexp *compile_cached(const string &regexp_string, const char *function, const char *file);
+
   int64_t exec(const string &subject, int64_t offset, bool second_try) const;
 
   bool is_valid_RE2_regexp(const char *regexp_string, int64_t regexp_len, bool is_utf8, const char *function, const char *file) noexcept;
@@ -100,6 +125,28 @@ public:
 
 void global_init_regexp_lib();
 
+// the maximum number of dynamic regexps kept compiled between requests by a worker, 0 disables the cache
+void set_regexp_cache_size(int64_t size) noexcept;
+
+struct RegexpStats : vk::not_copyable {
+public:
+  uint64_t cache_hits{0};
+  uint64_t cache_misses{0};
+  uint64_t cache_evictions{0};
+  uint64_t cache_size{0};
+  uint64_t jit_compiled{0};
+  uint64_t compile_time_ns{0};
+  // searches for a match stopped by the required prefix of the regexp missing in the subject
+  uint64_t prefilter_rejections{0};
+  // searches for a match of the literal regexp done without the regexp engines
+  uint64_t literal_searches{0};
+
+private:
+  RegexpStats() = default;
+
+  friend class vk::singleton<RegexpStats>;
+};
+
 inline void preg_add_match(array<mixed> &v, const mixed &match, const string &name);
 inline void preg_add_match(array<string> &v, const string &match, const string &name);
 
@@ -272,7 +319,7 @@ Optional<string> regexp::replace(const T &replace_val, const string &subject, in
     return {};
   }
 
-  if (is_utf8 && !mb_UTF8_check(subject.c_str())) {
+  if (is_utf8 && !mb_UTF8_check(subject.c_str(), subject.size())) {
     pcre_last_error = PCRE_ERROR_BADUTF8;
     return {};
   }
@@ -5,6 +5,7 @@
 #include "runtime/rpc.h"
 
 #include <cstdarg>
+#include <limits>
 
 #include "common/rpc-error-codes.h"
 #include "common/rpc-headers.h"
@@ -174,6 +175,10 @@ bool rpc_set_pos(int32_t pos) {
   return true;
 }
 
+int32_t rpc_get_remaining_len() {
+  return rpc_data_len;
+}
+
 
 static inline void check_rpc_data_len(int64_t len) {
   if (rpc_data_len < len) {
@@ -240,6 +245,24 @@ void f$fetch_raw_vector_double(array<double> &out, int64_t n_elems) {
   rpc_data += rpc_data_buf_offset;
 }
 
+void fetch_raw_vector_int(array<int64_t> &out, int64_t n_elems) {
+  TRY_CALL_VOID(void, (check_rpc_data_len(n_elems)));
+  out.convert_vector(n_elems, reinterpret_cast<const int32_t *>(rpc_data));
+  rpc_data += n_elems;
+}
+
+void fetch_raw_vector_long(array<int64_t> &out, int64_t n_elems) {
+  TRY_CALL_VOID(void, (check_rpc_data_len(2 * n_elems)));
+  out.memcpy_vector(n_elems, rpc_data);
+  rpc_data += 2 * n_elems;
+}
+
+void fetch_raw_vector_float(array<double> &out, int64_t n_elems) {
+  TRY_CALL_VOID(void, (check_rpc_data_len(n_elems)));
+  out.convert_vector(n_elems, reinterpret_cast<const float *>(rpc_data));
+  rpc_data += n_elems;
+}
+
 static inline const char *f$fetch_string_raw(int *string_len) {
   TRY_CALL_VOID_(check_rpc_data_len(1), return nullptr);
   const char *str = reinterpret_cast <const char *> (rpc_data);
@@ -401,6 +424,46 @@ void f$store_raw_vector_double(const array<double> &vector) {
                   sizeof(double) * vector.count());
 }
 
+// Narrows the elements through a small stack chunk, so the conversion loop is vectorized
+// and the buffer is grown once per chunk instead of once per element
+template<class To, class From>
+static inline void store_raw_vector_converted(const From *src, int64_t n) {
+  constexpr int64_t chunk_size = 256;
+  To chunk[chunk_size];
+  data_buf.reserve(static_cast<int>(sizeof(To) * n));
+  for (int64_t done = 0; done < n; done += chunk_size) {
+    const int64_t len = std::min(chunk_size, n - done);
+    for (int64_t i = 0; i < len; ++i) {
+      chunk[i] = static_cast<To>(src[done + i]);
+    }
+    data_buf.append(reinterpret_cast<const char *>(chunk), sizeof(To) * len);
+  }
+}
+
+bool store_raw_vector_int(const array<int64_t> &vector) {
+  const int64_t *src = vector.get_const_vector_pointer();
+  const int64_t n = vector.count();
+  bool overflow = false;
+  for (int64_t i = 0; i < n; ++i) {
+    // the same range as is_int32_overflow() accepts, but without branches
+    overflow |= (src[i] < std::numeric_limits<int32_t>::min()) | (src[i] > std::numeric_limits<uint32_t>::max());
+  }
+  if (unlikely(overflow)) {
+    return false;
+  }
+  store_raw_vector_converted<int32_t>(src, n);
+  return true;
+}
+
+void store_raw_vector_long(const array<int64_t> &vector) {
+  data_buf.append(reinterpret_cast<const char *>(vector.get_const_vector_pointer()),
+                  sizeof(int64_t) * vector.count());
+}
+
+void store_raw_vector_float(const array<double> &vector) {
+  store_raw_vector_converted<float>(vector.get_const_vector_pointer(), vector.count());
+}
+
 bool store_header(long long cluster_id, int64_t flags) {
   if (flags) {
     store_int(TL_RPC_DEST_ACTOR_FLAGS);
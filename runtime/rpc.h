@@ -48,6 +48,8 @@ int32_t rpc_get_pos();
 
 bool rpc_set_pos(int32_t pos);
 
+int32_t rpc_get_remaining_len();
+
 int32_t rpc_lookup_int();
 
 int32_t rpc_fetch_int();
@@ -74,6 +76,9 @@ bool f$fetch_eof();
 bool f$fetch_end();
 
 void f$fetch_raw_vector_double(array<double> &out, int64_t n_elems);
+void fetch_raw_vector_int(array<int64_t> &out, int64_t n_elems);
+void fetch_raw_vector_long(array<int64_t> &out, int64_t n_elems);
+void fetch_raw_vector_float(array<double> &out, int64_t n_elems);
 
 void estimate_and_flush_overflow(size_t &bytes_sent);
 
@@ -120,6 +125,10 @@ bool f$store_error(int64_t error_code, const string &error_text);
 bool f$store_raw(const string &data);
 
 void f$store_raw_vector_double(const array<double> &vector);
+// returns false without storing anything if some element doesn't fit into int32
+bool store_raw_vector_int(const array<int64_t> &vector);
+void store_raw_vector_long(const array<int64_t> &vector);
+void store_raw_vector_float(const array<double> &vector);
 
 bool f$set_fail_rpc_on_int32_overflow(bool fail_rpc); // TODO: remove when all RPC errors will be fixed
 
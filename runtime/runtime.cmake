@@ -2,6 +2,7 @@ prepend(KPHP_RUNTIME_MEMORY_RESOURCE_SOURCES memory_resource/
         dealer.cpp
         details/memory_chunk_tree.cpp
         details/memory_ordered_chunk_list.cpp
+        frozen_resource.cpp
         heap_resource.cpp
         memory_resource.cpp
         monotonic_buffer_resource.cpp
@@ -16,6 +17,7 @@ prepend(KPHP_RUNTIME_JOB_WORKERS_SOURCES job-workers/
 prepend(KPHP_RUNTIME_SOURCES ${BASE_DIR}/runtime/
         ${KPHP_RUNTIME_MEMORY_RESOURCE_SOURCES}
         ${KPHP_RUNTIME_JOB_WORKERS_SOURCES}
+        aho-corasick.cpp
         allocator.cpp
         array_functions.cpp
         bcmath.cpp
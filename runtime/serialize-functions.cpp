@@ -65,10 +65,195 @@ void impl_::PhpSerializer::serialize(const mixed &v) noexcept {
 
 namespace {
 
-int do_unserialize(const char *s, int s_len, mixed &out_var_value) noexcept {
+// SWAR parsing of 8 digits at once, the chunk holds the bytes in little-endian order
+bool is_eight_digits(uint64_t chunk) noexcept {
+  return !(((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL);
+}
+
+uint64_t parse_eight_digits(uint64_t chunk) noexcept {
+  chunk -= 0x3030303030303030ULL;
+  chunk = chunk * 10 + (chunk >> 8);
+  return (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+          (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+// parses an integer of 18 digits at most written as php writes it, such integers can't overflow int64_t;
+// returns the length of the integer or 0 if it doesn't fit this fast path
+int parse_short_int(const char *s, int s_len, int64_t &value) noexcept {
+  constexpr int max_digits = std::numeric_limits<int64_t>::digits10;
+  const bool has_minus = s_len > 0 && s[0] == '-';
+  const int digits_begin = has_minus;
+  int pos = digits_begin;
+  uint64_t result = 0;
+  for (int chunks = 0; chunks < 2 && pos + 8 <= s_len; ++chunks) {
+    uint64_t chunk = 0;
+    memcpy(&chunk, s + pos, sizeof(chunk));
+    if (!is_eight_digits(chunk)) {
+      break;
+    }
+    result = result * 100000000 + parse_eight_digits(chunk);
+    pos += 8;
+  }
+  while (pos < s_len && pos - digits_begin <= max_digits && '0' <= s[pos] && s[pos] <= '9') {
+    result = result * 10 + s[pos++] - '0';
+  }
+
+  const int digits = pos - digits_begin;
+  if (digits == 0 || digits > max_digits || (s[digits_begin] == '0' && (digits > 1 || has_minus))) {
+    return 0;
+  }
+  value = has_minus ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+  return pos;
+}
+
+// parses the "<digits>;" part of "i:<digits>;", the integers which don't fit int64_t are kept as strings;
+// returns the length including ';' or 0 on error
+int unserialize_int(const char *s, int s_len, int64_t &int_value, string &string_value, bool &is_int) noexcept {
+  is_int = true;
+  const int len = parse_short_int(s, s_len, int_value);
+  if (len && len < s_len && s[len] == ';') {
+    return len + 1;
+  }
+
+  const char *end = static_cast<const char *>(memchr(s, ';', s_len));
+  if (!end) {
+    return 0;
+  }
+  const int j = static_cast<int>(end - s);
+  if (php_try_to_int(s, j, &int_value)) {
+    return j + 1;
+  }
+
+  int k = 0;
+  if (s[k] == '-' || s[k] == '+') {
+    k++;
+  }
+  while ('0' <= s[k] && s[k] <= '9') {
+    k++;
+  }
+  if (k == j) {
+    is_int = false;
+    string_value.assign(s, j);
+    return j + 1;
+  }
+  return 0;
+}
+
+// parses the "<length>:" part of "s:<length>:" and "a:<count>:", the length can't exceed the rest of the string;
+// returns the length including ':' or 0 on error
+int unserialize_length(const char *s, int s_len, int64_t &length) noexcept {
+  int j = 0;
+  length = 0;
+  while (j < s_len && '0' <= s[j] && s[j] <= '9') {
+    length = length * 10 + s[j++] - '0';
+    if (length > s_len) {
+      return 0;
+    }
+  }
+  return j > 0 && j < s_len && s[j] == ':' ? j + 1 : 0;
+}
+
+// parses the "<length>:"<chars>";" part of "s:<length>:"<chars>";";
+// returns the length or 0 on error
+int unserialize_string(const char *s, int s_len, const char *&chars, string::size_type &chars_len) noexcept {
+  int64_t len = 0;
+  int pos = unserialize_length(s, s_len, len);
+  if (!pos || len >= string::max_size() || pos + len + 3 > s_len || s[pos] != '"') {
+    return 0;
+  }
+  ++pos;
+  if (s[pos + len] != '"' || s[pos + len + 1] != ';') {
+    return 0;
+  }
+  chars = s + pos;
+  chars_len = static_cast<string::size_type>(len);
+  return static_cast<int>(pos + len + 2);
+}
+
+class PhpUnserializer : vk::not_copyable {
+public:
+  // returns the length of the parsed value or 0 on error
+  int unserialize(const char *s, int s_len, mixed &out_var_value) noexcept;
+
+private:
+  int unserialize_array(const char *s, int s_len, mixed &out_var_value) noexcept;
+  void assign_key(const char *chars, string::size_type chars_len, string &key) noexcept;
+
+  // arrays of the same shape repeat their keys, the strings of the recent keys are shared instead of being copied
+  static constexpr size_t RECENT_KEYS_SIZE = 16;
+  string recent_keys_[RECENT_KEYS_SIZE];
+};
+
+void PhpUnserializer::assign_key(const char *chars, string::size_type chars_len, string &key) noexcept {
+  string &recent_key = recent_keys_[(chars_len + (chars_len ? static_cast<unsigned char>(chars[chars_len - 1]) : 0)) % RECENT_KEYS_SIZE];
+  if (recent_key.size() != chars_len || memcmp(recent_key.c_str(), chars, chars_len) != 0) {
+    recent_key = string{chars, chars_len};
+  }
+  key = recent_key;
+}
+
+// parses the "<count>:{<elements>}" part of "a:<count>:{<elements>}"
+int PhpUnserializer::unserialize_array(const char *s, int s_len, mixed &out_var_value) noexcept {
+  int64_t count = 0;
+  int pos = unserialize_length(s, s_len, count);
+  if (!pos || pos >= s_len || s[pos] != '{') {
+    return 0;
+  }
+  ++pos;
+
+  // the declared count pre-sizes the array, keys 0, 1, ... make a vector
+  array_size size(0, count, false);
+  if (pos + 1 < s_len && s[pos] == 'i') {//try to cheat
+    size = array_size(count, 0, pos + 3 < s_len && s[pos + 1] == ':' && s[pos + 2] == '0' && s[pos + 3] == ';');
+  }
+  array<mixed> res(size);
+
+  int64_t int_key = 0;
+  string string_key;
+  bool is_int_key = false;
+  while (count-- > 0) {
+    if (pos + 1 >= s_len || s[pos + 1] != ':') {
+      return 0;
+    }
+    int key_len = 0;
+    if (s[pos] == 'i') {
+      key_len = unserialize_int(s + pos + 2, s_len - pos - 2, int_key, string_key, is_int_key);
+    } else if (s[pos] == 's') {
+      const char *chars = nullptr;
+      string::size_type chars_len = 0;
+      key_len = unserialize_string(s + pos + 2, s_len - pos - 2, chars, chars_len);
+      if (key_len) {
+        is_int_key = false;
+        assign_key(chars, chars_len, string_key);
+      }
+    }
+    if (!key_len) {
+      return 0;
+    }
+    pos += key_len + 2;
+
+    mixed &value = is_int_key ? res[int_key] : res[string_key];
+    const int value_len = unserialize(s + pos, s_len - pos, value);
+    if (!value_len) {
+      return 0;
+    }
+    pos += value_len;
+  }
+
+  if (pos < s_len && s[pos] == '}') {
+    out_var_value = std::move(res);
+    return pos + 1;
+  }
+  return 0;
+}
+
+int PhpUnserializer::unserialize(const char *s, int s_len, mixed &out_var_value) noexcept {
   if (!out_var_value.is_null()) {
     out_var_value = mixed{};
   }
+  if (s_len < 2) {
+    return 0;
+  }
   switch (s[0]) {
     case 'N':
       if (s[1] == ';') {
@@ -76,7 +261,7 @@ int do_unserialize(const char *s, int s_len, mixed &out_var_value) noexcept {
       }
       break;
     case 'b':
-      if (s[1] == ':' && (static_cast<unsigned int>(s[2] - '0') < 2u) && s[3] == ';') {
+      if (s_len >= 4 && s[1] == ':' && (static_cast<unsigned int>(s[2] - '0') < 2u) && s[3] == ';') {
         out_var_value = static_cast<bool>(s[2] - '0');
         return 4;
       }
@@ -94,146 +279,33 @@ int do_unserialize(const char *s, int s_len, mixed &out_var_value) noexcept {
       break;
     case 'i':
       if (s[1] == ':') {
-        s += 2;
-        int j = 0;
-        while (s[j]) {
-          if (s[j] == ';') {
-            int64_t intval = 0;
-            if (php_try_to_int(s, j, &intval)) {
-              s += j + 1;
-              out_var_value = intval;
-              return j + 3;
-            }
-
-            int k = 0;
-            if (s[k] == '-' || s[k] == '+') {
-              k++;
-            }
-            while ('0' <= s[k] && s[k] <= '9') {
-              k++;
-            }
-            if (k == j) {
-              out_var_value = mixed(s, j);
-              return j + 3;
-            }
-            return 0;
+        int64_t int_value = 0;
+        string string_value;
+        bool is_int = false;
+        if (const int len = unserialize_int(s + 2, s_len - 2, int_value, string_value, is_int)) {
+          if (is_int) {
+            out_var_value = int_value;
+          } else {
+            out_var_value = std::move(string_value);
           }
-          j++;
+          return len + 2;
         }
       }
       break;
     case 's':
       if (s[1] == ':') {
-        s += 2;
-        uint32_t j = 0;
-        uint32_t len = 0;
-        while ('0' <= s[j] && s[j] <= '9') {
-          len = len * 10 + s[j++] - '0';
-        }
-        if (j > 0 && s[j] == ':' && s[j + 1] == '"' && len < string::max_size() && j + 2 + len < s_len) {
-          s += j + 2;
-
-          if (s[len] == '"' && s[len + 1] == ';') {
-            out_var_value = mixed(s, len);
-            return len + 6 + j;
-          }
+        const char *chars = nullptr;
+        string::size_type chars_len = 0;
+        if (const int len = unserialize_string(s + 2, s_len - 2, chars, chars_len)) {
+          out_var_value = mixed(chars, chars_len);
+          return len + 2;
         }
       }
       break;
     case 'a':
       if (s[1] == ':') {
-        const char *s_begin = s;
-        s += 2;
-        int j = 0;
-        int len = 0;
-        while ('0' <= s[j] && s[j] <= '9') {
-          len = len * 10 + s[j++] - '0';
-        }
-        if (j > 0 && len >= 0 && s[j] == ':' && s[j + 1] == '{') {
-          s += j + 2;
-          s_len -= j + 4;
-
-          array_size size(0, len, false);
-          if (s[0] == 'i') {//try to cheat
-            size = array_size(len, 0, s[1] == ':' && s[2] == '0' && s[3] == ';');
-          }
-          array<mixed> res(size);
-
-          while (len-- > 0) {
-            if (s[0] == 'i' && s[1] == ':') {
-              s += 2;
-              int k = 0;
-              while (s[k]) {
-                if (s[k] == ';') {
-                  int64_t intval = 0;
-                  if (php_try_to_int(s, k, &intval)) {
-                    s += k + 1;
-                    s_len -= k + 3;
-                    int length = do_unserialize(s, s_len, res[intval]);
-                    if (!length) {
-                      return 0;
-                    }
-                    s += length;
-                    s_len -= length;
-                    break;
-                  }
-
-                  int q = 0;
-                  if (s[q] == '-' || s[q] == '+') {
-                    q++;
-                  }
-                  while ('0' <= s[q] && s[q] <= '9') {
-                    q++;
-                  }
-                  if (q == k) {
-                    string key(s, k);
-                    s += k + 1;
-                    s_len -= k + 3;
-                    int length = do_unserialize(s, s_len, res[key]);
-                    if (!length) {
-                      return 0;
-                    }
-                    s += length;
-                    s_len -= length;
-                    break;
-                  }
-                  return 0;
-                }
-                k++;
-              }
-            } else if (s[0] == 's' && s[1] == ':') {
-              s += 2;
-              uint32_t k = 0;
-              uint32_t str_len = 0;
-              while ('0' <= s[k] && s[k] <= '9') {
-                str_len = str_len * 10 + s[k++] - '0';
-              }
-              if (k > 0 && s[k] == ':' && s[k + 1] == '"' && str_len < string::max_size() && k + 2 + str_len < s_len) {
-                s += k + 2;
-
-                if (s[str_len] == '"' && s[str_len + 1] == ';') {
-                  string key(s, str_len);
-                  s += str_len + 2;
-                  s_len -= str_len + 6 + k;
-                  int length = do_unserialize(s, s_len, res[key]);
-                  if (!length) {
-                    return 0;
-                  }
-                  s += length;
-                  s_len -= length;
-                }
-              } else {
-                return 0;
-              }
-            } else {
-              return 0;
-            }
-          }
-
-          if (s[0] == '}') {
-            out_var_value = std::move(res);
-            return static_cast<int>(s - s_begin + 1);
-          }
+        if (const int len = unserialize_array(s + 2, s_len - 2, out_var_value)) {
+          return len + 2;
         }
       }
       break;
@@ -246,7 +318,7 @@ int do_unserialize(const char *s, int s_len, mixed &out_var_value) noexcept {
 mixed unserialize_raw(const char *v, int32_t v_len) noexcept {
   mixed result;
 
-  if (do_unserialize(v, v_len, result) == v_len) {
+  if (PhpUnserializer{}.unserialize(v, v_len, result) == v_len) {
     return result;
   }
 
@@ -8,6 +8,7 @@
 #include <sys/types.h>
 
 #include "common/macos-ports.h"
+#include "common/string-encoders.h"
 #include "common/unicode/unicode-utils.h"
 
 #include "runtime/interface.h"
@@ -120,14 +121,8 @@ string f$addslashes(const string &str) {
 }
 
 string f$bin2hex(const string &str) {
-  int len = str.size();
-  string result(2 * len, false);
-
-  for (int i = 0; i < len; i++) {
-    result[2 * i] = lhex_digits[(str[i] >> 4) & 15];
-    result[2 * i + 1] = lhex_digits[str[i] & 15];
-  }
-
+  string result(2 * str.size(), false);
+  encode_hex(reinterpret_cast<const unsigned char *>(str.c_str()), str.size(), result.buffer());
   return result;
 }
 
@@ -240,14 +235,9 @@ string f$hex2bin(const string &str) {
   }
 
   string result(len / 2, false);
-  for (int i = 0; i < len; i += 2) {
-    int num_high = hex_to_int(str[i]);
-    int num_low = hex_to_int(str[i + 1]);
-    if (num_high == 16 || num_low == 16) {
-      php_warning("Wrong argument \"%s\" supplied for function hex2bin", str.c_str());
-      return string();
-    }
-    result[i / 2] = (char)((num_high << 4) + num_low);
+  if (!decode_hex(str.c_str(), len / 2, reinterpret_cast<unsigned char *>(result.buffer()))) {
+    php_warning("Wrong argument \"%s\" supplied for function hex2bin", str.c_str());
+    return string();
   }
 
   return result;
@@ -463,60 +453,16 @@ string f$htmlspecialchars(const string &str, int64_t flags) {
     php_critical_error ("unsupported parameter flags = %" PRIi64 " in function htmlspecialchars", flags);
   }
 
-  const string::size_type len = str.size();
-  static_SB.clean().reserve(6 * len);
-
-  for (string::size_type i = 0; i < len; i++) {
-    switch (str[i]) {
-      case '&':
-        static_SB.append_char('&');
-        static_SB.append_char('a');
-        static_SB.append_char('m');
-        static_SB.append_char('p');
-        static_SB.append_char(';');
-        break;
-      case '"':
-        if (!(flags & ENT_NOQUOTES)) {
-          static_SB.append_char('&');
-          static_SB.append_char('q');
-          static_SB.append_char('u');
-          static_SB.append_char('o');
-          static_SB.append_char('t');
-          static_SB.append_char(';');
-        } else {
-          static_SB.append_char('"');
-        }
-        break;
-      case '\'':
-        if (flags & ENT_QUOTES) {
-          static_SB.append_char('&');
-          static_SB.append_char('#');
-          static_SB.append_char('0');
-          static_SB.append_char('3');
-          static_SB.append_char('9');
-          static_SB.append_char(';');
-        } else {
-          static_SB.append_char('\'');
-        }
-        break;
-      case '<':
-        static_SB.append_char('&');
-        static_SB.append_char('l');
-        static_SB.append_char('t');
-        static_SB.append_char(';');
-        break;
-      case '>':
-        static_SB.append_char('&');
-        static_SB.append_char('g');
-        static_SB.append_char('t');
-        static_SB.append_char(';');
-        break;
-      default:
-        static_SB.append_char(str[i]);
-    }
+  const bool double_quotes = !(flags & ENT_NOQUOTES);
+  const bool single_quotes = flags & ENT_QUOTES;
+  const size_t result_len = html_escaped_len(str.c_str(), str.size(), double_quotes, single_quotes);
+  if (result_len == str.size()) {
+    return str;
   }
 
-  return static_SB.str();
+  string result(static_cast<string::size_type>(result_len), false);
+  escape_html(str.c_str(), str.size(), result.buffer(), double_quotes, single_quotes);
+  return result;
 }
 
 string f$htmlspecialchars_decode(const string &str, int64_t flags) {
@@ -1870,6 +1816,26 @@ string f$strtoupper(const string &str) {
   return res;
 }
 
+string strtr(const string &subject, const AhoCorasick &automaton, const array<string> &replaces) {
+  string result;
+  int64_t pos = 0;
+  while (true) {
+    int64_t match_pos = 0;
+    const int64_t found = automaton.find_leftmost_longest(subject, pos, match_pos);
+    if (found == -1) {
+      break;
+    }
+    result.append(subject.c_str() + pos, static_cast<string::size_type>(match_pos - pos));
+    result.append(replaces.get_value(found));
+    pos = match_pos + automaton.pattern_length(found);
+  }
+  if (pos == 0) {
+    return subject;
+  }
+  result.append(subject.c_str() + pos, static_cast<string::size_type>(subject.size() - pos));
+  return result;
+}
+
 string f$strtr(const string &subject, const string &from, const string &to) {
   int n = subject.size();
   string result(n, false);
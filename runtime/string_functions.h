@@ -5,6 +5,7 @@
 #pragma once
 
 #include <type_traits>
+#include "runtime/aho-corasick.h"
 #include "runtime/kphp_core.h"
 
 extern const string COLON;
@@ -169,28 +170,75 @@ string f$str_ireplace(const string &search, const string &replace, const string
 void str_replace_inplace(const string &search, const string &replace, string &subject, int64_t &replace_count, bool with_case);
 string str_replace(const string &search, const string &replace, const string &subject, int64_t &replace_count, bool with_case);
 
+// with this many search strings most of them usually don't occur in the subject,
+// so it's cheaper to find the occurring ones in one pass than to do a pass for every search string
+constexpr int64_t STR_REPLACE_AHO_CORASICK_MIN_SEARCH_COUNT = 8;
+
+template<typename T>
+const AhoCorasick *get_str_replace_automaton(const array<T> &search) {
+  if (const AhoCorasick *cached = find_cached_aho_corasick(search.get_inner_pointer(), AhoCorasickCacheKind::str_replace_search, nullptr)) {
+    return cached;
+  }
+  array<string> patterns(array_size(search.count(), 0, true));
+  for (typename array<T>::const_iterator it = search.begin(); it != search.end(); ++it) {
+    patterns.push_back(f$strval(it.get_value()));
+  }
+  if (const AhoCorasick *cached = find_cached_aho_corasick_by_values(AhoCorasickCacheKind::str_replace_search, patterns)) {
+    return cached;
+  }
+  auto *automaton = new AhoCorasick(patterns);
+  cache_aho_corasick(search, AhoCorasickCacheKind::str_replace_search, automaton, patterns);
+  return automaton;
+}
+
 template<typename T1, typename T2>
 string str_replace_string_array(const array<T1> &search, const array<T2> &replace, const string &subject, int64_t &replace_count, bool with_case) {
   string result = subject;
 
+  const AhoCorasick *automaton = nullptr;
+  array<bool> occurring;
+  if (with_case && search.count() >= STR_REPLACE_AHO_CORASICK_MIN_SEARCH_COUNT) {
+    automaton = get_str_replace_automaton(search);
+    automaton->find_occurring_patterns(result, occurring);
+  }
+
   string replace_value;
   typename array<T2>::const_iterator cur_replace_val;
   cur_replace_val = replace.begin();
 
-  for (typename array<T1>::const_iterator it = search.begin(); it != search.end(); ++it) {
+  int64_t search_index = 0;
+  for (typename array<T1>::const_iterator it = search.begin(); it != search.end(); ++it, ++search_index) {
+    typename array<T2>::const_iterator search_replace_val = cur_replace_val;
     if (cur_replace_val != replace.end()) {
-      replace_value = f$strval(cur_replace_val.get_value());
       ++cur_replace_val;
+    }
+    // empty search strings are not skipped, they produce a warning
+    if (automaton && !occurring.get_value(search_index) && automaton->pattern_length(search_index) != 0) {
+      continue;
+    }
+
+    if (search_replace_val != replace.end()) {
+      replace_value = f$strval(search_replace_val.get_value());
     } else {
       replace_value = string();
     }
 
+    const int64_t replace_count_before = replace_count;
     const string &search_string = f$strval(it.get_value());
     if (search_string.size() >= replace_value.size()) {
       str_replace_inplace(search_string, replace_value, result, replace_count, with_case);
     } else {
       result = str_replace(search_string, replace_value, result, replace_count, with_case);
     }
+    // the following search strings are applied to the result, replacements may have added or removed their occurrences;
+    // a rescan pays off only while it saves at least as many passes as the threshold, the plain loop finishes the rest
+    if (automaton && replace_count != replace_count_before) {
+      if (search.count() - search_index - 1 >= STR_REPLACE_AHO_CORASICK_MIN_SEARCH_COUNT) {
+        automaton->find_occurring_patterns(result, occurring);
+      } else {
+        automaton = nullptr;
+      }
+    }
   }
 
   return result;
@@ -360,8 +408,13 @@ Optional<string> f$strstr(const string &haystack, const mixed &needle, bool befo
   }
 }
 
+string strtr(const string &subject, const AhoCorasick &automaton, const array<string> &replaces);
+
+// a few pairs are found with memmem faster than the automaton is built, and such pairs are usually a fresh array on every call
+constexpr int64_t STRTR_AHO_CORASICK_MIN_PAIRS_COUNT = 8;
+
 template<class T>
-string f$strtr(const string &subject, const array<T> &replace_pairs) {
+string strtr_by_memmem(const string &subject, const array<T> &replace_pairs) {
   const char *piece = subject.c_str(), *piece_end = subject.c_str() + subject.size();
   string result;
   while (1) {
@@ -395,6 +448,31 @@ string f$strtr(const string &subject, const array<T> &replace_pairs) {
   return result;
 }
 
+template<class T>
+string f$strtr(const string &subject, const array<T> &replace_pairs) {
+  if (replace_pairs.count() < STRTR_AHO_CORASICK_MIN_PAIRS_COUNT) {
+    return strtr_by_memmem(subject, replace_pairs);
+  }
+  array<string> replaces;
+  const AhoCorasick *automaton = find_cached_aho_corasick(replace_pairs.get_inner_pointer(), AhoCorasickCacheKind::strtr_pairs, &replaces);
+  if (!automaton) {
+    array<string> searches(array_size(replace_pairs.count(), 0, true));
+    replaces = array<string>(array_size(replace_pairs.count(), 0, true));
+    for (typename array<T>::const_iterator p = replace_pairs.begin(); p != replace_pairs.end(); ++p) {
+      string search = f$strval(p.get_key());
+      if (search.empty()) {
+        return subject;
+      }
+      searches.push_back(std::move(search));
+      replaces.push_back(f$strval(p.get_value()));
+    }
+    auto *built = new AhoCorasick(searches);
+    cache_aho_corasick(replace_pairs, AhoCorasickCacheKind::strtr_pairs, built, replaces);
+    automaton = built;
+  }
+  return strtr(subject, *automaton, replaces);
+}
+
 inline string f$strtr(const string &subject, const mixed &from, const mixed &to) {
   return f$strtr(subject, from.to_string(), to.to_string());
 }
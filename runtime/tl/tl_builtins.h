@@ -21,6 +21,12 @@
 int tl_parse_save_pos();
 bool tl_parse_restore_pos(int pos);
 
+// Element counts come from the answer itself, so they are trusted only as far as the answer size allows:
+// any element except a bare True takes at least one int, which bounds a preallocation for a broken answer
+inline int64_t tl_fetch_reserve_size(int64_t elements_count) {
+  return std::min<int64_t>(elements_count, rpc_get_remaining_len());
+}
+
 struct tl_exclamation_fetch_wrapper {
   std::unique_ptr<tl_func_base> fetcher;
 
@@ -76,26 +82,6 @@ inline void fetch_magic_if_not_bare(unsigned int inner_magic, const char *error_
   }
 }
 
-template<class T>
-inline void fetch_raw_vector_T(array<T> &out __attribute__ ((unused)), int64_t n_elems __attribute__ ((unused))) {
-  php_assert(0 && "never called in runtime");
-}
-
-template<>
-inline void fetch_raw_vector_T<double>(array<double> &out, int64_t n_elems) {
-  f$fetch_raw_vector_double(out, n_elems);
-}
-
-template<class T>
-inline void store_raw_vector_T(const array<T> &v __attribute__ ((unused))) {
-  php_assert(0 && "never called in runtime");
-}
-
-template<>
-inline void store_raw_vector_T<double>(const array<double> &v) {
-  f$store_raw_vector_double(v);
-}
-
 // Wrap into Optional that TL types which PhpType is:
 //  1. int, double, string, bool
 //  2. array<T>
@@ -241,6 +227,67 @@ struct t_Float {
   }
 };
 
+// Bare vectors of these types are fetched and stored in bulk, without per element calls
+template<class SerializerT>
+struct tl_has_raw_vector : vk::is_type_in_list<SerializerT, t_Int, t_Long, t_Double, t_Float> {
+};
+
+template<class SerializerT>
+inline void fetch_raw_vector_T(array<typename SerializerT::PhpType> &out __attribute__ ((unused)), int64_t n_elems __attribute__ ((unused))) {
+  php_assert(0 && "never called in runtime");
+}
+
+template<>
+inline void fetch_raw_vector_T<t_Int>(array<int64_t> &out, int64_t n_elems) {
+  fetch_raw_vector_int(out, n_elems);
+}
+
+template<>
+inline void fetch_raw_vector_T<t_Long>(array<int64_t> &out, int64_t n_elems) {
+  fetch_raw_vector_long(out, n_elems);
+}
+
+template<>
+inline void fetch_raw_vector_T<t_Double>(array<double> &out, int64_t n_elems) {
+  f$fetch_raw_vector_double(out, n_elems);
+}
+
+template<>
+inline void fetch_raw_vector_T<t_Float>(array<double> &out, int64_t n_elems) {
+  fetch_raw_vector_float(out, n_elems);
+}
+
+// returns false if nothing was stored and the vector has to be stored element by element
+template<class SerializerT>
+inline bool store_raw_vector_T(const array<typename SerializerT::PhpType> &v __attribute__ ((unused))) {
+  php_assert(0 && "never called in runtime");
+  return false;
+}
+
+template<>
+inline bool store_raw_vector_T<t_Int>(const array<int64_t> &v) {
+  // int32 overflows are reported by the per element path
+  return store_raw_vector_int(v);
+}
+
+template<>
+inline bool store_raw_vector_T<t_Long>(const array<int64_t> &v) {
+  store_raw_vector_long(v);
+  return true;
+}
+
+template<>
+inline bool store_raw_vector_T<t_Double>(const array<double> &v) {
+  f$store_raw_vector_double(v);
+  return true;
+}
+
+template<>
+inline bool store_raw_vector_T<t_Float>(const array<double> &v) {
+  store_raw_vector_float(v);
+  return true;
+}
+
 struct t_String {
   void store(const mixed &tl_object) {
     f$store_string(f$strval(tl_object));
@@ -349,7 +396,7 @@ struct t_Vector {
       CurrentProcessingQuery::get().raise_fetching_error("Vector size is negative");
       return array<mixed>();
     }
-    array<mixed> result(array_size(std::min(n, 10000), 0, true));
+    array<mixed> result(array_size(tl_fetch_reserve_size(n), 0, true));
     for (int i = 0; i < n; ++i) {
       fetch_magic_if_not_bare(inner_magic, "Incorrect magic of inner type of type Vector");
       const mixed &cur_elem = elem_state.fetch();
@@ -366,8 +413,7 @@ struct t_Vector {
     int64_t n = v.count();
     f$store_int(n);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector()) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0 && v.is_vector() && store_raw_vector_T<T>(v)) {
       return;
     }
 
@@ -388,10 +434,10 @@ struct t_Vector {
       CurrentProcessingQuery::get().raise_fetching_error("Vector size is negative");
       return;
     }
-    out.reserve(n, 0, true);
+    out.reserve(tl_fetch_reserve_size(n), 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, n);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0) {
+      fetch_raw_vector_T<T>(out, n);
       return;
     }
 
@@ -507,6 +553,8 @@ struct tl_Dictionary_impl {
     }
   }
 
+  static constexpr bool has_string_keys = std::is_same<KeyT, t_String>::value;
+
   array<mixed> fetch() {
     CHECK_EXCEPTION(return array<mixed>());
     array<mixed> result;
@@ -515,6 +563,8 @@ struct tl_Dictionary_impl {
       CurrentProcessingQuery::get().raise_fetching_error("Dictionary size is negative");
       return result;
     }
+    const int64_t reserve_size = tl_fetch_reserve_size(n);
+    result.reserve(has_string_keys ? 0 : reserve_size, has_string_keys ? reserve_size : 0, false);
     for (int32_t i = 0; i < n; ++i) {
       const auto &key = KeyT().fetch();
       fetch_magic_if_not_bare(inner_value_magic, "Incorrect magic of inner type of some Dictionary");
@@ -531,7 +581,7 @@ struct tl_Dictionary_impl {
     int64_t n = v.count();
     f$store_int(n);
     for (auto it = v.begin(); it != v.end(); ++it) {
-      KeyT().typed_store(vk::constexpr_if(std::integral_constant<bool, std::is_same<KeyT, t_String>::value>{},
+      KeyT().typed_store(vk::constexpr_if(std::integral_constant<bool, has_string_keys>{},
                                           [&] { return it.get_key().to_string(); },
                                           [&] { return it.get_key().to_int(); }));
       store_magic_if_not_bare(inner_value_magic);
@@ -546,6 +596,8 @@ struct tl_Dictionary_impl {
       CurrentProcessingQuery::get().raise_fetching_error("Dictionary size is negative");
       return;
     }
+    const int64_t reserve_size = tl_fetch_reserve_size(n);
+    out.reserve(has_string_keys ? 0 : reserve_size, has_string_keys ? reserve_size : 0, false);
     for (int32_t i = 0; i < n; ++i) {
       typename KeyT::PhpType key;
       KeyT().typed_fetch_to(key);
@@ -594,7 +646,7 @@ struct t_Tuple {
 
   array<mixed> fetch() {
     CHECK_EXCEPTION(return array<mixed>());
-    array<mixed> result(array_size(size, 0, true));
+    array<mixed> result(array_size(tl_fetch_reserve_size(size), 0, true));
     for (int64_t i = 0; i < size; ++i) {
       fetch_magic_if_not_bare(inner_magic, "Incorrect magic of inner type of type Tuple");
       result.push_back(elem_state.fetch());
@@ -605,8 +657,7 @@ struct t_Tuple {
   using PhpType = array<typename T::PhpType>;
 
   void typed_store(const PhpType &v) {
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector() && v.count() == size) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0 && v.is_vector() && v.count() == size && store_raw_vector_T<T>(v)) {
       return;
     }
 
@@ -622,10 +673,10 @@ struct t_Tuple {
 
   void typed_fetch_to(PhpType &out) {
     CHECK_EXCEPTION(return);
-    out.reserve(size, 0, true);
+    out.reserve(tl_fetch_reserve_size(size), 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, size);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0) {
+      fetch_raw_vector_T<T>(out, size);
       return;
     }
 
@@ -665,7 +716,7 @@ struct tl_array {
   }
 
   array<mixed> fetch() {
-    array<mixed> result(array_size(size, 0, true));
+    array<mixed> result(array_size(tl_fetch_reserve_size(size), 0, true));
     CHECK_EXCEPTION(return result);
     for (int64_t i = 0; i < size; ++i) {
       fetch_magic_if_not_bare(inner_magic, "Incorrect magic of inner type of tl array");
@@ -678,8 +729,7 @@ struct tl_array {
   using PhpType = array<typename T::PhpType>;
 
   void typed_store(const PhpType &v) {
-    if (std::is_same<T, t_Double>{} && inner_magic == 0 && v.is_vector() && v.count() == size) {
-      store_raw_vector_T<typename T::PhpType>(v);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0 && v.is_vector() && v.count() == size && store_raw_vector_T<T>(v)) {
       return;
     }
 
@@ -695,10 +745,10 @@ struct tl_array {
 
   void typed_fetch_to(PhpType &out) {
     CHECK_EXCEPTION(return);
-    out.reserve(size, 0, true);
+    out.reserve(tl_fetch_reserve_size(size), 0, true);
 
-    if (std::is_same<T, t_Double>{} && inner_magic == 0) {
-      fetch_raw_vector_T<typename T::PhpType>(out, size);
+    if (tl_has_raw_vector<T>{} && inner_magic == 0) {
+      fetch_raw_vector_T<T>(out, size);
       return;
     }
 
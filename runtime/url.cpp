@@ -5,6 +5,7 @@
 #include "runtime/url.h"
 
 #include "common/macos-ports.h"
+#include "common/string-encoders.h"
 
 #include "runtime/array_functions.h"
 #include "runtime/regexp.h"
@@ -55,7 +56,17 @@ Optional<string> f$base64_decode(const string &s, bool strict) {
   string::size_type j = 0;
   int padding = 0;
   for (string::size_type pos = 0; pos < s.size(); pos++) {
-    int ch = s[pos];
+    if (i % 4 == 0 && !padding) {
+      const size_t decoded = decode_base64_blocks(s.c_str() + pos, s.size() - pos, reinterpret_cast<unsigned char *>(result.buffer()) + j);
+      pos += decoded;
+      j += decoded / 4 * 3;
+      i += decoded;
+      if (pos == s.size()) {
+        break;
+      }
+    }
+
+    int ch = static_cast<unsigned char>(s[pos]);
     if (ch == '=') {
       padding++;
       continue;
@@ -112,58 +123,9 @@ Optional<string> f$base64_decode(const string &s, bool strict) {
   return result;
 }
 
-int base64_encode(const unsigned char *const input, int ilen, char *output, int olen) {
-  static const char* const symbols64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
-
-  auto next_input_uchar = [input, ilen](int &i) {
-    if (i >= ilen) return static_cast<unsigned char>(0);
-    return input[i++];
-  };
-
-  int i, j = 0;
-  char buf[4];
-  for (i = 0; i < ilen; ) {
-    int old_i = i;
-    int o = next_input_uchar(i);
-    o <<= 8;
-    o |= next_input_uchar(i);
-    o <<= 8;
-    o |= next_input_uchar(i);
-    int l = i - old_i;
-    assert (l > 0 && l <= 3);
-    int u;
-    for (u = 3; u >= 0; u--) {
-      buf[u] = symbols64[o & 63];
-      o >>= 6;
-    }
-    if (l == 1) {
-      buf[2] = buf[3] = '=';
-    }
-    else if (l == 2) {
-      buf[3] = '=';
-    }
-    if (j + 3 >= olen) {
-      return -1;
-    }
-    memcpy (&output[j], buf, 4);
-    j += 4;
-  }
-  if (j >= olen) {
-    return -1;
-  }
-  output[j++] = 0;
-  return 0;
-}
-
 string f$base64_encode(const string &s) {
-  int result_len = (s.size() + 2) / 3 * 4;
-  string res(result_len, false);
-  result_len = base64_encode(reinterpret_cast <const unsigned char *> (s.c_str()), (int)s.size(), res.buffer(), result_len + 1);
-
-  if (result_len != 0) {
-    return string();
-  }
-
+  string res(static_cast<string::size_type>(base64_encoded_len(s.size())), false);
+  encode_base64(reinterpret_cast<const unsigned char *>(s.c_str()), s.size(), res.buffer());
   return res;
 }
 
@@ -473,28 +435,15 @@ string f$rawurldecode(const string &s) {
 }
 
 
-static const char *good_url_symbols =
-  "00000000000000000000000000000000"
-  "00000000000001101111111111000000"
-  "01111111111111111111111111100001"
-  "01111111111111111111111111100000"
-  "00000000000000000000000000000000"
-  "00000000000000000000000000000000"
-  "00000000000000000000000000000000"
-  "00000000000000000000000000000000";//[0-9a-zA-Z-_.]
-
 string f$rawurlencode(const string &s) {
-  static_SB.clean().reserve(3 * s.size());
-  for (int i = 0; i < (int)s.size(); i++) {
-    if (good_url_symbols[(unsigned char)s[i]] == '1') {
-      static_SB.append_char(s[i]);
-    } else {
-      static_SB.append_char('%');
-      static_SB.append_char(uhex_digits[(s[i] >> 4) & 15]);
-      static_SB.append_char(uhex_digits[s[i] & 15]);
-    }
+  const size_t result_len = url_encoded_len(s.c_str(), s.size(), true);
+  if (result_len == s.size()) {
+    return s;
   }
-  return static_SB.str();
+
+  string res(static_cast<string::size_type>(result_len), false);
+  encode_url(s.c_str(), s.size(), res.buffer(), true);
+  return res;
 }
 
 string f$urldecode(const string &s) {
@@ -520,17 +469,12 @@ string f$urldecode(const string &s) {
 }
 
 string f$urlencode(const string &s) {
-  static_SB.clean().reserve(3 * s.size());
-  for (int i = 0; i < (int)s.size(); i++) {
-    if (good_url_symbols[(unsigned char)s[i]] == '1') {
-      static_SB.append_char(s[i]);
-    } else if (s[i] == ' ') {
-      static_SB.append_char('+');
-    } else {
-      static_SB.append_char('%');
-      static_SB.append_char(uhex_digits[(s[i] >> 4) & 15]);
-      static_SB.append_char(uhex_digits[s[i] & 15]);
-    }
+  const size_t result_len = url_encoded_len(s.c_str(), s.size(), false);
+  if (result_len == s.size() && !memchr(s.c_str(), ' ', s.size())) {
+    return s;
   }
-  return static_SB.str();
+
+  string res(static_cast<string::size_type>(result_len), false);
+  encode_url(s.c_str(), s.size(), res.buffer(), false);
+  return res;
 }
@@ -0,0 +1,151 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <algorithm>
+#include <cassert>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+#include "common/kprintf.h"
+
+#include "server/workers-affinity.h"
+
+#include "server/http-reuseport-listeners.h"
+
+namespace {
+
+bool has_reuseport(int fd) noexcept {
+#if defined(SO_REUSEPORT)
+  int enabled = 0;
+  socklen_t len = sizeof(enabled);
+  return getsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enabled, &len) == 0 && enabled;
+#else
+  return false && fd;
+#endif
+}
+
+} // namespace
+
+void HttpReuseportListeners::init(int shared_fd, std::vector<int> handed_over_fds, int (*open_listener)(), uint16_t general_workers_count,
+                                  bool group_ordered) noexcept {
+  if (!enabled_ || is_inited() || shared_fd < 0 || !general_workers_count) {
+    for (int fd : handed_over_fds) {
+      close(fd);
+    }
+    return;
+  }
+  if (!has_reuseport(shared_fd)) {
+    // e.g. the socket is handed over by the old master, which was run without the option
+    kprintf("the shared http socket has no SO_REUSEPORT, all the workers will use it\n");
+    enabled_ = false;
+    for (int fd : handed_over_fds) {
+      close(fd);
+    }
+    return;
+  }
+
+  fds_.reserve(std::max<size_t>(general_workers_count, handed_over_fds.size() + 1));
+  fds_.push_back(shared_fd);
+  fds_.insert(fds_.end(), handed_over_fds.begin(), handed_over_fds.end());
+  // the sockets are closed from the end of the group, which doesn't move the others in it
+  while (fds_.size() > general_workers_count) {
+    kprintf("there are more handed over http sockets than workers, the connections queued on the socket %zu are reset\n", fds_.size() - 1);
+    close(fds_.back());
+    fds_.pop_back();
+  }
+  const size_t handed_over_count = fds_.size() - 1;
+  // the opened sockets are appended to the group
+  while (fds_.size() != general_workers_count) {
+    const int fd = open_listener();
+    if (fd < 0) {
+      kprintf("can't open the http socket for worker %zu: %m, all the workers will use the shared one\n", fds_.size());
+      for (size_t i = 1; i != fds_.size(); ++i) {
+        close(fds_[i]);
+      }
+      fds_.clear();
+      enabled_ = false;
+      return;
+    }
+    fds_.push_back(fd);
+  }
+  group_ordered_ = group_ordered;
+  vkprintf(1, "got %zu reuseport http sockets, %zu of them are handed over\n", fds_.size(), handed_over_count);
+
+  // the cpu steering relies on the order of the sockets in the reuseport group
+  if (cpu_steering_ && group_ordered_) {
+    cpu_steering_attached_ = attach_cpu_steering();
+  }
+}
+
+int HttpReuseportListeners::take_worker_listener(uint16_t worker_unique_id) noexcept {
+  assert(worker_unique_id < fds_.size());
+  const int worker_fd = fds_[worker_unique_id];
+  for (int fd : fds_) {
+    if (fd != worker_fd) {
+      close(fd);
+    }
+  }
+  fds_.clear();
+  return worker_fd;
+}
+
+void HttpReuseportListeners::close_worker_listeners() noexcept {
+  // the shared socket is left as it was before the reuseport sockets
+  for (size_t i = 1; i < fds_.size(); ++i) {
+    close(fds_[i]);
+  }
+  fds_.clear();
+}
+
+bool HttpReuseportListeners::attach_cpu_steering() noexcept {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  // the program returns the index of the socket in the group: the socket of the worker pinned to the current cpu,
+  // i.e. the connection is accepted on the cpu which has handled its SYN
+  const auto &affinity = vk::singleton<WorkersAffinity>::get();
+  if (affinity.get_mode() != WorkersAffinity::Mode::cpu) {
+    kprintf("the reuseport cpu steering requires the workers pinned to cpus\n");
+    return false;
+  }
+  std::vector<bool> used_cpus;
+  std::vector<sock_filter> code;
+  code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+  for (uint16_t worker = 0; worker != fds_.size(); ++worker) {
+    const int cpu = affinity.get_worker_cpu(worker);
+    if (cpu < 0) {
+      return false;
+    }
+    if (used_cpus.size() <= static_cast<size_t>(cpu)) {
+      used_cpus.resize(cpu + 1);
+    }
+    if (used_cpus[cpu]) {
+      // several workers on a cpu would leave all but the first one without connections
+      kprintf("the reuseport cpu steering requires not more general workers than cpus\n");
+      return false;
+    }
+    used_cpus[cpu] = true;
+    code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(cpu), 0, 1));
+    code.push_back(BPF_STMT(BPF_RET | BPF_K, worker));
+  }
+  // the cpus without workers are spread over all the sockets
+  code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(fds_.size())));
+  code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+  sock_fprog program{};
+  program.len = static_cast<unsigned short>(code.size());
+  program.filter = code.data();
+  if (setsockopt(fds_.front(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0) {
+    kprintf("can't attach the reuseport cpu steering program: %m\n");
+    return false;
+  }
+  vkprintf(1, "attached the reuseport cpu steering program\n");
+  return true;
+#else
+  kprintf("the reuseport cpu steering is not supported on this platform\n");
+  return false;
+#endif
+}
@@ -0,0 +1,58 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+// Every general worker accepts http connections on its own SO_REUSEPORT socket, and the kernel spreads them between the workers,
+// instead of waking up all idle workers on the shared socket. The sockets are owned by the master,
+// so a restarted worker gets the socket of its unique id back with all the connections queued meanwhile.
+// On the graceful restart the old master hands all the sockets over to the new one, like the shared socket,
+// so the connections queued on them aren't reset when the old master exits.
+class HttpReuseportListeners : vk::not_copyable {
+public:
+  void enable(bool cpu_steering) noexcept {
+    enabled_ = true;
+    cpu_steering_ = cpu_steering;
+  }
+
+  bool is_enabled() const noexcept { return enabled_; }
+  bool is_inited() const noexcept { return !fds_.empty(); }
+  bool is_cpu_steering_attached() const noexcept { return cpu_steering_attached_; }
+
+  // should be called by the master when it has got the shared http socket, which becomes the socket of the worker 0,
+  // and the other sockets of the group handed over by the old master, if any; the missing sockets are opened.
+  // The group is ordered if the index of every socket in the reuseport group is its index here
+  // (if the other sockets can't be opened, all the workers use the shared one)
+  void init(int shared_fd, std::vector<int> handed_over_fds, int (*open_listener)(), uint16_t general_workers_count, bool group_ordered) noexcept;
+
+  // the sockets except the shared one, the old master sends them to the new one on the graceful restart
+  const int *get_extra_fds() const noexcept { return fds_.empty() ? nullptr : fds_.data() + 1; }
+  size_t get_extra_fds_count() const noexcept { return fds_.empty() ? 0 : fds_.size() - 1; }
+  bool is_group_ordered() const noexcept { return group_ordered_; }
+
+  // should be called by the general worker just after fork: closes the sockets of the other workers and returns its own one
+  int take_worker_listener(uint16_t worker_unique_id) noexcept;
+
+  // should be called by the other workers just after fork: the kernel would keep queueing connections on the sockets they hold
+  void close_worker_listeners() noexcept;
+
+private:
+  HttpReuseportListeners() = default;
+
+  friend class vk::singleton<HttpReuseportListeners>;
+
+  bool attach_cpu_steering() noexcept;
+
+  bool enabled_{false};
+  bool cpu_steering_{false};
+  bool cpu_steering_attached_{false};
+  bool group_ordered_{false};
+  std::vector<int> fds_;
+};
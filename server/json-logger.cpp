@@ -18,9 +18,14 @@ namespace {
 enum {
   ServerLogCritical = -1,
   ServerLogError = -2,
-  ServerLogWarning = -3
+  ServerLogWarning = -3,
+  ServerLogSlowRequest = -4
 };
 
+int64_t ns2us(uint64_t ns) noexcept {
+  return static_cast<int64_t>(ns / 1000);
+}
+
 template<size_t N>
 void copy_if_enough_size(vk::string_view src, vk::string_view &dest, std::array<char, N> &buffer, volatile std::atomic<bool> &availability_flag) noexcept {
   if (src.size() <= buffer.size()) {
@@ -253,6 +258,56 @@ void JsonLogger::write_stack_overflow_log(int type) noexcept {
   write_log("Stack overflow", type, time(nullptr), trace.data(), trace_size, true);
 }
 
+void JsonLogger::write_request_log(vk::string_view endpoint, const RequestAccounting &accounting) noexcept {
+  if (json_log_fd_ <= 0) {
+    return;
+  }
+
+  auto json_out_it = buffers_.begin();
+  for (; json_out_it != buffers_.end() && !json_out_it->try_start_json(); ++json_out_it) {
+  }
+  assert(json_out_it != buffers_.end());
+
+  json_out_it->append_key("version").append_integer(release_version_);
+  json_out_it->append_key("type").append_integer(ServerLogSlowRequest);
+  json_out_it->append_key("created_at").append_integer(time(nullptr));
+  json_out_it->append_key("env").append_string(env_available_ ? env_ : vk::string_view{});
+
+  json_out_it->append_key("tags").start<'{'>();
+  if (tags_available_) {
+    json_out_it->append_raw(tags_);
+  }
+  json_out_it->finish<'}'>();
+
+  if (extra_info_available_) {
+    json_out_it->append_key("extra_info").start<'{'>().append_raw(extra_info_).finish<'}'>();
+  }
+
+  json_out_it->append_key("request").start<'{'>();
+  json_out_it->append_key("endpoint").append_raw_string(endpoint);
+  json_out_it->append_key("working_time_us").append_integer(ns2us(accounting.working_time_ns));
+  json_out_it->append_key("script_time_us").append_integer(ns2us(accounting.script_time_ns));
+  json_out_it->append_key("net_time_us").append_integer(ns2us(accounting.net_time_ns));
+  json_out_it->append_key("cpu_time_us").append_integer(ns2us(accounting.cpu_time_ns));
+  json_out_it->append_key("cpu_cycles").append_integer(accounting.cpu_cycles);
+  json_out_it->append_key("allocations").append_integer(accounting.allocations);
+  json_out_it->append_key("allocated_bytes").append_integer(accounting.allocated_bytes);
+  json_out_it->append_key("voluntary_context_switches").append_integer(accounting.voluntary_context_switches);
+  json_out_it->append_key("involuntary_context_switches").append_integer(accounting.involuntary_context_switches);
+  json_out_it->append_key("rpc_queries").append_integer(accounting.rpc_queries);
+  json_out_it->append_key("mc_queries").append_integer(accounting.mc_queries);
+  json_out_it->append_key("sql_queries").append_integer(accounting.sql_queries);
+  json_out_it->append_key("blocked_time_us").start<'{'>();
+  for (size_t i = 0; i != accounting.blocked_time_ns.size(); ++i) {
+    json_out_it->append_key(blocking_resource_name(static_cast<BlockingResource>(i))).append_integer(ns2us(accounting.blocked_time_ns[i]));
+  }
+  json_out_it->finish<'}'>();
+  json_out_it->finish<'}'>();
+
+  json_out_it->append_key("msg").append_string("Slow request");
+  json_out_it->finish_json_and_flush(json_log_fd_);
+}
+
 void JsonLogger::reset_buffers() noexcept {
   tags_available_ = false;
   extra_info_available_ = false;
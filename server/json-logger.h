@@ -11,6 +11,8 @@
 #include "common/smart_ptrs/singleton.h"
 #include "common/wrappers/string_view.h"
 
+#include "server/request-accounting.h"
+
 
 class JsonLogger : vk::not_copyable {
 public:
@@ -31,6 +33,7 @@ public:
   void write_log(vk::string_view message, int type, int64_t created_at, void *const *trace, int64_t trace_size, bool uncaught) noexcept;
   void write_log_with_backtrace(vk::string_view message, int type) noexcept;
   void write_stack_overflow_log(int type) noexcept;
+  void write_request_log(vk::string_view endpoint, const RequestAccounting &accounting) noexcept;
 
   void reset_buffers() noexcept;
 
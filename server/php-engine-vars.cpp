@@ -60,6 +60,7 @@ int force_clear_sql_connection = 0;
 long long static_buffer_length_limit = -1;
 int use_madvise_dontneed = 0;
 long long memory_used_to_recreate_script = LLONG_MAX;
+double slow_request_log_threshold = 0;
 
 /***
   save of stdout/stderr fd
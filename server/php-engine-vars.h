@@ -69,6 +69,7 @@ extern int force_clear_sql_connection;
 extern long long static_buffer_length_limit;
 extern int use_madvise_dontneed;
 extern long long memory_used_to_recreate_script;
+extern double slow_request_log_threshold;
 
 #define SIGTERM_MAX_TIMEOUT 10
 #define SIGTERM_WAIT_TIMEOUT 0.1
@@ -4,6 +4,7 @@
 
 #include "server/php-engine.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <cstdlib>
@@ -56,9 +57,11 @@
 #include "runtime/interface.h"
 #include "server/job-workers/shared-memory-manager.h"
 #include "runtime/profiler.h"
+#include "runtime/regexp.h"
 #include "runtime/rpc.h"
 #include "server/cluster-name.h"
 #include "server/confdata-binlog-replay.h"
+#include "server/http-reuseport-listeners.h"
 #include "server/job-workers/job-worker-client.h"
 #include "server/job-workers/job-worker-server.h"
 #include "server/job-workers/job-workers-context.h"
@@ -75,8 +78,11 @@
 #include "server/php-runner.h"
 #include "server/php-sql-connections.h"
 #include "server/php-worker.h"
+#include "server/sampling-profiler.h"
 #include "server/server-stats.h"
 #include "server/server-log.h"
+#include "server/workers-affinity.h"
+#include "server/workers-autoscaler.h"
 #include "server/workers-control.h"
 
 using job_workers::JobWorkersContext;
@@ -406,7 +412,10 @@ conn_type_t ct_php_engine_http_server = [] {
   res.magic = CONN_FUNC_MAGIC;
   res.title = "http_server";
   res.accept = accept_new_connections;
-  res.init_accepted = hts_init_accepted;
+  res.init_accepted = [](connection *c) {
+    vk::singleton<ServerStats>::get().add_accepted_http_connection();
+    return hts_init_accepted(c);
+  };
   res.run = server_read_write;
   res.reader = server_reader;
   res.writer = server_writer;
@@ -614,6 +623,19 @@ int hts_func_execute(connection *c, int op) {
   php_worker *worker = php_worker_create(http_worker, c, http_data, nullptr, nullptr, ++http_script_req_id, script_timeout);
   D->extra = worker;
 
+  char admission_header[32];
+  const int priority_len = get_http_header(qHeaders, qHeadersLen, admission_header, sizeof(admission_header), "X-Kphp-Priority", 15);
+  if (priority_len > 0) {
+    worker->priority = parse_request_priority(admission_header, priority_len);
+  }
+  // the time in milliseconds the client is going to wait for the answer
+  if (get_http_header(qHeaders, qHeadersLen, admission_header, sizeof(admission_header), "X-Kphp-Deadline-Ms", 18) > 0) {
+    const int deadline_ms = atoi(admission_header);
+    if (deadline_ms > 0) {
+      worker->deadline = std::min(worker->deadline, precise_now + deadline_ms / 1000.0);
+    }
+  }
+
   set_connection_timeout(c, script_timeout);
   c->status = conn_wait_net;
   return do_hts_func_wakeup(c, 0);
@@ -1010,6 +1032,10 @@ int rpcx_execute(connection *c, int op, raw_message *raw) {
 
       php_worker *worker = php_worker_create(run_once ? once_worker : rpc_worker, c, nullptr, rpc_data, nullptr, req_id, actual_script_timeout);
       D->extra = worker;
+      // the client waits for the answer not longer than the custom timeout
+      if (rpc_data->header.custom_timeout > 0) {
+        worker->deadline = std::min(worker->deadline, precise_now + rpc_data->header.custom_timeout / 1000.0);
+      }
 
       c->status = conn_wait_net;
       rpcx_func_wakeup(c);
@@ -1403,7 +1429,8 @@ void cron() {
 }
 
 int try_get_http_fd() {
-  return server_socket(http_port, settings_addr, backlog, 0);
+  const int mode = vk::singleton<HttpReuseportListeners>::get().is_enabled() ? SM_REUSEPORT : 0;
+  return server_socket(http_port, settings_addr, backlog, mode);
 }
 
 void reopen_json_log() {
@@ -1533,6 +1560,11 @@ static void generic_event_loop(WorkerType worker_type, bool init_and_listen_rpc_
 
     epoll_work(57);
 
+    // the script freed after a query is recreated here, when the response of that query is already written out
+    if (!php_worker_run_flag) {
+      php_worker_prepare_script();
+    }
+
     if (precise_now > next_create_outbound) {
       create_all_outbound_connections();
       next_create_outbound = precise_now + 0.03 + 0.02 * drand48();
@@ -1648,7 +1680,10 @@ void init_all() {
   }
 
   global_init_runtime_libs();
+  // the constants are created once by the master, all the workers share them after the fork
+  global_init_frozen_memory();
   global_init_php_scripts();
+  freeze_global_init_memory();
   global_init_script_allocator();
 
   init_handlers();
@@ -2027,6 +2062,44 @@ int main_args_handler(int i, const char *long_option) {
       use_utf8();
       return 0;
     }
+    case 2025: {
+      return parse_numeric_option(long_option, 0, 1 << 20, [](int size) { set_regexp_cache_size(size); });
+    }
+    case 2026: {
+      const bool cpu_steering = optarg && !strcmp(optarg, "cpu");
+      if (optarg && !cpu_steering) {
+        kprintf("--%s option: unknown value '%s'\n", long_option, optarg);
+        return -1;
+      }
+      vk::singleton<HttpReuseportListeners>::get().enable(cpu_steering);
+      return 0;
+    }
+    case 2027: {
+      if (const char *err = vk::singleton<WorkersAffinity>::get().set_mode(optarg)) {
+        kprintf("--%s option: %s\n", long_option, err);
+        return -1;
+      }
+      return 0;
+    }
+    case 2028: {
+      if (const char *err = vk::singleton<WorkersAutoscaler>::get().set_min_ratio(std::atof(optarg))) {
+        kprintf("--%s option: %s\n", long_option, err);
+        return -1;
+      }
+      return 0;
+    }
+    case 2029: {
+      return read_option_to(long_option, 0.0, double{MAX_SCRIPT_TIMEOUT}, slow_request_log_threshold);
+    }
+    case 2030: {
+      return parse_numeric_option(long_option, 1, SamplingProfiler::max_frequency, [](int frequency) {
+        vk::singleton<SamplingProfiler>::get().set_frequency(frequency);
+      });
+    }
+    case 2031: {
+      WarmUpContext::get().disable_instance_cache_handover();
+      return 0;
+    }
     default:
       return -1;
   }
@@ -2103,6 +2176,19 @@ void parse_main_args(int argc, char *argv[]) {
   parse_option("mysql-host", required_argument, 2022, "MySQL host");
   parse_option("disable-mysql-same-datacenter-check", no_argument, 2023, "Disable MySQL same datacenter check");
   parse_option("use-utf8", no_argument, 2024, "Use UTF8");
+  parse_option("regexp-cache-size", required_argument, 2025, "the maximum number of dynamic regexps kept compiled between requests by a worker, 0 disables the cache (default: 256)");
+  parse_option("http-reuseport", optional_argument, 2026, "every general worker accepts http connections on its own SO_REUSEPORT socket, "
+                                                            "with value 'cpu' the connections are steered to the worker pinned to the cpu which has received them");
+  parse_option("workers-cpu-affinity", required_argument, 2027, "pin the general workers to the cpus ('cpu') or to the numa nodes ('numa') round robin");
+  parse_option("workers-autoscale", required_argument, 2028, "grow and shrink the number of the running workers of each type by the load, "
+                                                               "keeping at least the given share of the configured ones, e.g. 0.25");
+  parse_option("slow-request-log-threshold", required_argument, 2029, "write the resources used by the requests working at least the given time in seconds "
+                                                                        "to the json log, 0 disables the log (default: 0)");
+  parse_option("sampling-profiler", required_argument, 2030, "sample the stacks of the workers with the given frequency per second of their cpu time, "
+                                                               "the collapsed stacks are given by the master on 'sampling_profile' memcache key "
+                                                               "and on /sampling-profile http request, e.g. 99");
+  parse_option("disable-instance-cache-handover", no_argument, 2031, "don't copy the instance cache of the old master on graceful restart of the same binary, "
+                                                                     "the new master always warms it up");
   parse_engine_options_long(argc, argv, main_args_handler);
   parse_main_args_till_option(argc, argv);
 }
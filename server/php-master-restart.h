@@ -32,8 +32,23 @@ struct master_data_t {
   int sent_http_fd_generation;
 
   uint32_t instance_cache_elements_cached;
-
-  int reserved[50 - 1];
+  uint32_t instance_cache_hit_rate_permille;
+
+  // the instance cache memory is handed over to the new master with the same layout hash
+  uint64_t instance_cache_layout_hash;
+  uint64_t instance_cache_memory_address;
+  uint64_t instance_cache_memory_size;
+  int ask_instance_cache_generation;
+  int sent_instance_cache_generation;
+  int instance_cache_handover_finished;
+
+  // the reuseport http sockets except the shared one are handed over after it
+  int http_reuseport_fds_count;
+  int http_reuseport_fds_ordered;
+  int ask_http_reuseport_fds_generation;
+  int sent_http_reuseport_fds_generation;
+
+  int reserved[50 - 15];
 };
 
 struct shared_data_t {
@@ -32,6 +32,7 @@ public:
   void try_start_warmup() {
     if (control_.get_running_count(WorkerType::general_worker) > 0 && !timer_.is_started()) {
       timer_.start();
+      old_instance_cache_hit_rate_permille_ = other->instance_cache_hit_rate_permille;
     }
   }
 
@@ -40,6 +41,51 @@ public:
     final_new_instance_cache_size_ = 0;
     final_old_instance_cache_size_ = 0;
     final_instance_cache_sizes_saved_ = false;
+    old_instance_cache_hit_rate_permille_ = 0;
+    instance_cache_hit_rate_recovery_time_ = {};
+    instance_cache_hit_rate_recovered_ = false;
+    instance_cache_handover_elements_transferred_ = 0;
+    instance_cache_handover_elements_skipped_ = 0;
+    instance_cache_handover_failed_ = false;
+  }
+
+  // the time since the start of the warm up until the instance cache hit rate of the new workers reaches the one of the old workers
+  void update_instance_cache_hit_rate_recovery_time() {
+    if (timer_.is_started() && !instance_cache_hit_rate_recovered_ && old_instance_cache_hit_rate_permille_ &&
+        me->instance_cache_hit_rate_permille >= old_instance_cache_hit_rate_permille_) {
+      instance_cache_hit_rate_recovery_time_ = timer_.time();
+      instance_cache_hit_rate_recovered_ = true;
+    }
+  }
+
+  double get_instance_cache_hit_rate_recovery_time() const {
+    return std::chrono::duration<double>(instance_cache_hit_rate_recovery_time_).count();
+  }
+
+  void set_instance_cache_handover_result(bool taken_over, uint64_t elements_transferred, uint64_t elements_skipped) {
+    instance_cache_handover_failed_ = !taken_over;
+    instance_cache_handover_elements_transferred_ = elements_transferred;
+    instance_cache_handover_elements_skipped_ = elements_skipped;
+  }
+
+  uint64_t get_instance_cache_handover_elements_transferred() const {
+    return instance_cache_handover_elements_transferred_;
+  }
+
+  uint64_t get_instance_cache_handover_elements_skipped() const {
+    return instance_cache_handover_elements_skipped_;
+  }
+
+  bool is_instance_cache_handover_failed() const {
+    return instance_cache_handover_failed_;
+  }
+
+  bool is_instance_cache_handover_enabled() const {
+    return instance_cache_handover_enabled_;
+  }
+
+  void disable_instance_cache_handover() {
+    instance_cache_handover_enabled_ = false;
   }
 
   bool need_more_workers_for_warmup() const {
@@ -70,6 +116,7 @@ private:
   double workers_part_for_warm_up_{1};
   double target_instance_cache_elements_part_{0};
   std::chrono::duration<double> warm_up_max_time_{5.0};
+  bool instance_cache_handover_enabled_{true};
 
   vk::SteadyTimer<std::chrono::milliseconds> timer_{};
 
@@ -77,6 +124,14 @@ private:
   uint32_t final_old_instance_cache_size_{0};
   bool final_instance_cache_sizes_saved_{false};
 
+  uint32_t old_instance_cache_hit_rate_permille_{0};
+  std::chrono::milliseconds instance_cache_hit_rate_recovery_time_{};
+  bool instance_cache_hit_rate_recovered_{false};
+
+  uint64_t instance_cache_handover_elements_transferred_{0};
+  uint64_t instance_cache_handover_elements_skipped_{0};
+  bool instance_cache_handover_failed_{false};
+
   const WorkersControl &control_;
 
   WarmUpContext() noexcept:
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <cinttypes>
 #include <climits>
 #include <cstdio>
 #include <cstdlib>
@@ -51,10 +52,15 @@
 #include "runtime/instance-cache.h"
 #include "server/cluster-name.h"
 #include "server/confdata-binlog-replay.h"
+#include "server/http-reuseport-listeners.h"
 #include "server/php-engine-vars.h"
 #include "server/php-engine.h"
 #include "server/php-master-tl-handlers.h"
+#include "server/php-worker.h"
+#include "server/sampling-profiler.h"
 #include "server/server-stats.h"
+#include "server/workers-affinity.h"
+#include "server/workers-autoscaler.h"
 #include "server/workers-control.h"
 
 #include "server/php-master-restart.h"
@@ -347,6 +353,7 @@ unsigned long long dead_stime, dead_utime;
 int *http_fd;
 int http_fd_port;
 int (*try_get_http_fd)();
+bool http_fd_opened_by_me = false;
 master_state state;
 bool in_sigterm;
 
@@ -359,6 +366,15 @@ int to_kill = 0, to_run = 0, to_exit = 0;
 int job_workers_to_kill = 0, job_workers_to_run = 0;
 long long generation;
 int receive_fd_attempts_cnt = 0;
+int ask_instance_cache_attempts_cnt = 0;
+bool instance_cache_take_over_started = false;
+bool instance_cache_take_over_done = false;
+InstanceCacheHandoverStats instance_cache_handover_stats;
+int ask_http_reuseport_fds_attempts_cnt = 0;
+bool http_reuseport_fds_handover_finished = false;
+bool http_reuseport_group_ordered = false;
+bool http_reuseport_listeners_init_done = false;
+std::vector<int> handed_over_http_reuseport_fds;
 
 worker_info_t *free_workers = nullptr;
 
@@ -488,6 +504,8 @@ WorkerType start_master(int *new_http_fd, int (*new_try_get_http_fd)(), int new_
   http_fd = new_http_fd;
   http_fd_port = new_http_fd_port;
   try_get_http_fd = new_try_get_http_fd;
+  vk::singleton<WorkersAffinity>::get().init();
+  vk::singleton<SamplingProfiler>::get().init(vk::singleton<WorkersControl>::get().get_total_workers_count());
 
   vkprintf(1, "start master: begin\n");
 
@@ -619,6 +637,18 @@ int run_worker(WorkerType worker_type) {
     ConfdataGlobalManager::get().force_release_all_resources_acquired_by_this_proc_if_init();
     vk::singleton<job_workers::SharedMemoryManager>::get().forcibly_release_all_attached_messages();
     vk::singleton<ServerStats>::get().after_fork(pid, active_special_connections, max_special_connections, worker_unique_id, worker_type);
+    vk::singleton<SamplingProfiler>::get().start_worker(worker_unique_id);
+    auto &reuseport_listeners = vk::singleton<HttpReuseportListeners>::get();
+    if (worker_type == WorkerType::general_worker) {
+      if (http_fd != nullptr && reuseport_listeners.is_inited()) {
+        *http_fd = reuseport_listeners.take_worker_listener(worker_unique_id);
+      }
+      vk::singleton<WorkersAffinity>::get().pin_this_worker(worker_unique_id);
+    } else {
+      reuseport_listeners.close_worker_listeners();
+    }
+    // the global init is done by the master, so the script memory is the only thing the worker needs before the first request
+    php_worker_prepare_script();
     return 1;
   }
 
@@ -898,7 +928,9 @@ std::string php_master_prepare_stats(bool add_worker_pids) {
       << "workers_killed\t" << workers_killed << "\n"
       << "workers_hung\t" << workers_hung << "\n"
       << "workers_terminated\t" << workers_terminated << "\n"
-      << "workers_failed\t" << workers_failed << "\n";
+      << "workers_failed\t" << workers_failed << "\n"
+      << "general_workers_target\t" << vk::singleton<WorkersControl>::get().get_target_count(WorkerType::general_worker) << "\n"
+      << "job_workers_target\t" << vk::singleton<WorkersControl>::get().get_target_count(WorkerType::job_worker) << "\n";
   stats.write_stats_to(oss, add_worker_pids);
 
   std::for_each(workers, last_worker, [&oss](const worker_info_t *w) {
@@ -971,6 +1003,11 @@ int php_master_get(connection *c, const char *old_key, int old_key_len) {
     return_one_key(c, old_key, res.c_str(), static_cast<int>(res.size()));
     return 0;
   }
+  if (key_len == 16 && strncmp(key, "sampling_profile", 16) == 0) {
+    std::string res = vk::singleton<SamplingProfiler>::get().dump_collapsed_stacks();
+    return_one_key(c, old_key, res.c_str(), static_cast<int>(res.size()));
+    return 0;
+  }
   if (key_len >= 5 && strncmp(key, "stats", 5) == 0) {
     return_one_key_key(c, old_key);
     php_master_wakeup(c);
@@ -1055,6 +1092,16 @@ STATS_PROVIDER_TAGGED(kphp_stats, 100, STATS_TAG_KPHP_SERVER) {
   add_gauge_stat_long(stats, "server.workers.terminated", workers_terminated);
   add_gauge_stat_long(stats, "server.workers.failed", workers_failed);
 
+  const auto &control = vk::singleton<WorkersControl>::get();
+  const auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  add_gauge_stat_long(stats, "workers.general.autoscale.target", control.get_target_count(WorkerType::general_worker));
+  add_gauge_stat_long(stats, "workers.general.autoscale.grows", autoscaler.get_stats(WorkerType::general_worker).grows);
+  add_gauge_stat_long(stats, "workers.general.autoscale.shrinks", autoscaler.get_stats(WorkerType::general_worker).shrinks);
+  add_gauge_stat_long(stats, "workers.job.autoscale.target", control.get_target_count(WorkerType::job_worker));
+  add_gauge_stat_long(stats, "workers.job.autoscale.grows", autoscaler.get_stats(WorkerType::job_worker).grows);
+  add_gauge_stat_long(stats, "workers.job.autoscale.shrinks", autoscaler.get_stats(WorkerType::job_worker).shrinks);
+  vk::singleton<SamplingProfiler>::get().write_stats_to(stats);
+
 
   const auto cpu_stats = server_stats.cpu[1].get_stat();
   add_gauge_stat_double(stats, "cpu.stime", cpu_stats.cpu_s_usage);
@@ -1084,6 +1131,10 @@ STATS_PROVIDER_TAGGED(kphp_stats, 100, STATS_TAG_KPHP_SERVER) {
 
   add_gauge_stat_long(stats, "graceful_restart.warmup.final_new_instance_cache_size", WarmUpContext::get().get_final_new_instance_cache_size());
   add_gauge_stat_long(stats, "graceful_restart.warmup.final_old_instance_cache_size", WarmUpContext::get().get_final_old_instance_cache_size());
+  add_gauge_stat_double(stats, "graceful_restart.warmup.instance_cache_hit_rate_recovery_time", WarmUpContext::get().get_instance_cache_hit_rate_recovery_time());
+  add_gauge_stat_long(stats, "graceful_restart.instance_cache_handover.elements_transferred", WarmUpContext::get().get_instance_cache_handover_elements_transferred());
+  add_gauge_stat_long(stats, "graceful_restart.instance_cache_handover.elements_skipped", WarmUpContext::get().get_instance_cache_handover_elements_skipped());
+  add_gauge_stat_long(stats, "graceful_restart.instance_cache_handover.failed", WarmUpContext::get().is_instance_cache_handover_failed());
 
   if (vk::singleton<job_workers::SharedMemoryManager>::get().is_initialized()) {
     vk::singleton<job_workers::SharedMemoryManager>::get().get_stats().write_stats_to(stats);
@@ -1121,6 +1172,14 @@ int php_master_http_execute(struct connection *c, int op) {
     return 0;
   }
 
+  const char *sampling_profile_query = "/sampling-profile";
+  if (D->uri_size == strlen(sampling_profile_query) && strncmp(ReqHdr + D->uri_offset, sampling_profile_query, static_cast<size_t>(D->uri_size)) == 0) {
+    std::string profile = vk::singleton<SamplingProfiler>::get().dump_collapsed_stacks();
+    write_basic_http_header(c, 200, 0, static_cast<int>(profile.length()), nullptr, "text/plain; charset=UTF-8");
+    write_out(&c->Out, profile.c_str(), static_cast<int>(profile.length()));
+    return 0;
+  }
+
   D->query_flags |= QF_ERROR;
   return -404;
 }
@@ -1155,6 +1214,27 @@ void run_master_off_in_graceful_restart() {
     changed = 1;
   }
 
+  if (other->is_alive && other->ask_http_reuseport_fds_generation > me->generation) {
+    const auto &reuseport_listeners = vk::singleton<HttpReuseportListeners>::get();
+    vkprintf(1, "send %zu reuseport http fds\n", reuseport_listeners.get_extra_fds_count());
+    for (size_t i = 0; i != reuseport_listeners.get_extra_fds_count(); ++i) {
+      send_fd_via_socket(reuseport_listeners.get_extra_fds()[i]);
+    }
+    me->sent_http_reuseport_fds_generation = static_cast<int>(generation);
+    changed = 1;
+  }
+
+  if (other->is_alive && other->ask_instance_cache_generation > me->generation) {
+    vkprintf(1, "send instance cache memory fd\n");
+    const InstanceCacheSharedMemory memory = instance_cache_get_shared_memory();
+    // the zero size tells the new master that nothing is sent
+    const bool sent = memory.fd != -1 && send_fd_via_socket(memory.fd);
+    me->instance_cache_memory_address = sent ? reinterpret_cast<uintptr_t>(memory.address) : 0;
+    me->instance_cache_memory_size = sent ? memory.size : 0;
+    me->sent_instance_cache_generation = static_cast<int>(generation);
+    changed = 1;
+  }
+
   if (other->to_kill_generation > me->generation) {
     // old master kills as many workers as new master told
     to_kill = other->to_kill;
@@ -1171,6 +1251,179 @@ void run_master_off_in_graceful_restart() {
   }
 }
 
+// the datagrams with the shared http fd sent on the previous asks can be still in the socket
+static int receive_http_reuseport_fd() {
+  struct stat shared_fd_stat{};
+  fstat(*http_fd, &shared_fd_stat);
+  for (int attempt = 0; attempt != 4; ++attempt) {
+    const int fd = receive_fd(socket_fd);
+    if (fd == -1) {
+      return -1;
+    }
+    struct stat fd_stat{};
+    if (fstat(fd, &fd_stat) == 0 && S_ISSOCK(fd_stat.st_mode) && fd_stat.st_ino != shared_fd_stat.st_ino) {
+      return fd;
+    }
+    close(fd);
+  }
+  return -1;
+}
+
+// the new master takes the reuseport http sockets of the old one after the shared one,
+// otherwise the connections queued on them would be reset, when the old master exits; returns false until it's done
+static bool run_http_reuseport_fds_handover() {
+  if (http_reuseport_fds_handover_finished) {
+    return true;
+  }
+  if (http_fd == nullptr || http_fd_opened_by_me || !vk::singleton<HttpReuseportListeners>::get().is_enabled() ||
+      !other->is_alive || other->http_reuseport_fds_count <= 1) {
+    http_reuseport_group_ordered = http_fd_opened_by_me;
+    http_reuseport_fds_handover_finished = true;
+    return true;
+  }
+
+  if (me->ask_http_reuseport_fds_generation != 0 && other->sent_http_reuseport_fds_generation > me->generation) {
+    const int fds_count = other->http_reuseport_fds_count - 1;
+    vkprintf(1, "read %d reuseport http fds\n", fds_count);
+    for (int i = 0; i != fds_count; ++i) {
+      const int fd = receive_http_reuseport_fd();
+      if (fd == -1) {
+        kprintf("only %d of %d reuseport http fds are received\n", i, fds_count);
+        break;
+      }
+      handed_over_http_reuseport_fds.push_back(fd);
+    }
+    // the order of the group is kept, if it's handed over as a whole
+    http_reuseport_group_ordered = other->http_reuseport_fds_ordered && handed_over_http_reuseport_fds.size() == static_cast<size_t>(fds_count);
+    http_reuseport_fds_handover_finished = true;
+    return true;
+  }
+
+  if (ask_http_reuseport_fds_attempts_cnt < 4) {
+    ask_http_reuseport_fds_attempts_cnt++;
+    vkprintf(1, "ask for reuseport http fds\n");
+    if (socket_fd == -1) {
+      socket_fd = sock_dgram(vk::singleton<ClusterName>::get().get_socket_name());
+    }
+    me->ask_http_reuseport_fds_generation = static_cast<int>(generation);
+    changed = 1;
+    return false;
+  }
+
+  kprintf("reuseport http fds aren't received, the connections queued on them will be reset\n");
+  http_reuseport_fds_handover_finished = true;
+  return true;
+}
+
+// the datagrams with the http fds sent on the previous asks can be still in the socket
+static int receive_instance_cache_memory_fd(size_t size) {
+  for (int attempt = 0; attempt != 4; ++attempt) {
+    const int fd = receive_fd(socket_fd);
+    if (fd == -1) {
+      return -1;
+    }
+    struct stat fd_stat{};
+    if (fstat(fd, &fd_stat) == 0 && S_ISREG(fd_stat.st_mode) && static_cast<size_t>(fd_stat.st_size) == size) {
+      return fd;
+    }
+    close(fd);
+  }
+  return -1;
+}
+
+// the new master copies the live elements of the instance cache of the old one, if its memory is readable by this binary,
+// otherwise the cache is warmed up by the new workers
+static void run_instance_cache_handover() {
+  auto &warm_up_ctx = WarmUpContext::get();
+  if (me->instance_cache_handover_finished) {
+    return;
+  }
+  // the elements are copied by run_instance_cache_take_over_batches() outside the shared data lock
+  if (instance_cache_take_over_started) {
+    if (instance_cache_take_over_done) {
+      vkprintf(1, "instance cache handover: [taken_over = 1] [elements_transferred = %" PRIu64 "] [elements_skipped = %" PRIu64 "]\n",
+               instance_cache_handover_stats.elements_transferred, instance_cache_handover_stats.elements_skipped);
+      warm_up_ctx.set_instance_cache_handover_result(true, instance_cache_handover_stats.elements_transferred,
+                                                     instance_cache_handover_stats.elements_skipped);
+      me->instance_cache_handover_finished = 1;
+      changed = 1;
+    }
+    return;
+  }
+  if (!other->is_alive || !warm_up_ctx.is_instance_cache_handover_enabled() ||
+      !me->instance_cache_layout_hash || other->instance_cache_layout_hash != me->instance_cache_layout_hash) {
+    me->instance_cache_handover_finished = 1;
+    return;
+  }
+
+  if (me->ask_instance_cache_generation != 0 && other->sent_instance_cache_generation > me->generation) {
+    vkprintf(1, "read instance cache memory fd\n");
+    InstanceCacheSharedMemory other_memory;
+    other_memory.address = reinterpret_cast<void *>(other->instance_cache_memory_address);
+    other_memory.size = other->instance_cache_memory_size;
+    other_memory.fd = other_memory.size ? receive_instance_cache_memory_fd(other_memory.size) : -1;
+    instance_cache_take_over_started = other_memory.fd != -1 && instance_cache_start_elements_take_over(other_memory);
+    if (other_memory.fd != -1) {
+      close(other_memory.fd);
+    }
+    if (!instance_cache_take_over_started) {
+      vkprintf(1, "instance cache handover: [taken_over = 0] [elements_transferred = 0] [elements_skipped = 0]\n");
+      warm_up_ctx.set_instance_cache_handover_result(false, 0, 0);
+      me->instance_cache_handover_finished = 1;
+      changed = 1;
+    }
+  } else if (ask_instance_cache_attempts_cnt < 4) {
+    ask_instance_cache_attempts_cnt++;
+    vkprintf(1, "ask for instance cache memory\n");
+    if (socket_fd == -1) {
+      socket_fd = sock_dgram(vk::singleton<ClusterName>::get().get_socket_name());
+    }
+    me->ask_instance_cache_generation = static_cast<int>(generation);
+    changed = 1;
+  } else {
+    vkprintf(1, "instance cache memory isn't received\n");
+    warm_up_ctx.set_instance_cache_handover_result(false, 0, 0);
+    me->instance_cache_handover_finished = 1;
+    changed = 1;
+  }
+}
+
+// the old master's shard is locked only for one batch, and the master spends a bounded time on them per iteration
+static void run_instance_cache_take_over_batches() {
+  if (!instance_cache_take_over_started || instance_cache_take_over_done) {
+    return;
+  }
+  constexpr size_t batch_size = 64;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{100};
+  do {
+    instance_cache_take_over_done = instance_cache_take_over_next_elements(instance_cache_handover_stats, batch_size);
+  } while (!instance_cache_take_over_done && std::chrono::steady_clock::now() < deadline);
+}
+
+// the old master doesn't reuse the memory of the instance cache while the new master copies the elements from it
+static bool is_instance_cache_memory_read_by_other() {
+  return me->sent_instance_cache_generation != 0 && other->is_alive && !other->instance_cache_handover_finished;
+}
+
+// the hit rate of the last second, the new master compares its own one with the one of the old master
+static void update_instance_cache_hit_rate() {
+  static uint64_t prev_hits = 0;
+  static uint64_t prev_requests = 0;
+  const auto &instance_cache_element_stats = instance_cache_get_stats();
+  const uint64_t hits = instance_cache_element_stats.elements_fetched.load(std::memory_order_relaxed);
+  const uint64_t requests = hits + instance_cache_element_stats.elements_missed.load(std::memory_order_relaxed)
+                            + instance_cache_element_stats.elements_logically_expired_and_ignored.load(std::memory_order_relaxed);
+  // the stats are started from scratch on the memory swap
+  const bool stats_reset = requests < prev_requests || hits < prev_hits;
+  const uint64_t window_hits = stats_reset ? hits : hits - prev_hits;
+  const uint64_t window_requests = stats_reset ? requests : requests - prev_requests;
+  prev_hits = hits;
+  prev_requests = requests;
+  if (window_requests) {
+    me->instance_cache_hit_rate_permille = static_cast<uint32_t>(window_hits * 1000 / window_requests);
+  }
+}
+
 void run_master_on() {
   vkprintf(2, "state: master_state::on\n");
 
@@ -1210,6 +1463,7 @@ void run_master_on() {
       *http_fd = try_get_http_fd();
       assert (*http_fd != -1 && "failed to get http_fd");
       me->own_http_fd = 1;
+      http_fd_opened_by_me = true;
       need_http_fd = false;
     } else {
       if (me->ask_http_fd_generation != 0 && other->sent_http_fd_generation > me->generation) {
@@ -1246,11 +1500,32 @@ void run_master_on() {
     }
   }
 
+  if (!need_http_fd && !run_http_reuseport_fds_handover()) {
+    need_http_fd = true;
+  }
+
   if (!need_http_fd) {
+    run_instance_cache_handover();
+
     const auto &control = vk::singleton<WorkersControl>::get();
+    auto &reuseport_listeners = vk::singleton<HttpReuseportListeners>::get();
+    if (http_fd != nullptr && !http_reuseport_listeners_init_done) {
+      http_reuseport_listeners_init_done = true;
+      reuseport_listeners.init(*http_fd, std::move(handed_over_http_reuseport_fds), try_get_http_fd,
+                               control.get_count(WorkerType::general_worker), http_reuseport_group_ordered);
+      handed_over_http_reuseport_fds.clear();
+      me->http_reuseport_fds_count = reuseport_listeners.is_inited() ? static_cast<int>(reuseport_listeners.get_extra_fds_count() + 1) : 0;
+      me->http_reuseport_fds_ordered = reuseport_listeners.is_group_ordered();
+      changed = 1;
+    }
     const int total_workers = control.get_alive_count(WorkerType::general_worker) + (other->is_alive ? other->running_http_workers_n + other->dying_http_workers_n : 0);
-    to_run = std::max(0, int{control.get_count(WorkerType::general_worker)} - total_workers);
-    job_workers_to_run = control.get_count(WorkerType::job_worker) - control.get_alive_count(WorkerType::job_worker);
+    to_run = std::max(0, int{control.get_target_count(WorkerType::general_worker)} - total_workers);
+    job_workers_to_run = std::max(0, int{control.get_target_count(WorkerType::job_worker)} - int{control.get_alive_count(WorkerType::job_worker)});
+    if (!other->is_alive) {
+      // the autoscaler has decreased the target
+      to_kill = std::max(0, int{control.get_running_count(WorkerType::general_worker)} - int{control.get_target_count(WorkerType::general_worker)});
+      job_workers_to_kill = std::max(0, int{control.get_running_count(WorkerType::job_worker)} - int{control.get_target_count(WorkerType::job_worker)});
+    }
 
     if (other->is_alive) {
       auto &warm_up_ctx = WarmUpContext::get();
@@ -1274,6 +1549,7 @@ void run_master_on() {
         changed = 1;
       }
     }
+    WarmUpContext::get().update_instance_cache_hit_rate_recovery_time();
   }
 }
 
@@ -1316,6 +1592,34 @@ void check_and_instance_cache_try_swap_memory() {
   }
 }
 
+static void update_workers_autoscaler(const ServerStats::WorkersStat &general_workers_stat, const ServerStats::WorkersStat &job_workers_stat) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  if (vk::singleton<HttpReuseportListeners>::get().is_inited()) {
+    // every general worker has its own socket in the reuseport group, the sockets without workers would get the connections too
+    autoscaler.disable(WorkerType::general_worker);
+  }
+  if (!autoscaler.is_enabled(WorkerType::general_worker) && !autoscaler.is_enabled(WorkerType::job_worker)) {
+    return;
+  }
+  // the cpu usage is read every second to keep the measured interval short
+  const double host_cpu_usage = autoscaler.read_host_cpu_usage();
+  // the workers are replaced during the graceful restart, the load of the old ones means nothing
+  if (state != master_state::on || other->is_alive || host_cpu_usage < 0) {
+    return;
+  }
+
+  auto &control = vk::singleton<WorkersControl>::get();
+  const auto update = [&](WorkerType worker_type, const ServerStats::WorkersStat &workers_stat, uint32_t accept_queue) {
+    WorkersAutoscaler::Load load;
+    load.running_ratio = workers_stat.total_workers ? static_cast<double>(workers_stat.running_workers) / workers_stat.total_workers : 0;
+    load.accept_queue = accept_queue;
+    load.host_cpu_usage = host_cpu_usage;
+    control.set_target_count(worker_type, autoscaler.update(worker_type, control.get_target_count(worker_type), control.get_count(worker_type), load));
+  };
+  update(WorkerType::general_worker, general_workers_stat, http_fd ? WorkersAutoscaler::get_accept_queue_size(*http_fd) : 0);
+  update(WorkerType::job_worker, job_workers_stat, 0);
+}
+
 static void cron() {
   if (!other->is_alive || in_old_master_on_restart()) {
     // write stats at the beginning to avoid spikes in graphs
@@ -1349,6 +1653,7 @@ static void cron() {
   server_stats.update_misc_stat_for_general_workers(MiscStatTimestamp{my_now, general_workers_stat.running_workers});
   const auto job_workers_stat = vk::singleton<ServerStats>::get().collect_workers_stat(WorkerType::job_worker);
   server_stats.update_misc_stat_for_job_workers(MiscStatTimestamp{my_now, job_workers_stat.running_workers});
+  update_workers_autoscaler(general_workers_stat, job_workers_stat);
 
   utime += dead_utime;
   stime += dead_stime;
@@ -1356,7 +1661,10 @@ static void cron() {
   server_stats.update(cpu_timestamp);
 
   instance_cache_purge_expired_elements();
-  check_and_instance_cache_try_swap_memory();
+  if (!is_instance_cache_memory_read_by_other()) {
+    check_and_instance_cache_try_swap_memory();
+  }
+  update_instance_cache_hit_rate();
   confdata_binlog_update_cron();
 }
 
@@ -1400,6 +1708,7 @@ static master_state master_change_state() {
 WorkerType run_master() {
   cpu_cnt = (int)sysconf(_SC_NPROCESSORS_ONLN);
   me->http_fd_port = http_fd_port;
+  me->instance_cache_layout_hash = instance_cache_get_layout_hash();
   me->own_http_fd = http_fd != nullptr && *http_fd != -1;
 
   epoll_sethandler(signal_fd, 0, signal_epoll_handler, nullptr);
@@ -1496,6 +1805,8 @@ WorkerType run_master() {
 
     shared_data_unlock(shared_data);
 
+    run_instance_cache_take_over_batches();
+
     if (to_exit) {
       vkprintf(1, "all workers killed. Exit\n");
       _exit(0);
@@ -1513,6 +1824,10 @@ WorkerType run_master() {
 
     using namespace std::chrono_literals;
     auto wait_time = 1s - (get_steady_tp_ms_now() - prev_cron_start_tp);
+    // the rest of the instance cache is copied on the next iteration
+    if (instance_cache_take_over_started && !instance_cache_take_over_done) {
+      wait_time = std::min<std::chrono::milliseconds>(wait_time, 10ms);
+    }
     epoll_work(static_cast<int>(std::max(wait_time, 0ms).count()));
 
     const auto new_tp = get_steady_tp_ms_now();
@@ -32,6 +32,7 @@
 #include "server/json-logger.h"
 #include "server/php-engine-vars.h"
 #include "server/php-queries.h"
+#include "server/sampling-profiler.h"
 #include "server/server-log.h"
 #include "server/server-stats.h"
 
@@ -48,12 +49,14 @@ void PHPScriptBase::error(const char *error_message, script_error_t error_type)
   current_script->state = run_state_t::error;
   current_script->error_message = error_message;
   current_script->error_type = error_type;
-  stack_end = reinterpret_cast<char *>(exit_context.uc_stack.ss_sp) + exit_context.uc_stack.ss_size;
+  stack_end = nullptr;
 #if ASAN7_ENABLED
   __sanitizer_finish_switch_fiber(nullptr, nullptr, nullptr);
-  __sanitizer_start_switch_fiber(nullptr, exit_context.uc_stack.ss_sp, exit_context.uc_stack.ss_size);
+  __sanitizer_start_switch_fiber(nullptr, nullptr, 0);
 #endif
-  setcontext(&exit_context);
+  // we may be in a signal handler here, the signal has to be unblocked before jumping out of it
+  sigprocmask(SIG_SETMASK, &exit_sigmask, nullptr);
+  set_execution_context(&exit_context);
 }
 
 void PHPScriptBase::check_tl() {
@@ -97,13 +100,15 @@ PHPScriptBase::PHPScriptBase(size_t mem_size, size_t stack_size) :
   data(nullptr),
   res(nullptr) {
   //fprintf (stderr, "PHPScriptBase: constructor\n");
-  stack_size = getpagesize() + (stack_size + getpagesize() - 1) / getpagesize() * getpagesize();
-  run_stack = (char *)valloc(stack_size);
-  assert (mprotect(run_stack, getpagesize(), PROT_NONE) == 0);
+  // the pooled stacks are matched by the size, so the same rounded one is used for all of them
+  this->stack_size = getpagesize() + (stack_size + getpagesize() - 1) / getpagesize() * getpagesize();
+  run_stack = acquire_execution_stack(this->stack_size);
   protected_end = run_stack + getpagesize();
-  run_stack_end = run_stack + stack_size;
+  run_stack_end = run_stack + this->stack_size;
+  vk::singleton<SamplingProfiler>::get().set_script_stack(run_stack, run_stack_end);
 
   run_mem = static_cast<char *>(mmap(nullptr, mem_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+  sigprocmask(SIG_SETMASK, nullptr, &exit_sigmask);
   //fprintf (stderr, "[%p -> %p] [%p -> %p]\n", run_stack, run_stack_end, run_mem, run_mem + mem_size);
 }
 
@@ -113,8 +118,8 @@ PHPScriptBase::~PHPScriptBase() {
     __sanitizer_finish_switch_fiber(nullptr, nullptr, nullptr);
   }
 #endif
-  mprotect(run_stack, getpagesize(), PROT_READ | PROT_WRITE);
-  free(run_stack);
+  vk::singleton<SamplingProfiler>::get().set_script_stack(nullptr, nullptr);
+  release_execution_stack(run_stack, stack_size);
   munmap(run_mem, mem_size);
 }
 
@@ -127,11 +132,7 @@ void PHPScriptBase::init(script_t *script, php_query_data *data_to_set) {
 
   assert (state == run_state_t::before_init);
 
-  getcontext(&run_context);
-  run_context.uc_stack.ss_sp = run_stack;
-  run_context.uc_stack.ss_size = stack_size;
-  run_context.uc_link = nullptr;
-  makecontext(&run_context, &cur_run, 0);
+  make_execution_context(&run_context, run_stack, stack_size, &cur_run);
 
   run_main = script;
   data = data_to_set;
@@ -145,6 +146,8 @@ void PHPScriptBase::init(script_t *script, php_query_data *data_to_set) {
   cur_timestamp = dl_time();
   queries_cnt = 0;
   long_queries_cnt = 0;
+  accounting.start();
+  blocked_on = BlockingResource::other;
 
   query_stats_id++;
   memset(&query_stats, 0, sizeof(query_stats));
@@ -152,29 +155,29 @@ void PHPScriptBase::init(script_t *script, php_query_data *data_to_set) {
   PHPScriptBase::ml_flag = false;
 }
 
-int PHPScriptBase::swapcontext_helper(ucontext_t *oucp, const ucontext_t *ucp) {
-  stack_end = reinterpret_cast<char *>(ucp->uc_stack.ss_sp) + ucp->uc_stack.ss_size;
+void PHPScriptBase::switch_context(execution_context *from, const execution_context *to, char *to_stack, size_t to_stack_size) {
+  stack_end = to_stack ? to_stack + to_stack_size : nullptr;
 #if ASAN7_ENABLED
   if (fiber_is_started) {
     __sanitizer_finish_switch_fiber(nullptr, nullptr, nullptr);
   }
   fiber_is_started = true;
-  __sanitizer_start_switch_fiber(nullptr, ucp->uc_stack.ss_sp, ucp->uc_stack.ss_size);
+  __sanitizer_start_switch_fiber(nullptr, to_stack, to_stack_size);
 #endif
 
-  return swapcontext(oucp, ucp);
+  swap_execution_context(from, to);
 }
 void PHPScriptBase::pause() {
   //fprintf (stderr, "pause: \n");
   is_running = false;
-  assert (swapcontext_helper(&run_context, &exit_context) == 0);
+  switch_context(&run_context, &exit_context, nullptr, 0);
   is_running = true;
   check_tl();
   //fprintf (stderr, "pause: ended\n");
 }
 
 void PHPScriptBase::resume() {
-  assert (swapcontext_helper(&exit_context, &run_context) == 0);
+  switch_context(&exit_context, &run_context, run_stack, stack_size);
 }
 
 void dump_query_stats() {
@@ -206,6 +209,48 @@ void dump_query_stats() {
   }
 }
 
+namespace {
+
+BlockingResource get_blocking_resource(const php_query_base_t *q_base) noexcept {
+  switch (static_cast<unsigned int>(q_base->type) & 0xFFFF0000) {
+    case PHPQ_NETQ:
+      if ((q_base->type & 0xFFFF) == NETQ_PACKET) {
+        switch (reinterpret_cast<const php_net_query_packet_t *>(q_base)->protocol) {
+          case p_memcached:
+            return BlockingResource::memcache;
+          case p_sql:
+            return BlockingResource::sql;
+          case p_rpc:
+            return BlockingResource::rpc;
+        }
+      }
+      return BlockingResource::other;
+    case PHPQ_WAIT:
+      // may be changed by the net event waking the script up
+      return BlockingResource::timer;
+    case PHPQ_HTTP_LOAD_POST:
+      return BlockingResource::http_post;
+    default:
+      return BlockingResource::other;
+  }
+}
+
+// the script waiting for the net events is woken up either by the event or by the timeout
+BlockingResource get_waking_resource() noexcept {
+  if (const net_event_t *event = get_last_net_event()) {
+    switch (event->type) {
+      case net_event_type_t::rpc_answer:
+      case net_event_type_t::rpc_error:
+        return BlockingResource::rpc;
+      case net_event_type_t::job_worker_answer:
+        return BlockingResource::job_worker;
+    }
+  }
+  return BlockingResource::timer;
+}
+
+} // namespace
+
 void PHPScriptBase::update_net_time() {
   double new_cur_timestamp = dl_time();
 
@@ -221,6 +266,8 @@ void PHPScriptBase::update_net_time() {
     }
   }
   net_time += net_add;
+  accounting.add_blocked_time(blocked_on == BlockingResource::timer ? get_waking_resource() : blocked_on, net_add);
+  blocked_on = BlockingResource::other;
 
   cur_timestamp = new_cur_timestamp;
 }
@@ -240,12 +287,17 @@ run_state_t PHPScriptBase::iterate() {
   update_net_time();
   notify_profiler_stop_waiting();
 
+  accounting.script_resumed();
   resume();
+  accounting.script_paused();
 
   notify_profiler_start_waiting();
   update_script_time();
 
-  queries_cnt += state == run_state_t::query;
+  if (state == run_state_t::query) {
+    ++queries_cnt;
+    blocked_on = get_blocking_resource(static_cast<const php_query_base_t *>(query));
+  }
   memset(&query_stats, 0, sizeof(query_stats));
   query_stats_id++;
 
@@ -260,6 +312,14 @@ void PHPScriptBase::finish() {
   update_net_time();
   vk::singleton<ServerStats>::get().add_request_stats(script_time, net_time, queries_cnt, long_queries_cnt, script_mem_stats.max_memory_used,
                                                       script_mem_stats.max_real_memory_used, vk::singleton<CurlMemoryUsage>::get().total_allocated, error_type);
+
+  accounting.finish(script_time, net_time, script_mem_stats.total_allocations, script_mem_stats.total_memory_allocated);
+  std::array<char, REQUEST_ENDPOINT_MAX_LEN> endpoint_buffer;
+  const vk::string_view endpoint = get_request_endpoint(data, endpoint_buffer);
+  vk::singleton<ServerStats>::get().add_request_accounting(endpoint, accounting);
+  if (slow_request_log_threshold > 0 && script_time + net_time >= slow_request_log_threshold) {
+    vk::singleton<JsonLogger>::get().write_request_log(endpoint, accounting);
+  }
   if (save_state == run_state_t::error) {
     assert (error_message != nullptr);
     kprintf("Critical error during script execution: %s\n", error_message);
@@ -300,7 +360,9 @@ void PHPScriptBase::finish() {
 
 void PHPScriptBase::clear() {
   assert(state == run_state_t::uncleared);
+  const int64_t reset_global_vars_before = global_vars_reset_count;
   run_main->clear();
+  vk::singleton<ServerStats>::get().add_global_vars_reset_stats(global_vars_reset_count - reset_global_vars_before);
   free_runtime_environment();
   state = run_state_t::empty;
   if (use_madvise_dontneed) {
@@ -395,7 +457,8 @@ int PHPScriptBase::get_net_queries_count() const {
 
 
 PHPScriptBase *volatile PHPScriptBase::current_script;
-ucontext_t PHPScriptBase::exit_context;
+execution_context PHPScriptBase::exit_context;
+sigset_t PHPScriptBase::exit_sigmask;
 volatile bool PHPScriptBase::is_running = false;
 volatile bool PHPScriptBase::tl_flag = false;
 volatile bool PHPScriptBase::ml_flag = false;
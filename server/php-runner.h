@@ -4,14 +4,16 @@
 
 #pragma once
 
-#include <ucontext.h>
+#include <csignal>
 
+#include "common/context-switch.h"
 #include "common/dl-utils-lite.h"
 #include "common/sanitizer.h"
 
 #include "server/php-engine-vars.h"
 #include "server/php-query-data.h"
 #include "server/php-script.h"
+#include "server/request-accounting.h"
 
 enum class run_state_t {
   finished,
@@ -93,17 +95,21 @@ class PHPScriptBase {
   double cur_timestamp, net_time, script_time;
   int queries_cnt;
   int long_queries_cnt{0};
+  RequestAccounting accounting;
+  // what the script is waiting for, the net time is accounted to it
+  BlockingResource blocked_on{BlockingResource::other};
 
 private:
 #if ASAN7_ENABLED
   bool fiber_is_started = false;
 #endif
-  int swapcontext_helper(ucontext_t *oucp, const ucontext_t *ucp);
+  void switch_context(execution_context *from, const execution_context *to, char *to_stack, size_t to_stack_size);
 
 public:
 
   static PHPScriptBase *volatile current_script;
-  static ucontext_t exit_context;
+  static execution_context exit_context;
+  static sigset_t exit_sigmask;
   volatile static bool is_running;
   volatile static bool tl_flag;
   volatile static bool ml_flag;
@@ -114,7 +120,7 @@ public:
   void *query;
   char *run_stack, *protected_end, *run_stack_end, *run_mem;
   size_t mem_size, stack_size;
-  ucontext_t run_context;
+  execution_context run_context;
 
   script_t *run_main;
   php_query_data *data;
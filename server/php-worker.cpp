@@ -2,12 +2,14 @@
 // Copyright (c) 2020 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <algorithm>
 #include <cassert>
 #include <poll.h>
 
 #include "common/precise-time.h"
 #include "common/rpc-error-codes.h"
 #include "net/net-connections.h"
+#include "net/net-http-server.h"
 #include "runtime/rpc.h"
 #include "runtime/job-workers/job-interface.h"
 #include "server/job-workers/job-stats.h"
@@ -35,6 +37,9 @@ php_worker *php_worker_create(php_worker_mode_t mode, connection *c, http_query_
   worker->init_time = precise_now;
   worker->finish_time = precise_now + timeout;
 
+  worker->priority = RequestPriority::normal;
+  worker->deadline = worker->finish_time;
+
   worker->paused = false;
   worker->terminate_flag = false;
   worker->terminate_reason = script_error_t::unclassified_error;
@@ -126,6 +131,24 @@ void php_worker_on_wakeup(php_worker *worker) {
   worker->wakeup_flag = 0;
 }
 
+/** the request can't be started before its deadline, it is answered without running the script **/
+static void php_worker_shed(php_worker *worker) {
+  vkprintf (1, "php script [req_id = %016llx] has missed the deadline, rejected\n", worker->req_id);
+  vk::singleton<ServerStats>::get().add_shed_request_stats(worker->priority);
+  static const char deadline_exceeded[] = "Request deadline exceeded";
+  if (worker->mode == http_worker) {
+    write_basic_http_header(worker->conn, 503, 0, sizeof(deadline_exceeded) - 1, nullptr, "text/plain; charset=UTF-8");
+    write_out(&worker->conn->Out, deadline_exceeded, sizeof(deadline_exceeded) - 1);
+  } else if (worker->mode == rpc_worker) {
+    server_rpc_error(worker->conn, worker->req_id, TL_ERROR_QUERY_TIMEOUT, deadline_exceeded);
+  }
+  worker->state = phpq_finish;
+
+  if (!php_worker_run_flag) {
+    php_worker_wakeup_pending();
+  }
+}
+
 /** trying to start query **/
 void php_worker_try_start(php_worker *worker) {
 
@@ -134,20 +157,31 @@ void php_worker_try_start(php_worker *worker) {
     return;
   }
 
+  if (worker->deadline <= precise_now) {
+    php_worker_shed(worker);
+    return;
+  }
+
   if (php_worker_run_flag) { // put connection into pending_http_query
     vkprintf (2, "php script [req_id = %016llx] is waiting\n", worker->req_id);
 
     auto pending_q = reinterpret_cast<conn_query *>(malloc(sizeof(conn_query)));
 
-    pending_q->custom_type = 0;
+    pending_q->custom_type = static_cast<int>(worker->priority);
     pending_q->outbound = (connection *)&pending_http_queue;
     assert (worker->conn != nullptr);
     pending_q->requester = worker->conn;
 
     pending_q->cq_type = &pending_cq_func;
-    pending_q->timer.wakeup_time = worker->finish_time;
+    // the request is woken up at the deadline to be rejected
+    pending_q->timer.wakeup_time = std::min(worker->finish_time, worker->deadline);
 
-    insert_conn_query(pending_q);
+    // the queue is ordered by the priority, the requests of the same priority keep the arrival order
+    auto *next_q = pending_http_queue.first_query;
+    while (next_q != (conn_query *)&pending_http_queue && next_q->custom_type >= pending_q->custom_type) {
+      next_q = next_q->next;
+    }
+    insert_conn_query_into_list(pending_q, next_q);
 
     worker->conn->status = conn_wait_net;
 
@@ -159,6 +193,17 @@ void php_worker_try_start(php_worker *worker) {
   worker->state = phpq_init_script;
 }
 
+void php_worker_wakeup_pending() {
+  int f = 0;
+  while (pending_http_queue.first_query != (conn_query *)&pending_http_queue && !f) {
+    //TODO: is it correct to do it?
+    conn_query *q = pending_http_queue.first_query;
+    // the expired requests are woken up as well, they are rejected without running the script
+    f = q->requester != nullptr && q->requester->generation == q->req_generation && q->timer.wakeup_time > precise_now;
+    delete_pending_query(q);
+  }
+}
+
 void php_worker_init_script(php_worker *worker) {
   double timeout = worker->finish_time - precise_now - 0.01;
   if (worker->terminate_flag) {
@@ -190,14 +235,18 @@ void php_worker_init_script(php_worker *worker) {
 
   script_t *script = get_script();
   dl_assert (script != nullptr, "failed to get script");
-  if (php_script == nullptr) {
-    php_script = php_script_create((size_t)max_memory, (size_t)(8 << 20));
-  }
+  php_worker_prepare_script();
   php_script_init(php_script, script, worker->data);
   php_script_set_timeout(timeout);
   worker->state = phpq_run;
 }
 
+void php_worker_prepare_script() {
+  if (php_script == nullptr) {
+    php_script = php_script_create((size_t)max_memory, (size_t)(8 << 20));
+  }
+}
+
 void php_worker_run_rpc_send_query(net_query_t *query) {
   int connection_id = query->host_num;
   slot_id_t slot_id = query->slot_id;
@@ -608,7 +657,6 @@ void php_worker_set_result(php_worker *worker, script_result *res) {
 
 void php_worker_free_script(php_worker *worker) {
   php_worker_run_flag = 0;
-  int f = 0;
 
   get_utime_monotonic();
   double worked = precise_now - worker->start_time;
@@ -627,13 +675,9 @@ void php_worker_free_script(php_worker *worker) {
   if (worked + waited > 1.0) {
     vkprintf (1, "ATTENTION php script [query worked = %.5lf] [query waited for start = %.5lf] [req_id = %016llx]\n", worked, waited, worker->req_id);
   }
+  vk::singleton<ServerStats>::get().add_queue_delay_stats(worker->priority, waited);
 
-  while (pending_http_queue.first_query != (conn_query *)&pending_http_queue && !f) {
-    //TODO: is it correct to do it?
-    conn_query *q = pending_http_queue.first_query;
-    f = q->requester != nullptr && q->requester->generation == q->req_generation;
-    delete_pending_query(q);
-  }
+  php_worker_wakeup_pending();
 
   php_queries_finish();
   php_script_clear(php_script);
@@ -644,6 +688,7 @@ void php_worker_free_script(php_worker *worker) {
     php_script_free(php_script);
     php_script = nullptr;
     finished_queries = 0;
+    // the response isn't flushed yet, so the new script is prepared by the event loop after it is
   }
 
   worker->state = phpq_finish;
@@ -7,6 +7,7 @@
 #include "server/php-query-data.h"
 #include "server/php-runner.h"
 #include "server/php-queries.h"
+#include "server/request-priority.h"
 
 
 enum php_worker_mode_t {
@@ -43,6 +44,10 @@ struct php_worker {
   double start_time;
   double finish_time;
 
+  // the request is rejected without running the script, if it can't be started before the deadline
+  RequestPriority priority;
+  double deadline;
+
   php_worker_state_t state;
   php_worker_mode_t mode;
 
@@ -61,8 +66,12 @@ void php_worker_terminate(php_worker *worker, int flag, script_error_t terminate
 void php_worker_on_wakeup(php_worker *worker);
 /** trying to start query **/
 void php_worker_try_start(php_worker *worker);
+// wakes up the waiting request of the highest priority, when the worker gets free
+void php_worker_wakeup_pending();
 
 void php_worker_init_script(php_worker *worker);
+// creates the script memory and stack beforehand, so the next request doesn't wait for them
+void php_worker_prepare_script();
 void php_worker_run(php_worker *worker);
 void php_worker_wait(php_worker *worker, int timeout_ms);
 void php_worker_run_rpc_answer_query(php_worker *worker, php_query_rpc_answer *ans);
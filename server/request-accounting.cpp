@@ -0,0 +1,144 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/request-accounting.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+
+#include "server/php-queries-stats.h"
+#include "server/php-query-data.h"
+
+namespace {
+
+// the numbers and the hex strings of at least 8 chars (with dashes for uuids) with a digit in them
+bool is_id_segment(const char *first, const char *last) noexcept {
+  const auto is_digit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+  const auto is_hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) || c == '-'; };
+  if (!std::any_of(first, last, is_digit)) {
+    return false;
+  }
+  return std::all_of(first, last, is_digit) || (last - first >= 8 && std::all_of(first, last, is_hex));
+}
+
+uint64_t seconds_to_ns(double time) noexcept {
+  return time > 0 ? std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(time)).count() : 0;
+}
+
+uint64_t timeval_to_ns(const timeval &tv) noexcept {
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000000 + static_cast<uint64_t>(tv.tv_usec) * 1000;
+}
+
+void get_thread_usage(rusage &usage) noexcept {
+#if defined(__APPLE__)
+  getrusage(RUSAGE_SELF, &usage);
+#else
+  getrusage(RUSAGE_THREAD, &usage);
+#endif
+}
+
+} // namespace
+
+const char *blocking_resource_name(BlockingResource resource) noexcept {
+  switch (resource) {
+    case BlockingResource::rpc:
+      return "rpc";
+    case BlockingResource::job_worker:
+      return "job_worker";
+    case BlockingResource::memcache:
+      return "memcache";
+    case BlockingResource::sql:
+      return "sql";
+    case BlockingResource::http_post:
+      return "http_post";
+    case BlockingResource::timer:
+      return "timer";
+    case BlockingResource::other:
+    case BlockingResource::types_count:
+      break;
+  }
+  return "other";
+}
+
+void RequestAccounting::start() noexcept {
+  *this = RequestAccounting{};
+  get_thread_usage(start_usage_);
+  start_rpc_queries_ = PhpQueriesStats::get_rpc_queries_stat().queries_count();
+  start_mc_queries_ = PhpQueriesStats::get_mc_queries_stat().queries_count();
+  start_sql_queries_ = PhpQueriesStats::get_sql_queries_stat().queries_count();
+}
+
+void RequestAccounting::finish(double script_time, double net_time, uint64_t script_allocations, uint64_t script_allocated_bytes) noexcept {
+  rusage usage{};
+  get_thread_usage(usage);
+  cpu_time_ns = timeval_to_ns(usage.ru_utime) + timeval_to_ns(usage.ru_stime)
+                - timeval_to_ns(start_usage_.ru_utime) - timeval_to_ns(start_usage_.ru_stime);
+  voluntary_context_switches = static_cast<uint64_t>(usage.ru_nvcsw - start_usage_.ru_nvcsw);
+  involuntary_context_switches = static_cast<uint64_t>(usage.ru_nivcsw - start_usage_.ru_nivcsw);
+
+  rpc_queries = PhpQueriesStats::get_rpc_queries_stat().queries_count() - start_rpc_queries_;
+  mc_queries = PhpQueriesStats::get_mc_queries_stat().queries_count() - start_mc_queries_;
+  sql_queries = PhpQueriesStats::get_sql_queries_stat().queries_count() - start_sql_queries_;
+
+  script_time_ns = seconds_to_ns(script_time);
+  net_time_ns = seconds_to_ns(net_time);
+  working_time_ns = script_time_ns + net_time_ns;
+  allocations = script_allocations;
+  allocated_bytes = script_allocated_bytes;
+}
+
+void RequestAccounting::add_blocked_time(BlockingResource resource, double time) noexcept {
+  blocked_time_ns[static_cast<size_t>(resource)] += seconds_to_ns(time);
+}
+
+vk::string_view get_request_endpoint(const php_query_data *data, std::array<char, REQUEST_ENDPOINT_MAX_LEN> &buffer) noexcept {
+  if (data == nullptr) {
+    return "cli";
+  }
+  if (data->job_data != nullptr) {
+    return "job";
+  }
+  if (const rpc_query_data *rpc_data = data->rpc_data) {
+    if (rpc_data->len <= 0) {
+      return "rpc";
+    }
+    // the function magic, the names of the tl functions aren't known by the server
+    const int len = snprintf(buffer.data(), buffer.size(), "rpc_0x%08x", static_cast<unsigned>(rpc_data->data[0]));
+    return {buffer.data(), static_cast<size_t>(len)};
+  }
+  if (const http_query_data *http_data = data->http_data) {
+    const char *segment = http_data->uri;
+    const char *last = std::find(segment, segment + http_data->uri_len, '?');
+    size_t len = 0;
+    const auto append = [&buffer, &len](const char *first, const char *last) {
+      for (; first != last && len != buffer.size(); ++first) {
+        buffer[len++] = std::isalnum(static_cast<unsigned char>(*first)) ? *first : '_';
+      }
+    };
+    for (size_t segments = 0; segments != REQUEST_ENDPOINT_MAX_SEGMENTS; ++segments) {
+      segment = std::find_if(segment, last, [](char c) { return c != '/'; });
+      if (segment == last) {
+        break;
+      }
+      const char *segment_end = std::find(segment, last, '/');
+      if (segments && len != buffer.size()) {
+        buffer[len++] = '_';
+      }
+      if (is_id_segment(segment, segment_end)) {
+        static constexpr char id[] = "id";
+        append(id, id + sizeof(id) - 1);
+      } else {
+        append(segment, segment_end);
+      }
+      segment = segment_end;
+    }
+    if (!len) {
+      return "index";
+    }
+    return {buffer.data(), len};
+  }
+  return "cli";
+}
@@ -0,0 +1,76 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <sys/resource.h>
+
+#include "common/cycleclock.h"
+#include "common/wrappers/string_view.h"
+
+struct php_query_data;
+
+// The resources the script waits for between its runs
+enum class BlockingResource : uint8_t {
+  rpc = 0,
+  job_worker,
+  memcache,
+  sql,
+  http_post,
+  timer,
+  other,
+  types_count
+};
+
+const char *blocking_resource_name(BlockingResource resource) noexcept;
+
+// The resources used by the request: it is collected with the cheap counters during the script run,
+// the rusage of the worker thread is taken only at the start and at the finish of the request
+struct RequestAccounting {
+  void start() noexcept;
+  void finish(double script_time, double net_time, uint64_t allocations, uint64_t allocated_bytes) noexcept;
+
+  void script_resumed() noexcept {
+    resumed_at_ = cycleclock_now();
+  }
+  void script_paused() noexcept {
+    cpu_cycles += cycleclock_now() - resumed_at_;
+  }
+
+  void add_blocked_time(BlockingResource resource, double time) noexcept;
+
+  uint64_t working_time_ns{0};
+  uint64_t script_time_ns{0};
+  uint64_t net_time_ns{0};
+  // the cycles spent in the script context, the event loop between the script runs isn't counted
+  uint64_t cpu_cycles{0};
+  // the user and system time of the worker, including the event loop
+  uint64_t cpu_time_ns{0};
+  uint64_t allocations{0};
+  uint64_t allocated_bytes{0};
+  uint64_t voluntary_context_switches{0};
+  uint64_t involuntary_context_switches{0};
+  uint64_t rpc_queries{0};
+  uint64_t mc_queries{0};
+  uint64_t sql_queries{0};
+  std::array<uint64_t, static_cast<size_t>(BlockingResource::types_count)> blocked_time_ns{};
+
+private:
+  uint64_t resumed_at_{0};
+  rusage start_usage_{};
+  uint64_t start_rpc_queries_{0};
+  uint64_t start_mc_queries_{0};
+  uint64_t start_sql_queries_{0};
+};
+
+// The stats of the requests are grouped by the endpoint: the http uri path, the rpc function or the job.
+// The name is made of [A-Za-z0-9_] only, so it can be used as a part of the stat name.
+// The endpoints take the stats slots for the lifetime of the server, so the http path is normalized:
+// only its first REQUEST_ENDPOINT_MAX_SEGMENTS segments are taken, and the ids in them (the numbers and the long hex strings,
+// like uuids or hashes) are replaced with "id", e.g. "/user/123/photos" and "/user/456" are both "user_id".
+constexpr size_t REQUEST_ENDPOINT_MAX_LEN = 48;
+constexpr size_t REQUEST_ENDPOINT_MAX_SEGMENTS = 2;
+vk::string_view get_request_endpoint(const php_query_data *data, std::array<char, REQUEST_ENDPOINT_MAX_LEN> &buffer) noexcept;
@@ -0,0 +1,27 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cinttypes>
+#include <strings.h>
+
+// The requests waiting for the busy worker are started by the priority, then by the arrival order.
+// The priority of the http request is taken from the X-Kphp-Priority header, the rpc requests are normal.
+enum class RequestPriority : uint8_t {
+  background = 0,
+  normal,
+  critical,
+  types_count
+};
+
+inline RequestPriority parse_request_priority(const char *value, int len) noexcept {
+  if (len == 10 && !strncasecmp(value, "background", 10)) {
+    return RequestPriority::background;
+  }
+  if (len == 8 && !strncasecmp(value, "critical", 8)) {
+    return RequestPriority::critical;
+  }
+  return RequestPriority::normal;
+}
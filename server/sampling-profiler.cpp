@@ -0,0 +1,294 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include "server/sampling-profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <map>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "common/dl-utils-lite.h"
+#include "common/fast-backtrace.h"
+#include "common/kprintf.h"
+#include "common/wrappers/memory-utils.h"
+
+struct SamplingProfiler::WorkerSamples {
+  // the table is written only by the signal handler of its worker and read by the master,
+  // the slot is published by the hash store and isn't changed after that, except the count
+  static constexpr size_t slots_count = 1024;
+  static constexpr size_t max_probes = 16;
+
+  struct Slot {
+    std::atomic<uint64_t> hash{0};
+    std::atomic<uint64_t> count{0};
+    int depth{0};
+    std::array<void *, max_stack_depth> frames{};
+  };
+
+  std::atomic<uint64_t> samples{0};
+  std::atomic<uint64_t> dropped_samples{0};
+  std::array<Slot, slots_count> slots;
+
+  void reset() noexcept {
+    samples.store(0, std::memory_order_relaxed);
+    dropped_samples.store(0, std::memory_order_relaxed);
+    for (auto &slot : slots) {
+      // the pages never written by the previous workers stay unallocated
+      if (slot.hash.load(std::memory_order_relaxed)) {
+        slot.hash.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void add(void *const *frames, int depth) noexcept {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i != depth; ++i) {
+      hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 0x100000001b3ULL;
+    }
+    hash |= 1;
+
+    for (size_t probe = 0; probe != max_probes; ++probe) {
+      Slot &slot = slots[(hash + probe) & (slots_count - 1)];
+      const uint64_t slot_hash = slot.hash.load(std::memory_order_relaxed);
+      if (!slot_hash) {
+        slot.depth = depth;
+        std::copy(frames, frames + depth, slot.frames.begin());
+        slot.count.store(1, std::memory_order_relaxed);
+        slot.hash.store(hash, std::memory_order_release);
+        return;
+      }
+      if (slot_hash == hash && slot.depth == depth && std::equal(frames, frames + depth, slot.frames.begin())) {
+        slot.count.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    dropped_samples.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+namespace {
+
+struct InterruptedContext {
+  void *ip{nullptr};
+  void *bp{nullptr};
+  const char *sp{nullptr};
+};
+
+InterruptedContext get_interrupted_context(void *ucontext) noexcept {
+  const auto *uc = static_cast<const ucontext_t *>(ucontext);
+  InterruptedContext context;
+#if defined(__APPLE__)
+  context.ip = reinterpret_cast<void *>(uc->uc_mcontext->__ss.__rip);
+  context.bp = reinterpret_cast<void *>(uc->uc_mcontext->__ss.__rbp);
+  context.sp = reinterpret_cast<const char *>(uc->uc_mcontext->__ss.__rsp);
+#elif defined(__x86_64__)
+  context.ip = reinterpret_cast<void *>(uc->uc_mcontext.gregs[REG_RIP]);
+  context.bp = reinterpret_cast<void *>(uc->uc_mcontext.gregs[REG_RBP]);
+  context.sp = reinterpret_cast<const char *>(uc->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__aarch64__)
+  context.ip = reinterpret_cast<void *>(uc->uc_mcontext.pc);
+  context.bp = reinterpret_cast<void *>(uc->uc_mcontext.regs[29]);
+  context.sp = reinterpret_cast<const char *>(uc->uc_mcontext.sp);
+#else
+#error "Unsupported arch"
+#endif
+  return context;
+}
+
+// the end of the argument list or of the template arguments at the top level of the demangled name
+size_t find_top_level(const std::string &name, char c) noexcept {
+  int depth = 0;
+  for (size_t i = 0; i != name.size(); ++i) {
+    if (name[i] == c && depth == 0 && i != 0) {
+      return i;
+    }
+    if (name[i] == '<' || name[i] == '(') {
+      ++depth;
+    } else if ((name[i] == '>' || name[i] == ')') && depth > 0) {
+      --depth;
+    }
+  }
+  return std::string::npos;
+}
+
+} // namespace
+
+void SamplingProfiler::init(uint16_t workers_count) noexcept {
+  if (!is_enabled() || !workers_count) {
+    return;
+  }
+  workers_count_ = workers_count;
+  samples_ = static_cast<WorkerSamples *>(mmap_shared(sizeof(WorkerSamples) * workers_count_));
+  for (uint16_t i = 0; i != workers_count_; ++i) {
+    new(samples_ + i) WorkerSamples{};
+  }
+}
+
+void SamplingProfiler::start_worker(uint16_t worker_unique_id) noexcept {
+  if (!samples_ || worker_unique_id >= workers_count_) {
+    return;
+  }
+  worker_samples_ = samples_ + worker_unique_id;
+  worker_samples_->reset();
+
+#if !defined(__APPLE__)
+  // the stack of the worker process before it switches to the script
+  rlimit stack_limit{};
+  getrlimit(RLIMIT_STACK, &stack_limit);
+  const rlim_t max_main_stack_size = rlim_t{1} << 30;
+  const rlim_t main_stack_size = std::min(stack_limit.rlim_cur, max_main_stack_size);
+  main_stack_end_ = static_cast<const char *>(__libc_stack_end);
+  main_stack_begin_ = main_stack_end_ - main_stack_size;
+#endif
+
+  dl_sigaction(SIGPROF, nullptr, dl_get_empty_sigset(), SA_SIGINFO | SA_RESTART, sigprof_handler);
+
+  itimerval timer{};
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = std::max(1000000 / frequency_, 1);
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    kprintf("can't start the sampling profiler: %s\n", strerror(errno));
+  }
+}
+
+void SamplingProfiler::sigprof_handler(int, siginfo_t *, void *ucontext) {
+  vk::singleton<SamplingProfiler>::get().add_sample(ucontext);
+}
+
+void SamplingProfiler::add_sample(void *ucontext) noexcept {
+  if (!worker_samples_) {
+    return;
+  }
+  worker_samples_->samples.fetch_add(1, std::memory_order_relaxed);
+
+  const InterruptedContext context = get_interrupted_context(ucontext);
+  std::array<void *, max_stack_depth> frames;
+  frames[0] = context.ip;
+  int depth = 1;
+  // only the frames of the stack the worker has been interrupted on are read, the frame pointer can be garbage in the middle of the switch
+  const char *stack_end = nullptr;
+  if (script_stack_begin_ <= context.sp && context.sp < script_stack_end_) {
+    stack_end = script_stack_end_;
+  } else if (main_stack_begin_ <= context.sp && context.sp < main_stack_end_) {
+    stack_end = main_stack_end_;
+  }
+  if (stack_end) {
+    depth += fast_backtrace_by_bp(context.bp, context.sp, stack_end, frames.data() + 1, max_stack_depth - 1);
+  }
+  worker_samples_->add(frames.data(), depth);
+}
+
+std::string SamplingProfiler::get_frame_name(const char *symbol) noexcept {
+  std::string name{symbol};
+  if (name.compare(0, 2, "_Z") == 0) {
+    int status = 0;
+    if (char *demangled = abi::__cxa_demangle(symbol, nullptr, nullptr, &status)) {
+      name = demangled;
+      std::free(demangled);
+    }
+  }
+
+  const size_t args_begin = find_top_level(name, '(');
+  if (args_begin != std::string::npos) {
+    name.resize(args_begin);
+  }
+  // the return type of the template function
+  const size_t name_begin = find_top_level(name, ' ');
+  if (name_begin != std::string::npos) {
+    name.erase(0, name_begin + 1);
+  }
+
+  if (name.compare(0, 2, "f$") == 0) {
+    const size_t template_args_begin = find_top_level(name, '<');
+    if (template_args_begin != std::string::npos) {
+      name.resize(template_args_begin);
+    }
+    // "Class$$method$$Context" is the method of the class called in the context of the derived one
+    name.erase(0, 2);
+    const size_t method_begin = name.find("$$");
+    if (method_begin != std::string::npos) {
+      const size_t context_begin = name.find("$$", method_begin + 2);
+      if (context_begin != std::string::npos) {
+        name.resize(context_begin);
+      }
+      name.replace(method_begin, 2, "::");
+    }
+    std::replace(name.begin(), name.end(), '$', '\\');
+  }
+  // ';' separates the frames in the collapsed format
+  std::replace(name.begin(), name.end(), ';', ':');
+  return name;
+}
+
+const std::string &SamplingProfiler::symbolize(void *ip) noexcept {
+  auto it = frame_names_.find(ip);
+  if (it != frame_names_.end()) {
+    return it->second;
+  }
+  std::string name;
+  Dl_info info{};
+  if (dladdr(ip, &info) && info.dli_sname) {
+    name = get_frame_name(info.dli_sname);
+  } else if (info.dli_fname) {
+    const char *file_name = std::strrchr(info.dli_fname, '/');
+    name = std::string{"["} + (file_name ? file_name + 1 : info.dli_fname) + "]";
+  } else {
+    name = "[unknown]";
+  }
+  return frame_names_.emplace(ip, std::move(name)).first->second;
+}
+
+std::string SamplingProfiler::dump_collapsed_stacks() noexcept {
+  // the different addresses of the same functions are merged
+  std::map<std::string, uint64_t> stacks;
+  for (uint16_t worker = 0; worker < workers_count_; ++worker) {
+    for (const auto &slot : samples_[worker].slots) {
+      if (!slot.hash.load(std::memory_order_acquire)) {
+        continue;
+      }
+      const uint64_t count = slot.count.load(std::memory_order_relaxed);
+      const int depth = std::min(slot.depth, max_stack_depth);
+      std::string stack;
+      for (int i = depth - 1; i >= 0; --i) {
+        // the return address points to the instruction after the call
+        auto *ip = static_cast<char *>(slot.frames[i]) - (i ? 1 : 0);
+        stack += symbolize(ip);
+        if (i) {
+          stack += ';';
+        }
+      }
+      stacks[stack] += count;
+    }
+  }
+
+  std::string result;
+  for (const auto &stack : stacks) {
+    result.append(stack.first).append(" ").append(std::to_string(stack.second)).append("\n");
+  }
+  return result;
+}
+
+void SamplingProfiler::write_stats_to(stats_t *stats) const noexcept {
+  if (!samples_) {
+    return;
+  }
+  uint64_t samples = 0;
+  uint64_t dropped_samples = 0;
+  for (uint16_t worker = 0; worker < workers_count_; ++worker) {
+    samples += samples_[worker].samples.load(std::memory_order_relaxed);
+    dropped_samples += samples_[worker].dropped_samples.load(std::memory_order_relaxed);
+  }
+  add_gauge_stat_long(stats, "sampling_profiler.samples", samples);
+  add_gauge_stat_long(stats, "sampling_profiler.dropped_samples", dropped_samples);
+}
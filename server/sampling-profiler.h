@@ -0,0 +1,74 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cinttypes>
+#include <csignal>
+#include <string>
+#include <unordered_map>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+#include "common/stats/provider.h"
+
+// The always-on sampling cpu profiler of the workers: the worker is interrupted by SIGPROF with the given frequency
+// of its cpu time, the stack is taken by the frame pointers and counted in the shared memory table of the worker.
+// The master merges the tables of all workers and names the frames by the dynamic symbol table of the binary,
+// the workers are forked from the master, so the addresses are the same. The kphp functions are named like in php.
+class SamplingProfiler : vk::not_copyable {
+public:
+  static constexpr int max_frequency = 1000;
+  static constexpr int max_stack_depth = 32;
+
+  void set_frequency(int frequency) noexcept {
+    frequency_ = frequency;
+  }
+  bool is_enabled() const noexcept {
+    return frequency_ > 0;
+  }
+
+  // should be called by the master before the workers are forked
+  void init(uint16_t workers_count) noexcept;
+
+  // should be called by the worker just after fork
+  void start_worker(uint16_t worker_unique_id) noexcept;
+
+  // the stack of the script, the worker switches to it for running the script
+  void set_script_stack(const char *stack_begin, const char *stack_end) noexcept {
+    script_stack_begin_ = stack_begin;
+    script_stack_end_ = stack_end;
+  }
+
+  // the stacks of all workers in the collapsed format: "root;caller;callee samples" per line
+  std::string dump_collapsed_stacks() noexcept;
+
+  void write_stats_to(stats_t *stats) const noexcept;
+
+  // "_Z5f$foov" -> "foo", "f$VK$Api$$call(string const&)" -> "VK\Api::call", "PHPScriptBase::run()" -> "PHPScriptBase::run"
+  static std::string get_frame_name(const char *symbol) noexcept;
+
+private:
+  SamplingProfiler() = default;
+
+  friend class vk::singleton<SamplingProfiler>;
+
+  struct WorkerSamples;
+
+  static void sigprof_handler(int signum, siginfo_t *info, void *ucontext);
+  void add_sample(void *ucontext) noexcept;
+  const std::string &symbolize(void *ip) noexcept;
+
+  int frequency_{0};
+  uint16_t workers_count_{0};
+  WorkerSamples *samples_{nullptr};
+  WorkerSamples *worker_samples_{nullptr};
+
+  const char *script_stack_begin_{nullptr};
+  const char *script_stack_end_{nullptr};
+  const char *main_stack_begin_{nullptr};
+  const char *main_stack_end_{nullptr};
+
+  std::unordered_map<void *, std::string> frame_names_;
+};
@@ -10,10 +10,14 @@
 
 #include "common/functional/identity.h"
 #include "common/smart_iterators/transform_iterator.h"
+#include "common/stats/hdr-histogram.h"
 #include "common/wrappers/memory-utils.h"
 #include "net/net-events.h"
+#include "net/net-tcp-rpc-client.h"
 
 #include "runtime/curl.h"
+#include "runtime/memory_usage.h"
+#include "runtime/regexp.h"
 
 #include "server/workers-control.h"
 
@@ -40,6 +44,18 @@ struct ScriptSamples : WithStatType<uint64_t> {
   };
 };
 
+// the time the request has been waiting for the busy worker, by the priority
+struct AdmissionSamples : WithStatType<uint64_t> {
+  enum class Key {
+    background_queue_delay = 0,
+    normal_queue_delay,
+    critical_queue_delay,
+    types_count
+  };
+};
+
+static_assert(static_cast<size_t>(AdmissionSamples::Key::types_count) == static_cast<size_t>(RequestPriority::types_count), "every priority has its samples");
+
 struct QueriesStat : WithStatType<uint64_t> {
   enum class Key {
     incoming_queries,
@@ -83,6 +99,31 @@ struct HeapStat : WithStatType<uint64_t> {
   enum class Key {
     script_heap_memory_usage = 0,
     curl_memory_currently_usage,
+    frozen_const_memory_usage,
+    frozen_const_shared_memory_usage,
+    types_count
+  };
+};
+
+struct RegexpStat : WithStatType<uint64_t> {
+  enum class Key {
+    cache_hits,
+    cache_misses,
+    cache_evictions,
+    cache_size,
+    jit_compiled,
+    compile_time,
+    prefilter_rejections,
+    literal_searches,
+    types_count
+  };
+};
+
+struct RpcClientStat : WithStatType<uint64_t> {
+  enum class Key {
+    flushes,
+    flushed_packets,
+    flushed_bytes,
     types_count
   };
 };
@@ -98,6 +139,20 @@ struct VMStat : WithStatType<uint32_t> {
   };
 };
 
+struct ConnectionsStat : WithStatType<uint64_t> {
+  enum class Key {
+    accepted_http_connections,
+    types_count
+  };
+};
+
+struct StartupStat : WithStatType<uint64_t> {
+  enum class Key {
+    time_to_first_request,
+    types_count
+  };
+};
+
 struct IdleStat : WithStatType<double> {
   enum class Key {
     tot_idle_time,
@@ -123,6 +178,9 @@ struct MiscStat : WithStatType<uint64_t> {
   };
 };
 
+// the latency, memory and other values of the requests are counted with the relative error below 3%
+using Histogram = vk::HdrHistogram<>;
+
 template<class E, class T = typename E::StatType>
 struct EnumTable : std::array<T, static_cast<size_t>(E::Key::types_count)> {
   using Base = std::array<T, static_cast<size_t>(E::Key::types_count)>;
@@ -141,26 +199,41 @@ struct EnumTable : std::array<T, static_cast<size_t>(E::Key::types_count)> {
 template<class T>
 struct Percentiles {
   T p50{};
+  T p90{};
   T p95{};
   T p99{};
+  T p999{};
   T max{};
   T sum{};
 
   template<class I, class Mapper = vk::identity>
   void update_percentiles(I first, I last, const Mapper &mapper = {}) noexcept {
     const auto size = last - first;
-    set_percentile<50>(p50, first, size, mapper);
-    set_percentile<95>(p95, first, size, mapper);
-    set_percentile<99>(p99, first, size, mapper);
-    set_percentile<100>(max, first, size, mapper);
+    set_percentile<500>(p50, first, size, mapper);
+    set_percentile<900>(p90, first, size, mapper);
+    set_percentile<950>(p95, first, size, mapper);
+    set_percentile<990>(p99, first, size, mapper);
+    set_percentile<999>(p999, first, size, mapper);
+    set_percentile<1000>(max, first, size, mapper);
     sum = std::accumulate(vk::make_transform_iterator(mapper, first), vk::make_transform_iterator(mapper, last), T{});
   }
 
+  void update_percentiles(const Histogram &histogram) noexcept {
+    const auto values = histogram.get_values_at_percentiles(std::array<double, 6>{50, 90, 95, 99, 99.9, 100});
+    p50 = values[0];
+    p90 = values[1];
+    p95 = values[2];
+    p99 = values[3];
+    p999 = values[4];
+    max = values[5];
+  }
+
 private:
+  // the percentile is given in the per mille
   template<size_t P, class I, class Mapper>
   static void set_percentile(T &out, I first, std::ptrdiff_t size, const Mapper &mapper) noexcept {
     if (size) {
-      const auto index = P * (size - 1) / 100;
+      const auto index = P * (size - 1) / 1000;
       std::nth_element(first, first + index, first + size);
       out = mapper(first[index]);
     } else {
@@ -193,6 +266,31 @@ EnumTable<HeapStat> get_heap_stat() noexcept {
   EnumTable<HeapStat> result;
   result[HeapStat::Key::curl_memory_currently_usage] = vk::singleton<CurlMemoryUsage>::get().currently_allocated;
   result[HeapStat::Key::script_heap_memory_usage] = dl::get_heap_memory_used();
+  const auto frozen_const_stats = get_frozen_const_memory_stats();
+  result[HeapStat::Key::frozen_const_memory_usage] = frozen_const_stats.frozen_bytes;
+  result[HeapStat::Key::frozen_const_shared_memory_usage] = frozen_const_stats.shared_bytes;
+  return result;
+}
+
+EnumTable<RegexpStat> get_regexp_stat() noexcept {
+  EnumTable<RegexpStat> result;
+  const auto &regexp_stats = vk::singleton<RegexpStats>::get();
+  result[RegexpStat::Key::cache_hits] = regexp_stats.cache_hits;
+  result[RegexpStat::Key::cache_misses] = regexp_stats.cache_misses;
+  result[RegexpStat::Key::cache_evictions] = regexp_stats.cache_evictions;
+  result[RegexpStat::Key::cache_size] = regexp_stats.cache_size;
+  result[RegexpStat::Key::jit_compiled] = regexp_stats.jit_compiled;
+  result[RegexpStat::Key::compile_time] = regexp_stats.compile_time_ns;
+  result[RegexpStat::Key::prefilter_rejections] = regexp_stats.prefilter_rejections;
+  result[RegexpStat::Key::literal_searches] = regexp_stats.literal_searches;
+  return result;
+}
+
+EnumTable<RpcClientStat> get_rpc_client_stat() noexcept {
+  EnumTable<RpcClientStat> result;
+  result[RpcClientStat::Key::flushes] = tcp_rpcc_total_flushes;
+  result[RpcClientStat::Key::flushed_packets] = tcp_rpcc_total_flushed_packets;
+  result[RpcClientStat::Key::flushed_bytes] = tcp_rpcc_total_flushed_bytes;
   return result;
 }
 
@@ -216,60 +314,20 @@ EnumTable<QueriesStat> make_queries_stat(uint64_t script_queries, uint64_t long_
   return result;
 }
 
-template<class T>
-struct AggregatedSamples;
-
-template<class T>
-struct SharedSamples : private vk::not_copyable {
-public:
-  void init(std::mt19937 *gen) noexcept {
-    gen_ = gen;
-  }
-
-  void add_sample(T value, size_t sample_index) noexcept {
-    if (sample_index >= samples_.size()) {
-      // the zero value doesn't override anything
-      if (value == T{}) {
-        return;
-      }
-      sample_index = std::uniform_int_distribution<size_t>{0, sample_index}(*gen_);
-    }
-    if (sample_index < samples_.size()) {
-      samples_[sample_index].store(value, std::memory_order_relaxed);
-    }
-  }
-
-private:
-  friend struct AggregatedSamples<T>;
-
-  std::mt19937 *gen_{nullptr};
-  std::array<std::atomic<T>, 1024> samples_{};
-};
-
 template<class E>
-struct SharedSamplesBundle : EnumTable<E, SharedSamples<typename E::StatType>>, private vk::not_copyable {
+struct SharedHistogramsBundle : EnumTable<E, Histogram>, private vk::not_copyable {
 public:
-  explicit SharedSamplesBundle(std::mt19937 *gen) noexcept {
-    for (auto &s : *this) {
-      s.init(gen);
-    }
-  }
-
   void add_sample(const EnumTable<E> &sample) noexcept {
-    const size_t sample_index = last_sample.fetch_add(1, std::memory_order_acq_rel);
     for (size_t i = 0; i != this->size(); ++i) {
-      (*this)[i].add_sample(sample[i], sample_index);
+      // the zero value means there is no sample
+      if (sample[i]) {
+        (*this)[i].add(sample[i]);
+      }
     }
   }
-
-  std::atomic<uint64_t> last_sample{0};
 };
 
 struct WorkerSharedStats : private vk::not_copyable {
-  explicit WorkerSharedStats(std::mt19937 *gen) noexcept:
-    script_samples(gen) {
-  }
-
   void add_request_stats(const EnumTable<QueriesStat> &queries, script_error_t error,
                          uint64_t memory_used, uint64_t real_memory_used, uint64_t curl_total_allocated) noexcept {
     errors[static_cast<size_t>(error)].fetch_add(1, std::memory_order_relaxed);
@@ -293,16 +351,14 @@ struct WorkerSharedStats : private vk::not_copyable {
   std::array<std::atomic<uint32_t>, static_cast<size_t>(script_error_t::errors_count)> errors{};
 
   EnumTable<QueriesStat, std::atomic<QueriesStat::StatType>> total_queries_stat;
-  SharedSamplesBundle<ScriptSamples> script_samples;
+  std::atomic<uint64_t> total_reset_global_vars{0};
+  SharedHistogramsBundle<ScriptSamples> script_samples;
+
+  std::array<std::atomic<uint64_t>, static_cast<size_t>(RequestPriority::types_count)> shed_requests{};
+  SharedHistogramsBundle<AdmissionSamples> admission_samples;
 };
 
 struct JobWorkerSharedStats : WorkerSharedStats {
-  explicit JobWorkerSharedStats(std::mt19937 *gen) noexcept:
-    WorkerSharedStats(gen),
-    job_samples(gen),
-    job_common_memory_samples(gen) {
-  }
-
   void add_job_stats(uint64_t job_wait_ns, uint64_t request_memory_used, uint64_t request_real_memory_used, uint64_t response_memory_used, uint64_t response_real_memory_used) noexcept {
     EnumTable<JobSamples> sample;
     sample[JobSamples::Key::wait_time] = job_wait_ns;
@@ -320,75 +376,135 @@ struct JobWorkerSharedStats : WorkerSharedStats {
     job_common_memory_samples.add_sample(sample);
   }
 
-  SharedSamplesBundle<JobSamples> job_samples;
-  SharedSamplesBundle<JobCommonMemorySamples> job_common_memory_samples;
+  SharedHistogramsBundle<JobSamples> job_samples;
+  SharedHistogramsBundle<JobCommonMemorySamples> job_common_memory_samples;
 };
 
-template<class T>
-struct AggregatedSamples : vk::not_copyable {
-public:
-  using Sample = std::pair<T, std::chrono::steady_clock::time_point>;
-
-  AggregatedSamples() noexcept:
-    last_(samples_.begin()) {
+struct EndpointSharedStats : private vk::not_copyable {
+  void add_request(const RequestAccounting &accounting) noexcept {
+    requests.fetch_add(1, std::memory_order_relaxed);
+    allocations.fetch_add(accounting.allocations, std::memory_order_relaxed);
+    voluntary_context_switches.fetch_add(accounting.voluntary_context_switches, std::memory_order_relaxed);
+    involuntary_context_switches.fetch_add(accounting.involuntary_context_switches, std::memory_order_relaxed);
+    rpc_queries.fetch_add(accounting.rpc_queries, std::memory_order_relaxed);
+    mc_queries.fetch_add(accounting.mc_queries, std::memory_order_relaxed);
+    sql_queries.fetch_add(accounting.sql_queries, std::memory_order_relaxed);
+    for (size_t i = 0; i != blocked_time.size(); ++i) {
+      blocked_time[i].fetch_add(accounting.blocked_time_ns[i], std::memory_order_relaxed);
+    }
+    working_time.add(accounting.working_time_ns);
+    cpu_time.add(accounting.cpu_time_ns);
+    allocated_bytes.add(accounting.allocated_bytes);
   }
 
-  void init(std::mt19937 *gen) noexcept {
-    gen_ = gen;
-  }
+  // the slot is taken by the first request of the endpoint, the name is written after that
+  std::atomic<uint64_t> name_hash{0};
+  std::atomic<bool> name_ready{false};
+  std::array<char, REQUEST_ENDPOINT_MAX_LEN + 1> name{};
+
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> voluntary_context_switches{0};
+  std::atomic<uint64_t> involuntary_context_switches{0};
+  std::atomic<uint64_t> rpc_queries{0};
+  std::atomic<uint64_t> mc_queries{0};
+  std::atomic<uint64_t> sql_queries{0};
+  std::array<std::atomic<uint64_t>, static_cast<size_t>(BlockingResource::types_count)> blocked_time{};
+
+  Histogram working_time;
+  Histogram cpu_time;
+  Histogram allocated_bytes;
+};
 
-  void recalc(SharedSamples<T> &samples, size_t samples_count,
-              std::chrono::steady_clock::time_point now_tp) noexcept {
-    last_ = std::remove_if(samples_.begin(), last_,
-                           [now_tp](const Sample &s) { return now_tp - s.second > std::chrono::minutes{1}; });
-    samples_count = std::min(samples_count, samples.samples_.size());
+struct EndpointsSharedStats : private vk::not_copyable {
+  // the endpoints which don't fit are counted in the last slot
+  static constexpr size_t max_endpoints = 64;
 
-    while (last_ != samples_.end() && samples_count) {
-      const Sample sample{samples.samples_[--samples_count].exchange(T{}, std::memory_order_relaxed), now_tp};
-      if (sample.first != T{}) {
-        *last_++ = sample;
+  EndpointSharedStats &get_endpoint(vk::string_view name) noexcept {
+    // FNV-1a, the zero hash means the free slot
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : name) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    hash |= 1;
+
+    constexpr size_t slots = max_endpoints - 1;
+    for (size_t i = 0, index = hash % slots; i != slots; ++i, index = (index + 1) % slots) {
+      auto &endpoint = endpoints[index];
+      uint64_t expected = 0;
+      if (endpoint.name_hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel)) {
+        const size_t len = std::min(name.size(), endpoint.name.size() - 1);
+        std::copy(name.begin(), name.begin() + len, endpoint.name.begin());
+        endpoint.name[len] = '\0';
+        endpoint.name_ready.store(true, std::memory_order_release);
+        return endpoint;
+      }
+      if (expected == hash) {
+        return endpoint;
       }
     }
+    return endpoints.back();
+  }
 
-    std::uniform_int_distribution<size_t> distrib(0, samples_.size());
-    while (samples_count) {
-      const Sample sample{samples.samples_[--samples_count].exchange(T{}, std::memory_order_relaxed), now_tp};
-      if (sample.first != T{}) {
-        const size_t index = distrib(*gen_);
-        if (index < samples_.size()) {
-          samples_[index] = sample;
-        }
-        // the zero value doesn't affect the sample
-        distrib.param(std::uniform_int_distribution<size_t>::param_type{0, distrib.max() + 1});
-      }
+  std::array<EndpointSharedStats, max_endpoints> endpoints;
+};
+
+// The counters of the shared histogram are moved to the master every time the stats are aggregated,
+// the percentiles are taken from the current and the previous minutes together
+struct AggregatedHistogram : private vk::not_copyable {
+  void recalc(Histogram &shared, std::chrono::steady_clock::time_point now_tp) noexcept {
+    if (now_tp - window_start_ >= std::chrono::minutes{1}) {
+      current_ ^= 1;
+      windows_[current_].reset();
+      window_start_ = now_tp;
     }
-    percentiles.update_percentiles(samples_.begin(), last_, [](const Sample &s) { return s.first; });
+    windows_[current_].drain(shared);
+
+    last_minutes_.reset();
+    last_minutes_.merge(windows_[0]);
+    last_minutes_.merge(windows_[1]);
+    percentiles.update_percentiles(last_minutes_);
   }
 
-  Percentiles<T> percentiles;
+  Percentiles<uint64_t> percentiles;
 
 private:
-  std::array<Sample, 4096> samples_{};
-  typename std::array<Sample, 4096>::iterator last_{};
-  std::mt19937 *gen_{nullptr};
+  std::array<Histogram, 2> windows_;
+  Histogram last_minutes_;
+  size_t current_{0};
+  std::chrono::steady_clock::time_point window_start_;
 };
 
 template<class E>
-struct AggregatedSamplesBundle : EnumTable<E, AggregatedSamples<typename E::StatType>>, private vk::not_copyable {
+struct AggregatedHistogramsBundle : EnumTable<E, AggregatedHistogram>, private vk::not_copyable {
 public:
-  explicit AggregatedSamplesBundle(std::mt19937 *gen) noexcept {
-    for (auto &s : *this) {
-      s.init(gen);
+  void recalc(SharedHistogramsBundle<E> &histograms, std::chrono::steady_clock::time_point now_tp) noexcept {
+    for (size_t i = 0; i != this->size(); ++i) {
+      (*this)[i].recalc(histograms[i], now_tp);
     }
   }
+};
 
-  void recalc(SharedSamplesBundle<E> &samples, std::chrono::steady_clock::time_point now_tp) noexcept {
-    const size_t last_sample = samples.last_sample.load(std::memory_order_acquire);
-    for (size_t i = 0; i != this->size(); ++i) {
-      (*this)[i].recalc(samples[i], last_sample, now_tp);
+struct EndpointAggregatedStats : private vk::not_copyable {
+  void recalc(EndpointSharedStats &shared, std::chrono::steady_clock::time_point now_tp) noexcept {
+    working_time.recalc(shared.working_time, now_tp);
+    cpu_time.recalc(shared.cpu_time, now_tp);
+    allocated_bytes.recalc(shared.allocated_bytes, now_tp);
+  }
+
+  AggregatedHistogram working_time;
+  AggregatedHistogram cpu_time;
+  AggregatedHistogram allocated_bytes;
+};
+
+struct EndpointsAggregatedStats : private vk::not_copyable {
+  void recalc(EndpointsSharedStats &shared, std::chrono::steady_clock::time_point now_tp) noexcept {
+    for (size_t i = 0; i != endpoints.size(); ++i) {
+      endpoints[i].recalc(shared.endpoints[i], now_tp);
     }
-    samples.last_sample.store(0, std::memory_order_release);
   }
+
+  std::array<EndpointAggregatedStats, EndpointsSharedStats::max_endpoints> endpoints;
 };
 
 template<class E>
@@ -421,14 +537,20 @@ struct WorkerStatsBundle : EnumTable<E, std::array<std::atomic<typename E::StatT
 struct WorkerProcessStats : private vk::not_copyable {
   WorkerStatsBundle<MallocStat> malloc_stats{};
   WorkerStatsBundle<HeapStat> heap_stats{};
+  WorkerStatsBundle<RegexpStat> regexp_stats{};
+  WorkerStatsBundle<RpcClientStat> rpc_client_stats{};
   WorkerStatsBundle<VMStat> vm_stats{};
   WorkerStatsBundle<MiscStat> misc_stats{};
   WorkerStatsBundle<QueriesStat> query_stats{};
   WorkerStatsBundle<IdleStat> idle_stats{};
+  WorkerStatsBundle<ConnectionsStat> connections_stats{};
+  WorkerStatsBundle<StartupStat> startup_stats{};
 
   void update_worker_stats(uint16_t worker_index) noexcept {
     malloc_stats.set_worker_stats(get_malloc_stat(), worker_index);
     heap_stats.set_worker_stats(get_heap_stat(), worker_index);
+    regexp_stats.set_worker_stats(get_regexp_stat(), worker_index);
+    rpc_client_stats.set_worker_stats(get_rpc_client_stat(), worker_index);
     vm_stats.set_worker_stats(get_virtual_memory_stat(), worker_index);
     idle_stats.set_worker_stats(get_idle_stat(), worker_index);
     misc_stats.inc_stat(MiscStat::Key::worker_activity_counter, worker_index);
@@ -449,6 +571,8 @@ struct WorkerProcessStats : private vk::not_copyable {
 
   void reset_worker_stats(pid_t worker_pid, uint64_t active_connections, uint64_t max_connections, uint16_t worker_index) noexcept {
     query_stats.set_worker_stats(EnumTable<QueriesStat>{}, worker_index);
+    connections_stats.set_worker_stats(EnumTable<ConnectionsStat>{}, worker_index);
+    startup_stats.set_worker_stats(EnumTable<StartupStat>{}, worker_index);
     misc_stats.set_stat(MiscStat::Key::worker_activity_counter, worker_index, 1);
     misc_stats.set_stat(MiscStat::Key::process_pid, worker_index, worker_pid);
     misc_stats.set_stat(MiscStat::Key::worker_status, worker_index, MiscStat::worker_idle);
@@ -479,35 +603,35 @@ struct WorkerPercentilesBundle : EnumTable<E, Percentiles<typename E::StatType>>
 };
 
 struct WorkerAggregatedStats {
-  explicit WorkerAggregatedStats(std::mt19937 *gen) noexcept:
-    script_samples(gen) {
-  }
-
-  void recalc(SharedSamplesBundle<ScriptSamples> &script_shared_samples, std::chrono::steady_clock::time_point now_tp,
+  void recalc(WorkerSharedStats &shared_stats, std::chrono::steady_clock::time_point now_tp,
               const WorkerProcessStats &stats, uint16_t first_id, uint16_t last_id) noexcept {
-    script_samples.recalc(script_shared_samples, now_tp);
+    script_samples.recalc(shared_stats.script_samples, now_tp);
+    admission_samples.recalc(shared_stats.admission_samples, now_tp);
     heap_percentiles.recalc(stats.heap_stats, first_id, last_id);
+    regexp_percentiles.recalc(stats.regexp_stats, first_id, last_id);
+    rpc_client_percentiles.recalc(stats.rpc_client_stats, first_id, last_id);
     malloc_percentiles.recalc(stats.malloc_stats, first_id, last_id);
     vm_percentiles.recalc(stats.vm_stats, first_id, last_id);
     idle_percentiles.recalc(stats.idle_stats, first_id, last_id);
+    connections_percentiles.recalc(stats.connections_stats, first_id, last_id);
+    startup_percentiles.recalc(stats.startup_stats, first_id, last_id);
   }
 
-  AggregatedSamplesBundle<ScriptSamples> script_samples;
+  AggregatedHistogramsBundle<ScriptSamples> script_samples;
+  AggregatedHistogramsBundle<AdmissionSamples> admission_samples;
   WorkerPercentilesBundle<MallocStat> malloc_percentiles;
   WorkerPercentilesBundle<HeapStat> heap_percentiles;
+  WorkerPercentilesBundle<RegexpStat> regexp_percentiles;
+  WorkerPercentilesBundle<RpcClientStat> rpc_client_percentiles;
   WorkerPercentilesBundle<VMStat> vm_percentiles;
   WorkerPercentilesBundle<IdleStat> idle_percentiles;
+  WorkerPercentilesBundle<ConnectionsStat> connections_percentiles;
+  WorkerPercentilesBundle<StartupStat> startup_percentiles;
 };
 
 struct JobWorkerAggregatedStats : WorkerAggregatedStats {
-  explicit JobWorkerAggregatedStats(std::mt19937 *gen) noexcept:
-    WorkerAggregatedStats(gen),
-    job_samples(gen),
-    job_common_memory_samples(gen) {
-  }
-
-  AggregatedSamplesBundle<JobSamples> job_samples;
-  AggregatedSamplesBundle<JobCommonMemorySamples> job_common_memory_samples;
+  AggregatedHistogramsBundle<JobSamples> job_samples;
+  AggregatedHistogramsBundle<JobCommonMemorySamples> job_common_memory_samples;
 };
 
 struct MasterProcessStats : private vk::not_copyable {
@@ -519,34 +643,25 @@ struct MasterProcessStats : private vk::not_copyable {
 } // namespace
 
 struct ServerStats::SharedStats {
-  explicit SharedStats(std::mt19937 *gen) noexcept:
-    general_workers(gen),
-    job_workers(gen) {
-  }
-
   WorkerSharedStats general_workers;
   JobWorkerSharedStats job_workers;
 
   WorkerProcessStats workers;
+  EndpointsSharedStats endpoints;
 };
 
 
 struct ServerStats::AggregatedStats {
-  explicit AggregatedStats(std::mt19937 *gen) noexcept:
-    general_workers(gen),
-    job_workers(gen) {
-  }
-
   WorkerAggregatedStats general_workers;
   JobWorkerAggregatedStats job_workers;
+  EndpointsAggregatedStats endpoints;
 
   MasterProcessStats master_process;
 };
 
 void ServerStats::init() noexcept {
-  gen_ = new std::mt19937{};
-  aggregated_stats_ = new AggregatedStats{gen_};
-  shared_stats_ = new(mmap_shared(sizeof(SharedStats))) SharedStats{gen_};
+  aggregated_stats_ = new AggregatedStats{};
+  shared_stats_ = new(mmap_shared(sizeof(SharedStats))) SharedStats{};
 }
 
 void ServerStats::after_fork(pid_t worker_pid, uint64_t active_connections, uint64_t max_connections,
@@ -554,9 +669,9 @@ void ServerStats::after_fork(pid_t worker_pid, uint64_t active_connections, uint
   assert(vk::any_of_equal(worker_type, WorkerType::general_worker, WorkerType::job_worker));
   worker_process_id_ = worker_process_id;
   worker_type_ = worker_type;
-  gen_->seed(worker_pid);
   shared_stats_->workers.reset_worker_stats(worker_pid, active_connections, max_connections, worker_process_id_);
   last_update_ = std::chrono::steady_clock::now();
+  worker_start_ = last_update_;
 }
 
 void ServerStats::add_request_stats(double script_time_sec, double net_time_sec, int64_t script_queries, int64_t long_script_queries, int64_t memory_used,
@@ -568,6 +683,12 @@ void ServerStats::add_request_stats(double script_time_sec, double net_time_sec,
 
   stats.add_request_stats(queries_stat, error, memory_used, real_memory_used, curl_total_allocated);
   shared_stats_->workers.add_worker_stats(queries_stat, worker_process_id_);
+
+  if (worker_start_ != std::chrono::steady_clock::time_point{}) {
+    const auto time_to_first_request = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - worker_start_);
+    shared_stats_->workers.startup_stats.set_stat(StartupStat::Key::time_to_first_request, worker_process_id_, time_to_first_request.count());
+    worker_start_ = {};
+  }
 }
 
 void ServerStats::add_job_stats(double job_wait_time_sec, int64_t request_memory_used, int64_t request_real_memory_used, int64_t response_memory_used,
@@ -580,6 +701,28 @@ void ServerStats::add_job_common_memory_stats(int64_t common_request_memory_used
   shared_stats_->job_workers.add_job_common_memory_stats(common_request_memory_used, common_request_real_memory_used);
 }
 
+void ServerStats::add_global_vars_reset_stats(int64_t reset_vars) noexcept {
+  auto &stats = worker_type_ == WorkerType::job_worker ? shared_stats_->job_workers : shared_stats_->general_workers;
+  stats.total_reset_global_vars.fetch_add(reset_vars, std::memory_order_relaxed);
+}
+
+void ServerStats::add_queue_delay_stats(RequestPriority priority, double queue_delay_sec) noexcept {
+  auto &stats = worker_type_ == WorkerType::job_worker ? shared_stats_->job_workers : shared_stats_->general_workers;
+  const auto queue_delay = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(queue_delay_sec));
+  EnumTable<AdmissionSamples> sample{};
+  sample[static_cast<size_t>(priority)] = queue_delay.count();
+  stats.admission_samples.add_sample(sample);
+}
+
+void ServerStats::add_shed_request_stats(RequestPriority priority) noexcept {
+  auto &stats = worker_type_ == WorkerType::job_worker ? shared_stats_->job_workers : shared_stats_->general_workers;
+  stats.shed_requests[static_cast<size_t>(priority)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ServerStats::add_request_accounting(vk::string_view endpoint, const RequestAccounting &accounting) noexcept {
+  shared_stats_->endpoints.get_endpoint(endpoint).add_request(accounting);
+}
+
 void ServerStats::update_this_worker_stats() noexcept {
   const auto now_tp = std::chrono::steady_clock::now();
   if (now_tp - last_update_ >= std::chrono::seconds{5}) {
@@ -588,6 +731,10 @@ void ServerStats::update_this_worker_stats() noexcept {
   }
 }
 
+void ServerStats::add_accepted_http_connection() noexcept {
+  shared_stats_->workers.connections_stats.inc_stat(ConnectionsStat::Key::accepted_http_connections, worker_process_id_);
+}
+
 void ServerStats::update_active_connections(uint64_t active_connections, uint64_t max_connections) noexcept {
   shared_stats_->workers.update_worker_special_connections(active_connections, max_connections, worker_process_id_);
 }
@@ -616,14 +763,16 @@ void ServerStats::aggregate_stats() noexcept {
   const uint16_t general_workers = workers_control.get_count(WorkerType::general_worker);
   const uint16_t job_workers = workers_control.get_count(WorkerType::job_worker);
 
-  aggregated_stats_->general_workers.recalc(shared_stats_->general_workers.script_samples, now_tp,
+  aggregated_stats_->general_workers.recalc(shared_stats_->general_workers, now_tp,
                                             shared_stats_->workers, 0, general_workers);
 
   aggregated_stats_->job_workers.job_samples.recalc(shared_stats_->job_workers.job_samples, now_tp);
   aggregated_stats_->job_workers.job_common_memory_samples.recalc(shared_stats_->job_workers.job_common_memory_samples, now_tp);
-  aggregated_stats_->job_workers.recalc(shared_stats_->job_workers.script_samples, now_tp,
+  aggregated_stats_->job_workers.recalc(shared_stats_->job_workers, now_tp,
                                         shared_stats_->workers, general_workers, job_workers + general_workers);
 
+  aggregated_stats_->endpoints.recalc(shared_stats_->endpoints, now_tp);
+
   aggregated_stats_->master_process.vm_stats = get_virtual_memory_stat();
   aggregated_stats_->master_process.malloc_stats = get_malloc_stat();
   aggregated_stats_->master_process.idle_stats = get_idle_stat();
@@ -642,8 +791,10 @@ uint64_t kb2bytes(uint64_t kb) noexcept {
 template<class T, class Mapper = vk::identity>
 void write_to(stats_t *stats, const char *prefix, const char *suffix, const Percentiles<T> &percentiles, const Mapper &mapper = {}) {
   add_gauge_stat(stats, mapper(percentiles.p50), prefix, suffix, ".p50");
+  add_gauge_stat(stats, mapper(percentiles.p90), prefix, suffix, ".p90");
   add_gauge_stat(stats, mapper(percentiles.p95), prefix, suffix, ".p95");
   add_gauge_stat(stats, mapper(percentiles.p99), prefix, suffix, ".p99");
+  add_gauge_stat(stats, mapper(percentiles.p999), prefix, suffix, ".p999");
   add_gauge_stat(stats, mapper(percentiles.max), prefix, suffix, ".max");
 }
 
@@ -664,18 +815,27 @@ void write_to(stats_t *stats, const char *prefix, const WorkerAggregatedStats &a
   add_gauge_stat(stats, shared.total_queries_stat[QueriesStat::Key::incoming_queries], prefix, ".requests.total_incoming_queries");
   add_gauge_stat(stats, shared.total_queries_stat[QueriesStat::Key::outgoing_queries], prefix, ".requests.total_outgoing_queries");
   add_gauge_stat(stats, shared.total_queries_stat[QueriesStat::Key::outgoing_long_queries], prefix, ".requests.total_outgoing_long_queries");
+  add_gauge_stat(stats, shared.total_reset_global_vars, prefix, ".requests.total_reset_global_vars");
 
   write_to(stats, prefix, ".requests.outgoing_queries", agg.script_samples[ScriptSamples::Key::outgoing_queries].percentiles);
   write_to(stats, prefix, ".requests.outgoing_long_queries", agg.script_samples[ScriptSamples::Key::outgoing_long_queries].percentiles);
   write_to(stats, prefix, ".requests.script_time", agg.script_samples[ScriptSamples::Key::script_time].percentiles, ns2double);
   write_to(stats, prefix, ".requests.net_time", agg.script_samples[ScriptSamples::Key::net_time].percentiles, ns2double);
   write_to(stats, prefix, ".requests.working_time", agg.script_samples[ScriptSamples::Key::working_time].percentiles, ns2double);
+  write_to(stats, prefix, ".requests.queue_delay.background", agg.admission_samples[AdmissionSamples::Key::background_queue_delay].percentiles, ns2double);
+  write_to(stats, prefix, ".requests.queue_delay.normal", agg.admission_samples[AdmissionSamples::Key::normal_queue_delay].percentiles, ns2double);
+  write_to(stats, prefix, ".requests.queue_delay.critical", agg.admission_samples[AdmissionSamples::Key::critical_queue_delay].percentiles, ns2double);
+  add_gauge_stat(stats, shared.shed_requests[static_cast<size_t>(RequestPriority::background)], prefix, ".requests.shed.background");
+  add_gauge_stat(stats, shared.shed_requests[static_cast<size_t>(RequestPriority::normal)], prefix, ".requests.shed.normal");
+  add_gauge_stat(stats, shared.shed_requests[static_cast<size_t>(RequestPriority::critical)], prefix, ".requests.shed.critical");
   write_to(stats, prefix, ".memory.script_usage", agg.script_samples[ScriptSamples::Key::memory_used].percentiles);
   write_to(stats, prefix, ".memory.script_real_usage", agg.script_samples[ScriptSamples::Key::real_memory_used].percentiles);
   write_to(stats, prefix, ".memory.script_total_allocated_by_curl", agg.script_samples[ScriptSamples::Key::total_allocated_by_curl].percentiles);
 
   write_to(stats, prefix, ".memory.currently_script_heap_usage_bytes", agg.heap_percentiles[HeapStat::Key::script_heap_memory_usage]);
   write_to(stats, prefix, ".memory.currently_allocated_by_curl_bytes", agg.heap_percentiles[HeapStat::Key::curl_memory_currently_usage]);
+  write_to(stats, prefix, ".memory.frozen_const_bytes", agg.heap_percentiles[HeapStat::Key::frozen_const_memory_usage]);
+  write_to(stats, prefix, ".memory.frozen_const_shared_bytes", agg.heap_percentiles[HeapStat::Key::frozen_const_shared_memory_usage]);
 
   write_to(stats, prefix, ".memory.malloc_non_mapped_allocated_bytes", agg.malloc_percentiles[MallocStat::Key::non_mmaped_allocated_bytes]);
   write_to(stats, prefix, ".memory.malloc_non_mapped_free_bytes", agg.malloc_percentiles[MallocStat::Key::non_mmaped_free_bytes]);
@@ -686,6 +846,31 @@ void write_to(stats_t *stats, const char *prefix, const WorkerAggregatedStats &a
   write_to(stats, prefix, ".memory.shm_bytes", agg.vm_percentiles[VMStat::Key::shm_kb], kb2bytes);
 
   write_to(stats, prefix, ".cpu.recent_idle", agg.idle_percentiles[IdleStat::Key::recent_idle_percent]);
+
+  // the spread between the workers shows how evenly the connections are balanced
+  write_to(stats, prefix, ".connections.accepted", agg.connections_percentiles[ConnectionsStat::Key::accepted_http_connections]);
+  add_gauge_stat(stats, agg.connections_percentiles[ConnectionsStat::Key::accepted_http_connections].sum, prefix, ".connections.accepted.total");
+
+  // from the fork to the end of the first request of the worker, the workers without requests are skipped
+  write_to(stats, prefix, ".startup.time_to_first_request", agg.startup_percentiles[StartupStat::Key::time_to_first_request], ns2double);
+
+  // the counters of the running workers
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::cache_hits].sum, prefix, ".regexp.cache_hits");
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::cache_misses].sum, prefix, ".regexp.cache_misses");
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::cache_evictions].sum, prefix, ".regexp.cache_evictions");
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::jit_compiled].sum, prefix, ".regexp.jit_compiled");
+  add_gauge_stat(stats, ns2double(agg.regexp_percentiles[RegexpStat::Key::compile_time].sum), prefix, ".regexp.compile_time.total");
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::prefilter_rejections].sum, prefix, ".regexp.prefilter_rejections");
+  add_gauge_stat(stats, agg.regexp_percentiles[RegexpStat::Key::literal_searches].sum, prefix, ".regexp.literal_searches");
+  write_to(stats, prefix, ".regexp.cache_size", agg.regexp_percentiles[RegexpStat::Key::cache_size]);
+
+  // every flush of the rpc client connection writes all the packets queued since the previous one
+  const auto rpc_client_flushes = agg.rpc_client_percentiles[RpcClientStat::Key::flushes].sum;
+  add_gauge_stat(stats, rpc_client_flushes, prefix, ".rpc_client.flushes");
+  add_gauge_stat(stats, safe_div(agg.rpc_client_percentiles[RpcClientStat::Key::flushed_packets].sum, rpc_client_flushes),
+                 prefix, ".rpc_client.packets_per_flush");
+  add_gauge_stat(stats, safe_div(agg.rpc_client_percentiles[RpcClientStat::Key::flushed_bytes].sum, rpc_client_flushes),
+                 prefix, ".rpc_client.bytes_per_flush");
 }
 
 void write_to(stats_t *stats, const char *prefix, const JobWorkerAggregatedStats &job_agg) noexcept {
@@ -708,6 +893,34 @@ void write_to(stats_t *stats, const char *prefix, const MasterProcessStats &mast
   add_gauge_stat(stats, kb2bytes(master_process.vm_stats[VMStat::Key::shm_kb]), prefix, ".memory.shm_bytes");
 }
 
+void write_to(stats_t *stats, const EndpointsAggregatedStats &agg, const EndpointsSharedStats &shared) noexcept {
+  for (size_t i = 0; i != shared.endpoints.size(); ++i) {
+    const auto &endpoint = shared.endpoints[i];
+    const bool is_other = i + 1 == shared.endpoints.size();
+    if (is_other ? !endpoint.requests.load(std::memory_order_relaxed) : !endpoint.name_ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    char prefix[sizeof("endpoints.") + REQUEST_ENDPOINT_MAX_LEN];
+    snprintf(prefix, sizeof(prefix), "endpoints.%s", is_other ? "other" : endpoint.name.data());
+
+    add_gauge_stat(stats, endpoint.requests, prefix, ".requests");
+    write_to(stats, prefix, ".working_time", agg.endpoints[i].working_time.percentiles, ns2double);
+    write_to(stats, prefix, ".cpu_time", agg.endpoints[i].cpu_time.percentiles, ns2double);
+    write_to(stats, prefix, ".allocated_bytes", agg.endpoints[i].allocated_bytes.percentiles);
+    add_gauge_stat(stats, endpoint.allocations, prefix, ".allocations");
+    add_gauge_stat(stats, endpoint.voluntary_context_switches, prefix, ".context_switches.voluntary");
+    add_gauge_stat(stats, endpoint.involuntary_context_switches, prefix, ".context_switches.involuntary");
+    add_gauge_stat(stats, endpoint.rpc_queries, prefix, ".queries.rpc");
+    add_gauge_stat(stats, endpoint.mc_queries, prefix, ".queries.memcache");
+    add_gauge_stat(stats, endpoint.sql_queries, prefix, ".queries.sql");
+    for (size_t r = 0; r != endpoint.blocked_time.size(); ++r) {
+      if (const uint64_t blocked_time = endpoint.blocked_time[r].load(std::memory_order_relaxed)) {
+        add_gauge_stat(stats, ns2double(blocked_time), prefix, ".blocked_time.", blocking_resource_name(static_cast<BlockingResource>(r)));
+      }
+    }
+  }
+}
+
 template<class S>
 auto get_max(const WorkerPercentilesBundle<S> &general_stats, const WorkerPercentilesBundle<S> &job_stats,
              const EnumTable<S> &master_stats, typename S::Key key) noexcept {
@@ -730,6 +943,12 @@ void write_server_vm_to(stats_t *stats, const char *prefix, const EnumTable<VMSt
   add_gauge_stat(stats, kb2bytes(rss_no_shm), prefix, ".memory.rss_no_shm_total_bytes");
 }
 
+// every worker would have its own copy of the frozen constants, if they weren't shared;
+// the copy they share is the master's one, which is resident anyway, so it isn't subtracted
+uint64_t get_frozen_const_saved_bytes(const WorkerPercentilesBundle<HeapStat> &general_heap, const WorkerPercentilesBundle<HeapStat> &job_heap) noexcept {
+  return general_heap[HeapStat::Key::frozen_const_shared_memory_usage].sum + job_heap[HeapStat::Key::frozen_const_shared_memory_usage].sum;
+}
+
 } // namespace
 
 void ServerStats::write_stats_to(stats_t *stats) const noexcept {
@@ -740,8 +959,12 @@ void ServerStats::write_stats_to(stats_t *stats) const noexcept {
 
   write_to(stats, "master", aggregated_stats_->master_process);
 
+  write_to(stats, aggregated_stats_->endpoints, shared_stats_->endpoints);
+
   write_server_vm_to(stats, "server", aggregated_stats_->master_process.vm_stats,
                      aggregated_stats_->general_workers.vm_percentiles, aggregated_stats_->job_workers.vm_percentiles);
+  add_gauge_stat(stats, get_frozen_const_saved_bytes(aggregated_stats_->general_workers.heap_percentiles, aggregated_stats_->job_workers.heap_percentiles),
+                 "server", ".memory.frozen_const_saved_bytes");
 }
 
 void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const noexcept {
@@ -765,6 +988,8 @@ void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const n
      << "VM_max\t" << get_max(general_vm, job_vm, master_vm, VMStat::Key::vm_peak_kb) << "Kb\n"
      << "RSS\t" << get_sum(general_vm, job_vm, master_vm, VMStat::Key::rss_kb) << "Kb\n"
      << "RSS_max\t" << get_sum(general_vm, job_vm, master_vm, VMStat::Key::rss_peak_kb) << "Kb\n"
+     << "frozen_const_saved\t" << get_frozen_const_saved_bytes(aggregated_stats_->general_workers.heap_percentiles,
+                                                              aggregated_stats_->job_workers.heap_percentiles) << "\n"
      << "tot_queries\t" << total_queries[QueriesStat::Key::incoming_queries].load(std::memory_order_relaxed) << "\n"
      << "tot_script_queries\t" << total_queries[QueriesStat::Key::outgoing_queries].load(std::memory_order_relaxed) << "\n"
      << "worked_time\t" << total_script_time + total_net_time << "\n"
@@ -778,6 +1003,7 @@ void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const n
   const auto &workers_query = shared_stats_->workers.query_stats;
   const auto &workers_misc = shared_stats_->workers.misc_stats;
   const auto &workers_idle = shared_stats_->workers.idle_stats;
+  const auto &workers_connections = shared_stats_->workers.connections_stats;
   for (uint16_t w = 0; w != workers_count; ++w) {
     const auto net_time = ns2double(workers_query.get_stat(QueriesStat::Key::net_time, w));
     const auto script_time = ns2double(workers_query.get_stat(QueriesStat::Key::script_time, w));
@@ -796,6 +1022,7 @@ void ServerStats::write_stats_to(std::ostream &os, bool add_worker_pids) const n
        << "worked_time " << worker_pid << "\t" << net_time + script_time << "\n"
        << "script_time " << worker_pid << "\t" << script_time << "\n"
        << "net_time " << worker_pid << "\t" << net_time << "\n"
+       << "accepted_http_connections " << worker_pid << "\t" << workers_connections.get_stat(ConnectionsStat::Key::accepted_http_connections, w) << "\n"
        << "tot_idle_time " << worker_pid << "\t" << workers_idle.get_stat(IdleStat::Key::tot_idle_time, w) << "\n"
        << "tot_idle_percent " << worker_pid << "\t" << workers_idle.get_stat(IdleStat::Key::tot_idle_percent, w) << "\n"
        << "recent_idle_percent " << worker_pid << "\t" << workers_idle.get_stat(IdleStat::Key::recent_idle_percent, w) << "\n";
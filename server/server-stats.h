@@ -6,13 +6,14 @@
 
 #include <chrono>
 #include <memory>
-#include <random>
 
 #include "common/mixin/not_copyable.h"
 #include "common/smart_ptrs/singleton.h"
 #include "common/stats/provider.h"
 
 #include "server/php-runner.h"
+#include "server/request-accounting.h"
+#include "server/request-priority.h"
 #include "server/workers-control.h"
 
 class ServerStats : vk::not_copyable {
@@ -24,7 +25,12 @@ public:
   void add_job_stats(double job_wait_time_sec, int64_t request_memory_used, int64_t request_real_memory_used, int64_t response_memory_used,
                      int64_t response_real_memory_used) noexcept;
   void add_job_common_memory_stats(int64_t common_request_memory_used, int64_t common_request_real_memory_used) noexcept;
+  void add_global_vars_reset_stats(int64_t reset_vars) noexcept;
+  void add_queue_delay_stats(RequestPriority priority, double queue_delay_sec) noexcept;
+  void add_shed_request_stats(RequestPriority priority) noexcept;
+  void add_request_accounting(vk::string_view endpoint, const RequestAccounting &accounting) noexcept;
   void update_this_worker_stats() noexcept;
+  void add_accepted_http_connection() noexcept;
   void update_active_connections(uint64_t active_connections, uint64_t max_connections) noexcept;
 
   void set_idle_worker_status() noexcept;
@@ -57,8 +63,8 @@ private:
   WorkerType worker_type_{WorkerType::general_worker};
   uint16_t worker_process_id_{0};
   std::chrono::steady_clock::time_point last_update_;
-
-  std::mt19937 *gen_{nullptr};
+  // is reset when the worker has served its first request
+  std::chrono::steady_clock::time_point worker_start_;
 
   struct AggregatedStats;
   AggregatedStats *aggregated_stats_{nullptr};
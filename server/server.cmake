@@ -2,6 +2,7 @@ prepend(KPHP_SERVER_SOURCES ${BASE_DIR}/server/
         cluster-name.cpp
         confdata-binlog-replay.cpp
         confdata-stats.cpp
+        http-reuseport-listeners.cpp
         json-logger.cpp
         lease-config-parser.cpp
         lease-rpc-client.cpp
@@ -18,9 +19,13 @@ prepend(KPHP_SERVER_SOURCES ${BASE_DIR}/server/
         php-script.cpp
         php-sql-connections.cpp
         php-worker.cpp
+        request-accounting.cpp
+        sampling-profiler.cpp
         server-log.cpp
         server-stats.cpp
         slot-ids-factory.cpp
+        workers-affinity.cpp
+        workers-autoscaler.cpp
         workers-control.cpp)
 
 prepend(KPHP_JOB_WORKERS_SOURCES ${BASE_DIR}/server/job-workers/
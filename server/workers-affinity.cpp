@@ -0,0 +1,184 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <sched.h>
+
+#include "common/kprintf.h"
+
+#include "server/workers-affinity.h"
+
+namespace {
+
+// the same as CPU_SETSIZE
+constexpr long MAX_CPUS = 1024;
+
+std::vector<int> get_allowed_cpus() noexcept {
+  std::vector<int> cpus;
+#if !defined(__APPLE__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+std::vector<std::vector<int>> get_numa_nodes(const std::vector<int> &allowed_cpus) noexcept {
+  std::vector<std::vector<int>> nodes;
+  const char *nodes_dir = "/sys/devices/system/node";
+  DIR *dir = opendir(nodes_dir);
+  if (!dir) {
+    return nodes;
+  }
+  std::vector<int> node_ids;
+  while (const dirent *entry = readdir(dir)) {
+    int node_id = 0;
+    if (std::sscanf(entry->d_name, "node%d", &node_id) == 1) {
+      node_ids.push_back(node_id);
+    }
+  }
+  closedir(dir);
+  std::sort(node_ids.begin(), node_ids.end());
+
+  for (int node_id : node_ids) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "%s/node%d/cpulist", nodes_dir, node_id);
+    FILE *f = std::fopen(path, "r");
+    if (!f) {
+      continue;
+    }
+    char cpu_list[4096];
+    const bool read = std::fgets(cpu_list, sizeof(cpu_list), f) != nullptr;
+    std::fclose(f);
+    if (!read) {
+      continue;
+    }
+    std::vector<int> node_cpus;
+    for (int cpu : WorkersAffinity::parse_cpu_list(cpu_list)) {
+      if (std::binary_search(allowed_cpus.begin(), allowed_cpus.end(), cpu)) {
+        node_cpus.push_back(cpu);
+      }
+    }
+    if (!node_cpus.empty()) {
+      nodes.emplace_back(std::move(node_cpus));
+    }
+  }
+  return nodes;
+}
+
+} // namespace
+
+const char *WorkersAffinity::set_mode(const char *mode) noexcept {
+  if (!std::strcmp(mode, "cpu")) {
+    mode_ = Mode::cpu;
+  } else if (!std::strcmp(mode, "numa")) {
+    mode_ = Mode::numa_node;
+  } else {
+    return "unknown mode, 'cpu' or 'numa' are expected";
+  }
+#if defined(__APPLE__)
+  mode_ = Mode::none;
+  return "not supported on this platform";
+#else
+  return nullptr;
+#endif
+}
+
+void WorkersAffinity::init() noexcept {
+  if (mode_ == Mode::none) {
+    return;
+  }
+  auto cpus = get_allowed_cpus();
+  auto numa_nodes = mode_ == Mode::numa_node ? get_numa_nodes(cpus) : std::vector<std::vector<int>>{};
+  init(std::move(cpus), std::move(numa_nodes));
+}
+
+void WorkersAffinity::init(std::vector<int> allowed_cpus, std::vector<std::vector<int>> numa_nodes) noexcept {
+  cpus_ = std::move(allowed_cpus);
+  numa_nodes_ = std::move(numa_nodes);
+  if (mode_ == Mode::numa_node && numa_nodes_.empty() && !cpus_.empty()) {
+    // no numa information, the whole machine is a single node
+    numa_nodes_.push_back(cpus_);
+  }
+  if (cpus_.empty()) {
+    kprintf("can't get the allowed cpus, the workers won't be pinned\n");
+    mode_ = Mode::none;
+  }
+}
+
+std::vector<int> WorkersAffinity::get_worker_cpus(uint16_t worker_unique_id) const noexcept {
+  switch (mode_) {
+    case Mode::cpu:
+      return {cpus_[worker_unique_id % cpus_.size()]};
+    case Mode::numa_node:
+      return numa_nodes_[worker_unique_id % numa_nodes_.size()];
+    default:
+      return {};
+  }
+}
+
+int WorkersAffinity::get_worker_cpu(uint16_t worker_unique_id) const noexcept {
+  return mode_ == Mode::cpu ? cpus_[worker_unique_id % cpus_.size()] : -1;
+}
+
+bool WorkersAffinity::pin_this_worker(uint16_t worker_unique_id) const noexcept {
+  const auto cpus = get_worker_cpus(worker_unique_id);
+  if (cpus.empty()) {
+    return false;
+  }
+#if !defined(__APPLE__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    kprintf("can't pin worker %d to cpu %d: %m\n", int{worker_unique_id}, cpus.front());
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::vector<int> WorkersAffinity::parse_cpu_list(const char *cpu_list) noexcept {
+  std::vector<int> cpus;
+  const char *s = cpu_list;
+  while (*s) {
+    char *end = nullptr;
+    const long first = std::strtol(s, &end, 10);
+    if (end == s || first < 0) {
+      break;
+    }
+    long last = first;
+    s = end;
+    if (*s == '-') {
+      ++s;
+      last = std::strtol(s, &end, 10);
+      if (end == s || last < first) {
+        break;
+      }
+      s = end;
+    }
+    for (long cpu = first; cpu <= last && cpu < MAX_CPUS; ++cpu) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+    if (*s != ',') {
+      break;
+    }
+    ++s;
+  }
+  return cpus;
+}
@@ -0,0 +1,51 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+// Pins the general workers to the cpus (or the numa nodes) allowed for the master, round robin by the worker unique id,
+// so a worker keeps its caches warm and, together with the reuseport listeners, handles the connections accepted on its cpu.
+class WorkersAffinity : vk::not_copyable {
+public:
+  enum class Mode {
+    none,
+    cpu,
+    numa_node
+  };
+
+  // "cpu" or "numa", returns an error description or nullptr
+  const char *set_mode(const char *mode) noexcept;
+  Mode get_mode() const noexcept { return mode_; }
+
+  // should be called by the master before the workers are forked
+  void init() noexcept;
+  void init(std::vector<int> allowed_cpus, std::vector<std::vector<int>> numa_nodes) noexcept;
+
+  // should be called by the general worker just after fork
+  bool pin_this_worker(uint16_t worker_unique_id) const noexcept;
+
+  // the set of the cpus for the worker, empty if the workers are not pinned
+  std::vector<int> get_worker_cpus(uint16_t worker_unique_id) const noexcept;
+
+  // the single cpu of the worker or -1
+  int get_worker_cpu(uint16_t worker_unique_id) const noexcept;
+
+  // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}, the format of /sys/devices/system/node/node*/cpulist
+  static std::vector<int> parse_cpu_list(const char *cpu_list) noexcept;
+
+private:
+  WorkersAffinity() = default;
+
+  friend class vk::singleton<WorkersAffinity>;
+
+  Mode mode_{Mode::none};
+  std::vector<int> cpus_;
+  std::vector<std::vector<int>> numa_nodes_;
+};
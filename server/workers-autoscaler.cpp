@@ -0,0 +1,118 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "common/kprintf.h"
+
+#include "server/workers-autoscaler.h"
+
+namespace {
+
+// the workers are considered busy when nearly all of them are running a script
+constexpr double OVERLOADED_RUNNING_RATIO = 0.9;
+constexpr double UNDERLOADED_RUNNING_RATIO = 0.5;
+// the new workers would just compete for the cpu
+constexpr double SATURATED_HOST_CPU_USAGE = 0.9;
+
+// growing reacts fast to the spikes, shrinking waits for the stable low traffic
+constexpr uint32_t GROW_AFTER_TICKS = 3;
+constexpr uint32_t SHRINK_AFTER_TICKS = 30;
+// the load needs some time to spread over the new set of the workers
+constexpr uint32_t COOLDOWN_TICKS = 5;
+
+} // namespace
+
+const char *WorkersAutoscaler::set_min_ratio(double min_ratio) noexcept {
+  if (!(min_ratio > 0 && min_ratio <= 1)) {
+    return "the ratio should be in (0, 1]";
+  }
+  min_ratio_ = min_ratio;
+  return nullptr;
+}
+
+uint16_t WorkersAutoscaler::update(WorkerType worker_type, uint16_t target, uint16_t max_count, const Load &load) noexcept {
+  auto &state = states_[static_cast<size_t>(worker_type)];
+  state.stats.last_decision = Decision::keep;
+  if (!is_enabled(worker_type) || !max_count) {
+    return target;
+  }
+
+  const auto min_count = static_cast<uint16_t>(std::clamp(std::ceil(min_ratio_ * max_count), 1.0, static_cast<double>(max_count)));
+  target = std::clamp(target, min_count, max_count);
+  if (state.cooldown_ticks) {
+    --state.cooldown_ticks;
+    return target;
+  }
+
+  const bool cpu_saturated = load.host_cpu_usage >= SATURATED_HOST_CPU_USAGE;
+  const bool overloaded = (load.accept_queue > 0 || load.running_ratio >= OVERLOADED_RUNNING_RATIO) && !cpu_saturated;
+  const bool underloaded = load.accept_queue == 0 && load.running_ratio <= UNDERLOADED_RUNNING_RATIO;
+  state.overloaded_ticks = overloaded ? state.overloaded_ticks + 1 : 0;
+  state.underloaded_ticks = underloaded ? state.underloaded_ticks + 1 : 0;
+
+  uint16_t new_target = target;
+  if (state.overloaded_ticks >= GROW_AFTER_TICKS && target < max_count) {
+    new_target = static_cast<uint16_t>(std::min(target + std::max(target / 4, 1), int{max_count}));
+    state.stats.last_decision = Decision::grow;
+    ++state.stats.grows;
+  } else if (state.underloaded_ticks >= SHRINK_AFTER_TICKS && target > min_count) {
+    new_target = static_cast<uint16_t>(std::max(target - std::max(target / 10, 1), int{min_count}));
+    state.stats.last_decision = Decision::shrink;
+    ++state.stats.shrinks;
+  } else {
+    return target;
+  }
+
+  vkprintf(1, "autoscaler: %s %s workers %d -> %d [running ratio = %.2f] [accept queue = %u] [host cpu = %.2f]\n",
+           state.stats.last_decision == Decision::grow ? "grow" : "shrink",
+           worker_type == WorkerType::general_worker ? "general" : "job",
+           int{target}, int{new_target}, load.running_ratio, load.accept_queue, load.host_cpu_usage);
+  state.overloaded_ticks = 0;
+  state.underloaded_ticks = 0;
+  state.cooldown_ticks = COOLDOWN_TICKS;
+  return new_target;
+}
+
+double WorkersAutoscaler::read_host_cpu_usage() noexcept {
+  FILE *f = std::fopen("/proc/stat", "r");
+  if (!f) {
+    return -1;
+  }
+  unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+  const int read = std::fscanf(f, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
+  std::fclose(f);
+  if (read < 4) {
+    return -1;
+  }
+
+  const uint64_t busy = user + nice + system + irq + softirq + steal;
+  const uint64_t total = busy + idle + iowait;
+  const bool has_prev = prev_cpu_total_ != 0;
+  const uint64_t busy_delta = busy - prev_cpu_busy_;
+  const uint64_t total_delta = total - prev_cpu_total_;
+  prev_cpu_busy_ = busy;
+  prev_cpu_total_ = total;
+  if (!has_prev || !total_delta) {
+    return -1;
+  }
+  return static_cast<double>(busy_delta) / static_cast<double>(total_delta);
+}
+
+uint32_t WorkersAutoscaler::get_accept_queue_size(int listening_fd) noexcept {
+#if defined(__linux__)
+  // for the listening sockets tcpi_unacked is the current length of the accept queue
+  tcp_info info{};
+  socklen_t len = sizeof(info);
+  if (listening_fd >= 0 && getsockopt(listening_fd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+    return info.tcpi_unacked;
+  }
+#endif
+  return 0 && listening_fd;
+}
@@ -0,0 +1,84 @@
+// Compiler for PHP (aka KPHP)
+// Copyright (c) 2021 LLC «V Kontakte»
+// Distributed under the GPL v3 License, see LICENSE.notice.txt
+
+#pragma once
+
+#include <array>
+#include <cinttypes>
+
+#include "common/mixin/not_copyable.h"
+#include "common/smart_ptrs/singleton.h"
+
+#include "server/workers-control.h"
+
+// Grows and shrinks the number of the running workers of each type between the lower bound and the configured count,
+// so the idle workers don't hold memory when the traffic is low, and the spikes don't wait in the accept queue.
+// The master makes the decisions once a second with a hysteresis: growing needs a few overloaded seconds in a row,
+// shrinking needs much more underloaded ones, and nothing is changed for a while after every decision.
+class WorkersAutoscaler : vk::not_copyable {
+public:
+  struct Load {
+    // the running workers / the alive workers of the type
+    double running_ratio{0};
+    // the connections waiting in the accept queue of the http socket
+    uint32_t accept_queue{0};
+    // the busy share of the host cpu time in [0, 1], more workers don't help if the cpu is saturated
+    double host_cpu_usage{0};
+  };
+
+  enum class Decision {
+    keep,
+    grow,
+    shrink
+  };
+
+  struct Stats {
+    uint64_t grows{0};
+    uint64_t shrinks{0};
+    Decision last_decision{Decision::keep};
+  };
+
+  // the share of the configured workers of each type kept running at least, in (0, 1]; returns an error description or nullptr
+  const char *set_min_ratio(double min_ratio) noexcept;
+
+  bool is_enabled(WorkerType worker_type) const noexcept {
+    return min_ratio_ > 0 && !disabled_[static_cast<size_t>(worker_type)];
+  }
+
+  void disable(WorkerType worker_type) noexcept {
+    disabled_[static_cast<size_t>(worker_type)] = true;
+  }
+
+  // should be called by the master once a second, returns the new target count of the workers in [min, max_count]
+  uint16_t update(WorkerType worker_type, uint16_t target, uint16_t max_count, const Load &load) noexcept;
+
+  const Stats &get_stats(WorkerType worker_type) const noexcept {
+    return states_[static_cast<size_t>(worker_type)].stats;
+  }
+
+  // the busy share of the host cpu time since the previous call, from /proc/stat; -1 on the first call or on error
+  double read_host_cpu_usage() noexcept;
+
+  // the length of the accept queue of the listening tcp socket
+  static uint32_t get_accept_queue_size(int listening_fd) noexcept;
+
+private:
+  WorkersAutoscaler() = default;
+
+  friend class vk::singleton<WorkersAutoscaler>;
+
+  struct State {
+    uint32_t overloaded_ticks{0};
+    uint32_t underloaded_ticks{0};
+    uint32_t cooldown_ticks{0};
+    Stats stats;
+  };
+
+  double min_ratio_{0};
+  std::array<bool, static_cast<size_t>(WorkerType::types_count)> disabled_{};
+  std::array<State, static_cast<size_t>(WorkerType::types_count)> states_{};
+
+  uint64_t prev_cpu_busy_{0};
+  uint64_t prev_cpu_total_{0};
+};
@@ -2,6 +2,7 @@
 // Copyright (c) 2021 LLC «V Kontakte»
 // Distributed under the GPL v3 License, see LICENSE.notice.txt
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -28,6 +29,8 @@ bool WorkersControl::init() noexcept {
 
   auto &general_workers = meta_[static_cast<size_t>(WorkerType::general_worker)];
   general_workers.count = total_workers_count_ - job_workers.count;
+  general_workers.target = general_workers.count;
+  job_workers.target = job_workers.count;
 
   general_workers.unique_ids_.fill(EMPTY_ID);
   std::iota(general_workers.unique_ids_.begin(), general_workers.unique_ids_.begin() + general_workers.count, uint16_t{0});
@@ -37,6 +40,11 @@ bool WorkersControl::init() noexcept {
   return true;
 }
 
+void WorkersControl::set_target_count(WorkerType worker_type, uint16_t target) noexcept {
+  auto &meta = meta_[static_cast<size_t>(worker_type)];
+  meta.target = std::clamp(target, std::min(uint16_t{1}, meta.count), meta.count);
+}
+
 void WorkersControl::on_worker_terminating(WorkerType worker_type) noexcept {
   auto &meta = meta_[static_cast<size_t>(worker_type)];
   assert(meta.running);
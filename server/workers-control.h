@@ -34,6 +34,13 @@ public:
     return meta_[static_cast<size_t>(worker_type)].count;
   }
 
+  // the number of the workers the master keeps running, it is changed by the autoscaler within [1, get_count()]
+  uint16_t get_target_count(WorkerType worker_type) const noexcept {
+    return meta_[static_cast<size_t>(worker_type)].target;
+  }
+
+  void set_target_count(WorkerType worker_type, uint16_t target) noexcept;
+
   uint16_t get_running_count(WorkerType worker_type) const noexcept {
     return meta_[static_cast<size_t>(worker_type)].running;
   }
@@ -72,6 +79,7 @@ private:
     double ratio{0};
 
     uint16_t count{0};
+    uint16_t target{0};
     uint16_t running{0};
 
     uint16_t dying{0};
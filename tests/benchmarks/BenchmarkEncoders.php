@@ -0,0 +1,46 @@
+<?php
+
+class BenchmarkEncoders {
+  /** @var string */
+  private $token = "";
+  /** @var string */
+  private $binary = "";
+  /** @var string */
+  private $text = "";
+  /** @var string */
+  private $query = "";
+
+  /** @var string */
+  private $token_base64 = "";
+  /** @var string */
+  private $binary_hex = "";
+
+  public function __construct() {
+    mt_srand(42);
+    for ($i = 0; $i < 48; ++$i) {
+      $this->token .= chr(mt_rand(0, 255));
+    }
+    for ($i = 0; $i < 4096; ++$i) {
+      $this->binary .= chr(mt_rand(0, 255));
+    }
+    while (strlen($this->text) < 4096) {
+      $this->text .= "Hello, this is a <b>rendered</b> comment with \"quotes\" & a lot of plain text around it. ";
+    }
+    for ($i = 0; $i < 20; ++$i) {
+      $this->query .= "param$i=value_$i/with spaces&";
+    }
+
+    $this->token_base64 = base64_encode($this->token);
+    $this->binary_hex = bin2hex($this->binary);
+  }
+
+  public function benchmarkBase64EncodeToken() { return base64_encode($this->token); }
+  public function benchmarkBase64DecodeToken() { return base64_decode($this->token_base64); }
+  public function benchmarkBase64Encode4k() { return base64_encode($this->binary); }
+  public function benchmarkBin2hex4k() { return bin2hex($this->binary); }
+  public function benchmarkHex2bin4k() { return hex2bin($this->binary_hex); }
+  public function benchmarkUrlencodeQuery() { return urlencode($this->query); }
+  public function benchmarkRawurlencodeQuery() { return rawurlencode($this->query); }
+  public function benchmarkHtmlspecialchars4k() { return htmlspecialchars($this->text); }
+  public function benchmarkHtmlspecialcharsQuotes4k() { return htmlspecialchars($this->text, ENT_QUOTES); }
+}
@@ -0,0 +1,68 @@
+<?php
+
+function make_json_user(int $id) {
+  return [
+    "id" => $id,
+    "name" => "user$id",
+    "active" => $id % 2 == 0,
+    "rating" => $id / 7,
+    "tags" => ["php", "json", "tag$id"],
+  ];
+}
+
+function make_json_text(int $len) {
+  $words = ["lorem", "ipsum", "\"quoted\"", "path/to/file", "new\nline", "tab\tbed", "юникод", "日本語"];
+  $text = "";
+  while (strlen($text) < $len) {
+    $text .= $words[mt_rand(0, count($words) - 1)] . str_repeat(" plain ascii text", mt_rand(0, 8));
+  }
+  return $text;
+}
+
+class BenchmarkJson {
+  /** @var mixed */
+  private $small_object = [];
+  /** @var mixed */
+  private $big_array = [];
+  /** @var mixed */
+  private $strings = [];
+
+  /** @var string */
+  private $small_object_json = "";
+  /** @var string */
+  private $big_array_json = "";
+  /** @var string */
+  private $big_objects_array_json = "";
+  /** @var string */
+  private $strings_json = "";
+
+  public function __construct() {
+    mt_srand(42);
+    $this->small_object = make_json_user(1);
+    for ($i = 0; $i < 100000; ++$i) {
+      $this->big_array[] = mt_rand();
+    }
+    $objects = [];
+    for ($i = 0; $i < 10000; ++$i) {
+      $objects[] = make_json_user($i);
+    }
+    for ($i = 0; $i < 1000; ++$i) {
+      $this->strings["key$i"] = make_json_text(mt_rand(16, 4096));
+    }
+
+    $this->small_object_json = (string)json_encode($this->small_object);
+    $this->big_array_json = (string)json_encode($this->big_array);
+    $this->big_objects_array_json = (string)json_encode($objects);
+    $this->strings_json = (string)json_encode($this->strings, JSON_UNESCAPED_UNICODE);
+  }
+
+  public function benchmarkDecodeSmallObject() { return json_decode($this->small_object_json, true); }
+  public function benchmarkDecodeBigArray() { return json_decode($this->big_array_json, true); }
+  public function benchmarkDecodeBigObjectsArray() { return json_decode($this->big_objects_array_json, true); }
+  public function benchmarkDecodeStrings() { return json_decode($this->strings_json, true); }
+
+  public function benchmarkEncodeSmallObject() { return json_encode($this->small_object); }
+  public function benchmarkEncodeBigArray() { return json_encode($this->big_array); }
+  public function benchmarkEncodeStrings() { return json_encode($this->strings); }
+  public function benchmarkEncodeStringsUnescapedUnicode() { return json_encode($this->strings, JSON_UNESCAPED_UNICODE); }
+}
@@ -0,0 +1,33 @@
+<?php
+
+class BenchmarkMbstring {
+  /** @var string */
+  private $ascii = "";
+  /** @var string */
+  private $cyrillic = "";
+  /** @var string */
+  private $mixed = "";
+
+  public function __construct() {
+    while (strlen($this->ascii) < 4096) {
+      $this->ascii .= "Hello, this is a plain ASCII comment with some Numbers 12345 and Words. ";
+    }
+    while (strlen($this->cyrillic) < 4096) {
+      $this->cyrillic .= "Привет, это комментарий на русском языке с Заглавными буквами. ";
+    }
+    while (strlen($this->mixed) < 4096) {
+      $this->mixed .= "Hello, мир! The quick brown fox прыгает over the lazy dog €100. ";
+    }
+  }
+
+  public function benchmarkCheckEncodingAscii() { return mb_check_encoding($this->ascii, "UTF-8"); }
+  public function benchmarkCheckEncodingCyrillic() { return mb_check_encoding($this->cyrillic, "UTF-8"); }
+  public function benchmarkStrlenAscii() { return mb_strlen($this->ascii, "UTF-8"); }
+  public function benchmarkStrlenCyrillic() { return mb_strlen($this->cyrillic, "UTF-8"); }
+  public function benchmarkSubstrMixed() { return mb_substr($this->mixed, 1000, 100, "UTF-8"); }
+  public function benchmarkStrtolowerAscii() { return mb_strtolower($this->ascii, "UTF-8"); }
+  public function benchmarkStrtolowerMixed() { return mb_strtolower($this->mixed, "UTF-8"); }
+  public function benchmarkStrtoupperCyrillic() { return mb_strtoupper($this->cyrillic, "UTF-8"); }
+  public function benchmarkPregMatchUtf8() { return preg_match('/lazy dog €(\d+)/u', $this->mixed); }
+  public function benchmarkJsonEncodeUnescapedUnicode() { return json_encode($this->mixed, JSON_UNESCAPED_UNICODE); }
+}
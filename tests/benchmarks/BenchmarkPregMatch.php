@@ -0,0 +1,35 @@
+<?php
+
+function make_log_text(int $len) {
+  $text = "";
+  while (strlen($text) < $len) {
+    $text .= "user_id=" . mt_rand(1, 1000000) . " action=" . (mt_rand(0, 1) ? "view" : "click") . " status=ok\n";
+  }
+  return substr($text, 0, $len);
+}
+
+class BenchmarkPregMatch {
+  /** @var string */
+  private $text = "";
+  /** @var string */
+  private $text_with_error = "";
+
+  public function __construct() {
+    mt_srand(42);
+    $this->text = make_log_text(64 * 1024);
+    $this->text_with_error = $this->text . "status=error code=500\n";
+  }
+
+  // the literal regexp is found without the regexp engines
+  public function benchmarkLiteralMiss() { return preg_match('/status=error/', $this->text); }
+  public function benchmarkLiteralHit() { return preg_match('/status=error/', $this->text_with_error); }
+  public function benchmarkLiteralMatchAll() { return preg_match_all('/action=click/', $this->text); }
+
+  // the engines run only from the occurrences of the literal prefix
+  public function benchmarkPrefixMiss() { return preg_match('/status=error code=(\d+)/', $this->text); }
+  public function benchmarkPrefixHit() { return preg_match('/status=error code=(\d+)/', $this->text_with_error, $matches); }
+  public function benchmarkPrefixReplace() { return preg_replace('/user_id=(\d+)/', 'user_id=*', $this->text); }
+
+  // no literal prefix
+  public function benchmarkNoPrefixMiss() { return preg_match('/[a-z]+=error/', $this->text); }
+}
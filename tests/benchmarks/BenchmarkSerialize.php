@@ -0,0 +1,52 @@
+<?php
+
+function make_cached_user(int $id) {
+  return [
+    "id" => $id * 1000003,
+    "first_name" => "first$id",
+    "last_name" => "last$id",
+    "updated" => 1369778313 + $id,
+    "sex" => $id % 3,
+    "rating" => $id / 7,
+    "friends" => [$id + 1, $id + 2, $id + 3],
+  ];
+}
+
+class BenchmarkSerialize {
+  /** @var mixed */
+  private $user = [];
+  /** @var mixed */
+  private $ints = [];
+  /** @var mixed */
+  private $users = [];
+
+  /** @var string */
+  private $user_serialized = "";
+  /** @var string */
+  private $ints_serialized = "";
+  /** @var string */
+  private $users_serialized = "";
+
+  public function __construct() {
+    mt_srand(42);
+    $this->user = make_cached_user(1);
+    for ($i = 0; $i < 100000; ++$i) {
+      $this->ints[] = mt_rand() * 1000 - 1000000000000;
+    }
+    for ($i = 0; $i < 10000; ++$i) {
+      $this->users[] = make_cached_user($i);
+    }
+
+    $this->user_serialized = serialize($this->user);
+    $this->ints_serialized = serialize($this->ints);
+    $this->users_serialized = serialize($this->users);
+  }
+
+  public function benchmarkUnserializeUser() { return unserialize($this->user_serialized); }
+  public function benchmarkUnserializeInts() { return unserialize($this->ints_serialized); }
+  public function benchmarkUnserializeUsers() { return unserialize($this->users_serialized); }
+
+  public function benchmarkSerializeUser() { return serialize($this->user); }
+  public function benchmarkSerializeInts() { return serialize($this->ints); }
+  public function benchmarkSerializeUsers() { return serialize($this->users); }
+}
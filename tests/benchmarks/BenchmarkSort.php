@@ -0,0 +1,71 @@
+<?php
+
+/**
+ * @param int $size
+ * @return int[]
+ */
+function make_random_ints(int $size) {
+  $ints = [];
+  for ($i = 0; $i < $size; ++$i) {
+    $ints[] = mt_rand() - mt_rand();
+  }
+  return $ints;
+}
+
+/**
+ * @param int $size
+ * @return float[]
+ */
+function make_random_floats(int $size) {
+  $floats = [];
+  for ($i = 0; $i < $size; ++$i) {
+    $floats[] = mt_rand() / 7 - mt_rand();
+  }
+  return $floats;
+}
+
+// every benchmark sorts a fresh copy of the array, so the copying is measured too
+class BenchmarkSort {
+  /** @var int[] */
+  private $ints10 = [];
+  /** @var int[] */
+  private $ints1k = [];
+  /** @var int[] */
+  private $ints100k = [];
+  /** @var int[] */
+  private $ints10m = [];
+  /** @var float[] */
+  private $floats100k = [];
+  /** @var string[] */
+  private $strings100k = [];
+  /** @var int[] */
+  private $map100k = [];
+
+  public function __construct() {
+    mt_srand(42);
+    $this->ints10 = make_random_ints(10);
+    $this->ints1k = make_random_ints(1000);
+    $this->ints100k = make_random_ints(100000);
+    $this->ints10m = make_random_ints(10000000);
+    $this->floats100k = make_random_floats(100000);
+    foreach ($this->ints100k as $i => $value) {
+      $this->strings100k[] = "str$value";
+      $this->map100k["key$i"] = $value;
+    }
+  }
+
+  public function benchmarkSortInts10() { $a = $this->ints10; sort($a); return $a; }
+  public function benchmarkSortInts1k() { $a = $this->ints1k; sort($a); return $a; }
+  public function benchmarkSortInts100k() { $a = $this->ints100k; sort($a); return $a; }
+  public function benchmarkSortInts10m() { $a = $this->ints10m; sort($a); return $a; }
+  public function benchmarkRsortInts100k() { $a = $this->ints100k; rsort($a); return $a; }
+  public function benchmarkSortFloats100k() { $a = $this->floats100k; sort($a); return $a; }
+  public function benchmarkSortStrings100k() { $a = $this->strings100k; sort($a); return $a; }
+  public function benchmarkAsortInts100k() { $a = $this->map100k; asort($a); return $a; }
+  public function benchmarkKsortVector100k() { $a = $this->ints100k; ksort($a); return $a; }
+  public function benchmarkUsortInts100k() {
+    $a = $this->ints100k;
+    usort($a, function(int $x, int $y) { return $x <=> $y; });
+    return $a;
+  }
+}
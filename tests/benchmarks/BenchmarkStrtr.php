@@ -0,0 +1,76 @@
+<?php
+
+function make_random_word(int $min_len, int $max_len) {
+  $word = "";
+  $len = mt_rand($min_len, $max_len);
+  for ($i = 0; $i < $len; $i++) {
+    $word .= chr(mt_rand(ord('a'), ord('z')));
+  }
+  return $word;
+}
+
+function make_replace_pairs(int $count) {
+  $pairs = [];
+  while (count($pairs) < $count) {
+    $pairs[make_random_word(3, 8)] = make_random_word(0, 8);
+  }
+  return $pairs;
+}
+
+function make_text(int $len, array $pairs) {
+  $words = array_keys($pairs);
+  $text = "";
+  while (strlen($text) < $len) {
+    // every tenth word is replaced
+    $text .= (mt_rand(0, 9) == 0 ? $words[mt_rand(0, count($words) - 1)] : make_random_word(1, 10)) . " ";
+  }
+  return substr($text, 0, $len);
+}
+
+class BenchmarkStrtr {
+  /** @var string[][] */
+  private $pairs = [];
+  /** @var string[] */
+  private $texts = [];
+
+  public function __construct() {
+    mt_srand(42);
+    foreach ([10, 100, 1000, 10000] as $pairs_count) {
+      $this->pairs[$pairs_count] = make_replace_pairs($pairs_count);
+      foreach ([1024, 64 * 1024, 1024 * 1024] as $text_len) {
+        $this->texts["$pairs_count:$text_len"] = make_text($text_len, $this->pairs[$pairs_count]);
+      }
+    }
+  }
+
+  private function strtr(int $pairs_count, int $text_len) {
+    return strtr($this->texts["$pairs_count:$text_len"], $this->pairs[$pairs_count]);
+  }
+
+  private function str_replace(int $pairs_count, int $text_len) {
+    $pairs = $this->pairs[$pairs_count];
+    return str_replace(array_keys($pairs), array_values($pairs), $this->texts["$pairs_count:$text_len"]);
+  }
+
+  // the pairs array is built on every call, like in strtr($s, ['{name}' => $name])
+  private function strtr_fresh_pairs(int $text_len) {
+    $word = (string)mt_rand(0, 9);
+    return strtr($this->texts["10:$text_len"], ['ab' => $word, 'cd' => "x$word"]);
+  }
+
+  public function benchmarkStrtrFresh2Pairs1K() { return $this->strtr_fresh_pairs(1024); }
+  public function benchmarkStrtrFresh2Pairs64K() { return $this->strtr_fresh_pairs(64 * 1024); }
+  public function benchmarkStrtr10Pairs1K() { return $this->strtr(10, 1024); }
+  public function benchmarkStrtr10Pairs1M() { return $this->strtr(10, 1024 * 1024); }
+  public function benchmarkStrtr100Pairs64K() { return $this->strtr(100, 64 * 1024); }
+  public function benchmarkStrtr1000Pairs1K() { return $this->strtr(1000, 1024); }
+  public function benchmarkStrtr1000Pairs64K() { return $this->strtr(1000, 64 * 1024); }
+  public function benchmarkStrtr10000Pairs1K() { return $this->strtr(10000, 1024); }
+  public function benchmarkStrtr10000Pairs1M() { return $this->strtr(10000, 1024 * 1024); }
+
+  public function benchmarkStrReplace10Pairs1K() { return $this->str_replace(10, 1024); }
+  public function benchmarkStrReplace10Pairs1M() { return $this->str_replace(10, 1024 * 1024); }
+  public function benchmarkStrReplace100Pairs64K() { return $this->str_replace(100, 64 * 1024); }
+  public function benchmarkStrReplace1000Pairs64K() { return $this->str_replace(1000, 64 * 1024); }
+  public function benchmarkStrReplace10000Pairs1K() { return $this->str_replace(10000, 1024); }
+}
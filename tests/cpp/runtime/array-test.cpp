@@ -132,3 +132,23 @@ TEST(array_test, test_mutate_shared_map) {
   ASSERT_EQ(arr_copy.get_reference_counter(), 1);
   ASSERT_FALSE(arr_copy.is_equal_inner_pointer(arr));
 }
+
+TEST(array_test, test_convert_vector) {
+  const int32_t ints[] = {0, -1, 2147483647, -2147483648, 42};
+  array<int64_t> arr;
+  arr.reserve(5, 0, true);
+  arr.convert_vector(5, ints);
+  ASSERT_TRUE(arr.is_vector());
+  ASSERT_EQ(arr.count(), 5);
+  for (int64_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(arr.get_value(i), int64_t{ints[i]});
+  }
+
+  const float floats[] = {0.5F, -1.25F, 3.0F};
+  array<double> doubles;
+  doubles.reserve(3, 0, true);
+  doubles.convert_vector(3, floats);
+  ASSERT_EQ(doubles.count(), 3);
+  ASSERT_EQ(doubles.get_value(1), -1.25);
+  ASSERT_EQ(doubles.get_next_key(), 3);
+}
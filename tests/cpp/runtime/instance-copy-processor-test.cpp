@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "runtime/instance-copy-processor.h"
+#include "runtime/kphp_core.h"
+#include "runtime/refcountable_php_classes.h"
+
+namespace {
+
+struct C$Node : refcountable_php_classes<C$Node> {
+  string name;
+  array<string> values;
+  class_instance<C$Node> next;
+
+  template<class Visitor>
+  void generic_accept(Visitor &&visitor) noexcept {
+    visitor("name", name);
+    visitor("values", values);
+    visitor("next", next);
+  }
+
+  void accept(InstanceReferencesCheckVisitor &visitor) noexcept {
+    return generic_accept(visitor);
+  }
+
+  void accept(InstanceDeepCopyVisitor &visitor) noexcept {
+    return generic_accept(visitor);
+  }
+
+  void accept(InstanceUniqueIndexVisitor &visitor) noexcept {
+    return generic_accept(visitor);
+  }
+};
+
+using MemoryRange = InstanceReferencesCheckVisitor::MemoryRange;
+
+MemoryRange memory_of(const void *ptr) {
+  return {ptr, static_cast<const char *>(ptr) + 1};
+}
+
+const MemoryRange all_memory{reinterpret_cast<const void *>(1), reinterpret_cast<const void *>(UINTPTR_MAX)};
+
+} // namespace
+
+TEST(instance_references_check_visitor_test, test_strings_and_arrays) {
+  string foo{"foo"};
+  string bar{"bar"};
+  auto arr = array<string>::create(foo, bar);
+
+  InstanceReferencesCheckVisitor foo_checker{{memory_of(foo.c_str())}};
+  ASSERT_TRUE(foo_checker.process(foo));
+  ASSERT_FALSE(foo_checker.process(bar));
+
+  auto node = class_instance<C$Node>{}.alloc();
+  node.get()->name = foo;
+  node.get()->values = arr;
+  // the strings of the array are checked too
+  InstanceReferencesCheckVisitor node_checker{{memory_of(node.get()), memory_of(arr.get_inner_pointer()), memory_of(foo.c_str())}};
+  ASSERT_FALSE(node_checker.process_instance(node));
+
+  InstanceReferencesCheckVisitor full_node_checker{{memory_of(node.get()), memory_of(arr.get_inner_pointer()),
+                                                    memory_of(foo.c_str()), memory_of(bar.c_str())}};
+  ASSERT_TRUE(full_node_checker.process_instance(node));
+}
+
+TEST(instance_references_check_visitor_test, test_instances) {
+  auto first = class_instance<C$Node>{}.alloc();
+  auto second = class_instance<C$Node>{}.alloc();
+  first.get()->next = second;
+  // the cycle is visited once
+  second.get()->next = first;
+
+  InstanceReferencesCheckVisitor all_checker{{all_memory}};
+  ASSERT_TRUE(all_checker.process_instance(first));
+
+  InstanceReferencesCheckVisitor first_checker{{memory_of(first.get())}};
+  ASSERT_FALSE(first_checker.process_instance(first));
+
+  InstanceReferencesCheckVisitor none_checker{{}};
+  ASSERT_FALSE(none_checker.process_instance(first));
+  class_instance<C$Node> null_instance;
+  ASSERT_TRUE(none_checker.process_instance(null_instance));
+
+  second.get()->next = class_instance<C$Node>{};
+}
+
+TEST(instance_deep_copy_visitor_test, test_keep_copied_instances_aside) {
+  std::array<char, 64 * 1024> buffer{};
+  memory_resource::unsynchronized_pool_resource resource;
+  resource.init(buffer.data(), buffer.size());
+
+  auto first = class_instance<C$Node>{}.alloc();
+  auto second = class_instance<C$Node>{}.alloc();
+  first.get()->next = second;
+  second.get()->next = first;
+
+  auto copy = first;
+  InstanceDeepCopyVisitor copier{resource};
+  copier.keep_copied_instances_aside();
+  ASSERT_TRUE(copier.process_instance(copy));
+  ASSERT_NE(copy.get(), first.get());
+  ASSERT_NE(copy.get()->next.get(), second.get());
+  // the cycle is copied once, the originals aren't marked
+  ASSERT_EQ(copy.get()->next.get()->next.get(), copy.get());
+  ASSERT_EQ(first.get()->get_unique_index_ref(), 0);
+  ASSERT_EQ(second.get()->get_unique_index_ref(), 0);
+
+  copy.get()->next.get()->next = class_instance<C$Node>{};
+  second.get()->next = class_instance<C$Node>{};
+}
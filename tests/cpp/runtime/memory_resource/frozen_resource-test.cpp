@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "runtime/memory_resource/frozen_resource.h"
+
+TEST(frozen_resource_test, allocation) {
+  memory_resource::frozen_resource resource;
+  ASSERT_FALSE(resource.is_accepting());
+  ASSERT_TRUE(resource.init(1024 * 1024));
+  ASSERT_TRUE(resource.is_accepting());
+
+  auto *mem1 = static_cast<char *>(resource.allocate(13));
+  ASSERT_TRUE(mem1);
+  ASSERT_TRUE(resource.contains(mem1));
+  ASSERT_EQ(resource.memory_used(), 16);
+
+  // the last piece grows in place
+  auto *mem2 = static_cast<char *>(resource.allocate(8));
+  ASSERT_EQ(mem2, mem1 + 16);
+  ASSERT_EQ(resource.reallocate(mem2, 64, 8), mem2);
+  ASSERT_EQ(resource.memory_used(), 80);
+
+  // the last piece goes back
+  resource.deallocate(mem2, 64);
+  ASSERT_EQ(resource.memory_used(), 16);
+  ASSERT_EQ(resource.allocate(8), mem2);
+
+  // the reserved space is over
+  ASSERT_FALSE(resource.allocate(1024 * 1024));
+  ASSERT_FALSE(resource.contains(&resource));
+}
+
+TEST(frozen_resource_test, shared_after_fork) {
+  memory_resource::frozen_resource resource;
+  ASSERT_TRUE(resource.init(1024 * 1024 * 1024));
+
+  constexpr size_t size = 1024 * 1024;
+  auto *mem = static_cast<char *>(resource.allocate(size));
+  ASSERT_TRUE(mem);
+  memset(mem, 'x', size);
+  resource.freeze();
+  ASSERT_FALSE(resource.is_accepting());
+  ASSERT_TRUE(resource.contains(mem + size - 1));
+  // nothing is shared before the fork
+  ASSERT_EQ(resource.get_shared_memory_size(), 0);
+
+  const pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    if (resource.get_shared_memory_size() != size) {
+      _exit(1);
+    }
+    // the written page is copied
+    mem[0] = 'y';
+    _exit(resource.get_shared_memory_size() == size - getpagesize() ? 0 : 2);
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
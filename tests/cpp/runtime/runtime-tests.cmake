@@ -7,6 +7,7 @@ prepend(RUNTIME_TESTS_SOURCES ${BASE_DIR}/tests/cpp/runtime/
         confdata-key-maker-test.cpp
         confdata-predefined-wildcards-test.cpp
         flex-test.cpp
+        instance-copy-processor-test.cpp
         inter-process-mutex-test.cpp
         inter-process-resource-test.cpp
         number-string-comparison.cpp
@@ -15,6 +16,7 @@ prepend(RUNTIME_TESTS_SOURCES ${BASE_DIR}/tests/cpp/runtime/
         memory_resource/details/memory_chunk_tree-test.cpp
         memory_resource/details/memory_ordered_chunk_list-test.cpp
         memory_resource/extra-memory-pool-test.cpp
+        memory_resource/frozen_resource-test.cpp
         memory_resource/unsynchronized_pool_resource-test.cpp
         string-list-test.cpp
         string-test.cpp
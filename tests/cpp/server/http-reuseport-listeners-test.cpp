@@ -0,0 +1,120 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "server/http-reuseport-listeners.h"
+#include "server/workers-affinity.h"
+
+namespace {
+
+uint16_t listener_port = 0;
+
+int open_loopback_listener() {
+  const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(listener_port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 1024) != 0) {
+    close(fd);
+    return -1;
+  }
+  socklen_t addr_len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &addr_len);
+  listener_port = ntohs(addr.sin_port);
+  return fd;
+}
+
+int connect_to_listener() {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(listener_port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+  return fd;
+}
+
+int accept_all(int listener_fd) {
+  int accepted = 0;
+  for (int fd; (fd = accept(listener_fd, nullptr, nullptr)) >= 0; ++accepted) {
+    close(fd);
+  }
+  return accepted;
+}
+
+} // namespace
+
+TEST(http_reuseport_listeners_test, test_connections_are_spread) {
+  auto &listeners = vk::singleton<HttpReuseportListeners>::get();
+  listeners.enable(false);
+
+  listener_port = 0;
+  const int shared_fd = open_loopback_listener();
+  ASSERT_GE(shared_fd, 0);
+  listeners.init(shared_fd, open_loopback_listener, 4, true);
+  ASSERT_TRUE(listeners.is_enabled());
+  ASSERT_TRUE(listeners.is_inited());
+
+  std::vector<int> clients;
+  for (int i = 0; i != 200; ++i) {
+    clients.push_back(connect_to_listener());
+  }
+
+  int total = 0;
+  for (uint16_t worker = 0; worker != 4; ++worker) {
+    const pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+      _exit(accept_all(listeners.take_worker_listener(worker)));
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_GT(WEXITSTATUS(status), 0);
+    total += WEXITSTATUS(status);
+  }
+  ASSERT_EQ(total, 200);
+
+  close(listeners.take_worker_listener(0));
+  for (int fd : clients) {
+    close(fd);
+  }
+}
+
+TEST(http_reuseport_listeners_test, test_shared_socket_without_reuseport) {
+  auto &listeners = vk::singleton<HttpReuseportListeners>::get();
+  listeners.enable(false);
+
+  const int shared_fd = socket(AF_INET, SOCK_STREAM, 0);
+  listeners.init(shared_fd, open_loopback_listener, 4, true);
+  ASSERT_FALSE(listeners.is_enabled());
+  ASSERT_FALSE(listeners.is_inited());
+  close(shared_fd);
+}
+
+TEST(http_reuseport_listeners_test, test_cpu_steering) {
+  auto &affinity = vk::singleton<WorkersAffinity>::get();
+  ASSERT_EQ(affinity.set_mode("cpu"), nullptr);
+  affinity.init({0, 1, 2, 3}, {});
+
+  auto &listeners = vk::singleton<HttpReuseportListeners>::get();
+  listeners.enable(true);
+
+  listener_port = 0;
+  const int shared_fd = open_loopback_listener();
+  listeners.init(shared_fd, open_loopback_listener, 4, true);
+  ASSERT_TRUE(listeners.is_inited());
+  ASSERT_TRUE(listeners.is_cpu_steering_attached());
+
+  const int client_fd = connect_to_listener();
+  close(client_fd);
+  close(listeners.take_worker_listener(0));
+}
@@ -0,0 +1,20 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "server/php-runner.h"
+
+TEST(php_runner_test, test_recreated_script_reuses_stack) {
+  // the size isn't a multiple of the page size, it's rounded up
+  constexpr size_t stack_size = 100000;
+  char *stack = nullptr;
+  {
+    PHPScriptBase script{1 << 20, stack_size};
+    ASSERT_EQ(script.stack_size % getpagesize(), 0);
+    ASSERT_GE(script.stack_size, stack_size + getpagesize());
+    ASSERT_EQ(script.run_stack_end, script.run_stack + script.stack_size);
+    stack = script.run_stack;
+  }
+  // the stack of the destroyed script comes back from the pool
+  PHPScriptBase script{1 << 20, stack_size};
+  ASSERT_EQ(script.run_stack, stack);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "server/php-query-data.h"
+#include "server/request-accounting.h"
+
+namespace {
+
+vk::string_view get_http_endpoint(const char *uri, std::array<char, REQUEST_ENDPOINT_MAX_LEN> &buffer) {
+  http_query_data http_data{};
+  http_data.uri = const_cast<char *>(uri);
+  http_data.uri_len = static_cast<int>(strlen(uri));
+  php_query_data data{&http_data, nullptr, nullptr};
+  return get_request_endpoint(&data, buffer);
+}
+
+} // namespace
+
+TEST(request_accounting_test, test_endpoint) {
+  std::array<char, REQUEST_ENDPOINT_MAX_LEN> buffer{};
+  ASSERT_EQ(get_request_endpoint(nullptr, buffer), "cli");
+  ASSERT_EQ(get_http_endpoint("/", buffer), "index");
+  ASSERT_EQ(get_http_endpoint("", buffer), "index");
+  ASSERT_EQ(get_http_endpoint("/api/users.get", buffer), "api_users_get");
+  ASSERT_EQ(get_http_endpoint(("/" + std::string(100, 'a')).c_str(), buffer), std::string(REQUEST_ENDPOINT_MAX_LEN, 'a'));
+  ASSERT_EQ(get_http_endpoint("/user/123", buffer), "user_id");
+  ASSERT_EQ(get_http_endpoint("//user//456/photos/789", buffer), "user_id");
+  ASSERT_EQ(get_http_endpoint("/doc/0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d", buffer), "doc_id");
+  ASSERT_EQ(get_http_endpoint("/api/v2/users", buffer), "api_v2");
+  ASSERT_EQ(get_http_endpoint("/beef/2fa?user=1", buffer), "beef_2fa");
+  ASSERT_EQ(get_http_endpoint("/?q=1", buffer), "index");
+
+  int rpc_function[] = {0x2374df3d, 42};
+  rpc_query_data rpc_data{};
+  rpc_data.data = rpc_function;
+  rpc_data.len = 2;
+  php_query_data rpc_query{nullptr, &rpc_data, nullptr};
+  ASSERT_EQ(get_request_endpoint(&rpc_query, buffer), "rpc_0x2374df3d");
+
+  job_query_data job_data{};
+  php_query_data job_query{nullptr, nullptr, &job_data};
+  ASSERT_EQ(get_request_endpoint(&job_query, buffer), "job");
+}
+
+TEST(request_accounting_test, test_accounting) {
+  RequestAccounting accounting;
+  accounting.start();
+  accounting.script_resumed();
+  volatile uint64_t x = 0;
+  for (int i = 0; i != 1000000; ++i) {
+    x = x + i;
+  }
+  accounting.script_paused();
+  accounting.add_blocked_time(BlockingResource::rpc, 0.25);
+  accounting.add_blocked_time(BlockingResource::rpc, 0.5);
+  accounting.add_blocked_time(BlockingResource::timer, 0.125);
+  accounting.finish(0.5, 0.875, 10, 1024);
+
+  ASSERT_GT(accounting.cpu_cycles, 0);
+  ASSERT_EQ(accounting.working_time_ns, 1375000000);
+  ASSERT_EQ(accounting.script_time_ns, 500000000);
+  ASSERT_EQ(accounting.net_time_ns, 875000000);
+  ASSERT_EQ(accounting.allocations, 10);
+  ASSERT_EQ(accounting.allocated_bytes, 1024);
+  ASSERT_EQ(accounting.blocked_time_ns[static_cast<size_t>(BlockingResource::rpc)], 750000000);
+  ASSERT_EQ(accounting.blocked_time_ns[static_cast<size_t>(BlockingResource::timer)], 125000000);
+  ASSERT_EQ(accounting.blocked_time_ns[static_cast<size_t>(BlockingResource::sql)], 0);
+
+  // the new request starts from scratch
+  accounting.start();
+  ASSERT_EQ(accounting.cpu_cycles, 0);
+  ASSERT_EQ(accounting.blocked_time_ns[static_cast<size_t>(BlockingResource::rpc)], 0);
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "common/fast-backtrace.h"
+#include "server/sampling-profiler.h"
+
+TEST(sampling_profiler_test, test_frame_name) {
+  ASSERT_EQ(SamplingProfiler::get_frame_name("_Z5f$foov"), "foo");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("_Z14f$VK$Api$$callRK6string"), "VK\\Api::call");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("f$Base$$get$$Derived(long)"), "Base::get");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("array<long> f$array_map<long>(array<long> const&)"), "array_map");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("PHPScriptBase::run()"), "PHPScriptBase::run");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("(anonymous namespace)::foo(int)"), "(anonymous namespace)::foo");
+  ASSERT_EQ(SamplingProfiler::get_frame_name("epoll_wait"), "epoll_wait");
+}
+
+TEST(sampling_profiler_test, test_backtrace_by_bp) {
+  // the frame records: the saved frame pointer and the return address
+  void *stack[8] = {};
+  auto *stack_begin = reinterpret_cast<const char *>(stack);
+  auto *stack_end = reinterpret_cast<const char *>(stack + 8);
+  stack[0] = &stack[2];
+  stack[1] = reinterpret_cast<void *>(0x10);
+  stack[2] = &stack[6];
+  stack[3] = reinterpret_cast<void *>(0x20);
+  // points outside of the stack
+  stack[6] = &stack[8];
+  stack[7] = reinterpret_cast<void *>(0x30);
+
+  void *frames[8];
+  ASSERT_EQ(fast_backtrace_by_bp(&stack[0], stack_begin, stack_end, frames, 8), 3);
+  ASSERT_EQ(frames[0], reinterpret_cast<void *>(0x10));
+  ASSERT_EQ(frames[1], reinterpret_cast<void *>(0x20));
+  ASSERT_EQ(frames[2], reinterpret_cast<void *>(0x30));
+
+  ASSERT_EQ(fast_backtrace_by_bp(&stack[0], stack_begin, stack_end, frames, 2), 2);
+  // the frame below the interrupted stack pointer isn't read
+  ASSERT_EQ(fast_backtrace_by_bp(&stack[0], stack_begin + sizeof(void *), stack_end, frames, 8), 0);
+
+  // the chain going down is stopped
+  stack[2] = &stack[0];
+  ASSERT_EQ(fast_backtrace_by_bp(&stack[0], stack_begin, stack_end, frames, 8), 2);
+}
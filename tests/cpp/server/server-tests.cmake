@@ -2,7 +2,13 @@ prepend(SERVER_TESTS_SOURCES ${BASE_DIR}/tests/cpp/server/
         job-workers/shared-memory-manager-test.cpp
         cluster-name-test.cpp
         confdata-binlog-events-test.cpp
+        http-reuseport-listeners-test.cpp
         php-engine-test.cpp
+        php-runner-test.cpp
+        request-accounting-test.cpp
+        sampling-profiler-test.cpp
+        workers-affinity-test.cpp
+        workers-autoscaler-test.cpp
         workers-control-test.cpp)
 
 if(COMPILER_GCC)
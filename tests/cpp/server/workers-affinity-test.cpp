@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include "server/workers-affinity.h"
+
+TEST(workers_affinity_test, test_parse_cpu_list) {
+  using cpus = std::vector<int>;
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list("0"), cpus({0}));
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list("0-3\n"), cpus({0, 1, 2, 3}));
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list("0-1,8,10-11"), cpus({0, 1, 8, 10, 11}));
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list(""), cpus{});
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list("3-1"), cpus{});
+  ASSERT_EQ(WorkersAffinity::parse_cpu_list("1,x"), cpus({1}));
+}
+
+TEST(workers_affinity_test, test_cpu_mode) {
+  auto &affinity = vk::singleton<WorkersAffinity>::get();
+  ASSERT_STREQ(affinity.set_mode("cpus"), "unknown mode, 'cpu' or 'numa' are expected");
+  ASSERT_EQ(affinity.set_mode("cpu"), nullptr);
+  affinity.init({2, 3, 5}, {});
+  ASSERT_EQ(affinity.get_mode(), WorkersAffinity::Mode::cpu);
+
+  ASSERT_EQ(affinity.get_worker_cpu(0), 2);
+  ASSERT_EQ(affinity.get_worker_cpu(1), 3);
+  ASSERT_EQ(affinity.get_worker_cpu(2), 5);
+  ASSERT_EQ(affinity.get_worker_cpu(3), 2);
+  ASSERT_EQ(affinity.get_worker_cpus(4), std::vector<int>{3});
+}
+
+TEST(workers_affinity_test, test_numa_mode) {
+  auto &affinity = vk::singleton<WorkersAffinity>::get();
+  ASSERT_EQ(affinity.set_mode("numa"), nullptr);
+  affinity.init({0, 1, 2, 3}, {{0, 1}, {2, 3}});
+  ASSERT_EQ(affinity.get_mode(), WorkersAffinity::Mode::numa_node);
+
+  ASSERT_EQ(affinity.get_worker_cpu(0), -1);
+  ASSERT_EQ(affinity.get_worker_cpus(0), std::vector<int>({0, 1}));
+  ASSERT_EQ(affinity.get_worker_cpus(1), std::vector<int>({2, 3}));
+  ASSERT_EQ(affinity.get_worker_cpus(2), std::vector<int>({0, 1}));
+
+  // no numa information
+  affinity.init({0, 1, 2, 3}, {});
+  ASSERT_EQ(affinity.get_worker_cpus(1), std::vector<int>({0, 1, 2, 3}));
+
+  affinity.init({}, {});
+  ASSERT_EQ(affinity.get_mode(), WorkersAffinity::Mode::none);
+  ASSERT_TRUE(affinity.get_worker_cpus(0).empty());
+}
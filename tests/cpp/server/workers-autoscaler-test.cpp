@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+#include "server/workers-autoscaler.h"
+
+namespace {
+
+constexpr uint16_t MAX_WORKERS = 64;
+constexpr uint16_t HOST_CPUS = 96;
+
+// the workers are modeled as the servers of a queue: 'demand' requests want to run at the same time,
+// the excess waits in the accept queue
+WorkersAutoscaler::Load make_load(double demand, uint16_t target) {
+  WorkersAutoscaler::Load load;
+  const double running = std::min(demand, static_cast<double>(target));
+  load.running_ratio = running / target;
+  load.accept_queue = static_cast<uint32_t>(std::max(demand - target, 0.0));
+  load.host_cpu_usage = running / HOST_CPUS;
+  return load;
+}
+
+struct SimulationResult {
+  uint64_t ticks{0};
+  uint64_t queued_ticks{0};
+  double avg_target{0};
+  uint16_t min_target{MAX_WORKERS};
+  uint16_t max_target{0};
+};
+
+template<class F>
+SimulationResult simulate(uint16_t &target, uint64_t ticks, const F &get_demand) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  SimulationResult result;
+  for (uint64_t t = 0; t != ticks; ++t) {
+    const auto load = make_load(get_demand(t), target);
+    result.queued_ticks += load.accept_queue > 0;
+    target = autoscaler.update(WorkerType::general_worker, target, MAX_WORKERS, load);
+    result.avg_target += target;
+    result.min_target = std::min(result.min_target, target);
+    result.max_target = std::max(result.max_target, target);
+  }
+  result.ticks = ticks;
+  result.avg_target /= ticks;
+  return result;
+}
+
+// neither overloaded nor underloaded ticks reset the hysteresis state of the previous test
+void settle(uint16_t target) {
+  ASSERT_EQ(vk::singleton<WorkersAutoscaler>::get().set_min_ratio(0.1), nullptr);
+  for (int i = 0; i != 100; ++i) {
+    vk::singleton<WorkersAutoscaler>::get().update(WorkerType::general_worker, target, MAX_WORKERS, make_load(target * 0.7, target));
+  }
+}
+
+} // namespace
+
+TEST(workers_autoscaler_test, test_min_ratio) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  ASSERT_NE(autoscaler.set_min_ratio(0), nullptr);
+  ASSERT_NE(autoscaler.set_min_ratio(-0.5), nullptr);
+  ASSERT_NE(autoscaler.set_min_ratio(1.5), nullptr);
+
+  ASSERT_EQ(autoscaler.set_min_ratio(0.1), nullptr);
+  ASSERT_TRUE(autoscaler.is_enabled(WorkerType::general_worker));
+  ASSERT_TRUE(autoscaler.is_enabled(WorkerType::job_worker));
+}
+
+TEST(workers_autoscaler_test, test_bounds) {
+  uint16_t target = MAX_WORKERS;
+  settle(target);
+
+  // no traffic: shrinks slowly to the lower bound
+  auto result = simulate(target, 3600, [](uint64_t) { return 0.0; });
+  ASSERT_EQ(target, 7);
+  ASSERT_EQ(result.min_target, 7);
+
+  // the traffic above the capacity: grows fast to the configured count
+  result = simulate(target, 200, [](uint64_t) { return 1000.0; });
+  ASSERT_EQ(target, MAX_WORKERS);
+  ASSERT_EQ(result.max_target, MAX_WORKERS);
+}
+
+TEST(workers_autoscaler_test, test_hysteresis) {
+  uint16_t target = 32;
+  settle(target);
+  const auto stats_before = vk::singleton<WorkersAutoscaler>::get().get_stats(WorkerType::general_worker);
+
+  // the short spikes and dips don't change anything
+  simulate(target, 3600, [](uint64_t t) { return t % 2 ? 40.0 : 8.0; });
+  ASSERT_EQ(target, 32);
+  settle(target);
+  simulate(target, 3600, [](uint64_t t) { return t % 20 < 2 ? 100.0 : 10.0; });
+  ASSERT_EQ(target, 32);
+
+  const auto &stats = vk::singleton<WorkersAutoscaler>::get().get_stats(WorkerType::general_worker);
+  ASSERT_EQ(stats.grows, stats_before.grows);
+  ASSERT_EQ(stats.shrinks, stats_before.shrinks);
+}
+
+TEST(workers_autoscaler_test, test_saturated_cpu) {
+  auto &autoscaler = vk::singleton<WorkersAutoscaler>::get();
+  uint16_t target = 32;
+  settle(target);
+
+  WorkersAutoscaler::Load load;
+  load.running_ratio = 1;
+  load.accept_queue = 100;
+  load.host_cpu_usage = 0.95;
+  for (int i = 0; i != 100; ++i) {
+    target = autoscaler.update(WorkerType::general_worker, target, MAX_WORKERS, load);
+  }
+  ASSERT_EQ(target, 32);
+}
+
+TEST(workers_autoscaler_test, test_daily_load) {
+  uint16_t target = MAX_WORKERS;
+  settle(target);
+
+  // a day is squeezed into 4 hours: the demand varies 5x between 10 and 50 workers, with the noise
+  constexpr uint64_t day = 4 * 3600;
+  std::mt19937 gen{43};
+  std::normal_distribution<double> noise{0, 2};
+  const auto result = simulate(target, 2 * day, [&](uint64_t t) {
+    const double phase = 2 * M_PI * static_cast<double>(t) / day;
+    return std::max(10 + 40 * (0.5 - 0.5 * std::cos(phase)) + noise(gen), 0.0);
+  });
+
+  // the spikes rarely wait in the accept queue
+  ASSERT_LT(result.queued_ticks, result.ticks / 20);
+  // the workers follow the demand instead of staying at the configured count
+  ASSERT_LT(result.min_target, 25);
+  ASSERT_GE(result.max_target, 50);
+  ASSERT_LT(result.avg_target, MAX_WORKERS * 0.75);
+}
@@ -80,3 +80,20 @@ TEST(workers_control_test, test_workers_count) {
   ASSERT_WORKERS(WorkerType::general_worker, 247, 2, 356);
   ASSERT_WORKERS(WorkerType::job_worker, 106, 1, 356);
 }
+
+TEST(workers_control_test, test_target_count) {
+  auto &control = vk::singleton<WorkersControl>::get();
+  control.set_total_workers_count(10);
+  control.set_ratio(WorkerType::job_worker, 0.2);
+  ASSERT_TRUE(control.init());
+
+  ASSERT_EQ(control.get_target_count(WorkerType::general_worker), 8);
+  ASSERT_EQ(control.get_target_count(WorkerType::job_worker), 2);
+
+  control.set_target_count(WorkerType::general_worker, 3);
+  ASSERT_EQ(control.get_target_count(WorkerType::general_worker), 3);
+  control.set_target_count(WorkerType::general_worker, 0);
+  ASSERT_EQ(control.get_target_count(WorkerType::general_worker), 1);
+  control.set_target_count(WorkerType::job_worker, 100);
+  ASSERT_EQ(control.get_target_count(WorkerType::job_worker), 2);
+}
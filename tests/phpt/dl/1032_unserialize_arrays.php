@@ -0,0 +1,44 @@
+@ok
+<?php
+
+function test_rows() {
+  $rows = [];
+  for ($i = 0; $i < 50; ++$i) {
+    // the same keys in every row
+    $rows[] = ["id" => $i * 1000003, "name" => "user$i", "10" => -$i, "rating" => $i + 0.25, "tags" => ["a", "b"], "deleted" => $i % 2 == 0];
+  }
+  $s = serialize($rows);
+  var_dump(unserialize($s) === $rows);
+  var_dump(unserialize($s)[7]);
+}
+
+function test_ints() {
+  foreach ([0, -1, 12345678, -123456789, 1234567890123456, 123456789012345678, -987654321098765432,
+            1234567890123456789, PHP_INT_MAX, -PHP_INT_MAX - 1] as $i) {
+    var_dump(unserialize(serialize($i)));
+    var_dump(unserialize(serialize([$i => $i])));
+  }
+}
+
+function test_malformed() {
+  $s = serialize(["key" => "value", 5 => [1, 2, 3], "x" => 1.5]);
+  for ($len = 0; $len < strlen($s); ++$len) {
+    if (unserialize(substr($s, 0, $len)) !== false) {
+      echo "prefix of length $len is unserialized\n";
+    }
+  }
+  var_dump(unserialize('a:1000000:{i:0;i:1;}'));
+  var_dump(unserialize('a:2:{i:0;i:1;}'));
+  var_dump(unserialize('s:10:"abc";'));
+  var_dump(unserialize('i:12a;'));
+}
+
+function test_duplicate_keys() {
+  var_dump(unserialize('a:3:{i:0;a:1:{i:0;i:1;}s:1:"k";i:2;i:0;s:1:"v";}'));
+  var_dump(unserialize('a:2:{s:1:"5";i:1;i:5;i:2;}'));
+}
+
+test_rows();
+test_ints();
+test_malformed();
+test_duplicate_keys();
@@ -0,0 +1,87 @@
+@ok
+<?php
+
+/**
+ * @param int[] $a
+ */
+function print_ints($a) {
+  echo count($a), " ", md5(implode(",", array_keys($a))), " ", md5(implode(",", $a)), "\n";
+}
+
+function test_ints(int $size) {
+  $ints = [];
+  for ($i = 0; $i < $size; ++$i) {
+    $ints[] = (($i + 1) * 7919) % 10007 * ($i % 2 ? 1 : -1) * 1000000007;
+  }
+  $ints[] = PHP_INT_MAX;
+  $ints[] = -PHP_INT_MAX - 1;
+
+  $a = $ints;
+  sort($a);
+  print_ints($a);
+  $a = $ints;
+  sort($a, SORT_NUMERIC);
+  print_ints($a);
+  $a = $ints;
+  rsort($a);
+  print_ints($a);
+  $a = $ints;
+  asort($a);
+  print_ints($a);
+  $a = $ints;
+  arsort($a);
+  print_ints($a);
+  $a = $ints;
+  ksort($a);
+  print_ints($a);
+  $a[] = 1;
+  print_ints($a);
+  $a = $ints;
+  krsort($a);
+  print_ints($a);
+  $a = $ints;
+  sort($a, SORT_STRING);
+  print_ints($a);
+
+  $map = [];
+  foreach ($ints as $i => $value) {
+    $map["k$i"] = $value;
+  }
+  asort($map);
+  print_ints($map);
+  var_dump($map["k1"]);
+}
+
+function test_floats(int $size) {
+  $floats = [];
+  for ($i = 0; $i < $size; ++$i) {
+    $floats[] = (($i + 1) * 7919) % 10007 / 8.0 * ($i % 2 ? 1 : -1);
+  }
+  $floats[] = INF;
+  $floats[] = -INF;
+  $floats[] = 1e-300;
+  $floats[] = -1e300;
+
+  $a = $floats;
+  sort($a);
+  var_dump(count($a), $a[0], $a[1], $a[2], $a[count($a) - 1]);
+  $sorted = true;
+  for ($i = 1; $i < count($a); ++$i) {
+    $sorted = $sorted && $a[$i - 1] <= $a[$i];
+  }
+  var_dump($sorted);
+
+  $a = $floats;
+  rsort($a, SORT_NUMERIC);
+  var_dump($a[0], $a[1], $a[count($a) - 1]);
+
+  $a = $floats;
+  arsort($a);
+  $keys = array_keys($a);
+  var_dump($keys[0], $keys[count($keys) - 1]);
+}
+
+foreach ([0, 1, 5, 16, 17, 100, 1023, 1024, 5000] as $size) {
+  test_ints($size);
+  test_floats($size);
+}
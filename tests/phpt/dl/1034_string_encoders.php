@@ -0,0 +1,67 @@
+@ok
+<?php
+
+function make_bytes(int $len, int $seed) {
+  $s = "";
+  for ($i = 0; $i < $len; ++$i) {
+    $s .= chr(($i * 131 + $seed * 17) % 256);
+  }
+  return $s;
+}
+
+function test_base64() {
+  foreach ([0, 1, 2, 3, 11, 12, 13, 16, 24, 27, 28, 29, 100, 1000] as $len) {
+    $s = make_bytes($len, $len);
+    $encoded = base64_encode($s);
+    echo $len, " ", md5($encoded), " ", strlen($encoded), "\n";
+    var_dump(base64_decode($encoded) === $s);
+    var_dump(base64_decode($encoded, true) === $s);
+    var_dump(base64_decode(implode("\r\n", str_split($encoded, 76)), true) === $s);
+    var_dump(base64_decode(rtrim($encoded, "=")) === $s);
+    var_dump(base64_decode($encoded . "*", true));
+    var_dump(md5(base64_decode("*" . $encoded . "\x80")));
+  }
+}
+
+function test_hex() {
+  foreach ([0, 1, 15, 16, 17, 31, 32, 33, 100] as $len) {
+    $s = make_bytes($len, $len + 1);
+    $hex = bin2hex($s);
+    echo $len, " ", md5($hex), "\n";
+    var_dump(hex2bin($hex) === $s);
+    var_dump(hex2bin(strtoupper($hex)) === $s);
+    if ($len) {
+      var_dump(hex2bin(substr($hex, 0, -1) . "g"));
+      var_dump(hex2bin("z" . substr($hex, 1)));
+    }
+  }
+}
+
+function test_urlencode() {
+  $s = "";
+  for ($i = 0; $i < 300; ++$i) {
+    $s .= chr($i % 256);
+    echo urlencode($s) === rawurlencode($s) ? "same" : "different", " ";
+  }
+  echo "\n", urlencode($s), "\n", rawurlencode($s), "\n";
+  var_dump(urlencode("plain_text-with.dots0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+  var_dump(urlencode("param=value with spaces&other=тест"));
+}
+
+function test_htmlspecialchars() {
+  $text = "";
+  for ($i = 0; $i < 40; ++$i) {
+    $text .= "<p class=\"c$i\">It's &amp; text</p>";
+    if ($i % 10 == 0) {
+      var_dump(htmlspecialchars($text));
+      var_dump(htmlspecialchars($text, ENT_QUOTES));
+      var_dump(htmlspecialchars($text, ENT_NOQUOTES));
+    }
+  }
+  var_dump(htmlspecialchars("nothing to escape in this long enough line of text"));
+}
+
+test_base64();
+test_hex();
+test_urlencode();
+test_htmlspecialchars();
@@ -0,0 +1,50 @@
+@ok
+<?php
+
+function make_text(int $len) {
+  $pieces = ["a", "Б", "c", " ", "Ж", "€", "😀", "Z", "ё", "/", "\"", "İ"];
+  $s = "";
+  for ($i = 0; $i < $len; ++$i) {
+    $s .= $pieces[($i * 7 + $len) % count($pieces)];
+  }
+  return $s;
+}
+
+function test_mb_functions() {
+  foreach ([0, 1, 5, 15, 16, 17, 31, 32, 33, 100, 1000] as $len) {
+    $s = make_text($len);
+    var_dump(mb_check_encoding($s, "UTF-8"));
+    var_dump(mb_strlen($s, "UTF-8"));
+    var_dump(md5(mb_strtolower($s, "UTF-8")));
+    var_dump(md5(mb_strtoupper($s, "UTF-8")));
+    var_dump(mb_substr($s, (int)($len / 3), (int)($len / 2), "UTF-8"));
+    var_dump(mb_strpos($s, "€", 0, "UTF-8"));
+    var_dump(md5(json_encode($s, JSON_UNESCAPED_UNICODE)));
+    var_dump(preg_match('/Ж€/u', $s));
+  }
+}
+
+function test_invalid() {
+  $s = str_repeat("abcdefgh", 10);
+  foreach (["\xff", "\xc3", "\xc0\x80", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe2\x82"] as $bad) {
+    foreach ([0, 15, 31, 79] as $pos) {
+      $t = substr($s, 0, $pos) . $bad . substr($s, $pos);
+      var_dump(mb_check_encoding($t, "UTF-8"));
+      var_dump(preg_match('/abc/u', $t));
+    }
+  }
+}
+
+function test_zero_bytes() {
+  $s = "ПРИВЕТ\0МИР\0" . str_repeat("AbC", 20);
+  var_dump(mb_check_encoding($s, "UTF-8"));
+  var_dump(mb_check_encoding($s . "\xff", "UTF-8"));
+  var_dump(mb_strlen($s, "UTF-8"));
+  var_dump(bin2hex(mb_strtolower($s, "UTF-8")));
+  var_dump(bin2hex(mb_substr($s, 5, 10, "UTF-8")));
+  var_dump(mb_strpos($s, "AbC", 3, "UTF-8"));
+}
+
+test_mb_functions();
+test_invalid();
+test_zero_bytes();
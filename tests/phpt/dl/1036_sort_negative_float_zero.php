@@ -0,0 +1,51 @@
+@ok
+<?php
+
+/**
+ * @param float[] $a
+ */
+function print_zeros($a) {
+  $zeros = [];
+  $zero_keys = [];
+  $positions = [];
+  $position = 0;
+  foreach ($a as $key => $value) {
+    if ($value == 0) {
+      $zeros[] = (string)$value;
+      $zero_keys[] = $key;
+      $positions[] = $position;
+    }
+    ++$position;
+  }
+  // -0.0 and 0.0 are equal, so only the set of them is checked, not their order
+  sort($zeros);
+  sort($zero_keys);
+  echo implode(",", $zeros), " ", implode(",", $zero_keys), " ", $positions[count($positions) - 1] - $positions[0], "\n";
+}
+
+function test_negative_zero(int $size) {
+  $floats = [];
+  for ($i = 0; $i < $size; ++$i) {
+    $floats[] = ($i + 1) * ($i % 2 ? 1.5 : -1.5);
+  }
+  $floats[3] = -0.0;
+  $floats[$size - 3] = 0.0;
+  $floats[intdiv($size, 2)] = -0.0;
+
+  $a = $floats;
+  sort($a);
+  print_zeros($a);
+  $a = $floats;
+  rsort($a);
+  print_zeros($a);
+  $a = $floats;
+  asort($a);
+  print_zeros($a);
+  $a = $floats;
+  arsort($a);
+  print_zeros($a);
+}
+
+foreach ([10, 1024, 5000] as $size) {
+  test_negative_zero($size);
+}
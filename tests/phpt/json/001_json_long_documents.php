@@ -0,0 +1,44 @@
+@ok
+<?php
+
+function test_encode_long_strings() {
+  // special characters at every position of 16-byte blocks
+  foreach (["\"", "\\", "/", "\n", "\x01", "\x1f", "é", "日", "\xff"] as $special) {
+    for ($i = 0; $i < 40; $i += 3) {
+      $s = str_repeat("a", $i) . $special . str_repeat("b", 37 - $i);
+      var_dump(@json_encode($s));
+      var_dump(@json_encode($s, JSON_UNESCAPED_UNICODE));
+    }
+  }
+}
+
+function test_decode_long_strings() {
+  foreach (["\\\"", "\\\\", "\\/", "\\n", "\\u00e9", "\\ud83d\\ude00"] as $escaped) {
+    for ($i = 0; $i < 40; $i += 3) {
+      $json = "\"" . str_repeat("a", $i) . $escaped . str_repeat("b", 37 - $i) . "\"";
+      var_dump(json_decode($json));
+    }
+  }
+  var_dump(json_decode("\"" . str_repeat("abc", 100) . "\\\""));
+}
+
+function test_decode_big_documents() {
+  $doc = [];
+  for ($i = 0; $i < 1000; ++$i) {
+    $doc[] = ["id" => $i, "name" => "[item, {$i}]", "list" => $i % 3 ? [] : [$i, "\"$i\"", [1, 2]], "obj" => ["key" => "{value}"]];
+  }
+  $decoded = json_decode(json_encode($doc), true);
+  var_dump(count($decoded));
+  var_dump($decoded[999]);
+  var_dump(json_encode($decoded) === json_encode($doc));
+
+  $numbers = "[" . implode(",", range(1, 5000)) . "]";
+  var_dump(array_sum(json_decode($numbers)));
+  var_dump(json_decode($numbers . "]"));
+  var_dump(json_decode("[" . $numbers . ",{\"a\":[1,2,3]}"));
+  var_dump(json_decode("{\"a\":" . $numbers . ",\"a\":" . $numbers . "}") !== null);
+}
+
+test_encode_long_strings();
+test_decode_long_strings();
+test_decode_big_documents();
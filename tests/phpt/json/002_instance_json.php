@@ -0,0 +1,109 @@
+@ok
+<?php
+
+#ifndef KPHP
+function instance_to_json($instance, int $flags = 0) {
+  return json_encode($instance, $flags);
+}
+
+function instance_from_json(string $json, string $class_name) {
+  return json_polyfill_convert(json_decode($json, true), $class_name);
+}
+
+function json_polyfill_convert($value, string $type) {
+  if ($value === null) {
+    return null;
+  }
+  if (substr($type, -2) === "[]") {
+    $result = [];
+    foreach ($value as $key => $element) {
+      $result[$key] = json_polyfill_convert($element, substr($type, 0, -2));
+    }
+    return $result;
+  }
+  if (!class_exists($type)) {
+    return $value;
+  }
+  $class = new ReflectionClass($type);
+  $instance = $class->newInstanceWithoutConstructor();
+  foreach ($class->getProperties() as $property) {
+    if (array_key_exists($property->getName(), $value)) {
+      preg_match('/@var \??(\w+(\[\])?)/', $property->getDocComment(), $matches);
+      $property->setValue($instance, json_polyfill_convert($value[$property->getName()], $matches[1]));
+    }
+  }
+  return $instance;
+}
+#endif
+
+class Point {
+  /** @var float */
+  public $x = 0.5;
+  /** @var float */
+  public $y = 0.5;
+}
+
+class User {
+  /** @var int */
+  public $id = 0;
+  /** @var string */
+  public $name = "";
+  /** @var bool */
+  public $active = false;
+  /** @var ?int */
+  public $age = null;
+  /** @var string[] */
+  public $tags = [];
+  /** @var Point[] */
+  public $points = [];
+  /** @var ?User */
+  public $friend = null;
+
+  public function __construct(int $id, string $name) {
+    $this->id = $id;
+    $this->name = $name;
+  }
+}
+
+function test_instance_to_json() {
+  $user = new User(1, "first \"user\" / é");
+  $user->tags = ["a", "b"];
+  $point = new Point;
+  $point->x = 1.5;
+  $user->points[] = $point;
+  $user->points[] = new Point;
+  $user->friend = new User(2, "second");
+  $user->friend->age = 30;
+  var_dump(instance_to_json($user));
+  var_dump(instance_to_json($user, JSON_UNESCAPED_UNICODE));
+}
+
+function test_instance_from_json() {
+  $user = instance_from_json('{"id": 5, "name": "bob", "active": true, "tags": ["x", "y"], "unknown": {"a": [1, "b", {"c": null}]},
+                               "points": [{"x": 2.5}, {"y": -1.5, "z": 1}], "friend": {"id": 6, "name": "al\\u00e9", "age": 20, "friend": null}}', User::class);
+  var_dump($user->id);
+  var_dump($user->name);
+  var_dump($user->active);
+  var_dump($user->age);
+  var_dump($user->tags);
+  var_dump(count($user->points));
+  var_dump($user->points[0]->x);
+  var_dump($user->points[0]->y);
+  var_dump($user->points[1]->y);
+  var_dump($user->friend->id);
+  var_dump($user->friend->name);
+  var_dump($user->friend->age);
+  var_dump($user->friend->friend === null);
+
+  $empty = instance_from_json('{}', User::class);
+  var_dump($empty->id);
+  var_dump($empty->name);
+
+  var_dump(instance_from_json('null', User::class) === null);
+
+  $copy = instance_from_json(instance_to_json($user), User::class);
+  var_dump(instance_to_json($copy) === instance_to_json($user));
+}
+
+test_instance_to_json();
+test_instance_from_json();
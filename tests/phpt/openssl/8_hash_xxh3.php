@@ -0,0 +1,34 @@
+@ok
+<?php
+
+function xxh3(string $s, bool $raw_output) {
+#ifndef KPHP
+  if (!in_array("xxh3", hash_algos())) {
+    // xxh3 appeared in php 8.1, the values are taken from it
+    $known_hashes = [0 => "2d06800538d394c2", 1 => "e6c632b61e964e1f", 3 => "78af5f94892f3950", 14 => "160d8e9329be94f9",
+                     40 => "7bce1718d27f8b61", 200 => "198e1bf91f3ea061", 3890 => "8ab48c0f33b8b879"];
+    $hash = $known_hashes[strlen($s)];
+    return $raw_output ? hex2bin($hash) : $hash;
+  }
+#endif
+  return hash("xxh3", $s, $raw_output);
+}
+
+function test_xxh3() {
+  $long = "";
+  for ($i = 0; $i < 1000; ++$i) {
+    $long .= "$i,";
+  }
+  foreach (["", "a", "abc", "message digest", "hello world, this is a key for the cache", substr($long, 0, 200), $long] as $s) {
+    var_dump(xxh3($s, false));
+    var_dump(bin2hex(xxh3($s, true)));
+  }
+}
+
+function test_hmac_algos() {
+  // non-cryptographic hashes can't be used with hash_hmac()
+  var_dump(in_array("xxh3", hash_hmac_algos()));
+}
+
+test_xxh3();
+test_hmac_algos();
@@ -0,0 +1,30 @@
+@ok
+<?php
+
+function make_pattern(string $name, int $i) {
+  return "/(?<$name>\\d+)-$i|x(y+)$i/";
+}
+
+function test_named_groups_of_dynamic_regexp() {
+  foreach (["first", "second", "first"] as $name) {
+    var_dump(preg_match(make_pattern($name, 7), "ab 12-7 xyy7", $matches));
+    var_dump($matches);
+    var_dump(preg_match_all(make_pattern($name, 7), "12-7 xyy7 5-7", $matches, PREG_SET_ORDER));
+    var_dump($matches);
+  }
+}
+
+function test_many_dynamic_regexps() {
+  // more regexps than the worker cache keeps
+  $total = 0;
+  for ($round = 0; $round < 2; ++$round) {
+    for ($i = 0; $i < 600; ++$i) {
+      $total += (int)preg_match(make_pattern("n", $i), "1-$i");
+      $total += (int)(preg_replace("/(\\d)$i\$/", "\${1}", "x{$i}1$i") === "x{$i}1");
+    }
+  }
+  var_dump($total);
+}
+
+test_named_groups_of_dynamic_regexp();
+test_many_dynamic_regexps();
@@ -0,0 +1,35 @@
+@ok
+<?php
+
+function test_literal_regexps() {
+  foreach (["/abc/", "/a/", "/a\\.b/", "/ab]c/", "/aé/u", "/^abc/", "/abc/A"] as $pattern) {
+    foreach (["", "abc", "xxabcxxabc", "a.b a-b", "ab]c", "ééaé", "ABC"] as $subject) {
+      var_dump(preg_match_all($pattern, $subject, $matches, PREG_OFFSET_CAPTURE));
+      var_dump($matches);
+      var_dump(preg_replace($pattern, "<\$0>", $subject));
+      var_dump(preg_split($pattern, $subject));
+    }
+  }
+}
+
+function test_regexps_with_literal_prefix() {
+  foreach (["/abc?d/", "/ab+c/", "/abc$/", "/foo(bar|baz)/", "/x(y+)z/", "/ab{2}/", "/aé?/u", "/abc/i", "/^abc/m", "/a b/x", "/foo|bar/"] as $pattern) {
+    foreach (["", "abd abcd", "xfoobazfoobar", "xyyz xz xyz", "abbb ab", "aé a", "ABC abc", "x\nabc", "a b ab"] as $subject) {
+      var_dump(preg_match_all($pattern, $subject, $matches, PREG_OFFSET_CAPTURE));
+      var_dump($matches);
+      var_dump(preg_replace($pattern, "<\$0>", $subject));
+    }
+  }
+}
+
+function test_offsets() {
+  var_dump(preg_match("/abc/", "abc abc", $matches, PREG_OFFSET_CAPTURE, 1));
+  var_dump($matches);
+  var_dump(preg_match("/ab(c)/", "abc abc", $matches, PREG_OFFSET_CAPTURE, 5));
+  var_dump($matches);
+  var_dump(preg_match("/^abc/", "abc abc", $matches, 0, 4));
+}
+
+test_literal_regexps();
+test_regexps_with_literal_prefix();
+test_offsets();
@@ -0,0 +1,52 @@
+@ok
+<?php
+
+function test_strtr() {
+  $pairs = ["h" => "-", "hello" => "hi", "hi" => "hello", "bcd" => "1", "abcde" => "2", "cd" => "3", "e" => "4"];
+  foreach (["hi all, I said hello world", "abcdef bcdx cde", "", "nothing to replace", "hhhello"] as $s) {
+    var_dump(strtr($s, $pairs));
+    // the second call goes through the cached automaton
+    var_dump(strtr($s, $pairs));
+  }
+
+  $int_keys = [1 => "one", 12 => "twelve", 123 => "one two three"];
+  var_dump(strtr("0123 12 1 2", $int_keys));
+
+  var_dump(strtr("abc", ["" => "x", "a" => "y"]));
+  var_dump(strtr("abc", []));
+
+  $dict = ["a" => "b"];
+  var_dump(strtr("aaa", $dict));
+  $dict["b"] = "c";
+  var_dump(strtr("aab", $dict));
+}
+
+function test_str_replace() {
+  $search = [];
+  $replace = [];
+  for ($i = 0; $i < 20; ++$i) {
+    $search[] = "w$i";
+    $replace[] = "w" . ($i + 1);
+  }
+  $count = 0;
+  // replacements are chained: w1 => w2 => ... => w20
+  var_dump(str_replace($search, $replace, "w1 w5 x w19", $count));
+  var_dump($count);
+
+  $search = ["a", "b", "c", "d", "e", "f", "g", "h", "xyz"];
+  $replace = ["b", "c", "", "dd"];
+  foreach (["abcdefgh", "xyzxyz", "none", "", "xy" . "z"] as $s) {
+    $count = 0;
+    var_dump(str_replace($search, $replace, $s, $count));
+    var_dump($count);
+  }
+
+  // the arrays built anew on every call are found in the cache by their content
+  foreach (["abcdefgh", "hgfedcba"] as $s) {
+    var_dump(str_replace(explode(",", "a,b,c,d,e,f,g,h"), ["1", "2", "3", "4", "5", "6", "7", $s], $s));
+    var_dump(str_replace(explode(",", "a,b,c,d,e,f,g,i"), ["1", "2", "3", "4", "5", "6", "7", $s], $s));
+  }
+}
+
+test_strtr();
+test_str_replace();
@@ -8,6 +8,28 @@ class A {
   public $b = "hello";
 }
 
+class GlobalCounters {
+  /** @var int */
+  public static $calls = 0;
+}
+
+/** @var int */
+$global_calls = 0;
+
+function count_global_vars_reset_calls() {
+  global $global_calls;
+  static $static_calls = 0;
+  $global_calls++;
+  $static_calls++;
+  GlobalCounters::$calls++;
+  return "$global_calls $static_calls " . GlobalCounters::$calls;
+}
+
+function yield_sleep(float $sleep_time) {
+  sched_yield_sleep($sleep_time);
+  return null;
+}
+
 if ($_SERVER["PHP_SELF"] === "/ini_get") {
   echo ini_get($_SERVER["QUERY_STRING"]);
 } else if (substr($_SERVER["PHP_SELF"], 0, 12) === "/test_limits") {
@@ -19,8 +41,20 @@ if ($_SERVER["PHP_SELF"] === "/ini_get") {
   sleep($sleep_time);
   fwrite(STDERR, "wake up!");
   echo "after sleep";
+} else if ($_SERVER["PHP_SELF"] === "/yield_sleep") {
+  // the worker serves the network while waiting, so the next requests are queued
+  wait(fork(yield_sleep((float)$_GET["time"])));
+  echo "after yield sleep";
+} else if ($_SERVER["PHP_SELF"] === "/start_time") {
+  // the order the queued requests are started in
+  echo sprintf("%.6f", microtime(true));
 } else if ($_SERVER["PHP_SELF"] === "/store-in-instance-cache") {
   echo instance_cache_store("test_key" . rand(), new A);
+} else if ($_SERVER["PHP_SELF"] === "/store-in-instance-cache-by-key") {
+  echo instance_cache_store((string)$_GET["key"], new A);
+} else if ($_SERVER["PHP_SELF"] === "/fetch-from-instance-cache") {
+  $a = instance_cache_fetch(A::class, (string)$_GET["key"]);
+  echo $a ? $a->b : "null";
 } else if ($_SERVER["PHP_SELF"] === "/test_zstd") {
   $res = "";
   switch($_GET["type"]) {
@@ -37,6 +71,11 @@ if ($_SERVER["PHP_SELF"] === "/ini_get") {
   }
   file_put_contents("out.dat", $res === false ? "false" : $res);
   echo "OK";
+} else if ($_SERVER["PHP_SELF"] === "/startup_const_arrays") {
+  require_once "startup_const_arrays.php";
+  echo startup_const_arrays_size();
+} else if ($_SERVER["PHP_SELF"] === "/global_vars_reset") {
+  echo count_global_vars_reset_calls();
 } else {
   echo "Hello world!";
 }
@@ -0,0 +1,273 @@
+<?php
+
+// large constant arrays are initialized by the master, the workers get them with the fork
+
+const STARTUP_INTS = [
+  39, 292, 712, 780, 147, 982, 473, 378, 687, 715, 811, 98, 464, 613, 510, 623, 19, 526, 442, 590, 381, 639, 872, 969, 560,
+  907, 773, 973, 444, 403, 180, 59, 871, 109, 839, 127, 384, 157, 98, 164, 524, 854, 507, 131, 790, 396, 611, 518, 278, 588,
+  186, 385, 65, 50, 593, 62, 191, 964, 62, 859, 169, 303, 281, 910, 78, 534, 638, 105, 876, 833, 598, 669, 955, 665, 695,
+  62, 96, 865, 637, 468, 805, 662, 920, 740, 339, 338, 541, 680, 717, 449, 170, 129, 868, 82, 799, 327, 51, 897, 605, 274,
+  376, 745, 190, 688, 618, 72, 992, 565, 678, 116, 304, 506, 920, 797, 746, 978, 370, 732, 444, 42, 484, 989, 424, 616, 792,
+  85, 366, 130, 660, 88, 894, 680, 748, 157, 587, 826, 314, 111, 706, 548, 434, 453, 601, 38, 150, 2, 108, 925, 810, 847,
+  127, 129, 752, 17, 791, 925, 841, 906, 799, 345, 121, 734, 545, 510, 265, 959, 772, 719, 467, 863, 348, 877, 973, 394, 89,
+  729, 34, 95, 734, 211, 867, 959, 688, 414, 198, 701, 957, 589, 413, 266, 608, 600, 418, 934, 819, 335, 407, 355, 53, 190,
+  550, 182, 802, 847, 192, 723, 755, 988, 52, 685, 239, 981, 307, 227, 353, 192, 795, 221, 392, 842, 398, 230, 62, 469, 513,
+  62, 98, 27, 24, 558, 881, 627, 867, 523, 909, 936, 515, 881, 517, 973, 114, 592, 353, 269, 224, 133, 459, 782, 400, 158,
+  255, 6, 111, 716, 224, 127, 579, 637, 425, 205, 385, 435, 108, 15, 191, 385, 119, 336, 320, 267, 551, 137, 553, 589, 155,
+  709, 248, 204, 242, 44, 92, 274, 490, 716, 958, 279, 857, 663, 813, 75, 493, 720, 347, 145, 327, 228, 10, 747, 212, 486,
+  993, 655, 153, 292, 583, 684, 454, 306, 740, 492, 454, 315, 934, 986, 770, 764, 561, 498, 865, 562, 624, 438, 741, 444, 530,
+  834, 588, 72, 218, 628, 953, 716, 654, 743, 839, 157, 620, 763, 25, 661, 110, 818, 902, 653, 716, 90, 926, 788, 914, 668,
+  236, 192, 202, 625, 812, 747, 829, 528, 61, 262, 173, 497, 473, 429, 304, 65, 350, 469, 453, 710, 273, 510, 142, 117, 823,
+  329, 366, 340, 373, 103, 802, 396, 715, 458, 334, 317, 856, 815, 215, 242, 810, 474, 186, 383, 308, 444, 245, 848, 607, 300,
+  539, 652, 49, 971, 185, 310, 907, 133, 807, 159, 218, 143, 182, 704, 960, 657, 602, 519, 733, 728, 928, 194, 267, 927, 511,
+  397, 935, 543, 190, 260, 853, 902, 108, 861, 764, 527, 371, 136, 105, 853, 446, 315, 513, 775, 260, 97, 157, 584, 709, 530,
+  402, 52, 385, 589, 449, 646, 470, 575, 482, 555, 663, 976, 109, 9, 691, 734, 498, 493, 837, 78, 294, 110, 682, 740, 210,
+  458, 715, 89, 697, 691, 556, 436, 490, 150, 973, 190, 367, 7, 84, 271, 338, 943, 43, 90, 912, 569, 855, 329, 189, 23,
+  643, 364, 209, 332, 875, 125, 424, 475, 60, 11, 649, 714, 85, 224, 915, 106, 950, 205, 628, 216, 250, 43, 793, 406, 40,
+  915, 113, 101, 311, 27, 73, 630, 894, 513, 684, 872, 827, 817, 672, 693, 229, 265, 284, 407, 622, 190, 810, 172, 640, 728,
+  328, 503, 818, 587, 420, 969, 642, 722, 870, 416, 679, 336, 470, 381, 604, 755, 208, 453, 447, 651, 852, 932, 496, 844, 17,
+  535, 834, 838, 158, 450, 33, 925, 592, 182, 786, 888, 115, 77, 454, 79, 472, 107, 125, 20, 644, 842, 257, 991, 707, 671,
+  514, 833, 536, 403, 236, 508, 781, 999, 11, 247, 320, 374, 104, 400, 88, 132, 11, 935, 535, 613, 73, 671, 116, 890, 442,
+  38, 696, 65, 207, 753, 672, 105, 571, 568, 946, 440, 829, 521, 22, 365, 717, 906, 592, 328, 383, 289, 682, 435, 556, 23,
+  448, 740, 748, 90, 29, 627, 10, 60, 20, 437, 277, 258, 864, 967, 551, 305, 26, 364, 461, 314, 33, 127, 961, 659, 407,
+  309, 801, 277, 772, 320, 83, 361, 45, 812, 757, 221, 555, 126, 426, 338, 368, 583, 459, 289, 944, 112, 507, 365, 515, 983,
+  191, 917, 111, 455, 434, 443, 490, 177, 227, 687, 613, 738, 272, 264, 506, 640, 416, 104, 992, 322, 328, 295, 110, 815, 974,
+  633, 520, 523, 723, 448, 771, 565, 924, 493, 749, 263, 795, 850, 676, 816, 856, 395, 799, 412, 879, 948, 36, 21, 646, 784,
+  14, 173, 297, 194, 763, 358, 879, 638, 666, 327, 158, 530, 613, 524, 450, 942, 423, 593, 7, 276, 927, 648, 255, 569, 320,
+  310, 628, 741, 726, 9, 578, 513, 894, 176, 62, 314, 728, 892, 133, 912, 122, 463, 983, 763, 344, 261, 151, 670, 235, 29,
+  697, 818, 93, 272, 269, 176, 587, 451, 513, 885, 47, 956, 170, 94, 390, 306, 557, 733, 716, 611, 138, 539, 842, 655, 368,
+  771, 70, 380, 630, 458, 690, 368, 840, 82, 685, 949, 492, 605, 68, 774, 112, 157, 130, 497, 425, 291, 356, 278, 62, 404,
+  153, 641, 468, 608, 715, 707, 604, 939, 818, 974, 579, 994, 954, 356, 322, 857, 957, 714, 594, 19, 153, 839, 250, 919, 187,
+  917, 663, 345, 94, 743, 559, 847, 967, 455, 721, 652, 13, 390, 342, 943, 303, 536, 164, 247, 203, 438, 564, 601, 532, 385,
+  896, 336, 234, 644, 244, 326, 235, 499, 909, 85, 294, 326, 958, 116, 898, 493, 713, 335, 127, 386, 41, 31, 296, 335, 216,
+  289, 10, 399, 598, 872, 39, 758, 585, 324, 935, 874, 59, 32, 485, 408, 855, 127, 243, 691, 134, 971, 59, 949, 712, 748,
+  781, 583, 437, 828, 356, 83, 538, 254, 122, 819, 282, 827, 28, 463, 98, 803, 232, 334, 735, 924, 805, 763, 496, 638, 431,
+  859, 566, 690, 659, 886, 845, 361, 673, 383, 977, 967, 94, 445, 990, 319, 246, 827, 930, 360, 627, 428, 480, 582, 901, 90,
+  774, 861, 662, 625, 912, 48, 212, 96, 392, 300, 201, 440, 466, 820, 999, 819, 167, 758, 854, 748, 609, 524, 783, 89, 916,
+  359, 953, 762, 168, 26, 465, 247, 668, 17, 567, 334, 414, 332, 174, 490, 426, 180, 479, 559, 55, 120, 465, 808, 660, 855,
+  46, 423, 7, 907, 726, 680, 289, 572, 769, 652, 747, 455, 276, 142, 822, 920, 338, 232, 261, 894, 926, 392, 748, 563, 888,
+  631, 590, 369, 742, 543, 868, 622, 393, 103, 345, 908, 292, 962, 929, 367, 654, 133, 381, 548, 782, 473, 974, 452, 518, 616,
+  854, 14, 579, 163, 697, 28, 564, 446, 1, 25, 581, 310, 939, 112, 700, 166, 528, 32, 385, 908, 221, 406, 466, 512, 981,
+  152, 154, 934, 634, 450, 536, 222, 93, 180, 249, 571, 265, 989, 91, 973, 95, 180, 847, 937, 316, 270, 687, 957, 500, 317,
+  528, 12, 464, 379, 33, 359, 73, 844, 127, 1, 833, 305, 716, 86, 983, 707, 599, 231, 270, 596, 16, 679, 893, 285, 756,
+  422, 960, 814, 993, 211, 924, 31, 125, 915, 221, 347, 834, 621, 625, 995, 466, 200, 533, 270, 847, 343, 43, 286, 81, 507,
+  719, 22, 254, 826, 341, 625, 218, 282, 406, 837, 384, 743, 721, 622, 425, 34, 882, 316, 970, 461, 269, 439, 120, 661, 621,
+  106, 63, 475, 424, 323, 200, 953, 846, 200, 414, 440, 853, 123, 606, 152, 763, 790, 681, 684, 804, 579, 752, 594, 824, 376,
+  398, 215, 179, 25, 237, 78, 835, 921, 119, 387, 781, 758, 48, 607, 15, 468, 751, 771, 745, 979, 805, 943, 378, 914, 700,
+  144, 753, 728, 235, 318, 125, 386, 62, 45, 312, 388, 794, 368, 232, 731, 854, 735, 666, 135, 976, 647, 280, 665, 994, 240,
+  796, 473, 47, 11, 279, 481, 118, 11, 339, 193, 597, 684, 992, 216, 878, 463, 322, 562, 597, 163, 513, 865, 19, 513, 288,
+  726, 514, 111, 520, 389, 734, 489, 309, 622, 72, 939, 767, 304, 834, 136, 228, 909, 360, 371, 491, 809, 445, 118, 621, 31,
+  737, 456, 10, 695, 132, 503, 449, 265, 512, 935, 763, 360, 769, 869, 392, 441, 655, 421, 301, 34, 522, 498, 859, 671, 749,
+  739, 20, 596, 741, 428, 589, 834, 913, 604, 57, 101, 0, 176, 308, 509, 914, 353, 643, 567, 225, 219, 81, 520, 897, 781,
+  356, 324, 899, 83, 697, 608, 829, 74, 727, 31, 919, 160, 497, 355, 403, 167, 801, 986, 537, 701, 174, 781, 740, 699, 847,
+  326, 858, 23, 48, 13, 98, 145, 720, 375, 580, 538, 84, 769, 91, 952, 965, 858, 286, 616, 210, 732, 530, 980, 861, 963,
+  190, 640, 856, 712, 104, 857, 12, 887, 595, 547, 436, 583, 200, 987, 847, 297, 53, 348, 703, 279, 525, 71, 610, 432, 388,
+  151, 7, 17, 591, 897, 816, 122, 449, 167, 125, 602, 85, 540, 51, 469, 881, 92, 635, 245, 818, 808, 845, 114, 27, 39,
+  560, 484, 164, 54, 294, 661, 185, 310, 530, 560, 332, 219, 87, 425, 823, 253, 865, 878, 560, 273, 907, 854, 548, 650, 166,
+  643, 827, 681, 557, 242, 391, 385, 97, 856, 352, 282, 479, 998, 607, 233, 408, 282, 937, 645, 411, 716, 408, 952, 284, 305,
+  99, 110, 131, 840, 490, 361, 46, 112, 467, 307, 999, 352, 894, 35, 465, 600, 862, 32, 574, 555, 460, 376, 34, 338, 557,
+  873, 349, 192, 827, 435, 160, 534, 294, 580, 774, 670, 898, 547, 40, 334, 353, 703, 298, 991, 597, 30, 949, 202, 598, 132,
+  22, 588, 935, 859, 437, 343, 504, 839, 672, 15, 392, 90, 906, 219, 2, 858, 119, 621, 21, 62, 786, 717, 571, 896, 167,
+  454, 0, 495, 429, 904, 958, 196, 23, 285, 605, 853, 74, 260, 323, 779, 916, 80, 691, 208, 38, 450, 282, 531, 62, 293,
+  680, 83, 300, 86, 441, 860, 874, 307, 329, 354, 433, 784, 151, 702, 510, 454, 592, 256, 347, 469, 91, 864, 640, 623, 583,
+  274, 133, 339, 751, 746, 276, 923, 317, 34, 439, 245, 241, 891, 575, 703, 551, 148, 781, 167, 905, 386, 861, 501, 948, 901,
+  524, 327, 100, 980, 815, 421, 51, 114, 107, 309, 679, 971, 714, 502, 820, 190, 268, 127, 756, 753, 458, 423, 18, 259, 748,
+  382, 676, 22, 379, 450, 427, 718, 137, 354, 826, 971, 250, 679, 220, 450, 806, 613, 389, 574, 635, 538, 534, 531, 506, 418,
+  629, 265, 495, 333, 78, 267, 515, 699, 548, 491, 17, 913, 2, 26, 999, 315, 337, 993, 115, 236, 99, 552, 452, 100, 898,
+  283, 845, 822, 507, 261, 763, 126, 696, 255, 757, 218, 912, 471, 372, 971, 507, 322, 752, 469, 764, 488, 846, 54, 82, 496,
+  693, 592, 788, 874, 640, 717, 611, 417, 314, 899, 364, 976, 233, 293, 7, 786, 69, 955, 72, 90, 145, 544, 5, 950, 983,
+  475, 915, 684, 899, 751, 399, 48, 855, 618, 673, 92, 506, 83, 710, 271, 924, 904, 149, 782, 277, 143, 311, 291, 869, 371,
+  777, 230, 273, 339, 695, 393, 654, 798, 735, 979, 542, 205, 151, 697, 575, 203, 957, 996, 670, 868, 179, 682, 321, 762, 418,
+  337, 800, 52, 32, 665, 912, 20, 105, 929, 464, 333, 820, 969, 203, 975, 94, 80, 729, 243, 928, 433, 716, 203, 494, 637,
+  316, 871, 626, 796, 359, 899, 158, 803, 481, 952, 572, 472, 696, 635, 710, 173, 326, 348, 487, 599, 767, 912, 944, 737, 829,
+  517, 40, 20, 853, 465, 948, 505, 933, 564, 717, 557, 527, 470, 431, 424, 544, 827, 326, 905, 810, 358, 355, 441, 909, 945,
+  970, 4, 741, 661, 105, 455, 835, 802, 876, 470, 43, 717, 753, 387, 775, 60, 365, 258, 283, 834, 11, 421, 929, 740, 370,
+  743, 781, 675, 185, 186, 786, 251, 289, 753, 578, 856, 261, 460, 397, 767, 650, 764, 169, 770, 314, 866, 397, 606, 398, 794,
+  398, 49, 250, 903, 125, 178, 763, 540, 510, 209, 829, 56, 211, 992, 830, 84, 649, 24, 851, 990, 863, 345, 337, 518, 278,
+  407, 172, 221, 586, 958, 780, 959, 143, 506, 955, 570, 283, 399, 342, 772, 556, 620, 591, 474, 686, 86, 660, 886, 534, 677,
+  993, 322, 748, 757, 522, 591, 369, 83, 827, 144, 371, 64, 86, 687, 577, 266, 739, 824, 210, 962, 537, 944, 377, 544, 291,
+  115, 386, 604, 689, 337, 609, 218, 656, 447, 47, 198, 322, 652, 377, 591, 552, 77, 997, 680, 359, 743, 993, 188, 306, 638,
+  469, 698, 790, 292, 927, 771, 846, 50, 902, 209, 391, 326, 874, 301, 37, 879, 655, 384, 869, 597, 198, 194, 761, 775, 593,
+  573, 118, 515, 749, 591, 771, 468, 191, 580, 132, 142, 835, 706, 674, 61, 852, 255, 57, 426, 453, 97, 686, 282, 895, 407,
+  994, 705, 19, 390, 876, 829, 231, 602, 670, 768, 322, 523, 508, 363, 826, 810, 149, 912, 555, 188, 145, 48, 638, 954, 507,
+  205, 588, 101, 464, 142, 437, 351, 537, 995, 674, 669, 273, 683, 121, 912, 647, 544, 735, 894, 965, 130, 117, 113, 634, 53,
+  50, 575, 945, 391, 920, 170, 169, 771, 733, 238, 660, 47, 173, 513, 19, 938, 100, 234, 800, 180, 187, 93, 229, 490, 753,
+  901, 450, 398, 354, 508, 755, 641, 377, 855, 964, 937, 123, 566, 615, 198, 432, 870, 308, 148, 15, 538, 220, 740, 460, 549,
+  713, 693, 255, 654, 407, 604, 539, 168, 385, 341, 427, 873, 272, 343, 453, 772, 8, 729, 605, 557, 704, 513, 615, 18, 684,
+  936, 927, 166, 647, 767, 424, 977, 693, 633, 231, 394, 696, 503, 763, 619, 418, 326, 855, 240, 724, 710, 785, 519, 991, 729,
+  482, 322, 69, 936, 416, 485, 564, 840, 670, 107, 829, 293, 871, 599, 626, 443, 990, 607, 566, 962, 560, 985, 470, 259, 791,
+  812, 901, 272, 479, 305, 121, 970, 262, 406, 492, 349, 964, 912, 622, 198, 319, 308, 67, 622, 865, 847, 96, 163, 662, 647,
+  211, 29, 481, 166, 395, 597, 149, 373, 825, 846, 342, 835, 957, 787, 250, 864, 429, 376, 801, 747, 881, 99, 296, 34, 713,
+  270, 384, 949, 307, 269, 577, 385, 797, 428, 136, 280, 386, 462, 93, 255, 162, 408, 278, 478, 814, 292, 211, 206, 557, 301,
+  565, 700, 716, 191, 151, 490, 830, 873, 611, 961, 463, 851, 362, 117, 696, 598, 404, 562, 493, 678, 119, 596, 227, 406, 354,
+  423, 868, 786, 483, 535, 469, 407, 226, 648, 285, 562, 445, 826, 164, 892, 84, 282, 681, 888, 392, 164, 480, 149, 638, 328,
+  517, 481, 879, 870, 366, 935, 388, 715, 826, 579, 362, 779, 117, 345, 294, 361, 200, 992, 930, 768, 582, 86, 565, 473, 221,
+  115, 888, 26, 125, 358, 831, 576, 284, 207, 830, 433, 482, 235, 494, 46, 121, 878, 652, 490, 986, 504, 473, 227, 542, 114,
+  792, 100, 91, 882, 682, 826, 405, 196, 950, 300, 308, 61, 71, 184, 89, 768, 93, 925, 89, 348, 441, 838, 860, 398, 258,
+  325, 945, 942, 457, 592, 211, 969, 867, 984, 812, 532, 647, 858, 125, 18, 30, 916, 365, 936, 557, 638, 337, 25, 806, 962,
+  285, 504, 776, 322, 634, 974, 445, 764, 555, 168, 313, 605, 952, 484, 940, 170, 218, 474, 972, 965, 961, 579, 802, 545, 585,
+  285, 744, 306, 839, 728, 454, 2, 702, 904, 819, 374, 949, 460, 547, 389, 34, 157, 352, 784, 541, 974, 55, 548, 303, 859,
+  394, 681, 14, 715, 422, 210, 895, 866, 739, 946, 606, 735, 527, 961, 316, 281, 742, 939, 75, 974, 468, 295, 797, 337, 995,
+  896, 131, 852, 315, 713, 689, 900, 462, 458, 444, 995, 725, 237, 376, 708, 790, 36, 862, 3, 970, 69, 661, 549, 188, 806,
+  621, 876, 620, 606, 409, 374, 618, 938, 939, 518, 46, 817, 576, 991, 516, 250, 224, 387, 576, 892, 80, 590, 676, 917, 462,
+  18, 643, 835, 556, 682, 211, 650, 851, 146, 743, 344, 925, 938, 792, 411, 710, 934, 274, 361, 786, 634, 157, 688, 943, 184,
+  338, 859, 258, 145, 46, 163, 421, 205, 338, 399, 647, 23, 912, 0, 814, 717, 121, 709, 239, 666, 860, 26, 133, 492, 774,
+  740, 981, 221, 783, 254, 759, 195, 320, 45, 674, 858, 921, 683, 243, 359, 448, 722, 156, 153, 885, 170, 678, 514, 912, 195,
+  437, 237, 430, 541, 47, 912, 102, 168, 347, 607, 489, 471, 561, 231, 943, 977, 630, 266, 407, 869, 602, 562, 406, 337, 425,
+  832, 417, 473, 998, 850, 528, 226, 104, 410, 574, 896, 652, 416, 571, 711, 906, 726, 935, 576, 187, 647, 912, 326, 555, 396,
+  28, 744, 356, 223, 482, 140, 667, 919, 878, 255, 139, 170, 250, 583, 497, 185, 19, 254, 429, 241, 442, 530, 846, 833, 468,
+  717, 504, 199, 931, 468, 772, 117, 793, 337, 515, 760, 36, 833, 588, 492, 41, 592, 478, 542, 975, 167, 277, 953, 196, 274,
+  138, 703, 336, 175, 61, 685, 839, 303, 444, 357, 424, 182, 209, 368, 975, 668, 216, 691, 522, 535, 416, 5, 10, 863, 990,
+  898, 818, 448, 72, 635, 598, 322, 10, 740, 367, 519, 238, 846, 168, 780, 182, 588, 425, 762, 76, 959, 340, 160, 89, 395,
+  638, 174, 238, 504, 612, 388, 372, 166, 603, 946, 94, 956, 343, 369, 533, 213, 382, 868, 181, 962, 572, 489, 928, 327, 846,
+  727, 584, 765, 160, 80, 400, 797, 123, 585, 795, 696, 892, 768, 807, 684, 541, 927, 744, 213, 825, 273, 763, 661, 129, 587,
+  311, 602, 573, 304, 632, 77, 615, 239, 908, 958, 361, 643, 37, 743, 236, 692, 692, 320, 278, 83, 670, 590, 41, 623, 152,
+  412, 922, 335, 199, 676, 519, 264, 554, 878, 75, 500, 247, 95, 274, 102, 163, 747, 652, 484, 527, 601, 754, 915, 901, 594,
+  478, 571, 90, 937, 345, 968, 276, 326, 57, 921, 676, 517, 864, 10, 953, 580, 646, 976, 666, 80, 613, 484, 550, 629, 215,
+  69, 729, 431, 842, 779, 621, 236, 510, 174, 970, 102, 317, 668, 359, 412, 926, 547, 993, 393, 950, 994, 958, 598, 407, 40,
+  891, 266, 530, 655, 835, 668, 854, 729, 466, 37, 729, 890, 750, 982, 550, 759, 625, 864, 453, 4, 206, 945, 160, 453, 549,
+  358, 47, 601, 448, 242, 181, 756, 123, 141, 307, 159, 348, 62, 949, 776, 160, 796, 856, 292, 297, 679, 590, 924, 387, 1,
+  191, 456, 29, 578, 704, 334, 161, 508, 620, 547, 416, 100, 147, 571, 481, 709, 768, 536, 844, 424, 415, 64, 328, 195, 953,
+  85, 166, 579, 169, 493, 899, 351, 334, 326, 580, 584, 439, 967, 296, 796, 730, 80, 599, 684, 567, 146, 866, 989, 735, 518,
+  343, 132, 693, 734, 321, 381, 863, 279, 305, 730, 976, 62, 915, 703, 311, 78, 755, 288, 695, 460, 583, 388, 85, 22, 49,
+  629, 13, 730, 864, 110, 197, 860, 583, 120, 615, 661, 597, 60, 624, 527, 867, 83, 158, 776, 496, 842, 706, 598, 683, 966,
+  350, 36, 863, 136, 211, 492, 871, 286, 487, 561, 54, 370, 825, 987, 261, 956, 710, 585, 981, 614, 308, 39, 329, 465, 610,
+  367, 368, 90, 344, 722, 151, 875, 181, 982, 178, 377, 530, 55, 273, 490, 788, 220, 490, 547, 656, 211, 566, 870, 717, 194,
+  937, 66, 975, 55, 274, 514, 193, 615, 764, 882, 493, 240, 644, 931, 443, 123, 34, 959, 415, 437, 784, 260, 929, 730, 407,
+  374, 553, 480, 588, 784, 314, 347, 447, 599, 413, 660, 275, 153, 172, 918, 483, 643, 18, 278, 849, 782, 472, 820, 548, 544,
+  114, 654, 261, 826, 794, 429, 335, 267, 601, 214, 438, 678, 124, 291, 947, 470, 625, 292, 437, 791, 386, 31, 326, 730, 701,
+  373, 727, 169, 253, 258, 724, 770, 462, 973, 306, 865, 317, 313, 257, 502, 527, 796, 301, 751, 449, 333, 412, 863, 404, 80,
+  791, 174, 601, 930, 921, 54, 854, 616, 306, 801, 768, 340, 953, 980, 416, 56, 749, 462, 807, 300, 121, 113, 188, 342, 735,
+  683, 826, 650, 535, 295, 708, 67, 237, 352, 105, 532, 813, 895, 111, 634, 476, 376, 135, 533, 674, 396, 757, 320, 945, 605,
+  938, 58, 457, 294, 773, 953, 236, 871, 92, 513, 232, 322, 389, 134, 298, 96, 501, 136, 937, 135, 601, 698, 862, 162, 83,
+  177, 178, 731, 938, 654, 358, 358, 931, 126, 523, 239, 564, 126, 694, 155, 263, 14, 669, 969, 913, 710, 605, 610, 782, 551,
+  458, 527, 476, 74, 333, 944, 434, 271, 262, 538, 315, 412, 831, 944, 416, 661, 81, 846, 993, 197, 318, 285, 671, 769, 856,
+  384, 817, 302, 83, 850, 446, 116, 682, 987, 746, 850, 826, 112, 260, 192, 717, 992, 486, 97, 523, 355, 548, 556, 812, 802,
+  391, 556, 495, 115, 50, 736, 371, 508, 506, 46, 399, 868, 205, 644, 107, 516, 824, 40, 168, 975, 830, 294, 212, 801, 927,
+  328, 35, 397, 423, 568, 387, 923, 90, 528, 930, 332, 272, 409, 613, 130, 956, 750, 886, 170, 470, 153, 911, 906, 386, 476,
+  672, 791, 370, 345, 867, 309, 134, 640, 139, 880, 668, 3, 996, 3, 86, 426, 317, 101, 168, 350, 456, 286, 203, 707, 429,
+  733, 606, 130, 952, 97, 668, 121, 663, 621, 240, 132, 261, 760, 787, 897, 700, 178, 843, 842, 555, 134, 373, 484, 611, 559,
+  249, 667, 834, 751, 365, 579, 12, 259, 685, 422, 364, 963, 804, 676, 928, 61, 988, 139, 169, 660, 219, 712, 596, 738, 888,
+  210, 493, 473, 465, 622, 955, 324, 832, 745, 431, 5, 245, 517, 350, 350, 398, 484, 43, 487, 193, 887, 934, 439, 918, 458,
+  460, 51, 469, 157, 517, 181, 584, 2, 730, 439, 97, 393, 52, 979, 922, 246, 696, 512, 741, 698, 352, 170, 508, 177, 801,
+  800, 454, 932, 859, 64, 954, 346, 978, 622, 164, 493, 313, 523, 659, 658, 169, 557, 285, 408, 107, 584, 328, 893, 886, 358,
+  655, 261, 195, 859, 905, 595, 58, 214, 79, 258, 889, 417, 642, 597, 353, 642, 76, 225, 74, 872, 587, 984, 466, 595, 541,
+  844, 922, 362, 264, 702, 615, 310, 739, 805, 15, 246, 574, 483, 602, 103, 925, 706, 51, 372, 976, 460, 878, 869, 593, 306,
+  751, 249, 141, 416, 287, 643, 518, 451, 116, 975, 374, 435, 695, 778, 745, 869, 557, 598, 425, 104, 652, 575, 773, 354, 325,
+  611, 174, 330, 97, 128, 195, 651, 280, 735, 826, 521, 217, 254, 255, 946, 950, 628, 729, 27, 759, 659, 740, 210, 832, 655,
+  78, 584, 962, 326, 939, 314, 230, 150, 749, 217, 63, 678, 527, 765, 322, 457, 860, 171, 443, 331, 729, 665, 642, 775, 290,
+  423, 292, 653, 387, 569, 642, 312, 728, 521, 844, 214, 537, 144, 189, 453, 865, 336, 967, 688, 369, 684, 893, 58, 724, 694,
+  228, 37, 634, 841, 582, 755, 966, 489, 158, 713, 138, 730, 10, 94, 494, 838, 495, 611, 784, 74, 417, 422, 791, 231, 575,
+  424, 828, 196, 541, 356, 967, 643, 260, 937, 8, 56, 55, 805, 499, 776, 435, 180, 753, 243, 173, 400, 423, 450, 566, 642,
+  985, 412, 775, 807, 679, 813, 345, 555, 965, 953, 606, 370, 788, 377, 924, 639, 364, 554, 974, 526, 603, 500, 577, 687, 255,
+  473, 337, 382, 485, 704, 15, 318, 704, 42, 382, 647, 814, 253, 383, 312, 369, 329, 880, 869, 810, 409, 891, 284, 478, 326,
+  895, 791, 394, 290, 770, 708, 139, 580, 826, 399, 272, 429, 126, 584, 741, 903, 22, 147, 786, 230, 952, 665, 535, 559, 693,
+  398, 204, 522, 307, 410, 925, 11, 984, 580, 45, 651, 957, 58, 624, 566, 531, 265, 596, 99, 652, 307, 239, 680, 62, 413,
+];
+
+const STARTUP_STRINGS = [
+  "k0" => 0, "k1" => 1, "k2" => 2, "k3" => 3, "k4" => 4, "k5" => 5, "k6" => 6, "k7" => 7, "k8" => 8, "k9" => 9,
+  "k10" => 10, "k11" => 11, "k12" => 12, "k13" => 13, "k14" => 14, "k15" => 15, "k16" => 16, "k17" => 17, "k18" => 18, "k19" => 19,
+  "k20" => 20, "k21" => 21, "k22" => 22, "k23" => 23, "k24" => 24, "k25" => 25, "k26" => 26, "k27" => 27, "k28" => 28, "k29" => 29,
+  "k30" => 30, "k31" => 31, "k32" => 32, "k33" => 33, "k34" => 34, "k35" => 35, "k36" => 36, "k37" => 37, "k38" => 38, "k39" => 39,
+  "k40" => 40, "k41" => 41, "k42" => 42, "k43" => 43, "k44" => 44, "k45" => 45, "k46" => 46, "k47" => 47, "k48" => 48, "k49" => 49,
+  "k50" => 50, "k51" => 51, "k52" => 52, "k53" => 53, "k54" => 54, "k55" => 55, "k56" => 56, "k57" => 57, "k58" => 58, "k59" => 59,
+  "k60" => 60, "k61" => 61, "k62" => 62, "k63" => 63, "k64" => 64, "k65" => 65, "k66" => 66, "k67" => 67, "k68" => 68, "k69" => 69,
+  "k70" => 70, "k71" => 71, "k72" => 72, "k73" => 73, "k74" => 74, "k75" => 75, "k76" => 76, "k77" => 77, "k78" => 78, "k79" => 79,
+  "k80" => 80, "k81" => 81, "k82" => 82, "k83" => 83, "k84" => 84, "k85" => 85, "k86" => 86, "k87" => 87, "k88" => 88, "k89" => 89,
+  "k90" => 90, "k91" => 91, "k92" => 92, "k93" => 93, "k94" => 94, "k95" => 95, "k96" => 96, "k97" => 97, "k98" => 98, "k99" => 99,
+  "k100" => 100, "k101" => 101, "k102" => 102, "k103" => 103, "k104" => 104, "k105" => 105, "k106" => 106, "k107" => 107, "k108" => 108, "k109" => 109,
+  "k110" => 110, "k111" => 111, "k112" => 112, "k113" => 113, "k114" => 114, "k115" => 115, "k116" => 116, "k117" => 117, "k118" => 118, "k119" => 119,
+  "k120" => 120, "k121" => 121, "k122" => 122, "k123" => 123, "k124" => 124, "k125" => 125, "k126" => 126, "k127" => 127, "k128" => 128, "k129" => 129,
+  "k130" => 130, "k131" => 131, "k132" => 132, "k133" => 133, "k134" => 134, "k135" => 135, "k136" => 136, "k137" => 137, "k138" => 138, "k139" => 139,
+  "k140" => 140, "k141" => 141, "k142" => 142, "k143" => 143, "k144" => 144, "k145" => 145, "k146" => 146, "k147" => 147, "k148" => 148, "k149" => 149,
+  "k150" => 150, "k151" => 151, "k152" => 152, "k153" => 153, "k154" => 154, "k155" => 155, "k156" => 156, "k157" => 157, "k158" => 158, "k159" => 159,
+  "k160" => 160, "k161" => 161, "k162" => 162, "k163" => 163, "k164" => 164, "k165" => 165, "k166" => 166, "k167" => 167, "k168" => 168, "k169" => 169,
+  "k170" => 170, "k171" => 171, "k172" => 172, "k173" => 173, "k174" => 174, "k175" => 175, "k176" => 176, "k177" => 177, "k178" => 178, "k179" => 179,
+  "k180" => 180, "k181" => 181, "k182" => 182, "k183" => 183, "k184" => 184, "k185" => 185, "k186" => 186, "k187" => 187, "k188" => 188, "k189" => 189,
+  "k190" => 190, "k191" => 191, "k192" => 192, "k193" => 193, "k194" => 194, "k195" => 195, "k196" => 196, "k197" => 197, "k198" => 198, "k199" => 199,
+  "k200" => 200, "k201" => 201, "k202" => 202, "k203" => 203, "k204" => 204, "k205" => 205, "k206" => 206, "k207" => 207, "k208" => 208, "k209" => 209,
+  "k210" => 210, "k211" => 211, "k212" => 212, "k213" => 213, "k214" => 214, "k215" => 215, "k216" => 216, "k217" => 217, "k218" => 218, "k219" => 219,
+  "k220" => 220, "k221" => 221, "k222" => 222, "k223" => 223, "k224" => 224, "k225" => 225, "k226" => 226, "k227" => 227, "k228" => 228, "k229" => 229,
+  "k230" => 230, "k231" => 231, "k232" => 232, "k233" => 233, "k234" => 234, "k235" => 235, "k236" => 236, "k237" => 237, "k238" => 238, "k239" => 239,
+  "k240" => 240, "k241" => 241, "k242" => 242, "k243" => 243, "k244" => 244, "k245" => 245, "k246" => 246, "k247" => 247, "k248" => 248, "k249" => 249,
+  "k250" => 250, "k251" => 251, "k252" => 252, "k253" => 253, "k254" => 254, "k255" => 255, "k256" => 256, "k257" => 257, "k258" => 258, "k259" => 259,
+  "k260" => 260, "k261" => 261, "k262" => 262, "k263" => 263, "k264" => 264, "k265" => 265, "k266" => 266, "k267" => 267, "k268" => 268, "k269" => 269,
+  "k270" => 270, "k271" => 271, "k272" => 272, "k273" => 273, "k274" => 274, "k275" => 275, "k276" => 276, "k277" => 277, "k278" => 278, "k279" => 279,
+  "k280" => 280, "k281" => 281, "k282" => 282, "k283" => 283, "k284" => 284, "k285" => 285, "k286" => 286, "k287" => 287, "k288" => 288, "k289" => 289,
+  "k290" => 290, "k291" => 291, "k292" => 292, "k293" => 293, "k294" => 294, "k295" => 295, "k296" => 296, "k297" => 297, "k298" => 298, "k299" => 299,
+  "k300" => 300, "k301" => 301, "k302" => 302, "k303" => 303, "k304" => 304, "k305" => 305, "k306" => 306, "k307" => 307, "k308" => 308, "k309" => 309,
+  "k310" => 310, "k311" => 311, "k312" => 312, "k313" => 313, "k314" => 314, "k315" => 315, "k316" => 316, "k317" => 317, "k318" => 318, "k319" => 319,
+  "k320" => 320, "k321" => 321, "k322" => 322, "k323" => 323, "k324" => 324, "k325" => 325, "k326" => 326, "k327" => 327, "k328" => 328, "k329" => 329,
+  "k330" => 330, "k331" => 331, "k332" => 332, "k333" => 333, "k334" => 334, "k335" => 335, "k336" => 336, "k337" => 337, "k338" => 338, "k339" => 339,
+  "k340" => 340, "k341" => 341, "k342" => 342, "k343" => 343, "k344" => 344, "k345" => 345, "k346" => 346, "k347" => 347, "k348" => 348, "k349" => 349,
+  "k350" => 350, "k351" => 351, "k352" => 352, "k353" => 353, "k354" => 354, "k355" => 355, "k356" => 356, "k357" => 357, "k358" => 358, "k359" => 359,
+  "k360" => 360, "k361" => 361, "k362" => 362, "k363" => 363, "k364" => 364, "k365" => 365, "k366" => 366, "k367" => 367, "k368" => 368, "k369" => 369,
+  "k370" => 370, "k371" => 371, "k372" => 372, "k373" => 373, "k374" => 374, "k375" => 375, "k376" => 376, "k377" => 377, "k378" => 378, "k379" => 379,
+  "k380" => 380, "k381" => 381, "k382" => 382, "k383" => 383, "k384" => 384, "k385" => 385, "k386" => 386, "k387" => 387, "k388" => 388, "k389" => 389,
+  "k390" => 390, "k391" => 391, "k392" => 392, "k393" => 393, "k394" => 394, "k395" => 395, "k396" => 396, "k397" => 397, "k398" => 398, "k399" => 399,
+  "k400" => 400, "k401" => 401, "k402" => 402, "k403" => 403, "k404" => 404, "k405" => 405, "k406" => 406, "k407" => 407, "k408" => 408, "k409" => 409,
+  "k410" => 410, "k411" => 411, "k412" => 412, "k413" => 413, "k414" => 414, "k415" => 415, "k416" => 416, "k417" => 417, "k418" => 418, "k419" => 419,
+  "k420" => 420, "k421" => 421, "k422" => 422, "k423" => 423, "k424" => 424, "k425" => 425, "k426" => 426, "k427" => 427, "k428" => 428, "k429" => 429,
+  "k430" => 430, "k431" => 431, "k432" => 432, "k433" => 433, "k434" => 434, "k435" => 435, "k436" => 436, "k437" => 437, "k438" => 438, "k439" => 439,
+  "k440" => 440, "k441" => 441, "k442" => 442, "k443" => 443, "k444" => 444, "k445" => 445, "k446" => 446, "k447" => 447, "k448" => 448, "k449" => 449,
+  "k450" => 450, "k451" => 451, "k452" => 452, "k453" => 453, "k454" => 454, "k455" => 455, "k456" => 456, "k457" => 457, "k458" => 458, "k459" => 459,
+  "k460" => 460, "k461" => 461, "k462" => 462, "k463" => 463, "k464" => 464, "k465" => 465, "k466" => 466, "k467" => 467, "k468" => 468, "k469" => 469,
+  "k470" => 470, "k471" => 471, "k472" => 472, "k473" => 473, "k474" => 474, "k475" => 475, "k476" => 476, "k477" => 477, "k478" => 478, "k479" => 479,
+  "k480" => 480, "k481" => 481, "k482" => 482, "k483" => 483, "k484" => 484, "k485" => 485, "k486" => 486, "k487" => 487, "k488" => 488, "k489" => 489,
+  "k490" => 490, "k491" => 491, "k492" => 492, "k493" => 493, "k494" => 494, "k495" => 495, "k496" => 496, "k497" => 497, "k498" => 498, "k499" => 499,
+  "k500" => 500, "k501" => 501, "k502" => 502, "k503" => 503, "k504" => 504, "k505" => 505, "k506" => 506, "k507" => 507, "k508" => 508, "k509" => 509,
+  "k510" => 510, "k511" => 511, "k512" => 512, "k513" => 513, "k514" => 514, "k515" => 515, "k516" => 516, "k517" => 517, "k518" => 518, "k519" => 519,
+  "k520" => 520, "k521" => 521, "k522" => 522, "k523" => 523, "k524" => 524, "k525" => 525, "k526" => 526, "k527" => 527, "k528" => 528, "k529" => 529,
+  "k530" => 530, "k531" => 531, "k532" => 532, "k533" => 533, "k534" => 534, "k535" => 535, "k536" => 536, "k537" => 537, "k538" => 538, "k539" => 539,
+  "k540" => 540, "k541" => 541, "k542" => 542, "k543" => 543, "k544" => 544, "k545" => 545, "k546" => 546, "k547" => 547, "k548" => 548, "k549" => 549,
+  "k550" => 550, "k551" => 551, "k552" => 552, "k553" => 553, "k554" => 554, "k555" => 555, "k556" => 556, "k557" => 557, "k558" => 558, "k559" => 559,
+  "k560" => 560, "k561" => 561, "k562" => 562, "k563" => 563, "k564" => 564, "k565" => 565, "k566" => 566, "k567" => 567, "k568" => 568, "k569" => 569,
+  "k570" => 570, "k571" => 571, "k572" => 572, "k573" => 573, "k574" => 574, "k575" => 575, "k576" => 576, "k577" => 577, "k578" => 578, "k579" => 579,
+  "k580" => 580, "k581" => 581, "k582" => 582, "k583" => 583, "k584" => 584, "k585" => 585, "k586" => 586, "k587" => 587, "k588" => 588, "k589" => 589,
+  "k590" => 590, "k591" => 591, "k592" => 592, "k593" => 593, "k594" => 594, "k595" => 595, "k596" => 596, "k597" => 597, "k598" => 598, "k599" => 599,
+  "k600" => 600, "k601" => 601, "k602" => 602, "k603" => 603, "k604" => 604, "k605" => 605, "k606" => 606, "k607" => 607, "k608" => 608, "k609" => 609,
+  "k610" => 610, "k611" => 611, "k612" => 612, "k613" => 613, "k614" => 614, "k615" => 615, "k616" => 616, "k617" => 617, "k618" => 618, "k619" => 619,
+  "k620" => 620, "k621" => 621, "k622" => 622, "k623" => 623, "k624" => 624, "k625" => 625, "k626" => 626, "k627" => 627, "k628" => 628, "k629" => 629,
+  "k630" => 630, "k631" => 631, "k632" => 632, "k633" => 633, "k634" => 634, "k635" => 635, "k636" => 636, "k637" => 637, "k638" => 638, "k639" => 639,
+  "k640" => 640, "k641" => 641, "k642" => 642, "k643" => 643, "k644" => 644, "k645" => 645, "k646" => 646, "k647" => 647, "k648" => 648, "k649" => 649,
+  "k650" => 650, "k651" => 651, "k652" => 652, "k653" => 653, "k654" => 654, "k655" => 655, "k656" => 656, "k657" => 657, "k658" => 658, "k659" => 659,
+  "k660" => 660, "k661" => 661, "k662" => 662, "k663" => 663, "k664" => 664, "k665" => 665, "k666" => 666, "k667" => 667, "k668" => 668, "k669" => 669,
+  "k670" => 670, "k671" => 671, "k672" => 672, "k673" => 673, "k674" => 674, "k675" => 675, "k676" => 676, "k677" => 677, "k678" => 678, "k679" => 679,
+  "k680" => 680, "k681" => 681, "k682" => 682, "k683" => 683, "k684" => 684, "k685" => 685, "k686" => 686, "k687" => 687, "k688" => 688, "k689" => 689,
+  "k690" => 690, "k691" => 691, "k692" => 692, "k693" => 693, "k694" => 694, "k695" => 695, "k696" => 696, "k697" => 697, "k698" => 698, "k699" => 699,
+  "k700" => 700, "k701" => 701, "k702" => 702, "k703" => 703, "k704" => 704, "k705" => 705, "k706" => 706, "k707" => 707, "k708" => 708, "k709" => 709,
+  "k710" => 710, "k711" => 711, "k712" => 712, "k713" => 713, "k714" => 714, "k715" => 715, "k716" => 716, "k717" => 717, "k718" => 718, "k719" => 719,
+  "k720" => 720, "k721" => 721, "k722" => 722, "k723" => 723, "k724" => 724, "k725" => 725, "k726" => 726, "k727" => 727, "k728" => 728, "k729" => 729,
+  "k730" => 730, "k731" => 731, "k732" => 732, "k733" => 733, "k734" => 734, "k735" => 735, "k736" => 736, "k737" => 737, "k738" => 738, "k739" => 739,
+  "k740" => 740, "k741" => 741, "k742" => 742, "k743" => 743, "k744" => 744, "k745" => 745, "k746" => 746, "k747" => 747, "k748" => 748, "k749" => 749,
+  "k750" => 750, "k751" => 751, "k752" => 752, "k753" => 753, "k754" => 754, "k755" => 755, "k756" => 756, "k757" => 757, "k758" => 758, "k759" => 759,
+  "k760" => 760, "k761" => 761, "k762" => 762, "k763" => 763, "k764" => 764, "k765" => 765, "k766" => 766, "k767" => 767, "k768" => 768, "k769" => 769,
+  "k770" => 770, "k771" => 771, "k772" => 772, "k773" => 773, "k774" => 774, "k775" => 775, "k776" => 776, "k777" => 777, "k778" => 778, "k779" => 779,
+  "k780" => 780, "k781" => 781, "k782" => 782, "k783" => 783, "k784" => 784, "k785" => 785, "k786" => 786, "k787" => 787, "k788" => 788, "k789" => 789,
+  "k790" => 790, "k791" => 791, "k792" => 792, "k793" => 793, "k794" => 794, "k795" => 795, "k796" => 796, "k797" => 797, "k798" => 798, "k799" => 799,
+  "k800" => 800, "k801" => 801, "k802" => 802, "k803" => 803, "k804" => 804, "k805" => 805, "k806" => 806, "k807" => 807, "k808" => 808, "k809" => 809,
+  "k810" => 810, "k811" => 811, "k812" => 812, "k813" => 813, "k814" => 814, "k815" => 815, "k816" => 816, "k817" => 817, "k818" => 818, "k819" => 819,
+  "k820" => 820, "k821" => 821, "k822" => 822, "k823" => 823, "k824" => 824, "k825" => 825, "k826" => 826, "k827" => 827, "k828" => 828, "k829" => 829,
+  "k830" => 830, "k831" => 831, "k832" => 832, "k833" => 833, "k834" => 834, "k835" => 835, "k836" => 836, "k837" => 837, "k838" => 838, "k839" => 839,
+  "k840" => 840, "k841" => 841, "k842" => 842, "k843" => 843, "k844" => 844, "k845" => 845, "k846" => 846, "k847" => 847, "k848" => 848, "k849" => 849,
+  "k850" => 850, "k851" => 851, "k852" => 852, "k853" => 853, "k854" => 854, "k855" => 855, "k856" => 856, "k857" => 857, "k858" => 858, "k859" => 859,
+  "k860" => 860, "k861" => 861, "k862" => 862, "k863" => 863, "k864" => 864, "k865" => 865, "k866" => 866, "k867" => 867, "k868" => 868, "k869" => 869,
+  "k870" => 870, "k871" => 871, "k872" => 872, "k873" => 873, "k874" => 874, "k875" => 875, "k876" => 876, "k877" => 877, "k878" => 878, "k879" => 879,
+  "k880" => 880, "k881" => 881, "k882" => 882, "k883" => 883, "k884" => 884, "k885" => 885, "k886" => 886, "k887" => 887, "k888" => 888, "k889" => 889,
+  "k890" => 890, "k891" => 891, "k892" => 892, "k893" => 893, "k894" => 894, "k895" => 895, "k896" => 896, "k897" => 897, "k898" => 898, "k899" => 899,
+  "k900" => 900, "k901" => 901, "k902" => 902, "k903" => 903, "k904" => 904, "k905" => 905, "k906" => 906, "k907" => 907, "k908" => 908, "k909" => 909,
+  "k910" => 910, "k911" => 911, "k912" => 912, "k913" => 913, "k914" => 914, "k915" => 915, "k916" => 916, "k917" => 917, "k918" => 918, "k919" => 919,
+  "k920" => 920, "k921" => 921, "k922" => 922, "k923" => 923, "k924" => 924, "k925" => 925, "k926" => 926, "k927" => 927, "k928" => 928, "k929" => 929,
+  "k930" => 930, "k931" => 931, "k932" => 932, "k933" => 933, "k934" => 934, "k935" => 935, "k936" => 936, "k937" => 937, "k938" => 938, "k939" => 939,
+  "k940" => 940, "k941" => 941, "k942" => 942, "k943" => 943, "k944" => 944, "k945" => 945, "k946" => 946, "k947" => 947, "k948" => 948, "k949" => 949,
+  "k950" => 950, "k951" => 951, "k952" => 952, "k953" => 953, "k954" => 954, "k955" => 955, "k956" => 956, "k957" => 957, "k958" => 958, "k959" => 959,
+  "k960" => 960, "k961" => 961, "k962" => 962, "k963" => 963, "k964" => 964, "k965" => 965, "k966" => 966, "k967" => 967, "k968" => 968, "k969" => 969,
+  "k970" => 970, "k971" => 971, "k972" => 972, "k973" => 973, "k974" => 974, "k975" => 975, "k976" => 976, "k977" => 977, "k978" => 978, "k979" => 979,
+  "k980" => 980, "k981" => 981, "k982" => 982, "k983" => 983, "k984" => 984, "k985" => 985, "k986" => 986, "k987" => 987, "k988" => 988, "k989" => 989,
+  "k990" => 990, "k991" => 991, "k992" => 992, "k993" => 993, "k994" => 994, "k995" => 995, "k996" => 996, "k997" => 997, "k998" => 998, "k999" => 999,
+];
+
+function startup_const_arrays_size() {
+  return count(STARTUP_INTS) + count(STARTUP_STRINGS);
+}
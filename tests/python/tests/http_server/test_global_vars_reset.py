@@ -0,0 +1,30 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestGlobalVarsReset(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 1,
+        })
+
+    def test_used_vars_are_reset(self):
+        initial_stats = self.kphp_server.get_stats(prefix="kphp_server.")
+        for _ in range(3):
+            resp = self.kphp_server.http_get("/global_vars_reset")
+            self.assertEqual(resp.status_code, 200)
+            self.assertEqual(resp.text, "1 1 1")
+        self.kphp_server.assert_stats(
+            initial_stats=initial_stats,
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_requests_total_reset_global_vars": self.cmpGe(3 * 3),
+            })
+
+    def test_reset_after_request_not_using_vars(self):
+        # the second request doesn't use the counters, so their parts aren't reset after it
+        self.kphp_server.http_get("/global_vars_reset")
+        resp = self.kphp_server.http_get("/")
+        self.assertEqual(resp.text, "Hello world!")
+        resp = self.kphp_server.http_get("/global_vars_reset")
+        self.assertEqual(resp.text, "1 1 1")
@@ -0,0 +1,58 @@
+from multiprocessing.dummy import Pool as ThreadPool
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestHttpReuseport(KphpServerAutoTestCase):
+    WORKERS = 4
+    REQUESTS = 2000
+    CLIENTS = 32
+
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": cls.WORKERS,
+            "-v": True,
+        })
+
+    def _send_request(self, ignore_id):
+        resp = self.kphp_server.http_get()
+        self.assertEqual(resp.status_code, 200)
+        self.assertEqual(resp.text, "Hello world!")
+
+    def _run_load(self, options):
+        self.kphp_server.update_options(options)
+        self.kphp_server.restart()
+        initial_stats = self.kphp_server.get_stats(prefix="kphp_server.")
+        # more concurrent clients than workers, so the workers are saturated
+        with ThreadPool(self.CLIENTS) as p:
+            p.map(self._send_request, range(self.REQUESTS))
+        self.kphp_server.assert_stats(
+            initial_stats=initial_stats,
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_connections_accepted_total": self.cmpGe(self.REQUESTS),
+                "workers_general_connections_accepted_p50": self.cmpGt(0),
+            })
+
+    def test_shared_socket(self):
+        self._run_load({"--http-reuseport": None})
+
+    def test_reuseport_sockets(self):
+        self._run_load({"--http-reuseport": True})
+
+    def test_reuseport_sockets_with_cpu_affinity(self):
+        self._run_load({"--http-reuseport": True, "--workers-cpu-affinity": "cpu"})
+        self.kphp_server.update_options({"--workers-cpu-affinity": None})
+
+    def test_reuseport_sockets_on_graceful_restart(self):
+        self.kphp_server.update_options({"--http-reuseport": True})
+        self.kphp_server.restart()
+        # every request fails on the connection reset, if a socket of the old master is closed with the queued connections
+        with ThreadPool(self.CLIENTS) as p:
+            load = p.map_async(self._send_request, range(self.REQUESTS))
+            self.kphp_server.start()
+            load.get()
+        self.kphp_server.assert_log(["got {} reuseport http sockets, {} of them are handed over".format(self.WORKERS, self.WORKERS - 1)],
+                                    "The reuseport http sockets were not handed over")
+        self._send_request(0)
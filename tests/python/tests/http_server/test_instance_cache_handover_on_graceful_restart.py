@@ -0,0 +1,45 @@
+import time
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestInstanceCacheHandoverOnGracefulRestart(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 4,
+            "-v": True,
+        })
+
+    def store_in_instance_cache(self, key):
+        resp = self.kphp_server.http_get(uri='/store-in-instance-cache-by-key?key={}'.format(key))
+        self.assertEqual(resp.status_code, 200)
+        self.assertEqual(resp.text, "1")
+
+    def fetch_from_instance_cache(self, key):
+        resp = self.kphp_server.http_get(uri='/fetch-from-instance-cache?key={}'.format(key))
+        self.assertEqual(resp.status_code, 200)
+        return resp.text
+
+    def test_instance_cache_handover(self):
+        self.kphp_server.update_options({"--disable-instance-cache-handover": None})
+        self.kphp_server.restart()
+
+        self.store_in_instance_cache("handover_key")
+        self.assertEqual(self.fetch_from_instance_cache("handover_key"), "hello")
+        self.kphp_server.start()
+
+        self.kphp_server.assert_log([r"instance cache handover: \[taken_over = 1\] \[elements_transferred = 1\]"],
+                                    "Instance cache was not handed over")
+        self.assertEqual(self.fetch_from_instance_cache("handover_key"), "hello")
+        self.assertEqual(self.fetch_from_instance_cache("missing_key"), "null")
+
+    def test_instance_cache_handover_disabled(self):
+        self.kphp_server.update_options({"--disable-instance-cache-handover": True})
+        self.kphp_server.restart()
+
+        self.store_in_instance_cache("handover_key")
+        self.kphp_server.start()
+
+        time.sleep(5)
+        self.assertEqual(self.fetch_from_instance_cache("handover_key"), "null")
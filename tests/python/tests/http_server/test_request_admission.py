@@ -0,0 +1,45 @@
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestRequestAdmission(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 1,
+        })
+
+    def test_request_past_deadline_is_shed(self):
+        with ThreadPoolExecutor(max_workers=2) as executor:
+            busy = executor.submit(self.kphp_server.http_get, "/yield_sleep?time=1.5")
+            time.sleep(0.3)
+            resp = self.kphp_server.http_get("/", headers={"X-Kphp-Deadline-Ms": "200"})
+            self.assertEqual(resp.status_code, 503)
+            self.assertEqual(busy.result().status_code, 200)
+
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_requests_shed_normal": 1,
+            })
+
+    def test_queue_delay_by_priority(self):
+        with ThreadPoolExecutor(max_workers=3) as executor:
+            busy = executor.submit(self.kphp_server.http_get, "/yield_sleep?time=0.5")
+            time.sleep(0.1)
+            background = executor.submit(self.kphp_server.http_get, "/start_time", headers={"X-Kphp-Priority": "background"})
+            # the background request is queued first
+            time.sleep(0.1)
+            critical = executor.submit(self.kphp_server.http_get, "/start_time", headers={"X-Kphp-Priority": "critical"})
+            for future in (busy, background, critical):
+                self.assertEqual(future.result().status_code, 200)
+            self.assertLess(float(critical.result().text), float(background.result().text))
+
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_requests_queue_delay_critical_max": self.cmpGt(0.1),
+                "workers_general_requests_queue_delay_background_max": self.cmpGt(0.2),
+            })
@@ -10,6 +10,8 @@ class TestWarmUpOnGracefulRestart(KphpServerAutoTestCase):
         cls.kphp_server.update_options({
             "--workers-num": 15,
             "-v": True,
+            # the same binary hands the instance cache over, so it's always hot
+            "--disable-instance-cache-handover": True,
         })
 
     def prepare_for_test(self, *, workers_part, instance_cache_part, timeout_sec):
@@ -0,0 +1,53 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestWorkerStartup(KphpServerAutoTestCase):
+    WORKERS = 4
+
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": cls.WORKERS,
+        })
+
+    def test_time_to_first_request_with_const_arrays(self):
+        self.kphp_server.restart()
+        resp = self.kphp_server.http_get("/startup_const_arrays")
+        self.assertEqual(resp.status_code, 200)
+        self.assertEqual(resp.text, "5000")
+
+        for _ in range(self.WORKERS * 4):
+            self.kphp_server.http_get("/startup_const_arrays")
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_startup_time_to_first_request_p50": self.cmpGt(0),
+                "workers_general_startup_time_to_first_request_max": self.cmpGt(0),
+            })
+
+    def test_frozen_const_arrays_are_shared(self):
+        for _ in range(self.WORKERS * 4):
+            self.kphp_server.http_get("/startup_const_arrays")
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "workers_general_memory_frozen_const_bytes_max": self.cmpGt(16 * 1024),
+                "workers_general_memory_frozen_const_shared_bytes_p50": self.cmpGt(0),
+                "server_memory_frozen_const_saved_bytes": self.cmpGt(0),
+            })
+
+
+class TestWorkerScriptReload(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--workers-num": 1,
+            "--worker-queries-to-reload": 2,
+        })
+
+    def test_queries_after_script_reload(self):
+        # the script is recreated by the event loop after every second response is written out
+        for _ in range(10):
+            resp = self.kphp_server.http_get("/startup_const_arrays")
+            self.assertEqual(resp.status_code, 200)
+            self.assertEqual(resp.text, "5000")
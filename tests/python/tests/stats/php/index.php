@@ -39,6 +39,24 @@ function get_stats_by_rpc() {
   echo json_encode($result["result"]);
 }
 
+function burn_cpu(int $iterations) {
+  $x = 0.0;
+  for ($i = 0; $i < $iterations; ++$i) {
+    $x += sqrt($i);
+  }
+  return $x;
+}
+
+function get_sampling_profile_by_mc() {
+  $mc = new McMemcache();
+  $mc->addServer("localhost", (int)$_GET["master-port"], true, 1, 10);
+  $result = $mc->get("sampling_profile");
+  if (!is_string($result)) {
+    critical_error("mc get timeout!");
+  }
+  echo $result;
+}
+
 function do_http_worker() {
   switch($_SERVER["PHP_SELF"]) {
     case "/get_stats_by_mc": {
@@ -49,6 +67,14 @@ function do_http_worker() {
       get_stats_by_rpc();
       return;
     }
+    case "/burn_cpu": {
+      echo burn_cpu((int)$_GET["iterations"]);
+      return;
+    }
+    case "/get_sampling_profile_by_mc": {
+      get_sampling_profile_by_mc();
+      return;
+    }
   }
 
   run_default();
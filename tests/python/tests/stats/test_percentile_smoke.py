@@ -38,6 +38,9 @@ class TestPercentileSmoke(KphpServerAutoTestCase):
                 "workers_general_requests_net_time_p99": self.cmpGe(0.01),
                 "workers_general_requests_working_time_p50": self.cmpGe(0.02),
                 "workers_general_requests_working_time_p95": self.cmpGe(0.02),
-                "workers_general_requests_working_time_p99": self.cmpGe(0.02)
+                "workers_general_requests_working_time_p99": self.cmpGe(0.02),
+                "workers_general_requests_working_time_p90": self.cmpGe(0.02),
+                "workers_general_requests_working_time_p999": self.cmpGe(0.02),
+                "workers_general_requests_working_time_max": self.cmpGe(0.02)
             }
         )
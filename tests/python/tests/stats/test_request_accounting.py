@@ -0,0 +1,21 @@
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestRequestAccounting(KphpServerAutoTestCase):
+    def test_endpoint_stats(self):
+        for _ in range(10):
+            resp = self.kphp_server.http_get("/")
+            self.assertEqual(resp.status_code, 200)
+            self.assertEqual(resp.text, "Hello world!")
+
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "endpoints_index_requests": 10,
+                "endpoints_index_working_time_p50": self.cmpGe(0.02),
+                "endpoints_index_working_time_max": self.cmpGe(0.02),
+                "endpoints_index_cpu_time_p50": self.cmpGe(0.005),
+                "endpoints_index_allocated_bytes_p50": self.cmpGt(0),
+                "endpoints_index_allocations": self.cmpGt(0),
+                "endpoints_index_blocked_time_timer": self.cmpGe(0.1),
+            })
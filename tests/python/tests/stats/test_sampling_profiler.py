@@ -0,0 +1,33 @@
+import re
+
+from python.lib.testcase import KphpServerAutoTestCase
+
+
+class TestSamplingProfiler(KphpServerAutoTestCase):
+    @classmethod
+    def extra_class_setup(cls):
+        cls.kphp_server.update_options({
+            "--sampling-profiler": 1000,
+        })
+
+    def test_collapsed_stacks(self):
+        resp = self.kphp_server.http_get("/burn_cpu?iterations=50000000")
+        self.assertEqual(resp.status_code, 200)
+
+        resp = self.kphp_server.http_get("/get_sampling_profile_by_mc?master-port={}".format(self.kphp_server.master_port))
+        self.assertEqual(resp.status_code, 200)
+        stacks = resp.text.splitlines()
+        self.assertTrue(stacks)
+        total_samples = 0
+        for stack in stacks:
+            match = re.fullmatch(r"(\S.*) (\d+)", stack)
+            self.assertIsNotNone(match, stack)
+            total_samples += int(match.group(2))
+        self.assertGreater(total_samples, 0)
+        self.assertTrue(any("burn_cpu" in stack for stack in stacks))
+
+        self.kphp_server.assert_stats(
+            prefix="kphp_server.",
+            expected_added_stats={
+                "sampling_profiler_samples": self.cmpGe(total_samples),
+            })